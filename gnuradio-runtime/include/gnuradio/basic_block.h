@@ -15,38 +15,21 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/logger.h>
 #include <gnuradio/msg_accepter.h>
+#include <gnuradio/msg_port_queue.h>
 #include <gnuradio/runtime_types.h>
 #include <gnuradio/sptr_magic.h>
 #include <gnuradio/thread/thread.h>
 #include <boost/thread/condition_variable.hpp>
-#include <deque>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <gnuradio/rpcregisterhelpers.h>
 
 namespace gr {
 
-class msg_queue_comparator
-{
-private:
-    const pmt::pmt_t d_system_port = pmt::intern("system");
-
-public:
-    bool operator()(pmt::pmt_t const& queue_key1, pmt::pmt_t const& queue_key2) const
-    {
-        if (pmt::eqv(queue_key2, d_system_port))
-            return false;
-        else if (pmt::eqv(queue_key1, d_system_port))
-            return true;
-        else {
-            pmt::comparator cmp;
-            return cmp(queue_key1, queue_key2);
-        }
-    }
-};
-
 /*!
  * \brief The abstract base class for all signal processing blocks.
  * \ingroup internal
@@ -67,17 +50,38 @@ private:
     typedef std::map<pmt::pmt_t, msg_handler_t, pmt::comparator> d_msg_handlers_t;
     d_msg_handlers_t d_msg_handlers;
 
-    typedef std::deque<pmt::pmt_t> msg_queue_t;
-    typedef std::map<pmt::pmt_t, msg_queue_t, msg_queue_comparator> msg_queue_map_t;
-    typedef std::map<pmt::pmt_t, msg_queue_t, msg_queue_comparator>::iterator
-        msg_queue_map_itr;
-
-    gr::thread::mutex mutex; //< protects all vars
+    // A subscriber of an output message port, resolved when it subscribes.
+    struct msg_target {
+        pmt::pmt_t target; //< (block alias . port), as in d_message_subscribers
+        std::weak_ptr<basic_block> block;
+        int port; //< index of the port on block, or -1 if not resolved
+    };
+    struct msg_out_port {
+        pmt::pmt_t port;
+        std::vector<msg_target> targets;
+    };
+
+    // Input message ports in the order they were registered, which makes
+    // the system port of a block the first; a port's index is its place
+    // here. Ports are only added, before the flowgraph runs.
+    std::vector<std::unique_ptr<msg_port_queue>> d_msg_ports;
+
+    // Output message ports and their subscribers. Like
+    // d_message_subscribers, only changed while the flowgraph is stopped
+    // or locked.
+    std::vector<msg_out_port> d_msg_out_ports;
+
+    msg_out_port* find_msg_out_port(const pmt::pmt_t& port_id);
+    msg_port_queue& msg_port(const pmt::pmt_t& which_port);
+
+    //! Queue \p msg on the input message port with index \p port.
+    void post_to(int port, const pmt::pmt_t& msg);
 
 protected:
     friend class flowgraph;
     friend class flat_flowgraph; // TODO: will be redundant
     friend class tpb_thread_body;
+    friend class scheduler_ws;
 
     enum vcolor { WHITE, GREY, BLACK };
 
@@ -96,7 +100,6 @@ protected:
     gr::logger_ptr d_logger;       //! Default logger
     gr::logger_ptr d_debug_logger; //! Verbose logger
 
-    msg_queue_map_t msg_queue;
     std::vector<rpcbasic_sptr> d_rpc_vars; // container for all RPC variables
 
     basic_block(void) {} // allows pure virtual interface sub-classes
@@ -143,6 +146,24 @@ protected:
         }
     }
 
+    /*!
+     * \brief Wake the block's thread for a newly queued message.
+     *
+     * Called after every message queued on one of our input ports.
+     */
+    virtual void notify_msg();
+
+    /*!
+     * \brief Dispatch the messages queued on the ports with a handler.
+     *
+     * Called by the schedulers from the block's thread. Pops the
+     * messages of each port in batches. Messages on ports without a
+     * handler stay queued, for the block to fetch with
+     * delete_head_nowait(). Logs the messages the ports' overflow
+     * policies dropped since the last call.
+     */
+    void dispatch_msgs();
+
     // Message passing interface
     pmt::pmt_t d_message_subscribers;
 
@@ -248,20 +269,42 @@ public:
      */
     void _post(pmt::pmt_t which_port, pmt::pmt_t msg);
 
+    /*!
+     * \brief Index of input message port \p which_port, or -1 if there is none.
+     *
+     * Stays the same for the life of the block.
+     */
+    int msg_port_index(const pmt::pmt_t& which_port) const;
+
+    /*!
+     * \brief Set how many messages input port \p which_port holds and
+     * what happens to a message posted while it is full.
+     *
+     * Ports hold max_messages from the [DEFAULT] section of the
+     * preferences and drop their oldest message by default. Their
+     * storage starts small and grows only as messages back up. Call this
+     * before the flowgraph starts, e.g. in the block's constructor.
+     *
+     * \param which_port the input message port
+     * \param policy see gr::msg_port_queue::overflow_t
+     * \param capacity number of messages; 0 keeps the current capacity
+     */
+    void set_msg_port_overflow(pmt::pmt_t which_port,
+                               msg_port_queue::overflow_t policy,
+                               size_t capacity = 0);
+
+    //! How many messages were dropped on \p which_port because it was full?
+    uint64_t nmsgs_dropped(pmt::pmt_t which_port) { return msg_port(which_port).dropped(); }
+
     //! is the queue empty?
-    bool empty_p(pmt::pmt_t which_port)
-    {
-        if (msg_queue.find(which_port) == msg_queue.end())
-            throw std::runtime_error("port does not exist!");
-        return msg_queue[which_port].empty();
-    }
+    bool empty_p(pmt::pmt_t which_port) { return msg_port(which_port).empty(); }
     bool empty_p()
     {
-        bool rv = true;
-        for (const auto& i : msg_queue) {
-            rv &= msg_queue[i.first].empty();
+        for (const auto& q : d_msg_ports) {
+            if (!q->empty())
+                return false;
         }
-        return rv;
+        return true;
     }
 
     //! are all msg ports with handlers empty?
@@ -271,41 +314,26 @@ public:
     }
     bool empty_handled_p()
     {
-        bool rv = true;
-        for (const auto& i : msg_queue) {
-            rv &= empty_handled_p(i.first);
+        for (const auto& q : d_msg_ports) {
+            if (!q->empty() && has_msg_handler(q->port()))
+                return false;
         }
-        return rv;
+        return true;
     }
 
     //! How many messages in the queue?
-    size_t nmsgs(pmt::pmt_t which_port)
-    {
-        if (msg_queue.find(which_port) == msg_queue.end())
-            throw std::runtime_error("port does not exist!");
-        return msg_queue[which_port].size();
-    }
+    size_t nmsgs(pmt::pmt_t which_port) { return msg_port(which_port).size(); }
 
-    //| Acquires and release the mutex
+    //| Does not lock; applies the port's overflow policy if it is full
     void insert_tail(pmt::pmt_t which_port, pmt::pmt_t msg);
     /*!
      * \returns returns pmt at head of queue or pmt::pmt_t() if empty.
      */
     pmt::pmt_t delete_head_nowait(pmt::pmt_t which_port);
 
-    msg_queue_t::iterator get_iterator(pmt::pmt_t which_port)
-    {
-        return msg_queue[which_port].begin();
-    }
-
-    void erase_msg(pmt::pmt_t which_port, msg_queue_t::iterator it)
-    {
-        msg_queue[which_port].erase(it);
-    }
-
     virtual bool has_msg_port(pmt::pmt_t which_port)
     {
-        if (msg_queue.find(which_port) != msg_queue.end()) {
+        if (msg_port_index(which_port) >= 0) {
             return true;
         }
         if (pmt::dict_has_key(d_message_subscribers, which_port)) {
@@ -314,8 +342,6 @@ public:
         return false;
     }
 
-    const msg_queue_map_t& get_msg_map(void) const { return msg_queue; }
-
 #ifdef GR_CTRLPORT
     /*!
      * \brief Add an RPC variable (get or set).
@@ -405,7 +431,7 @@ public:
     template <typename T>
     void set_msg_handler(pmt::pmt_t which_port, T msg_handler)
     {
-        if (msg_queue.find(which_port) == msg_queue.end()) {
+        if (msg_port_index(which_port) < 0) {
             throw std::runtime_error(
                 "attempt to set_msg_handler() on bad input message port!");
         }
@@ -810,6 +810,9 @@ protected:
 
     void set_fixed_rate(bool fixed_rate) { d_fixed_rate = fixed_rate; }
 
+    //! Wakes our thread through the block detail, without a registry lookup
+    void notify_msg() override;
+
     /*!
      * \brief  Adds a new tag onto the given output buffer.
      *
@@ -15,6 +15,7 @@
 #include <gnuradio/custom_lock.h>
 #include <gnuradio/logger.h>
 #include <gnuradio/runtime_types.h>
+#include <gnuradio/tag_ring.h>
 #include <gnuradio/tags.h>
 #include <gnuradio/thread/thread.h>
 #include <gnuradio/transfer_type.h>
@@ -151,6 +152,24 @@ public:
      */
     void add_item_tag(const tag_t& tag);
 
+    /*!
+     * \brief  Adds a batch of tags to the buffer under a single lock.
+     *
+     * \param tags       the new tags
+     */
+    void add_item_tags(const std::vector<tag_t>& tags);
+
+    /*!
+     * \brief  Moves a batch of tags into the buffer under a single lock.
+     *
+     * Like add_item_tags(), but the buffer takes over the tags' PMTs
+     * instead of copying them, which saves their reference count
+     * updates. Only the offsets of \p tags are left intact.
+     *
+     * \param tags       the new tags
+     */
+    void move_item_tags(std::vector<tag_t>& tags);
+
     /*!
      * \brief  Removes an existing tag from the buffer.
      *
@@ -172,18 +191,26 @@ public:
      */
     void prune_tags(uint64_t max_time);
 
-    std::multimap<uint64_t, tag_t>::iterator get_tags_begin()
+    /*!
+     * \brief  Returns a view of the tags with offsets in [\p start, \p end).
+     *
+     * Nothing is copied; the caller must hold mutex() for as long as it
+     * uses the view.
+     */
+    tag_ring::view get_tags_in_range(uint64_t start, uint64_t end) const
     {
-        return d_item_tags.begin();
+        return d_item_tags.range(start, end);
     }
-    std::multimap<uint64_t, tag_t>::iterator get_tags_end() { return d_item_tags.end(); }
-    std::multimap<uint64_t, tag_t>::iterator get_tags_lower_bound(uint64_t x)
+
+    tag_ring::const_iterator get_tags_begin() const { return d_item_tags.begin(); }
+    tag_ring::const_iterator get_tags_end() const { return d_item_tags.end(); }
+    tag_ring::const_iterator get_tags_lower_bound(uint64_t x) const
     {
-        return d_item_tags.lower_bound(x);
+        return d_item_tags.begin() + d_item_tags.lower_bound(x);
     }
-    std::multimap<uint64_t, tag_t>::iterator get_tags_upper_bound(uint64_t x)
+    tag_ring::const_iterator get_tags_upper_bound(uint64_t x) const
     {
-        return d_item_tags.upper_bound(x);
+        return d_item_tags.begin() + d_item_tags.upper_bound(x);
     }
 
     /*!
@@ -318,7 +345,7 @@ protected:
     unsigned int d_write_index;  // in items [0,d_bufsize)
     uint64_t d_abs_write_offset; // num items written since the start
     bool d_done;
-    std::multimap<uint64_t, tag_t> d_item_tags;
+    tag_ring d_item_tags;
     uint64_t d_last_min_items_read;
     //
     gr::thread::condition_variable d_cv;
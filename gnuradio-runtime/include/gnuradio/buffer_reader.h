@@ -139,6 +139,21 @@ public:
                            uint64_t abs_end,
                            long id);
 
+    /*!
+     * \brief Given a [start,end), returns a view of the tags in the range.
+     *
+     * Unlike get_tags_in_range(), nothing is copied or filtered: the view
+     * refers to the tags as the writer stored them, so their offsets do
+     * not include this reader's sample_delay() and tags that a block has
+     * removed with remove_item_tag() are still present (see
+     * tag_t::marked_deleted). The caller must hold mutex() while it
+     * uses the view.
+     *
+     * \param abs_start    a uint64 count of the start of the range of interest
+     * \param abs_end      a uint64 count of the end of the range of interest
+     */
+    tag_ring::view tags_in_range(uint64_t abs_start, uint64_t abs_end) const;
+
     /*!
      * \brief Returns true when the current thread is ready to call the callback,
      * false otherwise. Delegate calls to buffer class's input_blkd_cb_ready().
@@ -231,7 +231,7 @@ public:
         if (pmt::list_has(hier_message_ports_in, port_id))
             throw std::invalid_argument(
                 "hier msg in port by this name already registered");
-        if (msg_queue.find(port_id) != msg_queue.end())
+        if (msg_port_index(port_id) >= 0)
             throw std::invalid_argument(
                 "block already has a primitive input port by this name");
         hier_message_ports_in = pmt::list_add(hier_message_ports_in, port_id);
@@ -0,0 +1,161 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_MSG_PORT_QUEUE_H
+#define INCLUDED_GR_MSG_PORT_QUEUE_H
+
+#include <gnuradio/api.h>
+#include <gnuradio/thread/thread.h>
+#include <pmt/pmt.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+namespace gr {
+
+/*!
+ * \brief Bounded queue of the messages posted to one input message port.
+ * \ingroup internal
+ *
+ * A power-of-two ring of slots, each with a sequence number that says
+ * whether it holds a message and for which lap of the ring. Any number
+ * of threads push() without taking a lock: a producer claims a slot
+ * with one compare-and-swap on the tail, moves the message in and
+ * publishes it by storing the slot's sequence number. The block's
+ * thread pops runs of published messages at once with pop(), claiming
+ * them with one compare-and-swap on the head.
+ *
+ * The ring starts with a few slots and grows toward the capacity only
+ * when messages back up: a producer that finds it full appends to a
+ * spill list under a mutex, and so do all producers until the consumer
+ * has emptied the ring, moved the spilled messages into a larger one
+ * and made the ring lock-free again.
+ *
+ * What a push into a full queue does is the port's overflow policy:
+ * drop the oldest queued message, block until the consumer made room,
+ * or drop the new message. Dropped messages are counted.
+ */
+class GR_RUNTIME_API msg_port_queue
+{
+public:
+    enum overflow_t {
+        OVERFLOW_DROP_OLDEST, //< discard the oldest queued message
+        OVERFLOW_BLOCK,       //< wait until the consumer pops a message; not
+                              //< for ports the block posts to itself
+        OVERFLOW_COUNT,       //< discard the new message
+    };
+
+    /*!
+     * \param port the port's name
+     * \param capacity the number of messages the queue holds, rounded up
+     *        to a power of two
+     * \param policy what push() does when the queue is full
+     */
+    msg_port_queue(pmt::pmt_t port, size_t capacity, overflow_t policy);
+    ~msg_port_queue();
+    msg_port_queue(const msg_port_queue&) = delete;
+    msg_port_queue& operator=(const msg_port_queue&) = delete;
+
+    const pmt::pmt_t& port() const { return d_port; }
+    size_t capacity() const { return d_capacity; }
+    overflow_t policy() const { return d_policy; }
+
+    //! Slots of the ring allocated so far; at most capacity()
+    size_t slots() const { return d_mask + 1; }
+
+    /*!
+     * \brief Change the capacity and the overflow policy.
+     *
+     * Keeps the queued messages, as many as fit. Only while no other
+     * thread uses the queue, i.e. before the flowgraph starts.
+     */
+    void configure(size_t capacity, overflow_t policy);
+
+    /*!
+     * \brief Queue \p msg. Safe to call from any number of threads.
+     *
+     * \return false if \p msg was dropped (OVERFLOW_COUNT on a full queue)
+     */
+    bool push(const pmt::pmt_t& msg);
+
+    /*!
+     * \brief Move up to \p max of the oldest messages to \p msgs.
+     *
+     * Meant for the block's thread. Messages posted while a pop is
+     * under way may or may not be part of it.
+     *
+     * \return the number of messages popped
+     */
+    size_t pop(pmt::pmt_t* msgs, size_t max);
+
+    //! The oldest message, or a null pmt_t if the queue is empty
+    pmt::pmt_t pop();
+
+    //! Number of queued messages; a snapshot while producers are active.
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    //! Messages dropped by the overflow policy so far
+    uint64_t dropped() const { return d_dropped.load(std::memory_order_relaxed); }
+
+    //! For the consumer: messages dropped since the last call
+    uint64_t take_dropped()
+    {
+        const uint64_t dropped = this->dropped();
+        const uint64_t n = dropped - d_dropped_taken;
+        d_dropped_taken = dropped;
+        return n;
+    }
+
+private:
+    struct slot {
+        std::atomic<uint64_t> seq;
+        pmt::pmt_t msg;
+    };
+
+    void allocate(size_t slots);
+    bool try_push(const pmt::pmt_t& msg);
+    bool push_locked(const pmt::pmt_t& msg);
+    size_t pop_ring(pmt::pmt_t* msgs, size_t max);
+    size_t ring_size() const;
+    bool tail_free() const;
+    bool can_spill() const;
+    void unspill();
+    void wait_for_room(gr::thread::scoped_lock& lock);
+    void wake_producers();
+
+    const pmt::pmt_t d_port;
+    overflow_t d_policy;
+    uint64_t d_capacity;
+    std::unique_ptr<slot[]> d_slots;
+    uint64_t d_mask;
+
+    // Producers and the consumer each work their own end of the ring.
+    // d_pushing counts the producers on the lock-free path.
+    alignas(64) std::atomic<uint64_t> d_tail;
+    std::atomic<int> d_pushing;
+    alignas(64) std::atomic<uint64_t> d_head;
+    std::atomic<uint64_t> d_dropped;
+    uint64_t d_dropped_taken; // owned by the consumer
+
+    // Taken by producers that find the ring full and by the consumer to
+    // drain d_spill or to wake producers that wait for room.
+    std::atomic<uint64_t> d_nspilled; // size of d_spill
+    std::atomic<int> d_waiting;
+    gr::thread::mutex d_mutex;
+    gr::thread::condition_variable d_room;
+    std::deque<pmt::pmt_t> d_spill;
+};
+
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_MSG_PORT_QUEUE_H */
@@ -0,0 +1,210 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_TAG_RING_H
+#define INCLUDED_GR_TAG_RING_H
+
+#include <gnuradio/api.h>
+#include <gnuradio/tags.h>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace gr {
+
+/*!
+ * \brief Offset-ordered ring of stream tags, as stored by gr::buffer.
+ *
+ * Tags live in one power-of-two array of slots. Tags are nearly always
+ * added in offset order, so add() is an amortized O(1) append at the
+ * tail; an out-of-order tag is moved back to its place, after any tags
+ * with the same offset. Range queries are binary searches, and
+ * prune() drops a whole prefix at once by moving the head. Slots are
+ * reused, so a buffer whose tag rate is steady stops allocating.
+ * Pruned slots hold null PMTs until they are reused.
+ *
+ * Not thread safe; gr::buffer guards its ring with its mutex.
+ */
+class GR_RUNTIME_API tag_ring
+{
+public:
+    //! Random access iterator over the tags, in offset order.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = tag_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const tag_t*;
+        using reference = const tag_t&;
+
+        const_iterator() : d_ring(nullptr), d_index(0) {}
+        const_iterator(const tag_ring* ring, size_t index) : d_ring(ring), d_index(index)
+        {
+        }
+
+        reference operator*() const { return (*d_ring)[d_index]; }
+        pointer operator->() const { return &(*d_ring)[d_index]; }
+        reference operator[](difference_type n) const { return (*d_ring)[d_index + n]; }
+
+        const_iterator& operator++()
+        {
+            ++d_index;
+            return *this;
+        }
+        const_iterator operator++(int) { return const_iterator(d_ring, d_index++); }
+        const_iterator& operator--()
+        {
+            --d_index;
+            return *this;
+        }
+        const_iterator operator--(int) { return const_iterator(d_ring, d_index--); }
+        const_iterator& operator+=(difference_type n)
+        {
+            d_index += n;
+            return *this;
+        }
+        const_iterator& operator-=(difference_type n)
+        {
+            d_index -= n;
+            return *this;
+        }
+        const_iterator operator+(difference_type n) const
+        {
+            return const_iterator(d_ring, d_index + n);
+        }
+        friend const_iterator operator+(difference_type n, const const_iterator& it)
+        {
+            return it + n;
+        }
+        const_iterator operator-(difference_type n) const
+        {
+            return const_iterator(d_ring, d_index - n);
+        }
+        difference_type operator-(const const_iterator& rhs) const
+        {
+            return static_cast<difference_type>(d_index) -
+                   static_cast<difference_type>(rhs.d_index);
+        }
+
+        bool operator==(const const_iterator& rhs) const
+        {
+            return d_index == rhs.d_index;
+        }
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return d_index != rhs.d_index;
+        }
+        bool operator<(const const_iterator& rhs) const { return d_index < rhs.d_index; }
+        bool operator>(const const_iterator& rhs) const { return d_index > rhs.d_index; }
+        bool operator<=(const const_iterator& rhs) const
+        {
+            return d_index <= rhs.d_index;
+        }
+        bool operator>=(const const_iterator& rhs) const
+        {
+            return d_index >= rhs.d_index;
+        }
+
+        //! position counted from the oldest tag in the ring
+        size_t index() const { return d_index; }
+
+    private:
+        const tag_ring* d_ring;
+        size_t d_index;
+    };
+
+    /*!
+     * \brief Non-owning view of a run of consecutive tags.
+     *
+     * Copies nothing; it is only valid until the ring is next modified,
+     * i.e. for as long as the owning buffer's mutex is held.
+     */
+    class view
+    {
+    public:
+        view() = default;
+        view(const_iterator begin, const_iterator end) : d_begin(begin), d_end(end) {}
+
+        const_iterator begin() const { return d_begin; }
+        const_iterator end() const { return d_end; }
+        size_t size() const { return d_end - d_begin; }
+        bool empty() const { return d_begin == d_end; }
+        const tag_t& operator[](size_t i) const { return d_begin[i]; }
+
+    private:
+        const_iterator d_begin;
+        const_iterator d_end;
+    };
+
+    tag_ring();
+
+    size_t size() const { return d_size; }
+    bool empty() const { return d_size == 0; }
+    size_t capacity() const { return d_slots.size(); }
+
+    //! The \p i th oldest tag; \p i must be less than size().
+    const tag_t& operator[](size_t i) const { return d_slots[(d_head + i) & d_mask]; }
+    tag_t& operator[](size_t i) { return d_slots[(d_head + i) & d_mask]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, d_size); }
+
+    //! Index of the first tag with an offset not less than \p offset
+    size_t lower_bound(uint64_t offset) const;
+
+    //! Index of the first tag with an offset greater than \p offset
+    size_t upper_bound(uint64_t offset) const;
+
+    //! All tags with offsets in [\p start, \p end)
+    view range(uint64_t start, uint64_t end) const;
+
+    //! Insert \p tag after all tags with an offset not greater than its own.
+    void add(const tag_t& tag);
+
+    /*!
+     * \brief Like add(), but takes over the PMTs of \p tag.
+     *
+     * Saves the reference count updates of a copy when the caller is
+     * done with \p tag: its key, value and srcid are swapped for the
+     * unused ones of the slot it goes into.
+     */
+    void take(tag_t& tag);
+
+    //! Make room for \p n tags in all, so that adding them does not allocate.
+    void reserve(size_t n);
+
+    /*!
+     * \brief Drop all tags with an offset less than \p offset.
+     *
+     * The slots are reset so that the tags' PMTs are released right away.
+     *
+     * \return the number of tags dropped
+     */
+    size_t prune(uint64_t offset);
+
+    void clear();
+
+private:
+    std::vector<tag_t> d_slots;
+    size_t d_mask;
+    size_t d_head;
+    size_t d_size;
+
+    tag_t& push_back();
+    void sort_back();
+    void drop_front(size_t n);
+    void grow(size_t min_capacity);
+};
+
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_TAG_RING_H */
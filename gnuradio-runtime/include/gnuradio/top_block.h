@@ -128,6 +128,20 @@ public:
     //! Set the maximum number of noutput_items in the flowgraph
     void set_max_noutput_items(int nmax);
 
+    /*!
+     * Select the scheduler that runs this flowgraph the next time it
+     * is started or reconfigured: "TPB" (thread-per-block, the
+     * default) or "WS" (a fixed pool of work-stealing worker
+     * threads). An empty name falls back to the GR_SCHEDULER
+     * environment variable.
+     *
+     * \throws std::invalid_argument if \p name is not a known scheduler
+     */
+    void set_scheduler(const std::string& name);
+
+    //! Get the scheduler selected with set_scheduler(); empty if none
+    std::string scheduler_name();
+
     top_block_sptr to_top_block(); // Needed for Python type coercion
 
     void setup_rpc() override;
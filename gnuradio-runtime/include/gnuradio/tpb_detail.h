@@ -14,24 +14,47 @@
 #include <gnuradio/api.h>
 #include <gnuradio/thread/thread.h>
 #include <pmt/pmt.h>
+#include <atomic>
 #include <deque>
+#include <functional>
 
 namespace gr {
 
 class block_detail;
 
 /*!
- * \brief used by thread-per-block scheduler
+ * \brief used by thread-per-block and work-stealing schedulers
+ *
+ * Readiness is published with a single atomic store to input_changed
+ * or output_changed. The mutex and condition variable are only used
+ * to park our thread in wait_input()/wait_output(), and a notifier
+ * only touches them when it sees that we are actually parked, or to
+ * call the wakeup hook if a scheduler installed one.
  */
 struct GR_RUNTIME_API tpb_detail {
-    gr::thread::mutex mutex; //< protects all vars
-    bool input_changed;
-    gr::thread::condition_variable input_cond;
-    bool output_changed;
-    gr::thread::condition_variable output_cond;
+    std::atomic<bool> input_changed;
+    std::atomic<bool> output_changed;
+    std::atomic<int> parked; //< what our thread waits for on cond, if anything
+    gr::thread::mutex mutex; //< only taken to park and to wake us
+    gr::thread::condition_variable cond;
 
 public:
-    tpb_detail() : input_changed(false), output_changed(false) {}
+    enum { NOT_PARKED = 0, PARKED_INPUT = 1, PARKED_OUTPUT = 2 };
+
+    tpb_detail()
+        : input_changed(false),
+          output_changed(false),
+          parked(NOT_PARKED),
+          has_wakeup(false)
+    {
+    }
+
+    //! Install an optional hook for schedulers that run blocks as
+    //! tasks rather than threads, or remove it with nullptr. The hook
+    //! is called whenever our input, output or message state changes,
+    //! with our mutex held, so once the hook is removed it is neither
+    //! running nor called again, even by message posters.
+    void set_wakeup(std::function<void()> hook);
 
     //! Called by us to tell all our upstream blocks that their output
     //! may have changed.
@@ -47,36 +70,59 @@ public:
     //! Called by pmt msg posters
     void notify_msg()
     {
-        gr::thread::scoped_lock guard(mutex);
-        input_changed = true;
-        input_cond.notify_one();
-        output_changed = true;
-        output_cond.notify_one();
+        input_changed.store(true);
+        output_changed.store(true);
+        wake(PARKED_INPUT | PARKED_OUTPUT);
     }
 
     //! Called by us
     void clear_changed()
     {
-        gr::thread::scoped_lock guard(mutex);
-        input_changed = false;
-        output_changed = false;
+        input_changed.store(false);
+        output_changed.store(false);
     }
 
+    //! Called by us to wait until our input changed, or until \p
+    //! timeout_ms milliseconds passed.
+    void wait_input(unsigned int timeout_ms);
+
+    //! Called by us to wait until our output changed.
+    void wait_output();
+
 private:
+    std::atomic<bool> has_wakeup; //< lets notifiers skip the mutex without a hook
+    std::function<void()> wakeup; //< guarded by mutex
+
     //! Used by notify_downstream
     void set_input_changed()
     {
-        gr::thread::scoped_lock guard(mutex);
-        input_changed = true;
-        input_cond.notify_one();
+        input_changed.store(true);
+        wake(PARKED_INPUT);
     }
 
     //! Used by notify_upstream
     void set_output_changed()
     {
-        gr::thread::scoped_lock guard(mutex);
-        output_changed = true;
-        output_cond.notify_one();
+        output_changed.store(true);
+        wake(PARKED_OUTPUT);
+    }
+
+    //! Wake our thread if, and only if, it is parked waiting for \p what
+    void wake(int what)
+    {
+        // The seq_cst store to the flag above and this load pair up with
+        // the store to parked and the flag load in wait_*(): either we
+        // see the thread parked, or it sees the flag set and does not
+        // go to sleep.
+        if (parked.load() & what) {
+            gr::thread::scoped_lock guard(mutex);
+            cond.notify_one();
+        }
+        if (has_wakeup.load()) {
+            gr::thread::scoped_lock guard(mutex);
+            if (wakeup)
+                wakeup();
+        }
     }
 };
 
@@ -17,6 +17,7 @@
 #include <any>
 #include <complex>
 #include <cstdint>
+#include <functional>
 #include <iosfwd>
 #include <memory>
 #include <stdexcept>
@@ -445,6 +446,15 @@ PMT_API bool is_blob(pmt_t x);
  */
 PMT_API pmt_t make_blob(const void* buf, size_t len);
 
+/*!
+ * \brief Make a blob of the \p len bytes at \p buf, without copying them
+ *
+ * The memory is owned elsewhere and must stay valid and unchanged until
+ * \p release is called, once the last reference to the blob is gone. See
+ * make_u8vector_view.
+ */
+PMT_API pmt_t make_blob_view(const void* buf, size_t len, std::function<void()> release);
+
 //! Return a pointer to the blob's data
 PMT_API const void* blob_data(pmt_t blob);
 
@@ -535,6 +545,37 @@ PMT_API pmt_t init_c32vector(size_t k, const std::vector<std::complex<float>>& d
 PMT_API pmt_t init_c64vector(size_t k, const std::complex<double>* data);
 PMT_API pmt_t init_c64vector(size_t k, const std::vector<std::complex<double>>& data);
 
+/*!
+ * \brief Make uniform vectors of the \p k elements at \p data, without copying them
+ *
+ * The storage is owned elsewhere, e.g. by a buffer pool. It must stay valid until
+ * \p release is called, which happens once the last reference to the vector is
+ * gone, on whichever thread drops it; \p release must not throw. Writing to the
+ * vector writes to the storage.
+ */
+PMT_API pmt_t make_u8vector_view(size_t k, uint8_t* data, std::function<void()> release);
+PMT_API pmt_t make_s8vector_view(size_t k, int8_t* data, std::function<void()> release);
+PMT_API pmt_t make_u16vector_view(size_t k,
+                                  uint16_t* data,
+                                  std::function<void()> release);
+PMT_API pmt_t make_s16vector_view(size_t k, int16_t* data, std::function<void()> release);
+PMT_API pmt_t make_u32vector_view(size_t k,
+                                  uint32_t* data,
+                                  std::function<void()> release);
+PMT_API pmt_t make_s32vector_view(size_t k, int32_t* data, std::function<void()> release);
+PMT_API pmt_t make_u64vector_view(size_t k,
+                                  uint64_t* data,
+                                  std::function<void()> release);
+PMT_API pmt_t make_s64vector_view(size_t k, int64_t* data, std::function<void()> release);
+PMT_API pmt_t make_f32vector_view(size_t k, float* data, std::function<void()> release);
+PMT_API pmt_t make_f64vector_view(size_t k, double* data, std::function<void()> release);
+PMT_API pmt_t make_c32vector_view(size_t k,
+                                  std::complex<float>* data,
+                                  std::function<void()> release);
+PMT_API pmt_t make_c64vector_view(size_t k,
+                                  std::complex<double>* data,
+                                  std::function<void()> release);
+
 PMT_API uint8_t u8vector_ref(pmt_t v, size_t k);
 PMT_API int8_t s8vector_ref(pmt_t v, size_t k);
 PMT_API uint16_t u16vector_ref(pmt_t v, size_t k);
@@ -626,6 +667,13 @@ c64vector_writable_elements(pmt_t v, size_t& len); //< len is in elements
  * This is a functional data structure that is persistent.  Updating a
  * functional data structure does not destroy the existing version, but
  * rather creates a new version that coexists with the old.
+ *
+ * make_dict() starts an association list, which dict_add() extends; its
+ * lookups are linear in the number of keys. dict_builder makes a hashed
+ * dictionary instead, with constant time lookups. The dict functions
+ * accept both, but only an association list is a pair. deserialize() and
+ * dict_from_mapping() return association lists, which existing code walks
+ * with car, cdr and nth.
  * ------------------------------------------------------------------------
  */
 
@@ -639,27 +687,18 @@ PMT_API pmt_t dcons(const pmt_t& x, const pmt_t& y);
 //! Make an empty dictionary
 PMT_API pmt_t make_dict();
 
+//! Return a new dictionary with \p key associated with \p value.
+PMT_API pmt_t dict_add(const pmt_t& dict, const pmt_t& key, const pmt_t& value);
+
 /*!
- * \brief Make a dictionary from an existing mapping type.
- * The constraint for this to work is the ability for the map_t to iterate over [key,
- * value] pairs, that is, to be able to be used in a
+ * \brief Return a new dictionary with \p key associated with \p value.
  *
- * <pre>for(const auto& [key, val] : prototype)</pre>
+ * If \p dict is a hashed dictionary nothing else refers to, it is
+ * updated in place and returned, e.g. in
  *
- * loop.
+ * <pre>d = dict_add(std::move(d), key, value);</pre>
  */
-template <typename map_t>
-pmt_t dict_from_mapping(const map_t& prototype)
-{
-    pmt_t protodict = make_dict();
-    for (const auto& [key, value] : prototype) {
-        protodict = dict_add(protodict, key, value);
-    }
-    return protodict;
-}
-
-//! Return a new dictionary with \p key associated with \p value.
-PMT_API pmt_t dict_add(const pmt_t& dict, const pmt_t& key, const pmt_t& value);
+PMT_API pmt_t dict_add(pmt_t&& dict, const pmt_t& key, const pmt_t& value);
 
 //! Return a new dictionary with \p key removed.
 PMT_API pmt_t dict_delete(const pmt_t& dict, const pmt_t& key);
@@ -682,6 +721,54 @@ PMT_API pmt_t dict_update(const pmt_t& dict1, const pmt_t& dict2);
 //! Return list of values
 PMT_API pmt_t dict_values(pmt_t dict);
 
+/*!
+ * \brief Builds a hashed dictionary in place.
+ *
+ * Adding keys to a builder gives the same dictionary as the equivalent
+ * chain of dict_add() calls, but it is allocated once, with room for the
+ * number of keys the builder was constructed with, and filled in place.
+ *
+ * <pre>
+ * pmt_t meta = dict_builder(2)
+ *                  .add(mp("snr"), from_double(snr))
+ *                  .add(mp("encoding"), from_long(encoding))
+ *                  .build();
+ * </pre>
+ */
+class PMT_API dict_builder
+{
+public:
+    explicit dict_builder(size_t capacity = 0);
+
+    //! Associate \p key with \p value, replacing an earlier value of \p key
+    dict_builder& add(const pmt_t& key, const pmt_t& value);
+
+    //! Hand over the dictionary; the builder is empty afterwards
+    pmt_t build();
+
+private:
+    pmt_t d_dict;
+};
+
+/*!
+ * \brief Make a dictionary from an existing mapping type.
+ * The constraint for this to work is the ability for the map_t to iterate over [key,
+ * value] pairs, that is, to be able to be used in a
+ *
+ * <pre>for(const auto& [key, val] : prototype)</pre>
+ *
+ * loop.
+ */
+template <typename map_t>
+pmt_t dict_from_mapping(const map_t& prototype)
+{
+    pmt_t protodict = make_dict();
+    for (const auto& [key, value] : prototype) {
+        protodict = dict_add(protodict, key, value);
+    }
+    return protodict;
+}
+
 /*
  * ------------------------------------------------------------------------
  *   Any (wraps std::any -- can be used to wrap pretty much anything)
@@ -732,7 +819,14 @@ PMT_API std::shared_ptr<gr::messages::msg_accepter> msg_accepter_ref(const pmt_t
  */
 PMT_API bool is_pdu(const pmt_t& obj);
 
-//! Return true if x and y are the same object; otherwise return false.
+/*!
+ * \brief Return true if x and y are the same object; otherwise return false.
+ *
+ * from_long(), from_uint64() and from_double() return shared objects for
+ * the integral values in [-128, 1023], except -0.0. eq() is therefore
+ * true for two such numbers of the same type and value, and false for
+ * other equal numbers. Compare numbers with eqv().
+ */
 PMT_API bool eq(const pmt_t& x, const pmt_t& y);
 
 /*!
@@ -12,7 +12,9 @@
 
 #include <condition_variable>
 #include <pmt/api.h>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <mutex>
 #include <vector>
 
@@ -21,15 +23,36 @@ namespace pmt {
 /*!
  * \brief very simple thread-safe fixed-size allocation pool
  *
- * FIXME may want to go to global allocation with per-thread free list.
- * This would eliminate virtually all lock contention.
+ * Each thread keeps a small free list of its own, so malloc and free
+ * usually touch no shared state at all. Threads trade free items with
+ * a shared depot in batches, each an atomic exchange on one of the
+ * depot's slots. The mutex is only taken when the depot is empty or
+ * full, to get a new chunk from the underlying allocator, and, if
+ * max_items is set, to count the items in use.
  */
 class PMT_API pmt_pool
 {
+public:
+    //! Counters of a pool. Threads report their mallocs and frees
+    //! whenever they trade a batch with the depot, so these lag a little.
+    struct stats {
+        size_t itemsize;    //!< bytes per item, after alignment
+        uint64_t chunks;    //!< chunks taken from the underlying allocator
+        uint64_t items;     //!< items carved from those chunks
+        uint64_t in_depot;  //!< free items in the depot
+        uint64_t mallocs;   //!< items handed out
+        uint64_t frees;     //!< items given back
+        uint64_t refills;   //!< batches threads took from the depot
+        uint64_t handbacks; //!< batches threads gave back to the depot
+    };
 
+private:
     struct PMT_API item {
-        struct item* d_next;
+        struct item* d_next;  // next free item
+        struct item* d_batch; // in the depot: next batch
     };
+    struct thread_cache;
+    struct thread_caches;
 
     using scoped_lock = std::unique_lock<std::mutex>;
     mutable std::mutex d_mutex;
@@ -39,10 +62,29 @@ class PMT_API pmt_pool
     size_t d_alignment;
     size_t d_allocation_size;
     size_t d_max_items;
-    size_t d_n_items;
-    item* d_freelist;
+    size_t d_batch_size;
+    uint64_t d_serial; // unique over all pools ever made
+    size_t d_slot;     // index of this pool's thread caches
+    size_t d_n_items;  // only counted with max_items
+
+    static const size_t depot_slots = 32;
+    std::atomic<item*> d_depot[depot_slots]; // batches of free items
+    item* d_overflow;                         // more batches, under d_mutex
     std::vector<char*> d_allocations;
 
+    std::atomic<uint64_t> d_chunks;
+    std::atomic<uint64_t> d_items;
+    std::atomic<uint64_t> d_in_depot;
+    std::atomic<uint64_t> d_mallocs;
+    std::atomic<uint64_t> d_frees;
+    std::atomic<uint64_t> d_refills;
+    std::atomic<uint64_t> d_handbacks;
+
+    thread_cache* cache();
+    void refill(thread_cache& c);
+    void hand_back(thread_cache& c, size_t n);
+    void report(thread_cache& c);
+
 public:
     /*!
      * \param itemsize size in bytes of the items to be allocated.
@@ -59,8 +101,15 @@ public:
 
     void* malloc();
     void free(void* p);
+
+    stats get_stats() const;
 };
 
+/*!
+ * \brief Counters of the pools PMTs are allocated from, one per size class
+ */
+PMT_API std::vector<pmt_pool::stats> pool_stats();
+
 } /* namespace pmt */
 
 #endif /* INCLUDED_PMT_POOL_H */
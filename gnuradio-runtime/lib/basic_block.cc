@@ -16,6 +16,9 @@
 #include <gnuradio/basic_block.h>
 #include <gnuradio/block_registry.h>
 #include <gnuradio/logger.h>
+#include <gnuradio/pmt_fmt.h>
+#include <gnuradio/prefs.h>
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 
@@ -24,6 +27,9 @@ namespace gr {
 static long s_next_id = 0;
 static long s_ncurrently_allocated = 0;
 
+// Messages the scheduler pops from a port at once
+static const size_t MSG_BATCH = 64;
+
 long basic_block_ncurrently_allocated() { return s_ncurrently_allocated; }
 
 basic_block::basic_block(const std::string& name,
@@ -78,16 +84,53 @@ void basic_block::message_port_register_in(pmt::pmt_t port_id)
     if (!pmt::is_symbol(port_id)) {
         throw std::runtime_error("message_port_register_in: bad port id");
     }
-    msg_queue[port_id] = msg_queue_t();
+    const size_t capacity =
+        std::max(prefs::singleton()->get_long("DEFAULT", "max_messages", 8192), 1L);
+    auto queue = std::make_unique<msg_port_queue>(
+        port_id, capacity, msg_port_queue::OVERFLOW_DROP_OLDEST);
+
+    // Registering a port again empties it, as it always did.
+    const int index = msg_port_index(port_id);
+    if (index >= 0) {
+        d_msg_ports[index] = std::move(queue);
+    } else {
+        d_msg_ports.push_back(std::move(queue));
+    }
+}
+
+int basic_block::msg_port_index(const pmt::pmt_t& which_port) const
+{
+    // Port ids are interned symbols, so comparing pointers is enough.
+    for (size_t i = 0; i < d_msg_ports.size(); i++) {
+        if (pmt::eq(d_msg_ports[i]->port(), which_port)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+msg_port_queue& basic_block::msg_port(const pmt::pmt_t& which_port)
+{
+    const int index = msg_port_index(which_port);
+    if (index < 0) {
+        throw std::runtime_error("port does not exist!");
+    }
+    return *d_msg_ports[index];
+}
+
+void basic_block::set_msg_port_overflow(pmt::pmt_t which_port,
+                                        msg_port_queue::overflow_t policy,
+                                        size_t capacity)
+{
+    msg_port_queue& queue = msg_port(which_port);
+    queue.configure(capacity ? capacity : queue.capacity(), policy);
 }
 
 pmt::pmt_t basic_block::message_ports_in()
 {
-    pmt::pmt_t port_names = pmt::make_vector(msg_queue.size(), pmt::PMT_NIL);
-    msg_queue_map_itr itr = msg_queue.begin();
-    for (size_t i = 0; i < msg_queue.size(); i++) {
-        pmt::vector_set(port_names, i, (*itr).first);
-        itr++;
+    pmt::pmt_t port_names = pmt::make_vector(d_msg_ports.size(), pmt::PMT_NIL);
+    for (size_t i = 0; i < d_msg_ports.size(); i++) {
+        pmt::vector_set(port_names, i, d_msg_ports[i]->port());
     }
     return port_names;
 }
@@ -102,6 +145,17 @@ void basic_block::message_port_register_out(pmt::pmt_t port_id)
         throw std::runtime_error("message_port_register_out: port already in use");
     }
     d_message_subscribers = pmt::dict_add(d_message_subscribers, port_id, pmt::PMT_NIL);
+    d_msg_out_ports.push_back(msg_out_port{ port_id, {} });
+}
+
+basic_block::msg_out_port* basic_block::find_msg_out_port(const pmt::pmt_t& port_id)
+{
+    for (auto& port : d_msg_out_ports) {
+        if (pmt::eq(port.port, port_id)) {
+            return &port;
+        }
+    }
+    return nullptr;
 }
 
 pmt::pmt_t basic_block::message_ports_out()
@@ -118,22 +172,21 @@ pmt::pmt_t basic_block::message_ports_out()
 //  - publish a message on a message port
 void basic_block::message_port_pub(pmt::pmt_t port_id, pmt::pmt_t msg)
 {
-    if (!pmt::dict_has_key(d_message_subscribers, port_id)) {
+    const msg_out_port* out = find_msg_out_port(port_id);
+    if (!out) {
         throw std::runtime_error("port does not exist");
     }
 
-    pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers, port_id, pmt::PMT_NIL);
     // iterate through subscribers on port
-    while (pmt::is_pair(currlist)) {
-        pmt::pmt_t target = pmt::car(currlist);
-
-        pmt::pmt_t block = pmt::car(target);
-        pmt::pmt_t port = pmt::cdr(target);
-
-        currlist = pmt::cdr(currlist);
-        basic_block_sptr blk = global_block_registry.block_lookup(block);
-        // blk->post(msg);
-        blk->post(port, msg);
+    for (const auto& target : out->targets) {
+        basic_block_sptr blk = target.block.lock();
+        if (blk && target.port >= 0) {
+            blk->post_to(target.port, msg);
+        } else {
+            // Not resolved when it subscribed; look it up as we go.
+            blk = global_block_registry.block_lookup(pmt::car(target.target));
+            blk->post(pmt::cdr(target.target), msg);
+        }
     }
 }
 
@@ -149,9 +202,22 @@ void basic_block::message_port_sub(pmt::pmt_t port_id, pmt::pmt_t target)
     pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers, port_id, pmt::PMT_NIL);
 
     // ignore re-adds of the same target
-    if (!pmt::list_has(currlist, target))
-        d_message_subscribers = pmt::dict_add(
-            d_message_subscribers, port_id, pmt::list_add(currlist, target));
+    if (pmt::list_has(currlist, target))
+        return;
+    d_message_subscribers =
+        pmt::dict_add(d_message_subscribers, port_id, pmt::list_add(currlist, target));
+
+    // Resolve the target block and port now rather than for each
+    // message. A block that does not exist yet, or is not owned by a
+    // shared pointer, is looked up when publishing, as before.
+    msg_target resolved{ target, {}, -1 };
+    try {
+        basic_block_sptr blk = global_block_registry.block_lookup(pmt::car(target));
+        resolved.port = blk->msg_port_index(pmt::cdr(target));
+        resolved.block = blk;
+    } catch (const std::exception&) {
+    }
+    find_msg_out_port(port_id)->targets.push_back(resolved);
 }
 
 void basic_block::message_port_unsub(pmt::pmt_t port_id, pmt::pmt_t target)
@@ -167,6 +233,14 @@ void basic_block::message_port_unsub(pmt::pmt_t port_id, pmt::pmt_t target)
     pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers, port_id, pmt::PMT_NIL);
     d_message_subscribers =
         pmt::dict_add(d_message_subscribers, port_id, pmt::list_rm(currlist, target));
+
+    std::vector<msg_target>& targets = find_msg_out_port(port_id)->targets;
+    targets.erase(std::remove_if(targets.begin(),
+                                 targets.end(),
+                                 [&target](const msg_target& t) {
+                                     return pmt::equal(t.target, target);
+                                 }),
+                  targets.end());
 }
 
 void basic_block::_post(pmt::pmt_t which_port, pmt::pmt_t msg)
@@ -176,32 +250,53 @@ void basic_block::_post(pmt::pmt_t which_port, pmt::pmt_t msg)
 
 void basic_block::insert_tail(pmt::pmt_t which_port, pmt::pmt_t msg)
 {
-    gr::thread::scoped_lock guard(mutex);
-    const auto& queue = msg_queue.find(which_port);
-    if (queue == msg_queue.end()) {
+    const int index = msg_port_index(which_port);
+    if (index < 0) {
         d_logger->error("attempted insertion on invalid queue {:s}",
                         pmt::symbol_to_string(which_port));
         throw std::runtime_error("attempted to insert_tail on invalid queue!");
     }
+    post_to(index, msg);
+}
 
-    queue->second.push_back(msg);
+void basic_block::post_to(int port, const pmt::pmt_t& msg)
+{
+    d_msg_ports[port]->push(msg);
 
     // wake up thread if BLKD_IN or BLKD_OUT
-    global_block_registry.notify_blk(d_symbol_name);
+    notify_msg();
 }
 
+void basic_block::notify_msg() { global_block_registry.notify_blk(d_symbol_name); }
+
 pmt::pmt_t basic_block::delete_head_nowait(pmt::pmt_t which_port)
 {
-    gr::thread::scoped_lock guard(mutex);
+    return msg_port(which_port).pop();
+}
 
-    if (empty_p(which_port)) {
-        return pmt::pmt_t();
+void basic_block::dispatch_msgs()
+{
+    pmt::pmt_t msgs[MSG_BATCH];
+    for (const auto& queue : d_msg_ports) {
+        const uint64_t dropped = queue->take_dropped();
+        if (dropped) {
+            d_logger->warn(
+                "message port {} was full; {} message(s) discarded", queue->port(), dropped);
+        }
+
+        // Check if we have a message handler attached before getting
+        // any messages. This is mostly a protection for the unknown
+        // startup sequence of the threads.
+        if (queue->empty() || !has_msg_handler(queue->port())) {
+            continue;
+        }
+        size_t n;
+        while ((n = queue->pop(msgs, MSG_BATCH)) > 0) {
+            for (size_t i = 0; i < n; i++) {
+                dispatch_msg(queue->port(), std::move(msgs[i]));
+            }
+        }
     }
-
-    pmt::pmt_t m(msg_queue[which_port].front());
-    msg_queue[which_port].pop_front();
-
-    return m;
 }
 
 pmt::pmt_t basic_block::message_subscribers(pmt::pmt_t port)
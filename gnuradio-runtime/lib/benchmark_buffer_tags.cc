@@ -0,0 +1,223 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/* ensure that tweakme.h is included before the bundled spdlog/fmt header, see
+ * https://github.com/gabime/spdlog/issues/2922 */
+#include <spdlog/tweakme.h>
+
+#include <gnuradio/buffer.h>
+#include <gnuradio/buffer_double_mapped.h>
+#include <gnuradio/buffer_reader.h>
+#include <gnuradio/thread/thread.h>
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tag throughput of a buffer: a writer adds tags for each chunk of
+// items, a reader collects the tags of the chunk it consumes, and tags
+// behind the reader are pruned, the same sequence of calls that
+// block_executor makes. The multimap tag store that gr::buffer used
+// before the tag ring is replicated below for comparison.
+
+constexpr int chunk = 1024; // items per work call
+constexpr uint64_t ntags = 4'000'000;
+constexpr int buffer_items = 16 * 1024;
+
+// The tag store as buffer/buffer_reader implemented it with a multimap.
+struct legacy_tag_store {
+    gr::thread::mutex mutex;
+    std::multimap<uint64_t, gr::tag_t> tags;
+
+    void add_item_tag(const gr::tag_t& tag)
+    {
+        gr::thread::scoped_lock guard(mutex);
+        tags.insert(std::pair<uint64_t, gr::tag_t>(tag.offset, tag));
+    }
+
+    void get_tags_in_range(std::vector<gr::tag_t>& v,
+                           uint64_t abs_start,
+                           uint64_t abs_end,
+                           long id)
+    {
+        gr::thread::scoped_lock guard(mutex);
+        v.clear();
+        auto itr = tags.lower_bound(abs_start);
+        auto itr_end = tags.upper_bound(abs_end);
+        for (; itr != itr_end; itr++) {
+            if (itr->second.offset >= abs_start && itr->second.offset < abs_end &&
+                std::find(itr->second.marked_deleted.begin(),
+                          itr->second.marked_deleted.end(),
+                          id) == itr->second.marked_deleted.end()) {
+                v.push_back(itr->second);
+            }
+        }
+    }
+
+    void prune_tags(uint64_t max_time)
+    {
+        gr::thread::scoped_lock guard(mutex);
+        auto itr = tags.begin();
+        while (itr != tags.end() && itr->second.offset + buffer_items < max_time) {
+            itr = tags.erase(itr);
+        }
+    }
+};
+
+struct ring_tag_store {
+    gr::buffer_sptr buf;
+    gr::buffer_reader_sptr reader;
+
+    ring_tag_store()
+        : buf(gr::buffer_double_mapped::make_buffer(
+              buffer_items, sizeof(float), buffer_items, 1, gr::block_sptr())),
+          reader(gr::buffer_add_reader(buf, 0, gr::block_sptr()))
+    {
+    }
+
+    void add_item_tag(const gr::tag_t& tag) { buf->add_item_tag(tag); }
+
+    void get_tags_in_range(std::vector<gr::tag_t>& v,
+                           uint64_t abs_start,
+                           uint64_t abs_end,
+                           long id)
+    {
+        reader->get_tags_in_range(v, abs_start, abs_end, id);
+    }
+
+    void prune_tags(uint64_t max_time)
+    {
+        gr::thread::scoped_lock guard(*buf->mutex());
+        buf->prune_tags(max_time);
+    }
+};
+
+// Like ring_tag_store, but the reader walks the tags in place.
+struct ring_view_tag_store : ring_tag_store {
+    void get_tags_in_range(std::vector<gr::tag_t>& v,
+                           uint64_t abs_start,
+                           uint64_t abs_end,
+                           long id)
+    {
+        gr::thread::scoped_lock guard(*reader->mutex());
+        uint64_t n = 0;
+        for (const auto& tag : reader->tags_in_range(abs_start, abs_end)) {
+            n += tag.offset;
+        }
+        sink += n;
+    }
+
+    std::atomic<uint64_t> sink{ 0 };
+};
+
+static gr::tag_t make_tag(uint64_t offset)
+{
+    static const pmt::pmt_t key = pmt::mp("wifi_start");
+    static const pmt::pmt_t value = pmt::from_double(0.5);
+    gr::tag_t tag;
+    tag.offset = offset;
+    tag.key = key;
+    tag.value = value;
+    return tag;
+}
+
+// Writer and reader in one thread, one work call after the other.
+template <typename store_t>
+static double serial_ns_per_tag(int tags_per_chunk)
+{
+    store_t store;
+    std::vector<gr::tag_t> v;
+    const uint64_t nchunks = ntags / tags_per_chunk;
+    const int spacing = chunk / tags_per_chunk;
+
+    auto before = std::chrono::steady_clock::now();
+    for (uint64_t c = 0; c < nchunks; c++) {
+        const uint64_t start = c * chunk;
+        for (int i = 0; i < tags_per_chunk; i++) {
+            store.add_item_tag(make_tag(start + i * spacing));
+        }
+        store.get_tags_in_range(v, start, start + chunk, 1);
+        store.prune_tags(start + chunk);
+    }
+    auto after = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(after - before).count() /
+           (nchunks * tags_per_chunk);
+}
+
+// Writer and reader on two threads, contending for the buffer lock.
+template <typename store_t>
+static double threaded_ns_per_tag(int tags_per_chunk)
+{
+    store_t store;
+    const uint64_t nchunks = ntags / tags_per_chunk;
+    const int spacing = chunk / tags_per_chunk;
+    std::atomic<uint64_t> written{ 0 };
+
+    auto before = std::chrono::steady_clock::now();
+    std::thread writer([&]() {
+        for (uint64_t c = 0; c < nchunks; c++) {
+            // stay within a buffer of the reader, like a real writer
+            while (c > written.load() + buffer_items / chunk) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < tags_per_chunk; i++) {
+                store.add_item_tag(make_tag(c * chunk + i * spacing));
+            }
+        }
+    });
+
+    std::vector<gr::tag_t> v;
+    for (uint64_t c = 0; c < nchunks; c++) {
+        const uint64_t start = c * chunk;
+        store.get_tags_in_range(v, start, start + chunk, 1);
+        store.prune_tags(start + chunk);
+        written.store(c);
+    }
+    writer.join();
+    auto after = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(after - before).count() /
+           (nchunks * tags_per_chunk);
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> lines;
+    for (int tags_per_chunk : { 1, 8, 64 }) {
+        auto row = [&](const char* store, double ns) {
+            lines.emplace_back(
+                fmt::format(FMT_STRING("{:>2} tags/work  {:<20} {:>8.2f} ns/tag"),
+                            tags_per_chunk,
+                            store,
+                            ns));
+        };
+        row("multimap", serial_ns_per_tag<legacy_tag_store>(tags_per_chunk));
+        row("ring", serial_ns_per_tag<ring_tag_store>(tags_per_chunk));
+        row("ring, view", serial_ns_per_tag<ring_view_tag_store>(tags_per_chunk));
+        row("multimap, 2 threads", threaded_ns_per_tag<legacy_tag_store>(tags_per_chunk));
+        row("ring, 2 threads", threaded_ns_per_tag<ring_tag_store>(tags_per_chunk));
+    }
+
+    size_t maxlen = 0;
+    for (const auto& line : lines) {
+        maxlen = std::max(line.size(), maxlen);
+    }
+    fmt::print("+{1:—^{0}}+\n", maxlen + 2, "");
+    for (const auto& line : lines) {
+        fmt::print("|{1:^{0}}|\n", maxlen + 2, line);
+    }
+    fmt::print("+{1:—^{0}}+\n", maxlen + 2, "");
+}
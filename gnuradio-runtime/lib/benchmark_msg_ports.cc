@@ -0,0 +1,160 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/* ensure that tweakme.h is included before the bundled spdlog/fmt header, see
+ * https://github.com/gabime/spdlog/issues/2922 */
+#include <spdlog/tweakme.h>
+
+#include <gnuradio/msg_port_queue.h>
+#include <gnuradio/thread/thread.h>
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Message throughput of an input message port: producer threads post
+// small messages, as message_port_pub does for each subscriber, and one
+// consumer drains them, as the scheduler does for the block's thread.
+// The map of deques behind one block-wide mutex that basic_block used
+// before the port queues is replicated below for comparison.
+
+constexpr uint64_t nmsgs = 4'000'000;
+constexpr size_t capacity = 8192;
+
+// The port store as basic_block implemented it.
+struct legacy_msg_store {
+    gr::thread::mutex mutex;
+    std::map<pmt::pmt_t, std::deque<pmt::pmt_t>, pmt::comparator> queues;
+    const pmt::pmt_t port = pmt::mp("in");
+
+    legacy_msg_store()
+    {
+        queues[pmt::mp("system")];
+        queues[port];
+    }
+
+    void push(const pmt::pmt_t& msg)
+    {
+        gr::thread::scoped_lock guard(mutex);
+        queues.find(port)->second.push_back(msg);
+    }
+
+    size_t drain()
+    {
+        size_t n = 0;
+        for (const auto& i : queues) {
+            for (;;) {
+                pmt::pmt_t msg;
+                {
+                    gr::thread::scoped_lock guard(mutex);
+                    auto& q = queues[i.first];
+                    if (q.empty()) {
+                        break;
+                    }
+                    msg = q.front();
+                    q.pop_front();
+                }
+                n++;
+            }
+        }
+        return n;
+    }
+};
+
+struct ring_msg_store {
+    gr::msg_port_queue system{ pmt::mp("system"),
+                               capacity,
+                               gr::msg_port_queue::OVERFLOW_DROP_OLDEST };
+    gr::msg_port_queue queue{ pmt::mp("in"), capacity, gr::msg_port_queue::OVERFLOW_BLOCK };
+
+    void push(const pmt::pmt_t& msg) { queue.push(msg); }
+
+    size_t drain()
+    {
+        pmt::pmt_t msgs[64];
+        size_t n = 0;
+        for (auto* q : { &system, &queue }) {
+            size_t k;
+            while ((k = q->pop(msgs, 64)) > 0) {
+                for (size_t i = 0; i < k; i++) {
+                    msgs[i].reset();
+                }
+                n += k;
+            }
+        }
+        return n;
+    }
+};
+
+template <typename store_t>
+static double ns_per_msg(int nproducers)
+{
+    store_t store;
+    const pmt::pmt_t msg = pmt::cons(pmt::PMT_NIL, pmt::from_long(42));
+    const uint64_t per_producer = nmsgs / nproducers;
+
+    auto before = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < nproducers; p++) {
+        producers.emplace_back([&]() {
+            for (uint64_t i = 0; i < per_producer; i++) {
+                store.push(msg);
+            }
+        });
+    }
+
+    uint64_t received = 0;
+    while (received < per_producer * nproducers) {
+        const size_t n = store.drain();
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+        received += n;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    auto after = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(after - before).count() /
+           (per_producer * nproducers);
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> lines;
+    for (int nproducers : { 1, 2, 4 }) {
+        auto row = [&](const char* store, double ns) {
+            lines.emplace_back(
+                fmt::format(FMT_STRING("{} producer(s)  {:<14} {:>8.2f} ns/msg"),
+                            nproducers,
+                            store,
+                            ns));
+        };
+        row("map + mutex", ns_per_msg<legacy_msg_store>(nproducers));
+        row("port queue", ns_per_msg<ring_msg_store>(nproducers));
+    }
+
+    size_t maxlen = 0;
+    for (const auto& line : lines) {
+        maxlen = std::max(line.size(), maxlen);
+    }
+    fmt::print("+{1:—^{0}}+\n", maxlen + 2, "");
+    for (const auto& line : lines) {
+        fmt::print("|{1:^{0}}|\n", maxlen + 2, line);
+    }
+    fmt::print("+{1:—^{0}}+\n", maxlen + 2, "");
+}
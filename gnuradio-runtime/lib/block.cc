@@ -762,13 +762,23 @@ void block::system_handler(pmt::pmt_t msg)
     pmt::pmt_t op = pmt::car(msg);
     if (pmt::eqv(op, d_pmt_done)) {
         d_finished = pmt::to_long(pmt::cdr(msg));
-        global_block_registry.notify_blk(d_symbol_name);
+        notify_msg();
     } else {
         d_logger->warn("bad message op on system port!");
         pmt::print(msg);
     }
 }
 
+void block::notify_msg()
+{
+    block_detail_sptr detail = d_detail;
+    // not having block detail is not necessarily a problem; this will happen when
+    // publishing a message to a block that exists but has not yet been started
+    if (detail) {
+        detail->d_tpb.notify_msg();
+    }
+}
+
 void block::set_log_level(const std::string& level) { d_logger->set_level(level); }
 
 std::string block::log_level()
@@ -17,6 +17,7 @@
 #include <gnuradio/custom_lock.h>
 #include <gnuradio/prefs.h>
 #include <block_executor.h>
+#include <algorithm>
 #include <limits>
 #include <sstream>
 
@@ -108,6 +109,68 @@ static int min_available_space(block* m,
     return min_space;
 }
 
+//
+// Append the tags in [abs_start, abs_end) on the input read by \p reader
+// that \p block_id has not removed, with offsets as seen by the reader.
+//
+static void append_tags(buffer_reader* reader,
+                        uint64_t abs_start,
+                        uint64_t abs_end,
+                        long block_id,
+                        std::vector<tag_t>& tags)
+{
+    gr::thread::scoped_lock guard(*reader->mutex());
+
+    const auto range = reader->tags_in_range(abs_start, abs_end);
+    if (range.empty()) {
+        return;
+    }
+
+    const uint64_t delay = reader->sample_delay();
+    tags.reserve(tags.size() + range.size());
+    for (const tag_t& tag : range) {
+        if (std::find(tag.marked_deleted.begin(), tag.marked_deleted.end(), block_id) ==
+            tag.marked_deleted.end()) {
+            tags.push_back(tag);
+            tags.back().offset += delay;
+        }
+    }
+}
+
+//
+// Map the offsets of \p tags from input to output item counts.
+//
+static void rescale_offsets(std::vector<tag_t>& tags,
+                            double rrate,
+                            mpq_class& mp_rrate,
+                            bool use_fp_rrate)
+{
+    static const mpq_class one_half(1, 2);
+
+    if (rrate == 1.0) {
+        return;
+    }
+
+    if (use_fp_rrate) {
+        for (auto& tag : tags) {
+            tag.offset = std::llround((double)tag.offset * rrate);
+        }
+    } else {
+        mpz_class offset;
+        for (auto& tag : tags) {
+            mpz_import(offset.get_mpz_t(), 1, 1, sizeof(tag.offset), 0, 0, &tag.offset);
+            offset = offset * mp_rrate + one_half;
+            tag.offset = offset.get_ui();
+        }
+    }
+}
+
+//
+// The tags are gathered into rtags, whose capacity is kept from call to
+// call, rescaled there once, and handed to each downstream buffer in one
+// locked batch. The last (or only) buffer takes the tags' PMTs over
+// instead of copying them.
+//
 static bool propagate_tags(block::tag_propagation_policy_t policy,
                            block_detail* d,
                            const std::vector<uint64_t>& start_nitems_read,
@@ -117,8 +180,6 @@ static bool propagate_tags(block::tag_propagation_policy_t policy,
                            std::vector<tag_t>& rtags,
                            long block_id)
 {
-    static const mpq_class one_half(1, 2);
-
     // Move tags downstream
     // if a sink, we don't need to move downstream
     if (d->sink_p()) {
@@ -131,98 +192,46 @@ static bool propagate_tags(block::tag_propagation_policy_t policy,
         return true;
     case block::TPP_ALL_TO_ALL: {
         // every tag on every input propagates to everyone downstream
-        std::vector<buffer_sptr> out_buf;
-
+        rtags.clear();
         for (int i = 0; i < d->ninputs(); i++) {
-            d->get_tags_in_range(
-                rtags, i, start_nitems_read[i], d->nitems_read(i), block_id);
+            append_tags(d->input(i).get(),
+                        start_nitems_read[i],
+                        d->nitems_read(i),
+                        block_id,
+                        rtags);
+        }
 
-            if (rtags.empty()) {
-                continue;
-            }
+        if (rtags.empty()) {
+            return true;
+        }
 
-            if (out_buf.empty()) {
-                out_buf.reserve(d->noutputs());
-                for (int o = 0; o < d->noutputs(); o++)
-                    out_buf.push_back(d->output(o));
-            }
+        rescale_offsets(rtags, rrate, mp_rrate, use_fp_rrate);
 
-            std::vector<tag_t>::iterator t;
-            if (rrate == 1.0) {
-                for (t = rtags.begin(); t != rtags.end(); t++) {
-                    for (int o = 0; o < d->noutputs(); o++)
-                        out_buf[o]->add_item_tag(*t);
-                }
-            } else if (use_fp_rrate) {
-                for (t = rtags.begin(); t != rtags.end(); t++) {
-                    tag_t new_tag = *t;
-                    new_tag.offset = std::llround((double)new_tag.offset * rrate);
-                    for (int o = 0; o < d->noutputs(); o++)
-                        out_buf[o]->add_item_tag(new_tag);
-                }
-            } else {
-                mpz_class offset;
-                for (t = rtags.begin(); t != rtags.end(); t++) {
-                    tag_t new_tag = *t;
-                    mpz_import(offset.get_mpz_t(),
-                               1,
-                               1,
-                               sizeof(new_tag.offset),
-                               0,
-                               0,
-                               &new_tag.offset);
-                    offset = offset * mp_rrate + one_half;
-                    new_tag.offset = offset.get_ui();
-                    for (int o = 0; o < d->noutputs(); o++)
-                        out_buf[o]->add_item_tag(new_tag);
-                }
-            }
+        const int last = d->noutputs() - 1;
+        for (int o = 0; o < last; o++) {
+            d->output(o)->add_item_tags(rtags);
         }
+        d->output(last)->move_item_tags(rtags);
     } break;
     case block::TPP_ONE_TO_ONE:
         // tags from input i only go to output i
         // this requires d->ninputs() == d->noutputs; this is checked when this
         // type of tag-propagation system is selected in block_detail
         if (d->ninputs() == d->noutputs()) {
-            buffer_sptr out_buf;
-
             for (int i = 0; i < d->ninputs(); i++) {
-                d->get_tags_in_range(
-                    rtags, i, start_nitems_read[i], d->nitems_read(i), block_id);
+                rtags.clear();
+                append_tags(d->input(i).get(),
+                            start_nitems_read[i],
+                            d->nitems_read(i),
+                            block_id,
+                            rtags);
 
                 if (rtags.empty()) {
                     continue;
                 }
 
-                out_buf = d->output(i);
-
-                std::vector<tag_t>::iterator t;
-                if (rrate == 1.0) {
-                    for (t = rtags.begin(); t != rtags.end(); t++) {
-                        out_buf->add_item_tag(*t);
-                    }
-                } else if (use_fp_rrate) {
-                    for (t = rtags.begin(); t != rtags.end(); t++) {
-                        tag_t new_tag = *t;
-                        new_tag.offset = std::llround((double)new_tag.offset * rrate);
-                        out_buf->add_item_tag(new_tag);
-                    }
-                } else {
-                    mpz_class offset;
-                    for (t = rtags.begin(); t != rtags.end(); t++) {
-                        tag_t new_tag = *t;
-                        mpz_import(offset.get_mpz_t(),
-                                   1,
-                                   1,
-                                   sizeof(new_tag.offset),
-                                   0,
-                                   0,
-                                   &new_tag.offset);
-                        offset = offset * mp_rrate + one_half;
-                        new_tag.offset = offset.get_ui();
-                        out_buf->add_item_tag(new_tag);
-                    }
-                }
+                rescale_offsets(rtags, rrate, mp_rrate, use_fp_rrate);
+                d->output(i)->move_item_tags(rtags);
             }
         } else {
             std::ostringstream msg;
@@ -163,18 +163,34 @@ void buffer::drop_reader(buffer_reader* reader)
 void buffer::add_item_tag(const tag_t& tag)
 {
     gr::thread::scoped_lock guard(*mutex());
-    d_item_tags.insert(std::pair<uint64_t, tag_t>(tag.offset, tag));
+    d_item_tags.add(tag);
+}
+
+void buffer::add_item_tags(const std::vector<tag_t>& tags)
+{
+    gr::thread::scoped_lock guard(*mutex());
+    d_item_tags.reserve(d_item_tags.size() + tags.size());
+    for (const auto& tag : tags) {
+        d_item_tags.add(tag);
+    }
+}
+
+void buffer::move_item_tags(std::vector<tag_t>& tags)
+{
+    gr::thread::scoped_lock guard(*mutex());
+    d_item_tags.reserve(d_item_tags.size() + tags.size());
+    for (auto& tag : tags) {
+        d_item_tags.take(tag);
+    }
 }
 
 void buffer::remove_item_tag(const tag_t& tag, long id)
 {
     gr::thread::scoped_lock guard(*mutex());
-    for (std::multimap<uint64_t, tag_t>::iterator it =
-             d_item_tags.lower_bound(tag.offset);
-         it != d_item_tags.upper_bound(tag.offset);
-         ++it) {
-        if ((*it).second == tag) {
-            (*it).second.marked_deleted.push_back(id);
+    const size_t end = d_item_tags.upper_bound(tag.offset);
+    for (size_t i = d_item_tags.lower_bound(tag.offset); i < end; i++) {
+        if (d_item_tags[i] == tag) {
+            d_item_tags[i].marked_deleted.push_back(id);
         }
     }
 }
@@ -191,30 +207,11 @@ void buffer::prune_tags(uint64_t max_time)
            gr::thread::scoped_lock guard(*mutex());
      */
 
-    /*
-      http://www.cplusplus.com/reference/map/multimap/erase/
-      "Iterators, pointers and references referring to elements removed
-      by the function are invalidated. All other iterators, pointers
-      and references keep their validity."
-
-      Store the iterator to be deleted in tmp; increment itr to the
-      next valid iterator, then erase tmp, which now becomes invalid.
-     */
-
-    uint64_t item_time;
-    std::multimap<uint64_t, tag_t>::iterator itr(d_item_tags.begin()), tmp;
-    while (itr != d_item_tags.end()) {
-        item_time = (*itr).second.offset;
-        if (item_time + d_max_reader_delay + bufsize() < max_time) {
-            tmp = itr;
-            itr++;
-            d_item_tags.erase(tmp);
-        } else {
-            // d_item_tags is a map sorted by offset, so when the if
-            // condition above fails, all future tags in the map must also
-            // fail. So just break here.
-            break;
-        }
+    // Keep every tag with item_time + d_max_reader_delay + bufsize() >= max_time.
+    // d_item_tags is sorted by offset, so that is one cut at the front.
+    const uint64_t keep = static_cast<uint64_t>(d_max_reader_delay) + bufsize();
+    if (max_time > keep) {
+        d_item_tags.prune(max_time - keep);
     }
 }
 
@@ -135,44 +135,35 @@ void buffer_reader::update_read_pointer(int nitems)
 #endif
 }
 
-void buffer_reader::get_tags_in_range(std::vector<tag_t>& v,
-                                      uint64_t abs_start,
-                                      uint64_t abs_end,
-                                      long id)
+tag_ring::view buffer_reader::tags_in_range(uint64_t abs_start, uint64_t abs_end) const
 {
-    gr::thread::scoped_lock guard(*mutex());
-
     uint64_t lower_bound = abs_start - d_attr_delay;
     // check for underflow and if so saturate at 0
     if (lower_bound > abs_start)
         lower_bound = 0;
     uint64_t upper_bound = abs_end - d_attr_delay;
-    // check for underflow and if so saturate at 0
+    // check for underflow and if so the range is empty
     if (upper_bound > abs_end)
         upper_bound = 0;
 
+    return d_buffer->get_tags_in_range(lower_bound, upper_bound);
+}
+
+void buffer_reader::get_tags_in_range(std::vector<tag_t>& v,
+                                      uint64_t abs_start,
+                                      uint64_t abs_end,
+                                      long id)
+{
+    gr::thread::scoped_lock guard(*mutex());
+
     v.clear();
-    std::multimap<uint64_t, tag_t>::iterator itr =
-        d_buffer->get_tags_lower_bound(lower_bound);
-    std::multimap<uint64_t, tag_t>::iterator itr_end =
-        d_buffer->get_tags_upper_bound(upper_bound);
-
-    uint64_t item_time;
-    while (itr != itr_end) {
-        item_time = (*itr).second.offset + d_attr_delay;
-        if ((item_time >= abs_start) && (item_time < abs_end)) {
-            std::vector<long>::iterator id_itr;
-            id_itr = std::find(
-                itr->second.marked_deleted.begin(), itr->second.marked_deleted.end(), id);
-            // If id is not in the vector of marked blocks
-            if (id_itr == itr->second.marked_deleted.end()) {
-                tag_t t = (*itr).second;
-                t.offset += d_attr_delay;
-                v.push_back(t);
-                v.back().marked_deleted.clear();
-            }
+    for (const tag_t& tag : tags_in_range(abs_start, abs_end)) {
+        // If id is not in the vector of marked blocks
+        if (std::find(tag.marked_deleted.begin(), tag.marked_deleted.end(), id) ==
+            tag.marked_deleted.end()) {
+            v.push_back(tag);
+            v.back().offset += d_attr_delay;
         }
-        itr++;
     }
 }
 
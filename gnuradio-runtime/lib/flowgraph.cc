@@ -129,12 +129,10 @@ void flowgraph::check_valid_port(const msg_endpoint& e)
         "check_valid_port({}, {})", e.block()->identifier(), pmt::write_string(e.port()));
 
     if (!e.block()->has_msg_port(e.port())) {
-        const gr::basic_block::msg_queue_map_t& msg_map = e.block()->get_msg_map();
+        const pmt::pmt_t ports = e.block()->message_ports_in();
         d_logger->warn("Could not find port {} in:", pmt::write_string(e.port()));
-        for (gr::basic_block::msg_queue_map_t::const_iterator it = msg_map.begin();
-             it != msg_map.end();
-             ++it)
-            d_logger->warn("  {}", pmt::write_string(it->first));
+        for (size_t i = 0; i < pmt::length(ports); i++)
+            d_logger->warn("  {}", pmt::write_string(pmt::vector_ref(ports, i)));
         throw std::invalid_argument("invalid msg port in connect() or disconnect()");
     }
 }
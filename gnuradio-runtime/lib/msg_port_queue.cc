@@ -0,0 +1,310 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/msg_port_queue.h>
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gr {
+
+/*
+ * A slot at ring position pos (pos & d_mask) is free for the producer
+ * of pos while its sequence number is pos, and holds the message of pos
+ * once it is pos + 1. The consumer frees it for the next lap by storing
+ * pos + slots. Positions only grow, so they never wrap in practice.
+ *
+ * While d_spill holds messages, producers queue there under d_mutex, so
+ * that each producer's messages stay in order, and the consumer takes
+ * them once the ring is empty. Only then, with no producer left on the
+ * lock-free path, may it replace the ring.
+ */
+
+namespace {
+
+// A new ring's slots: enough for a few messages, not max_messages of them
+// for every port of every block.
+const size_t INITIAL_SLOTS = 32;
+
+// The sequence numbers need at least two slots to tell a published
+// message from a slot freed for the next lap.
+size_t round_up(size_t capacity)
+{
+    size_t n = 2;
+    while (n < capacity) {
+        n <<= 1;
+    }
+    return n;
+}
+
+struct counter_guard {
+    std::atomic<int>& count;
+    explicit counter_guard(std::atomic<int>& c) : count(c) { count.fetch_add(1); }
+    ~counter_guard() { count.fetch_sub(1); }
+};
+
+} // namespace
+
+msg_port_queue::msg_port_queue(pmt::pmt_t port, size_t capacity, overflow_t policy)
+    : d_port(port),
+      d_policy(policy),
+      d_capacity(round_up(capacity)),
+      d_mask(0),
+      d_tail(0),
+      d_pushing(0),
+      d_head(0),
+      d_dropped(0),
+      d_dropped_taken(0),
+      d_nspilled(0),
+      d_waiting(0)
+{
+    allocate(std::min<size_t>(d_capacity, INITIAL_SLOTS));
+}
+
+msg_port_queue::~msg_port_queue() {}
+
+void msg_port_queue::allocate(size_t slots)
+{
+    d_slots.reset(new slot[slots]);
+    for (size_t i = 0; i < slots; i++) {
+        d_slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    d_mask = slots - 1;
+    d_tail.store(0, std::memory_order_relaxed);
+    d_head.store(0, std::memory_order_relaxed);
+}
+
+void msg_port_queue::configure(size_t capacity, overflow_t policy)
+{
+    std::vector<pmt::pmt_t> queued;
+    pmt::pmt_t msg;
+    while ((msg = pop())) {
+        queued.push_back(std::move(msg));
+    }
+
+    d_capacity = round_up(capacity);
+    d_policy = policy;
+    size_t first = 0;
+    if (queued.size() > d_capacity) {
+        first = queued.size() - d_capacity;
+        d_dropped.fetch_add(first, std::memory_order_relaxed);
+    }
+    allocate(std::min<size_t>(d_capacity,
+                              round_up(std::max(INITIAL_SLOTS, queued.size() - first))));
+    for (size_t i = first; i < queued.size(); i++) {
+        try_push(queued[i]);
+    }
+}
+
+bool msg_port_queue::try_push(const pmt::pmt_t& msg)
+{
+    uint64_t pos = d_tail.load(std::memory_order_relaxed);
+    for (;;) {
+        slot& s = d_slots[pos & d_mask];
+        const int64_t diff =
+            static_cast<int64_t>(s.seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (d_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                s.msg = msg;
+                s.seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            // The consumer has not freed the slot of the previous lap yet.
+            return false;
+        } else {
+            pos = d_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool msg_port_queue::push(const pmt::pmt_t& msg)
+{
+    {
+        // Pairs with unspill(): either it sees us here, or we see the
+        // spilled messages and queue behind them.
+        counter_guard pushing(d_pushing);
+        if (d_nspilled.load() == 0 && try_push(msg)) {
+            return true;
+        }
+    }
+    return push_locked(msg);
+}
+
+bool msg_port_queue::push_locked(const pmt::pmt_t& msg)
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    for (;;) {
+        if (d_spill.empty() && try_push(msg)) {
+            return true;
+        }
+        if (can_spill()) {
+            d_spill.push_back(msg);
+            d_nspilled.store(d_spill.size());
+            return true;
+        }
+        switch (d_policy) {
+        case OVERFLOW_DROP_OLDEST: {
+            // May find the queue empty if the consumer just made room.
+            pmt::pmt_t oldest;
+            bool dropped = pop_ring(&oldest, 1) > 0;
+            if (!dropped && !d_spill.empty()) {
+                d_spill.pop_front();
+                d_nspilled.store(d_spill.size());
+                dropped = true;
+            }
+            if (dropped) {
+                d_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+        }
+        case OVERFLOW_BLOCK:
+            wait_for_room(lock);
+            break;
+        case OVERFLOW_COUNT:
+            d_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+}
+
+size_t msg_port_queue::pop_ring(pmt::pmt_t* msgs, size_t max)
+{
+    uint64_t pos = d_head.load(std::memory_order_relaxed);
+    size_t n;
+    for (;;) {
+        n = 0;
+        while (n < max && d_slots[(pos + n) & d_mask].seq.load(
+                              std::memory_order_acquire) == pos + n + 1) {
+            n++;
+        }
+        if (n == 0) {
+            const int64_t diff = static_cast<int64_t>(
+                d_slots[pos & d_mask].seq.load(std::memory_order_acquire) - (pos + 1));
+            if (diff < 0 || max == 0) {
+                return 0;
+            }
+            // Someone else (a producer dropping the oldest message) took pos.
+            pos = d_head.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (d_head.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        slot& s = d_slots[(pos + i) & d_mask];
+        msgs[i] = std::move(s.msg);
+        s.msg.reset();
+        s.seq.store(pos + i + d_mask + 1, std::memory_order_release);
+    }
+    return n;
+}
+
+size_t msg_port_queue::pop(pmt::pmt_t* msgs, size_t max)
+{
+    size_t n = pop_ring(msgs, max);
+    if (n == 0 && max > 0 && d_nspilled.load(std::memory_order_acquire) != 0) {
+        gr::thread::scoped_lock lock(d_mutex);
+        unspill();
+        n = pop_ring(msgs, max);
+    }
+    if (n > 0) {
+        wake_producers();
+    }
+    return n;
+}
+
+pmt::pmt_t msg_port_queue::pop()
+{
+    pmt::pmt_t msg;
+    pop(&msg, 1);
+    return msg;
+}
+
+void msg_port_queue::unspill()
+{
+    // New producers see the spilled messages and wait for d_mutex; the
+    // ones still on the lock-free path are about to leave it.
+    while (d_pushing.load() != 0) {
+        std::this_thread::yield();
+    }
+    // Messages that made it into the ring before are older than the
+    // spilled ones of the same producer.
+    if (d_spill.empty() || ring_size() != 0) {
+        return;
+    }
+
+    const size_t slots = std::min<size_t>(
+        d_capacity, round_up(std::max<size_t>(2 * (d_mask + 1), d_spill.size())));
+    if (slots > d_mask + 1) {
+        allocate(slots);
+    }
+    for (auto& msg : d_spill) {
+        try_push(msg);
+    }
+    d_spill.clear();
+    d_nspilled.store(0);
+}
+
+size_t msg_port_queue::ring_size() const
+{
+    const uint64_t head = d_head.load(std::memory_order_acquire);
+    const uint64_t tail = d_tail.load(std::memory_order_acquire);
+    // A claimed slot counts before its message is published.
+    if (tail <= head) {
+        return 0;
+    }
+    return std::min<uint64_t>(tail - head, d_mask + 1);
+}
+
+size_t msg_port_queue::size() const
+{
+    return ring_size() + d_nspilled.load(std::memory_order_relaxed);
+}
+
+bool msg_port_queue::tail_free() const
+{
+    const uint64_t pos = d_tail.load(std::memory_order_relaxed);
+    return d_slots[pos & d_mask].seq.load(std::memory_order_acquire) >= pos;
+}
+
+bool msg_port_queue::can_spill() const
+{
+    return d_mask + 1 < d_capacity && size() < d_capacity;
+}
+
+void msg_port_queue::wait_for_room(gr::thread::scoped_lock& lock)
+{
+    counter_guard waiting(d_waiting);
+    // Pairs with the fence in wake_producers(): either the consumer sees
+    // us waiting, or we see the slot it freed.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!(d_spill.empty() && tail_free()) && !can_spill()) {
+        d_room.wait(lock); // an interruption point, like the other scheduler waits
+    }
+}
+
+void msg_port_queue::wake_producers()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (d_waiting.load(std::memory_order_relaxed) > 0) {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_room.notify_all();
+    }
+}
+
+} /* namespace gr */
@@ -14,6 +14,9 @@
 #include <pmt/pmt.h>
 #include <pmt/pmt_pool.h>
 #include <string_view>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <mutex>
@@ -85,19 +88,19 @@ pmt_null::pmt_null() {}
 
 pmt_t get_PMT_NIL()
 {
-    static pmt_t _NIL = pmt_t(new pmt_null());
+    static pmt_t _NIL = make_pmt<pmt_null>();
     return _NIL;
 }
 
 pmt_t get_PMT_T()
 {
-    static const pmt_t _T = pmt_t(new pmt_bool());
+    static const pmt_t _T = make_pmt<pmt_bool>();
     return _T;
 }
 
 pmt_t get_PMT_F()
 {
-    static const pmt_t _F = pmt_t(new pmt_bool());
+    static const pmt_t _F = make_pmt<pmt_bool>();
     return _F;
 }
 
@@ -168,7 +171,7 @@ pmt_t string_to_symbol(std::string_view name)
     }
 
     // Nope.  Make a new one.
-    pmt_t sym = pmt_t(new pmt_symbol(name));
+    pmt_t sym = make_pmt<pmt_symbol>(name);
     _symbol(sym)->set_next((*get_symbol_hash_table())[hash]);
     (*get_symbol_hash_table())[hash] = sym;
     return sym;
@@ -192,6 +195,34 @@ const std::string symbol_to_string(const pmt_t& sym)
 
 bool is_number(pmt_t x) { return x->is_number(); }
 
+////////////////////////////////////////////////////////////////////////////
+//                          Small Numbers
+////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Small integers, and doubles holding them, are common enough as tag
+ * values, lengths and counters that from_long, from_uint64 and
+ * from_double hand out shared instances of them rather than allocating
+ * new ones. Numbers are immutable, so nobody can tell but eq().
+ */
+static const long small_min = -128;
+static const long small_max = 1023;
+
+static bool is_small(long x) { return x >= small_min && x <= small_max; }
+
+template <typename T>
+static const pmt_t& small_number(long x)
+{
+    static const std::vector<pmt_t> numbers = [] {
+        std::vector<pmt_t> numbers;
+        numbers.reserve(small_max - small_min + 1);
+        for (long i = small_min; i <= small_max; i++)
+            numbers.push_back(make_pmt<T>(i));
+        return numbers;
+    }();
+    return numbers[x - small_min];
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //                             Integer
 ////////////////////////////////////////////////////////////////////////////
@@ -201,7 +232,12 @@ pmt_integer::pmt_integer(long value) : d_value(value) {}
 bool is_integer(pmt_t x) { return x->is_integer(); }
 
 
-pmt_t from_long(long x) { return pmt_t(new pmt_integer(x)); }
+pmt_t from_long(long x)
+{
+    if (is_small(x))
+        return small_number<pmt_integer>(x);
+    return make_pmt<pmt_integer>(x);
+}
 
 long to_long(pmt_t x)
 {
@@ -221,7 +257,12 @@ pmt_uint64::pmt_uint64(uint64_t value) : d_value(value) {}
 bool is_uint64(pmt_t x) { return x->is_uint64(); }
 
 
-pmt_t from_uint64(uint64_t x) { return pmt_t(new pmt_uint64(x)); }
+pmt_t from_uint64(uint64_t x)
+{
+    if (x <= uint64_t(small_max))
+        return small_number<pmt_uint64>(x);
+    return make_pmt<pmt_uint64>(x);
+}
 
 uint64_t to_uint64(pmt_t x)
 {
@@ -244,9 +285,15 @@ pmt_real::pmt_real(double value) : d_value(value) {}
 
 bool is_real(pmt_t x) { return x->is_real(); }
 
-pmt_t from_double(double x) { return pmt_t(new pmt_real(x)); }
+pmt_t from_double(double x)
+{
+    // -0.0 is eqv to 0.0, but dividing by it tells them apart
+    if (x >= small_min && x <= small_max && x == long(x) && !(x == 0 && std::signbit(x)))
+        return small_number<pmt_real>(long(x));
+    return make_pmt<pmt_real>(x);
+}
 
-pmt_t from_float(float x) { return pmt_t(new pmt_real(x)); }
+pmt_t from_float(float x) { return from_double(x); }
 
 double to_double(pmt_t x)
 {
@@ -274,15 +321,15 @@ pmt_t from_complex(double re, double im) { return pmt_from_complex(re, im); }
 
 pmt_t pmt_from_complex(double re, double im)
 {
-    return pmt_t(new pmt_complex(std::complex<double>(re, im)));
+    return make_pmt<pmt_complex>(std::complex<double>(re, im));
 }
 
 pmt_t pmt_from_complex(const std::complex<double>& z)
 {
-    return pmt_t(new pmt_complex(z));
+    return make_pmt<pmt_complex>(z);
 }
 
-pmt_t from_complex(const std::complex<double>& z) { return pmt_t(new pmt_complex(z)); }
+pmt_t from_complex(const std::complex<double>& z) { return make_pmt<pmt_complex>(z); }
 
 std::complex<double> to_complex(pmt_t x)
 {
@@ -306,7 +353,7 @@ bool is_null(const pmt_t& x) { return x == PMT_NIL; }
 
 bool is_pair(const pmt_t& obj) { return obj->is_pair(); }
 
-pmt_t cons(const pmt_t& x, const pmt_t& y) { return pmt_t(new pmt_pair(x, y)); }
+pmt_t cons(const pmt_t& x, const pmt_t& y) { return make_pmt<pmt_pair>(x, y); }
 
 pmt_t car(const pmt_t& pair)
 {
@@ -374,7 +421,7 @@ void pmt_vector::fill(pmt_t obj)
 
 bool is_vector(pmt_t obj) { return obj->is_vector(); }
 
-pmt_t make_vector(size_t k, pmt_t fill) { return pmt_t(new pmt_vector(k, fill)); }
+pmt_t make_vector(size_t k, pmt_t fill) { return make_pmt<pmt_vector>(k, fill); }
 
 pmt_t vector_ref(pmt_t vector, size_t k)
 {
@@ -422,52 +469,52 @@ pmt_t tuple_ref(const pmt_t& tuple, size_t k)
 // for (i=0; i < 10; i++)
 //   make_constructor()
 
-pmt_t make_tuple() { return pmt_t(new pmt_tuple(0)); }
+pmt_t make_tuple() { return make_pmt<pmt_tuple>(0); }
 
 pmt_t make_tuple(const pmt_t& e0)
 {
-    pmt_tuple* t = new pmt_tuple(1);
+    auto t = make_pmt<pmt_tuple>(1);
     t->_set(0, e0);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t make_tuple(const pmt_t& e0, const pmt_t& e1)
 {
-    pmt_tuple* t = new pmt_tuple(2);
+    auto t = make_pmt<pmt_tuple>(2);
     t->_set(0, e0);
     t->_set(1, e1);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t make_tuple(const pmt_t& e0, const pmt_t& e1, const pmt_t& e2)
 {
-    pmt_tuple* t = new pmt_tuple(3);
+    auto t = make_pmt<pmt_tuple>(3);
     t->_set(0, e0);
     t->_set(1, e1);
     t->_set(2, e2);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t make_tuple(const pmt_t& e0, const pmt_t& e1, const pmt_t& e2, const pmt_t& e3)
 {
-    pmt_tuple* t = new pmt_tuple(4);
+    auto t = make_pmt<pmt_tuple>(4);
     t->_set(0, e0);
     t->_set(1, e1);
     t->_set(2, e2);
     t->_set(3, e3);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t make_tuple(
     const pmt_t& e0, const pmt_t& e1, const pmt_t& e2, const pmt_t& e3, const pmt_t& e4)
 {
-    pmt_tuple* t = new pmt_tuple(5);
+    auto t = make_pmt<pmt_tuple>(5);
     t->_set(0, e0);
     t->_set(1, e1);
     t->_set(2, e2);
     t->_set(3, e3);
     t->_set(4, e4);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t make_tuple(const pmt_t& e0,
@@ -477,14 +524,14 @@ pmt_t make_tuple(const pmt_t& e0,
                  const pmt_t& e4,
                  const pmt_t& e5)
 {
-    pmt_tuple* t = new pmt_tuple(6);
+    auto t = make_pmt<pmt_tuple>(6);
     t->_set(0, e0);
     t->_set(1, e1);
     t->_set(2, e2);
     t->_set(3, e3);
     t->_set(4, e4);
     t->_set(5, e5);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t make_tuple(const pmt_t& e0,
@@ -495,7 +542,7 @@ pmt_t make_tuple(const pmt_t& e0,
                  const pmt_t& e5,
                  const pmt_t& e6)
 {
-    pmt_tuple* t = new pmt_tuple(7);
+    auto t = make_pmt<pmt_tuple>(7);
     t->_set(0, e0);
     t->_set(1, e1);
     t->_set(2, e2);
@@ -503,7 +550,7 @@ pmt_t make_tuple(const pmt_t& e0,
     t->_set(4, e4);
     t->_set(5, e5);
     t->_set(6, e6);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t make_tuple(const pmt_t& e0,
@@ -515,7 +562,7 @@ pmt_t make_tuple(const pmt_t& e0,
                  const pmt_t& e6,
                  const pmt_t& e7)
 {
-    pmt_tuple* t = new pmt_tuple(8);
+    auto t = make_pmt<pmt_tuple>(8);
     t->_set(0, e0);
     t->_set(1, e1);
     t->_set(2, e2);
@@ -524,7 +571,7 @@ pmt_t make_tuple(const pmt_t& e0,
     t->_set(5, e5);
     t->_set(6, e6);
     t->_set(7, e7);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t make_tuple(const pmt_t& e0,
@@ -537,7 +584,7 @@ pmt_t make_tuple(const pmt_t& e0,
                  const pmt_t& e7,
                  const pmt_t& e8)
 {
-    pmt_tuple* t = new pmt_tuple(9);
+    auto t = make_pmt<pmt_tuple>(9);
     t->_set(0, e0);
     t->_set(1, e1);
     t->_set(2, e2);
@@ -547,7 +594,7 @@ pmt_t make_tuple(const pmt_t& e0,
     t->_set(6, e6);
     t->_set(7, e7);
     t->_set(8, e8);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t make_tuple(const pmt_t& e0,
@@ -561,7 +608,7 @@ pmt_t make_tuple(const pmt_t& e0,
                  const pmt_t& e8,
                  const pmt_t& e9)
 {
-    pmt_tuple* t = new pmt_tuple(10);
+    auto t = make_pmt<pmt_tuple>(10);
     t->_set(0, e0);
     t->_set(1, e1);
     t->_set(2, e2);
@@ -572,7 +619,7 @@ pmt_t make_tuple(const pmt_t& e0,
     t->_set(7, e7);
     t->_set(8, e8);
     t->_set(9, e9);
-    return pmt_t(t);
+    return t;
 }
 
 pmt_t to_tuple(const pmt_t& x)
@@ -581,13 +628,12 @@ pmt_t to_tuple(const pmt_t& x)
         return x;
 
     size_t len = length(x);
-    pmt_tuple* t = new pmt_tuple(len);
-    pmt_t r = pmt_t(t);
+    auto t = make_pmt<pmt_tuple>(len);
 
     if (x->is_vector()) {
         for (size_t i = 0; i < len; i++)
             t->_set(i, _vector(x)->ref(i));
-        return r;
+        return t;
     }
 
     if (x->is_pair()) {
@@ -596,7 +642,7 @@ pmt_t to_tuple(const pmt_t& x)
             t->_set(i, car(y));
             y = cdr(y);
         }
-        return r;
+        return t;
     }
 
     throw wrong_type("pmt_to_tuple", x);
@@ -636,15 +682,154 @@ void* uniform_vector_writable_elements(pmt_t vector, size_t& len)
 ////////////////////////////////////////////////////////////////////////////
 
 /*
- * This is an a-list implementation.
- *
- * When we need better performance for large dictionaries, consider implementing
- * persistent Red-Black trees as described in "Purely Functional Data Structures",
- * Chris Okasaki, 1998, section 3.3.
+ * There are two implementations. make_dict() and dict_add() on an a-list
+ * build an a-list, as they always have; dict_builder and deserialize()
+ * build a pmt_hash_dict. The dict functions accept either.
  */
 
 pmt_dict::pmt_dict(const pmt_t& car, const pmt_t& cdr) : pmt_pair::pmt_pair(car, cdr) {}
 
+static pmt_hash_dict* _hash_dict(const pmt_t& x)
+{
+    return dynamic_cast<pmt_hash_dict*>(x.get());
+}
+
+static uint64_t double_bits(double x)
+{
+    if (x == 0.0) // -0.0 is eqv to 0.0
+        x = 0.0;
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+/*
+ * Keys that are eqv hash alike. Numbers hash by value; symbols are
+ * interned, so they hash by address, as does everything else.
+ */
+static uint32_t hash_key(const pmt_t& key)
+{
+    pmt_base* p = key.get();
+    uint64_t bits = reinterpret_cast<uintptr_t>(p);
+    if (!p->is_symbol() && p->is_number()) {
+        if (p->is_integer())
+            bits = static_cast<uint64_t>(static_cast<pmt_integer*>(p)->value());
+        else if (p->is_uint64())
+            bits = static_cast<pmt_uint64*>(p)->value();
+        else if (p->is_real())
+            bits = double_bits(static_cast<pmt_real*>(p)->value());
+        else if (p->is_complex()) {
+            const std::complex<double> c = static_cast<pmt_complex*>(p)->value();
+            bits = double_bits(c.real()) * 31 ^ double_bits(c.imag());
+        }
+    }
+    return static_cast<uint32_t>((bits * 0x9e3779b97f4a7c15ULL) >> 32);
+}
+
+pmt_t pmt_hash_dict::make(size_t capacity)
+{
+    capacity = std::max<size_t>(capacity, 4);
+    if (capacity > (1U << 30))
+        throw std::length_error("pmt_make_dict: too many keys");
+    size_t nslots = 8;
+    while (nslots < 2 * capacity)
+        nslots <<= 1;
+
+    const size_t nbytes =
+        sizeof(pmt_hash_dict) + capacity * sizeof(entry) + nslots * sizeof(uint32_t);
+    pmt_hash_dict* d = new (pool_malloc(nbytes)) pmt_hash_dict(capacity, nslots);
+    return pmt_t(
+        d,
+        [nbytes](pmt_hash_dict* d) {
+            d->~pmt_hash_dict();
+            pool_free(d, nbytes);
+        },
+        pmt_allocator<pmt_hash_dict>());
+}
+
+pmt_hash_dict::pmt_hash_dict(size_t capacity, size_t nslots)
+    : d_size(0),
+      d_used(0),
+      d_capacity(capacity),
+      d_mask(nslots - 1),
+      d_entries(reinterpret_cast<entry*>(this + 1)),
+      d_index(reinterpret_cast<uint32_t*>(d_entries + capacity))
+{
+    std::fill_n(d_index, nslots, 0);
+}
+
+pmt_hash_dict::~pmt_hash_dict()
+{
+    for (uint32_t i = 0; i < d_used; i++)
+        d_entries[i].~entry();
+}
+
+// The index slot of key, or the empty slot where it would go
+uint32_t* pmt_hash_dict::probe(const pmt_t& key, uint32_t hash) const
+{
+    for (uint32_t i = hash;; i++) {
+        uint32_t* slot = &d_index[i & d_mask];
+        if (*slot == 0)
+            return slot;
+        const entry& e = d_entries[*slot - 1];
+        if (e.hash == hash && eqv(e.key, key))
+            return slot;
+    }
+}
+
+void pmt_hash_dict::append(uint32_t* slot,
+                           const pmt_t& key,
+                           const pmt_t& value,
+                           uint32_t hash)
+{
+    new (&d_entries[d_used]) entry{ key, value, hash };
+    *slot = ++d_used;
+    d_size++;
+}
+
+const pmt_hash_dict::entry* pmt_hash_dict::find(const pmt_t& key) const
+{
+    const uint32_t* slot = probe(key, hash_key(key));
+    return *slot ? &d_entries[*slot - 1] : nullptr;
+}
+
+bool pmt_hash_dict::set(const pmt_t& key, const pmt_t& value)
+{
+    const uint32_t hash = hash_key(key);
+    uint32_t* slot = probe(key, hash);
+    const uint32_t old = *slot;
+    if (old != 0 && old == d_used) { // already the newest entry
+        d_entries[old - 1].value = value;
+        return true;
+    }
+    if (d_used == d_capacity)
+        return false;
+
+    append(slot, key, value, hash);
+    if (old != 0) {
+        d_entries[old - 1].key.reset();
+        d_entries[old - 1].value.reset();
+        d_size--;
+    }
+    return true;
+}
+
+pmt_t pmt_hash_dict::copy(size_t capacity, const pmt_t& skip) const
+{
+    const entry* skipped = skip ? find(skip) : nullptr;
+    pmt_t result = make(capacity);
+    pmt_hash_dict* d = static_cast<pmt_hash_dict*>(result.get());
+    for (const entry& e : *this) {
+        if (e.key && &e != skipped)
+            d->append(d->probe(e.key, e.hash), e.key, e.value, e.hash);
+    }
+    return result;
+}
+
+// Leaves room for more keys, so that a dict only we refer to is not
+// reallocated for each key added to it.
+static size_t grown(size_t size) { return size + size / 2 + 1; }
+
 bool is_dict(const pmt_t& obj) { return is_null(obj) || obj->is_dict(); }
 
 pmt_t make_dict() { return PMT_NIL; }
@@ -656,12 +841,20 @@ pmt_t dcons(const pmt_t& x, const pmt_t& y)
         throw wrong_type("pmt_dcons: not a pair", x);
     if (!is_dict(y))
         throw wrong_type("pmt_dcons: not a dict", y);
+    if (_hash_dict(y))
+        throw wrong_type("pmt_dcons: not an a-list", y);
 
-    return pmt_t(new pmt_dict(x, y));
+    return make_pmt<pmt_dict>(x, y);
 }
 
 pmt_t dict_add(const pmt_t& dict, const pmt_t& key, const pmt_t& value)
 {
+    if (pmt_hash_dict* d = _hash_dict(dict)) {
+        pmt_t result = d->copy(grown(d->size()), key);
+        _hash_dict(result)->set(key, value);
+        return result;
+    }
+
     if (is_null(dict))
         return acons(key, value, PMT_NIL);
 
@@ -671,12 +864,27 @@ pmt_t dict_add(const pmt_t& dict, const pmt_t& key, const pmt_t& value)
     return acons(key, value, dict);
 }
 
+pmt_t dict_add(pmt_t&& dict, const pmt_t& key, const pmt_t& value)
+{
+    // Nobody can tell a dict only we refer to from a changed copy of it.
+    pmt_hash_dict* d = _hash_dict(dict);
+    if (d && dict.use_count() == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!d->set(key, value)) {
+            dict = d->copy(grown(d->size()), key);
+            _hash_dict(dict)->set(key, value);
+        }
+        return std::move(dict);
+    }
+    return dict_add(static_cast<const pmt_t&>(dict), key, value);
+}
+
 pmt_t dict_update(const pmt_t& dict1, const pmt_t& dict2)
 {
     pmt_t d(dict1);
     pmt_t k(dict_keys(dict2));
     while (is_pair(k)) {
-        d = dict_add(d, car(k), dict_ref(dict2, car(k), PMT_NIL));
+        d = dict_add(std::move(d), car(k), dict_ref(dict2, car(k), PMT_NIL));
         k = cdr(k);
     }
     return d;
@@ -685,6 +893,9 @@ pmt_t dict_update(const pmt_t& dict1, const pmt_t& dict2)
 
 pmt_t dict_delete(const pmt_t& dict, const pmt_t& key)
 {
+    if (pmt_hash_dict* d = _hash_dict(dict))
+        return d->find(key) ? d->copy(d->size(), key) : dict;
+
     if (is_null(dict))
         return dict;
 
@@ -696,6 +907,11 @@ pmt_t dict_delete(const pmt_t& dict, const pmt_t& key)
 
 pmt_t dict_ref(const pmt_t& dict, const pmt_t& key, const pmt_t& not_found)
 {
+    if (pmt_hash_dict* d = _hash_dict(dict)) {
+        const pmt_hash_dict::entry* e = d->find(key);
+        return e ? e->value : not_found;
+    }
+
     pmt_t p = assv(key, dict); // look for (key . value) pair
     if (is_pair(p))
         return cdr(p);
@@ -705,6 +921,9 @@ pmt_t dict_ref(const pmt_t& dict, const pmt_t& key, const pmt_t& not_found)
 
 bool dict_has_key(const pmt_t& dict, const pmt_t& key)
 {
+    if (pmt_hash_dict* d = _hash_dict(dict))
+        return d->find(key) != nullptr;
+
     return is_pair(assv(key, dict));
 }
 
@@ -713,6 +932,16 @@ pmt_t dict_items(pmt_t dict)
     if (!is_dict(dict))
         throw wrong_type("pmt_dict_values", dict);
 
+    if (pmt_hash_dict* d = _hash_dict(dict)) {
+        // the equivalent a-list, newest entry first
+        pmt_t r = PMT_NIL;
+        for (const auto& e : *d) {
+            if (e.key)
+                r = make_pmt<pmt_dict>(cons(e.key, e.value), r);
+        }
+        return r;
+    }
+
     return dict; // equivalent to dict in the a-list case
 }
 
@@ -721,6 +950,15 @@ pmt_t dict_keys(pmt_t dict)
     if (!is_dict(dict))
         throw wrong_type("pmt_dict_keys", dict);
 
+    if (pmt_hash_dict* d = _hash_dict(dict)) {
+        pmt_t r = PMT_NIL;
+        for (const auto& e : *d) {
+            if (e.key)
+                r = cons(e.key, r);
+        }
+        return r;
+    }
+
     return map(car, dict);
 }
 
@@ -729,9 +967,35 @@ pmt_t dict_values(pmt_t dict)
     if (!is_dict(dict))
         throw wrong_type("pmt_dict_keys", dict);
 
+    if (pmt_hash_dict* d = _hash_dict(dict)) {
+        pmt_t r = PMT_NIL;
+        for (const auto& e : *d) {
+            if (e.key)
+                r = cons(e.value, r);
+        }
+        return r;
+    }
+
     return map(cdr, dict);
 }
 
+dict_builder::dict_builder(size_t capacity) : d_dict(pmt_hash_dict::make(capacity)) {}
+
+dict_builder& dict_builder::add(const pmt_t& key, const pmt_t& value)
+{
+    if (!d_dict)
+        d_dict = pmt_hash_dict::make(0);
+    d_dict = dict_add(std::move(d_dict), key, value);
+    return *this;
+}
+
+pmt_t dict_builder::build()
+{
+    if (!d_dict)
+        return pmt_hash_dict::make(0);
+    return std::move(d_dict);
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //                                 Any
 ////////////////////////////////////////////////////////////////////////////
@@ -740,7 +1004,7 @@ pmt_any::pmt_any(const std::any& any) : d_any(any) {}
 
 bool is_any(pmt_t obj) { return obj->is_any(); }
 
-pmt_t make_any(const std::any& any) { return pmt_t(new pmt_any(any)); }
+pmt_t make_any(const std::any& any) { return make_pmt<pmt_any>(any); }
 
 std::any any_ref(pmt_t obj)
 {
@@ -794,6 +1058,12 @@ pmt_t make_blob(const void* buf, size_t len_in_bytes)
     return init_u8vector(len_in_bytes, (const uint8_t*)buf);
 }
 
+pmt_t make_blob_view(const void* buf, size_t len, std::function<void()> release)
+{
+    return make_u8vector_view(
+        len, static_cast<uint8_t*>(const_cast<void*>(buf)), std::move(release));
+}
+
 const void* blob_data(pmt_t blob)
 {
     size_t len;
@@ -888,6 +1158,10 @@ bool equal(const pmt_t& x, const pmt_t& y)
         return false;
     }
 
+    // a hash dict is equal to the a-list it stands for
+    if (is_dict(x) && is_dict(y) && (_hash_dict(x) || _hash_dict(y)))
+        return equal(dict_items(x), dict_items(y));
+
     // FIXME add other cases here...
 
     return false;
@@ -907,6 +1181,9 @@ size_t length(const pmt_t& x)
     if (x->is_null())
         return 0;
 
+    if (pmt_hash_dict* d = _hash_dict(x))
+        return d->size();
+
     // also returns correct result for dictionaries
     if (x->is_pair()) {
         size_t length = 1;
@@ -985,6 +1262,9 @@ pmt_t map(pmt_t proc(const pmt_t&), pmt_t list)
 
 pmt_t reverse(pmt_t listx)
 {
+    if (_hash_dict(listx))
+        listx = dict_items(listx);
+
     pmt_t list = listx;
     pmt_t r = PMT_NIL;
 
@@ -13,6 +13,7 @@
 #include <pmt/pmt.h>
 #include <string_view>
 #include <any>
+#include <utility>
 
 /*
  * EVERYTHING IN THIS FILE IS PRIVATE TO THE IMPLEMENTATION!
@@ -22,6 +23,74 @@
 
 namespace pmt {
 
+/*
+ * PMTs are allocated in one block with their reference counts, from
+ * pmt_pools of a few block sizes (see pmt_pool.cc). Larger blocks come
+ * from the heap. The elements of vectors come from a second set of
+ * pools, aligned for volk.
+ */
+void* pool_malloc(size_t nbytes);
+void pool_free(void* p, size_t nbytes);
+void* pool_malloc_elements(size_t nbytes);
+void pool_free_elements(void* p, size_t nbytes);
+
+template <typename T, bool elements = false>
+class pmt_allocator
+{
+public:
+    typedef T value_type;
+    template <typename U>
+    struct rebind {
+        typedef pmt_allocator<U, elements> other;
+    };
+
+    pmt_allocator() = default;
+    template <typename U>
+    pmt_allocator(const pmt_allocator<U, elements>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        const size_t nbytes = n * sizeof(T);
+        return static_cast<T*>(elements ? pool_malloc_elements(nbytes)
+                                        : pool_malloc(nbytes));
+    }
+    void deallocate(T* p, size_t n)
+    {
+        if (elements)
+            pool_free_elements(p, n * sizeof(T));
+        else
+            pool_free(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const pmt_allocator<U, elements>&) const
+    {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const pmt_allocator<U, elements>&) const
+    {
+        return false;
+    }
+};
+
+//! Element storage of vectors, blobs and tuples
+template <typename T>
+using pmt_elements = std::vector<T, pmt_allocator<T, true>>;
+
+/*!
+ * Use instead of pmt_t(new T(args...)). The object and the shared_ptr
+ * control block share one pooled block. The reference count stays the
+ * control block's atomic one.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> make_pmt(Args&&... args)
+{
+    return std::allocate_shared<T>(pmt_allocator<T>(), std::forward<Args>(args)...);
+}
+
 
 class pmt_bool : public pmt_base
 {
@@ -136,9 +205,61 @@ public:
     bool is_dict() const override { return true; }
 };
 
+/*
+ * A dictionary in a single block: the entries in the order they
+ * were added, followed by an open-addressing index into them (linear
+ * probing, at most half full). Adding a key that is already present
+ * clears the old entry and appends a new one, so the entries read
+ * newest first give the keys in the order of the equivalent a-list.
+ *
+ * Only ever changed in place while a single pmt_t refers to it.
+ */
+class pmt_hash_dict : public pmt_base
+{
+public:
+    struct entry {
+        pmt_t key; // null once the key was added again
+        pmt_t value;
+        uint32_t hash;
+    };
+
+    //! An empty dictionary with room for \p capacity entries
+    static pmt_t make(size_t capacity);
+    ~pmt_hash_dict() override;
+
+    bool is_dict() const override { return true; }
+
+    size_t size() const { return d_size; }
+    size_t capacity() const { return d_capacity; }
+    //! Entries in the order they were added, cleared ones included
+    const entry* begin() const { return d_entries; }
+    const entry* end() const { return d_entries + d_used; }
+
+    const entry* find(const pmt_t& key) const;
+
+    //! Add or replace \p key. Returns false if there is no room left.
+    bool set(const pmt_t& key, const pmt_t& value);
+
+    //! A copy with room for \p capacity entries, without \p skip
+    pmt_t copy(size_t capacity, const pmt_t& skip = pmt_t()) const;
+
+private:
+    pmt_hash_dict(size_t capacity, size_t nslots);
+
+    uint32_t* probe(const pmt_t& key, uint32_t hash) const;
+    void append(uint32_t* slot, const pmt_t& key, const pmt_t& value, uint32_t hash);
+
+    uint32_t d_size;     // live entries
+    uint32_t d_used;     // entries, cleared ones included
+    uint32_t d_capacity; // room for entries
+    uint32_t d_mask;     // index slots - 1
+    entry* d_entries;
+    uint32_t* d_index; // entry number + 1, 0 for an empty slot
+};
+
 class pmt_vector : public pmt_base
 {
-    std::vector<pmt_t> d_v;
+    pmt_elements<pmt_t> d_v;
 
 public:
     pmt_vector(size_t len, pmt_t fill);
@@ -155,7 +276,7 @@ public:
 
 class pmt_tuple : public pmt_base
 {
-    std::vector<pmt_t> d_v;
+    pmt_elements<pmt_t> d_v;
 
 public:
     pmt_tuple(size_t len);
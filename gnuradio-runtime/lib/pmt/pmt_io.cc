@@ -83,9 +83,8 @@ void write(pmt_t obj, std::ostream& port)
         }
         port << ")";
     } else if (is_dict(obj)) {
-        // FIXME
-        // port << "#<dict " << obj << ">";
-        port << "#<dict>";
+        // a hashed dict, written as the a-list it stands for
+        write(dict_items(obj), port);
     } else if (is_uniform_vector(obj)) {
         port << "#[";
         size_t len = length(obj);
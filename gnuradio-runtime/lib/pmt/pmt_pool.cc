@@ -12,9 +12,12 @@
 #include <config.h>
 #endif
 
+#include "pmt_int.h"
 #include <pmt/pmt_pool.h>
+#include <volk/volk.h>
 #include <algorithm>
 #include <cstdint>
+#include <new>
 
 namespace pmt {
 
@@ -23,64 +26,241 @@ static inline size_t ROUNDUP(size_t x, size_t stride)
     return ((((x) + (stride)-1) / (stride)) * (stride));
 }
 
+namespace {
+
+// Every pool gets a slot for its thread caches, reused once it is gone.
+struct pool_registry {
+    std::mutex mutex;
+    uint64_t serial = 0;
+    std::vector<pmt_pool*> pools; // by slot, null if free
+    std::vector<size_t> free_slots;
+};
+
+pool_registry& registry()
+{
+    // Never destroyed: threads may exit after static destruction began.
+    static pool_registry* r = new pool_registry;
+    return *r;
+}
+
+// Set once this thread's caches are gone, as the thread exits.
+thread_local bool t_caches_gone = false;
+
+} // namespace
+
+struct pmt_pool::thread_cache {
+    uint64_t serial = 0; // pool the items belong to
+    item* head = nullptr;
+    size_t count = 0;
+    uint64_t mallocs = 0; // not yet reported to the pool
+    uint64_t frees = 0;
+};
+
+struct pmt_pool::thread_caches {
+    std::vector<thread_cache> caches; // by pool slot
+
+    ~thread_caches()
+    {
+        t_caches_gone = true;
+
+        // give the items back to the pools that still exist
+        pool_registry& r = registry();
+        std::lock_guard<std::mutex> guard(r.mutex);
+        for (size_t i = 0; i < caches.size() && i < r.pools.size(); i++) {
+            pmt_pool* pool = r.pools[i];
+            if (pool && pool->d_serial == caches[i].serial) {
+                pool->report(caches[i]);
+                if (caches[i].count)
+                    pool->hand_back(caches[i], caches[i].count);
+            }
+        }
+    }
+};
+
 pmt_pool::pmt_pool(size_t itemsize,
                    size_t alignment,
                    size_t allocation_size,
                    size_t max_items)
-    : d_itemsize(ROUNDUP(itemsize, alignment)),
-      d_alignment(alignment),
+    : d_itemsize(ROUNDUP(std::max(itemsize, sizeof(item)),
+                         std::max(alignment, alignof(item)))),
+      d_alignment(std::max(alignment, alignof(item))),
       d_allocation_size(std::max(allocation_size, 16 * itemsize)),
       d_max_items(max_items),
+      d_batch_size(std::clamp(d_allocation_size / d_itemsize / 2, size_t(1), size_t(32))),
       d_n_items(0),
-      d_freelist(0)
+      d_overflow(0),
+      d_chunks(0),
+      d_items(0),
+      d_in_depot(0),
+      d_mallocs(0),
+      d_frees(0),
+      d_refills(0),
+      d_handbacks(0)
 {
+    for (auto& slot : d_depot)
+        slot.store(nullptr, std::memory_order_relaxed);
+
+    pool_registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    d_serial = ++r.serial;
+    if (r.free_slots.empty()) {
+        d_slot = r.pools.size();
+        r.pools.push_back(this);
+    } else {
+        d_slot = r.free_slots.back();
+        r.free_slots.pop_back();
+        r.pools[d_slot] = this;
+    }
 }
 
 pmt_pool::~pmt_pool()
 {
+    {
+        pool_registry& r = registry();
+        std::lock_guard<std::mutex> guard(r.mutex);
+        r.pools[d_slot] = nullptr;
+        r.free_slots.push_back(d_slot);
+    }
+
+    // Items still cached by other threads are dropped with their chunks.
     for (unsigned int i = 0; i < d_allocations.size(); i++) {
         delete[] d_allocations[i];
     }
 }
 
-void* pmt_pool::malloc()
+pmt_pool::thread_cache* pmt_pool::cache()
+{
+    if (t_caches_gone)
+        return nullptr;
+
+    static thread_local thread_caches t;
+    if (d_slot >= t.caches.size())
+        t.caches.resize(d_slot + 1);
+
+    thread_cache& c = t.caches[d_slot];
+    if (c.serial != d_serial) { // left over from an earlier pool in this slot
+        c = thread_cache();
+        c.serial = d_serial;
+    }
+    return &c;
+}
+
+void pmt_pool::report(thread_cache& c)
 {
+    if (c.mallocs) {
+        d_mallocs.fetch_add(c.mallocs, std::memory_order_relaxed);
+        c.mallocs = 0;
+    }
+    if (c.frees) {
+        d_frees.fetch_add(c.frees, std::memory_order_relaxed);
+        c.frees = 0;
+    }
+}
+
+void pmt_pool::refill(thread_cache& c)
+{
+    report(c);
+
+    item* batch = nullptr;
+    for (auto& slot : d_depot) {
+        if (slot.load(std::memory_order_relaxed) &&
+            (batch = slot.exchange(nullptr, std::memory_order_acquire)))
+            break;
+    }
+
+    if (!batch) {
+        scoped_lock guard(d_mutex);
+        if (d_overflow) {
+            batch = d_overflow;
+            d_overflow = batch->d_batch;
+        } else {
+            // allocate a new chunk
+            char* alloc = new char[d_allocation_size + d_alignment - 1];
+            d_allocations.push_back(alloc);
+
+            // get the alignment we require
+            char* start = (char*)(((uintptr_t)alloc + d_alignment - 1) & -d_alignment);
+            char* end = alloc + d_allocation_size + d_alignment - 1;
+            size_t n = (end - start) / d_itemsize;
+
+            // link the new items onto this thread's free list.
+            item* p = (item*)start;
+            for (size_t i = 0; i < n; i++) {
+                p->d_next = c.head;
+                c.head = p;
+                p = (item*)((char*)p + d_itemsize);
+            }
+            c.count = n;
+            d_chunks.fetch_add(1, std::memory_order_relaxed);
+            d_items.fetch_add(n, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    size_t n = 0;
+    for (item* p = batch; p; p = p->d_next)
+        n++;
+    c.head = batch;
+    c.count = n;
+    d_in_depot.fetch_sub(n, std::memory_order_relaxed);
+    d_refills.fetch_add(1, std::memory_order_relaxed);
+}
+
+void pmt_pool::hand_back(thread_cache& c, size_t n)
+{
+    report(c);
+
+    item* batch = c.head;
+    item* last = batch;
+    for (size_t i = 1; i < n; i++)
+        last = last->d_next;
+    c.head = last->d_next;
+    c.count -= n;
+    last->d_next = nullptr;
+
+    d_in_depot.fetch_add(n, std::memory_order_relaxed);
+    d_handbacks.fetch_add(1, std::memory_order_relaxed);
+    for (auto& slot : d_depot) {
+        item* empty = nullptr;
+        if (!slot.load(std::memory_order_relaxed) &&
+            slot.compare_exchange_strong(
+                empty, batch, std::memory_order_release, std::memory_order_relaxed))
+            return;
+    }
+
     scoped_lock guard(d_mutex);
-    item* p;
+    batch->d_batch = d_overflow;
+    d_overflow = batch;
+}
 
+void* pmt_pool::malloc()
+{
     if (d_max_items != 0) {
+        scoped_lock guard(d_mutex);
         while (d_n_items >= d_max_items)
             d_cond.wait(guard);
-    }
-
-    if (d_freelist) { // got something?
-        p = d_freelist;
-        d_freelist = p->d_next;
         d_n_items++;
-        return p;
     }
 
-    // allocate a new chunk
-    char* alloc = new char[d_allocation_size + d_alignment - 1];
-    d_allocations.push_back(alloc);
+    thread_cache* c = cache();
+    thread_cache exiting;
+    if (!c) {
+        exiting.serial = d_serial;
+        c = &exiting;
+    }
 
-    // get the alignment we require
-    char* start = (char*)(((uintptr_t)alloc + d_alignment - 1) & -d_alignment);
-    char* end = alloc + d_allocation_size + d_alignment - 1;
-    size_t n = (end - start) / d_itemsize;
+    if (!c->head)
+        refill(*c);
+    item* p = c->head;
+    c->head = p->d_next;
+    c->count--;
+    c->mallocs++;
 
-    // link the new items onto the free list.
-    p = (item*)start;
-    for (size_t i = 0; i < n; i++) {
-        p->d_next = d_freelist;
-        d_freelist = p;
-        p = (item*)((char*)p + d_itemsize);
+    if (c == &exiting) {
+        report(exiting);
+        if (exiting.count)
+            hand_back(exiting, exiting.count);
     }
-
-    // now return the first one
-    p = d_freelist;
-    d_freelist = p->d_next;
-    d_n_items++;
     return p;
 }
 
@@ -89,14 +269,132 @@ void pmt_pool::free(void* foo)
     if (!foo)
         return;
 
-    scoped_lock guard(d_mutex);
+    thread_cache* c = cache();
+    thread_cache exiting;
+    if (!c) {
+        exiting.serial = d_serial;
+        c = &exiting;
+    }
 
     item* p = (item*)foo;
-    p->d_next = d_freelist;
-    d_freelist = p;
-    d_n_items--;
-    if (d_max_items != 0)
+    p->d_next = c->head;
+    c->head = p;
+    c->count++;
+    c->frees++;
+    if (c == &exiting)
+        hand_back(exiting, exiting.count);
+    else if (c->count >= 2 * d_batch_size)
+        hand_back(*c, d_batch_size);
+
+    if (d_max_items != 0) {
+        {
+            scoped_lock guard(d_mutex);
+            d_n_items--;
+        }
         d_cond.notify_one();
+    }
+}
+
+pmt_pool::stats pmt_pool::get_stats() const
+{
+    stats s;
+    s.itemsize = d_itemsize;
+    s.chunks = d_chunks.load(std::memory_order_relaxed);
+    s.items = d_items.load(std::memory_order_relaxed);
+    s.in_depot = d_in_depot.load(std::memory_order_relaxed);
+    s.mallocs = d_mallocs.load(std::memory_order_relaxed);
+    s.frees = d_frees.load(std::memory_order_relaxed);
+    s.refills = d_refills.load(std::memory_order_relaxed);
+    s.handbacks = d_handbacks.load(std::memory_order_relaxed);
+    return s;
+}
+
+/*
+ * The size classes PMTs are allocated from: one pool for each multiple
+ * of 16 bytes up to 256, which covers all PMTs with their reference
+ * counts except the larger dicts. The elements of vectors come from
+ * a second set, aligned for volk, up to 2 KiB.
+ */
+namespace {
+
+struct size_classes {
+    const size_t granularity;
+    const size_t max_size;
+    std::vector<pmt_pool*> pools;
+
+    size_classes(size_t granularity, size_t max_size)
+        : granularity(granularity), max_size(max_size)
+    {
+        for (size_t size = granularity; size <= max_size; size += granularity)
+            pools.push_back(new pmt_pool(size, granularity, 16384));
+    }
+
+    bool covers(size_t nbytes) const { return nbytes != 0 && nbytes <= max_size; }
+    pmt_pool& operator[](size_t nbytes) { return *pools[(nbytes - 1) / granularity]; }
+};
+
+// Never destroyed: PMTs held by static objects are freed on exit too.
+size_classes& object_classes()
+{
+    static size_classes* classes = new size_classes(16, 256);
+    return *classes;
+}
+
+size_classes& element_classes()
+{
+    static size_classes* classes =
+        new size_classes(std::max(size_t(16), volk_get_alignment()), 2048);
+    return *classes;
+}
+
+} // namespace
+
+void* pool_malloc(size_t nbytes)
+{
+    size_classes& classes = object_classes();
+    if (!classes.covers(nbytes))
+        return ::operator new(nbytes);
+    return classes[nbytes].malloc();
+}
+
+void pool_free(void* p, size_t nbytes)
+{
+    size_classes& classes = object_classes();
+    if (!classes.covers(nbytes))
+        ::operator delete(p);
+    else
+        classes[nbytes].free(p);
+}
+
+void* pool_malloc_elements(size_t nbytes)
+{
+    size_classes& classes = element_classes();
+    if (!classes.covers(nbytes)) {
+        void* p = volk_malloc(nbytes, volk_get_alignment());
+        if (!p && nbytes)
+            throw std::bad_alloc();
+        return p;
+    }
+    return classes[nbytes].malloc();
+}
+
+void pool_free_elements(void* p, size_t nbytes)
+{
+    size_classes& classes = element_classes();
+    if (!classes.covers(nbytes))
+        volk_free(p);
+    else
+        classes[nbytes].free(p);
+}
+
+std::vector<pmt_pool::stats> pool_stats()
+{
+    std::vector<pmt_pool::stats> result;
+    for (auto* classes : { &object_classes(), &element_classes() }) {
+        for (pmt_pool* pool : classes->pools)
+            result.push_back(pool->get_stats());
+    }
+    return result;
 }
 
 } /* namespace pmt */
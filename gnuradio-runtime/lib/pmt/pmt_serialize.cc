@@ -549,8 +549,22 @@ tail_recursion:
         }
     }
 
-    if (is_dict(obj))
-        throw notimplemented("pmt::serialize (dict)", obj);
+    if (is_dict(obj)) {
+        // A hashed dict goes out as the a-list it stands for, newest
+        // entry first, so that any reader can parse it.
+        const pmt_hash_dict* d = static_cast<const pmt_hash_dict*>(obj.get());
+        ok = true;
+        for (const pmt_hash_dict::entry* e = d->end(); e != d->begin();) {
+            if (!(--e)->key)
+                continue;
+            ok &= serialize_untagged_u8(PST_DICT, sb);
+            ok &= serialize_untagged_u8(PST_PAIR, sb);
+            ok &= serialize(e->key, sb);
+            ok &= serialize(e->value, sb);
+        }
+        ok &= serialize_untagged_u8(PST_NULL, sb);
+        return ok;
+    }
 
     if (is_tuple(obj)) {
         size_t tuple_len = pmt::length(obj);
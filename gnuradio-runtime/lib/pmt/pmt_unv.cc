@@ -44,6 +44,11 @@ pmt_u8vector::pmt_u8vector(size_t k, const uint8_t* data) : d_v(k)
     }
 }
 
+pmt_u8vector::pmt_u8vector(size_t k, uint8_t* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 
 uint8_t pmt_u8vector::ref(size_t k) const
 {
@@ -85,20 +90,25 @@ void* pmt_u8vector::uniform_writable_elements(size_t& len)
 
 bool is_u8vector(pmt_t obj) { return obj->is_u8vector(); }
 
-pmt_t make_u8vector(size_t k, uint8_t fill) { return pmt_t(new pmt_u8vector(k, fill)); }
+pmt_t make_u8vector(size_t k, uint8_t fill) { return make_pmt<pmt_u8vector>(k, fill); }
 
 pmt_t init_u8vector(size_t k, const uint8_t* data)
 {
-    return pmt_t(new pmt_u8vector(k, data));
+    return make_pmt<pmt_u8vector>(k, data);
 }
 
 pmt_t init_u8vector(size_t k, const std::vector<uint8_t>& data)
 {
     if (k) {
-        return pmt_t(new pmt_u8vector(k, &data[0]));
+        return make_pmt<pmt_u8vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_u8vector(k, static_cast<uint8_t>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_u8vector>(k, static_cast<uint8_t>(0));
+}
+
+pmt_t make_u8vector_view(size_t k, uint8_t* data, std::function<void()> release)
+{
+    return make_pmt<pmt_u8vector>(k, data, std::move(release));
 }
 
 uint8_t u8vector_ref(pmt_t vector, size_t k)
@@ -168,6 +178,11 @@ pmt_s8vector::pmt_s8vector(size_t k, const int8_t* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(int8_t));
 }
 
+pmt_s8vector::pmt_s8vector(size_t k, int8_t* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 int8_t pmt_s8vector::ref(size_t k) const
 {
     if (k >= length())
@@ -208,20 +223,25 @@ void* pmt_s8vector::uniform_writable_elements(size_t& len)
 
 bool is_s8vector(pmt_t obj) { return obj->is_s8vector(); }
 
-pmt_t make_s8vector(size_t k, int8_t fill) { return pmt_t(new pmt_s8vector(k, fill)); }
+pmt_t make_s8vector(size_t k, int8_t fill) { return make_pmt<pmt_s8vector>(k, fill); }
 
 pmt_t init_s8vector(size_t k, const int8_t* data)
 {
-    return pmt_t(new pmt_s8vector(k, data));
+    return make_pmt<pmt_s8vector>(k, data);
 }
 
 pmt_t init_s8vector(size_t k, const std::vector<int8_t>& data)
 {
     if (k) {
-        return pmt_t(new pmt_s8vector(k, &data[0]));
+        return make_pmt<pmt_s8vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_s8vector(k, static_cast<int8_t>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_s8vector>(k, static_cast<int8_t>(0));
+}
+
+pmt_t make_s8vector_view(size_t k, int8_t* data, std::function<void()> release)
+{
+    return make_pmt<pmt_s8vector>(k, data, std::move(release));
 }
 
 int8_t s8vector_ref(pmt_t vector, size_t k)
@@ -294,6 +314,11 @@ pmt_u16vector::pmt_u16vector(size_t k, const uint16_t* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(uint16_t));
 }
 
+pmt_u16vector::pmt_u16vector(size_t k, uint16_t* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 uint16_t pmt_u16vector::ref(size_t k) const
 {
     if (k >= length())
@@ -336,21 +361,26 @@ bool is_u16vector(pmt_t obj) { return obj->is_u16vector(); }
 
 pmt_t make_u16vector(size_t k, uint16_t fill)
 {
-    return pmt_t(new pmt_u16vector(k, fill));
+    return make_pmt<pmt_u16vector>(k, fill);
 }
 
 pmt_t init_u16vector(size_t k, const uint16_t* data)
 {
-    return pmt_t(new pmt_u16vector(k, data));
+    return make_pmt<pmt_u16vector>(k, data);
 }
 
 pmt_t init_u16vector(size_t k, const std::vector<uint16_t>& data)
 {
     if (k) {
-        return pmt_t(new pmt_u16vector(k, &data[0]));
+        return make_pmt<pmt_u16vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_u16vector(k, static_cast<uint16_t>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_u16vector>(k, static_cast<uint16_t>(0));
+}
+
+pmt_t make_u16vector_view(size_t k, uint16_t* data, std::function<void()> release)
+{
+    return make_pmt<pmt_u16vector>(k, data, std::move(release));
 }
 
 uint16_t u16vector_ref(pmt_t vector, size_t k)
@@ -422,6 +452,11 @@ pmt_s16vector::pmt_s16vector(size_t k, const int16_t* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(int16_t));
 }
 
+pmt_s16vector::pmt_s16vector(size_t k, int16_t* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 int16_t pmt_s16vector::ref(size_t k) const
 {
     if (k >= length())
@@ -462,20 +497,25 @@ void* pmt_s16vector::uniform_writable_elements(size_t& len)
 
 bool is_s16vector(pmt_t obj) { return obj->is_s16vector(); }
 
-pmt_t make_s16vector(size_t k, int16_t fill) { return pmt_t(new pmt_s16vector(k, fill)); }
+pmt_t make_s16vector(size_t k, int16_t fill) { return make_pmt<pmt_s16vector>(k, fill); }
 
 pmt_t init_s16vector(size_t k, const int16_t* data)
 {
-    return pmt_t(new pmt_s16vector(k, data));
+    return make_pmt<pmt_s16vector>(k, data);
 }
 
 pmt_t init_s16vector(size_t k, const std::vector<int16_t>& data)
 {
     if (k) {
-        return pmt_t(new pmt_s16vector(k, &data[0]));
+        return make_pmt<pmt_s16vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_s16vector(k, static_cast<int16_t>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_s16vector>(k, static_cast<int16_t>(0));
+}
+
+pmt_t make_s16vector_view(size_t k, int16_t* data, std::function<void()> release)
+{
+    return make_pmt<pmt_s16vector>(k, data, std::move(release));
 }
 
 int16_t s16vector_ref(pmt_t vector, size_t k)
@@ -547,6 +587,11 @@ pmt_u32vector::pmt_u32vector(size_t k, const uint32_t* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(uint32_t));
 }
 
+pmt_u32vector::pmt_u32vector(size_t k, uint32_t* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 uint32_t pmt_u32vector::ref(size_t k) const
 {
     if (k >= length())
@@ -589,21 +634,26 @@ bool is_u32vector(pmt_t obj) { return obj->is_u32vector(); }
 
 pmt_t make_u32vector(size_t k, uint32_t fill)
 {
-    return pmt_t(new pmt_u32vector(k, fill));
+    return make_pmt<pmt_u32vector>(k, fill);
 }
 
 pmt_t init_u32vector(size_t k, const uint32_t* data)
 {
-    return pmt_t(new pmt_u32vector(k, data));
+    return make_pmt<pmt_u32vector>(k, data);
 }
 
 pmt_t init_u32vector(size_t k, const std::vector<uint32_t>& data)
 {
     if (k) {
-        return pmt_t(new pmt_u32vector(k, &data[0]));
+        return make_pmt<pmt_u32vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_u32vector(k, static_cast<uint32_t>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_u32vector>(k, static_cast<uint32_t>(0));
+}
+
+pmt_t make_u32vector_view(size_t k, uint32_t* data, std::function<void()> release)
+{
+    return make_pmt<pmt_u32vector>(k, data, std::move(release));
 }
 
 uint32_t u32vector_ref(pmt_t vector, size_t k)
@@ -675,6 +725,11 @@ pmt_s32vector::pmt_s32vector(size_t k, const int32_t* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(int32_t));
 }
 
+pmt_s32vector::pmt_s32vector(size_t k, int32_t* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 int32_t pmt_s32vector::ref(size_t k) const
 {
     if (k >= length())
@@ -715,20 +770,25 @@ void* pmt_s32vector::uniform_writable_elements(size_t& len)
 
 bool is_s32vector(pmt_t obj) { return obj->is_s32vector(); }
 
-pmt_t make_s32vector(size_t k, int32_t fill) { return pmt_t(new pmt_s32vector(k, fill)); }
+pmt_t make_s32vector(size_t k, int32_t fill) { return make_pmt<pmt_s32vector>(k, fill); }
 
 pmt_t init_s32vector(size_t k, const int32_t* data)
 {
-    return pmt_t(new pmt_s32vector(k, data));
+    return make_pmt<pmt_s32vector>(k, data);
 }
 
 pmt_t init_s32vector(size_t k, const std::vector<int32_t>& data)
 {
     if (k) {
-        return pmt_t(new pmt_s32vector(k, &data[0]));
+        return make_pmt<pmt_s32vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_s32vector(k, static_cast<int32_t>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_s32vector>(k, static_cast<int32_t>(0));
+}
+
+pmt_t make_s32vector_view(size_t k, int32_t* data, std::function<void()> release)
+{
+    return make_pmt<pmt_s32vector>(k, data, std::move(release));
 }
 
 int32_t s32vector_ref(pmt_t vector, size_t k)
@@ -800,6 +860,11 @@ pmt_u64vector::pmt_u64vector(size_t k, const uint64_t* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(uint64_t));
 }
 
+pmt_u64vector::pmt_u64vector(size_t k, uint64_t* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 uint64_t pmt_u64vector::ref(size_t k) const
 {
     if (k >= length())
@@ -842,21 +907,26 @@ bool is_u64vector(pmt_t obj) { return obj->is_u64vector(); }
 
 pmt_t make_u64vector(size_t k, uint64_t fill)
 {
-    return pmt_t(new pmt_u64vector(k, fill));
+    return make_pmt<pmt_u64vector>(k, fill);
 }
 
 pmt_t init_u64vector(size_t k, const uint64_t* data)
 {
-    return pmt_t(new pmt_u64vector(k, data));
+    return make_pmt<pmt_u64vector>(k, data);
 }
 
 pmt_t init_u64vector(size_t k, const std::vector<uint64_t>& data)
 {
     if (k) {
-        return pmt_t(new pmt_u64vector(k, &data[0]));
+        return make_pmt<pmt_u64vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_u64vector(k, static_cast<uint64_t>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_u64vector>(k, static_cast<uint64_t>(0));
+}
+
+pmt_t make_u64vector_view(size_t k, uint64_t* data, std::function<void()> release)
+{
+    return make_pmt<pmt_u64vector>(k, data, std::move(release));
 }
 
 uint64_t u64vector_ref(pmt_t vector, size_t k)
@@ -928,6 +998,11 @@ pmt_s64vector::pmt_s64vector(size_t k, const int64_t* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(int64_t));
 }
 
+pmt_s64vector::pmt_s64vector(size_t k, int64_t* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 int64_t pmt_s64vector::ref(size_t k) const
 {
     if (k >= length())
@@ -968,20 +1043,25 @@ void* pmt_s64vector::uniform_writable_elements(size_t& len)
 
 bool is_s64vector(pmt_t obj) { return obj->is_s64vector(); }
 
-pmt_t make_s64vector(size_t k, int64_t fill) { return pmt_t(new pmt_s64vector(k, fill)); }
+pmt_t make_s64vector(size_t k, int64_t fill) { return make_pmt<pmt_s64vector>(k, fill); }
 
 pmt_t init_s64vector(size_t k, const int64_t* data)
 {
-    return pmt_t(new pmt_s64vector(k, data));
+    return make_pmt<pmt_s64vector>(k, data);
 }
 
 pmt_t init_s64vector(size_t k, const std::vector<int64_t>& data)
 {
     if (k) {
-        return pmt_t(new pmt_s64vector(k, &data[0]));
+        return make_pmt<pmt_s64vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_s64vector(k, static_cast<int64_t>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_s64vector>(k, static_cast<int64_t>(0));
+}
+
+pmt_t make_s64vector_view(size_t k, int64_t* data, std::function<void()> release)
+{
+    return make_pmt<pmt_s64vector>(k, data, std::move(release));
 }
 
 int64_t s64vector_ref(pmt_t vector, size_t k)
@@ -1053,6 +1133,11 @@ pmt_f32vector::pmt_f32vector(size_t k, const float* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(float));
 }
 
+pmt_f32vector::pmt_f32vector(size_t k, float* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 float pmt_f32vector::ref(size_t k) const
 {
     if (k >= length())
@@ -1093,20 +1178,25 @@ void* pmt_f32vector::uniform_writable_elements(size_t& len)
 
 bool is_f32vector(pmt_t obj) { return obj->is_f32vector(); }
 
-pmt_t make_f32vector(size_t k, float fill) { return pmt_t(new pmt_f32vector(k, fill)); }
+pmt_t make_f32vector(size_t k, float fill) { return make_pmt<pmt_f32vector>(k, fill); }
 
 pmt_t init_f32vector(size_t k, const float* data)
 {
-    return pmt_t(new pmt_f32vector(k, data));
+    return make_pmt<pmt_f32vector>(k, data);
 }
 
 pmt_t init_f32vector(size_t k, const std::vector<float>& data)
 {
     if (k) {
-        return pmt_t(new pmt_f32vector(k, &data[0]));
+        return make_pmt<pmt_f32vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_f32vector(k, static_cast<float>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_f32vector>(k, static_cast<float>(0));
+}
+
+pmt_t make_f32vector_view(size_t k, float* data, std::function<void()> release)
+{
+    return make_pmt<pmt_f32vector>(k, data, std::move(release));
 }
 
 float f32vector_ref(pmt_t vector, size_t k)
@@ -1180,6 +1270,11 @@ pmt_f64vector::pmt_f64vector(size_t k, const double* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(double));
 }
 
+pmt_f64vector::pmt_f64vector(size_t k, double* data, std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 double pmt_f64vector::ref(size_t k) const
 {
     if (k >= length())
@@ -1220,20 +1315,25 @@ void* pmt_f64vector::uniform_writable_elements(size_t& len)
 
 bool is_f64vector(pmt_t obj) { return obj->is_f64vector(); }
 
-pmt_t make_f64vector(size_t k, double fill) { return pmt_t(new pmt_f64vector(k, fill)); }
+pmt_t make_f64vector(size_t k, double fill) { return make_pmt<pmt_f64vector>(k, fill); }
 
 pmt_t init_f64vector(size_t k, const double* data)
 {
-    return pmt_t(new pmt_f64vector(k, data));
+    return make_pmt<pmt_f64vector>(k, data);
 }
 
 pmt_t init_f64vector(size_t k, const std::vector<double>& data)
 {
     if (k) {
-        return pmt_t(new pmt_f64vector(k, &data[0]));
+        return make_pmt<pmt_f64vector>(k, &data[0]);
     }
-    return pmt_t(
-        new pmt_f64vector(k, static_cast<double>(0))); // fills an empty vector with 0
+    // fills an empty vector with 0
+    return make_pmt<pmt_f64vector>(k, static_cast<double>(0));
+}
+
+pmt_t make_f64vector_view(size_t k, double* data, std::function<void()> release)
+{
+    return make_pmt<pmt_f64vector>(k, data, std::move(release));
 }
 
 double f64vector_ref(pmt_t vector, size_t k)
@@ -1308,6 +1408,13 @@ pmt_c32vector::pmt_c32vector(size_t k, const std::complex<float>* data) : d_v(k)
         std::memcpy(d_v.data(), data, k * sizeof(std::complex<float>));
 }
 
+pmt_c32vector::pmt_c32vector(size_t k,
+                             std::complex<float>* data,
+                             std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 std::complex<float> pmt_c32vector::ref(size_t k) const
 {
     if (k >= length())
@@ -1350,21 +1457,28 @@ bool is_c32vector(pmt_t obj) { return obj->is_c32vector(); }
 
 pmt_t make_c32vector(size_t k, std::complex<float> fill)
 {
-    return pmt_t(new pmt_c32vector(k, fill));
+    return make_pmt<pmt_c32vector>(k, fill);
 }
 
 pmt_t init_c32vector(size_t k, const std::complex<float>* data)
 {
-    return pmt_t(new pmt_c32vector(k, data));
+    return make_pmt<pmt_c32vector>(k, data);
 }
 
 pmt_t init_c32vector(size_t k, const std::vector<std::complex<float>>& data)
 {
     if (k) {
-        return pmt_t(new pmt_c32vector(k, &data[0]));
+        return make_pmt<pmt_c32vector>(k, &data[0]);
     }
-    return pmt_t(new pmt_c32vector(
-        k, static_cast<std::complex<float>>(0))); // fills an empty vector with 0
+    return make_pmt<pmt_c32vector>(
+        k, static_cast<std::complex<float>>(0)); // fills an empty vector with 0
+}
+
+pmt_t make_c32vector_view(size_t k,
+                          std::complex<float>* data,
+                          std::function<void()> release)
+{
+    return make_pmt<pmt_c32vector>(k, data, std::move(release));
 }
 
 std::complex<float> c32vector_ref(pmt_t vector, size_t k)
@@ -1438,6 +1552,13 @@ pmt_c64vector::pmt_c64vector(size_t k, const std::complex<double>* data) : d_v(k
         std::memcpy(d_v.data(), data, k * sizeof(std::complex<double>));
 }
 
+pmt_c64vector::pmt_c64vector(size_t k,
+                             std::complex<double>* data,
+                             std::function<void()> release)
+    : d_v(k, data, std::move(release))
+{
+}
+
 std::complex<double> pmt_c64vector::ref(size_t k) const
 {
     if (k >= length())
@@ -1480,21 +1601,28 @@ bool is_c64vector(pmt_t obj) { return obj->is_c64vector(); }
 
 pmt_t make_c64vector(size_t k, std::complex<double> fill)
 {
-    return pmt_t(new pmt_c64vector(k, fill));
+    return make_pmt<pmt_c64vector>(k, fill);
 }
 
 pmt_t init_c64vector(size_t k, const std::complex<double>* data)
 {
-    return pmt_t(new pmt_c64vector(k, data));
+    return make_pmt<pmt_c64vector>(k, data);
 }
 
 pmt_t init_c64vector(size_t k, const std::vector<std::complex<double>>& data)
 {
     if (k) {
-        return pmt_t(new pmt_c64vector(k, &data[0]));
+        return make_pmt<pmt_c64vector>(k, &data[0]);
     }
-    return pmt_t(new pmt_c64vector(
-        k, static_cast<std::complex<double>>(0))); // fills an empty vector with 0
+    return make_pmt<pmt_c64vector>(
+        k, static_cast<std::complex<double>>(0)); // fills an empty vector with 0
+}
+
+pmt_t make_c64vector_view(size_t k,
+                          std::complex<double>* data,
+                          std::function<void()> release)
+{
+    return make_pmt<pmt_c64vector>(k, data, std::move(release));
 }
 
 std::complex<double> c64vector_ref(pmt_t vector, size_t k)
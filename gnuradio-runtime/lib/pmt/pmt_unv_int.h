@@ -13,22 +13,56 @@
 
 #include "pmt_int.h"
 
-#include <volk/volk_alloc.hh>
-
 #include <cstdint>
+#include <functional>
 #include <vector>
 
 namespace pmt {
+
+/*
+ * The elements of a uniform vector: its own, or, for a view, storage
+ * owned elsewhere, which is released when the vector goes away.
+ */
+template <typename T>
+class unv_storage
+{
+    pmt_elements<T> d_own;
+    T* d_data;
+    size_t d_size;
+    std::function<void()> d_release;
+
+public:
+    explicit unv_storage(size_t k) : d_own(k), d_data(d_own.data()), d_size(k) {}
+    unv_storage(size_t k, T* data, std::function<void()> release)
+        : d_data(data), d_size(k), d_release(std::move(release))
+    {
+    }
+    ~unv_storage()
+    {
+        if (d_release)
+            d_release();
+    }
+    unv_storage(const unv_storage&) = delete;
+    unv_storage& operator=(const unv_storage&) = delete;
+
+    size_t size() const { return d_size; }
+    T* data() { return d_data; }
+    const T* data() const { return d_data; }
+    T& operator[](size_t k) { return d_data[k]; }
+    const T& operator[](size_t k) const { return d_data[k]; }
+};
+
 ////////////////////////////////////////////////////////////////////////////
 //                           pmt_u8vector
 ////////////////////////////////////////////////////////////////////////////
 class PMT_API pmt_u8vector : public pmt_uniform_vector
 {
-    volk::vector<uint8_t> d_v;
+    unv_storage<uint8_t> d_v;
 
 public:
     pmt_u8vector(size_t k, uint8_t fill);
     pmt_u8vector(size_t k, const uint8_t* data);
+    pmt_u8vector(size_t k, uint8_t* data, std::function<void()> release);
     // ~pmt_u8vector();
 
     bool is_u8vector() const override { return true; }
@@ -49,11 +83,12 @@ public:
 
 class pmt_s8vector : public pmt_uniform_vector
 {
-    volk::vector<int8_t> d_v;
+    unv_storage<int8_t> d_v;
 
 public:
     pmt_s8vector(size_t k, int8_t fill);
     pmt_s8vector(size_t k, const int8_t* data);
+    pmt_s8vector(size_t k, int8_t* data, std::function<void()> release);
     // ~pmt_s8vector();
 
     bool is_s8vector() const override { return true; }
@@ -74,11 +109,12 @@ public:
 
 class pmt_u16vector : public pmt_uniform_vector
 {
-    volk::vector<uint16_t> d_v;
+    unv_storage<uint16_t> d_v;
 
 public:
     pmt_u16vector(size_t k, uint16_t fill);
     pmt_u16vector(size_t k, const uint16_t* data);
+    pmt_u16vector(size_t k, uint16_t* data, std::function<void()> release);
     // ~pmt_u16vector();
 
     bool is_u16vector() const override { return true; }
@@ -99,11 +135,12 @@ public:
 
 class pmt_s16vector : public pmt_uniform_vector
 {
-    volk::vector<int16_t> d_v;
+    unv_storage<int16_t> d_v;
 
 public:
     pmt_s16vector(size_t k, int16_t fill);
     pmt_s16vector(size_t k, const int16_t* data);
+    pmt_s16vector(size_t k, int16_t* data, std::function<void()> release);
     // ~pmt_s16vector();
 
     bool is_s16vector() const override { return true; }
@@ -124,11 +161,12 @@ public:
 
 class pmt_u32vector : public pmt_uniform_vector
 {
-    volk::vector<uint32_t> d_v;
+    unv_storage<uint32_t> d_v;
 
 public:
     pmt_u32vector(size_t k, uint32_t fill);
     pmt_u32vector(size_t k, const uint32_t* data);
+    pmt_u32vector(size_t k, uint32_t* data, std::function<void()> release);
     // ~pmt_u32vector();
 
     bool is_u32vector() const override { return true; }
@@ -149,11 +187,12 @@ public:
 
 class pmt_s32vector : public pmt_uniform_vector
 {
-    volk::vector<int32_t> d_v;
+    unv_storage<int32_t> d_v;
 
 public:
     pmt_s32vector(size_t k, int32_t fill);
     pmt_s32vector(size_t k, const int32_t* data);
+    pmt_s32vector(size_t k, int32_t* data, std::function<void()> release);
     // ~pmt_s32vector();
 
     bool is_s32vector() const override { return true; }
@@ -174,11 +213,12 @@ public:
 
 class pmt_u64vector : public pmt_uniform_vector
 {
-    volk::vector<uint64_t> d_v;
+    unv_storage<uint64_t> d_v;
 
 public:
     pmt_u64vector(size_t k, uint64_t fill);
     pmt_u64vector(size_t k, const uint64_t* data);
+    pmt_u64vector(size_t k, uint64_t* data, std::function<void()> release);
     // ~pmt_u64vector();
 
     bool is_u64vector() const override { return true; }
@@ -199,11 +239,12 @@ public:
 
 class pmt_s64vector : public pmt_uniform_vector
 {
-    volk::vector<int64_t> d_v;
+    unv_storage<int64_t> d_v;
 
 public:
     pmt_s64vector(size_t k, int64_t fill);
     pmt_s64vector(size_t k, const int64_t* data);
+    pmt_s64vector(size_t k, int64_t* data, std::function<void()> release);
     // ~pmt_s64vector();
 
     bool is_s64vector() const override { return true; }
@@ -224,11 +265,12 @@ public:
 
 class pmt_f32vector : public pmt_uniform_vector
 {
-    volk::vector<float> d_v;
+    unv_storage<float> d_v;
 
 public:
     pmt_f32vector(size_t k, float fill);
     pmt_f32vector(size_t k, const float* data);
+    pmt_f32vector(size_t k, float* data, std::function<void()> release);
     // ~pmt_f32vector();
 
     bool is_f32vector() const override { return true; }
@@ -249,11 +291,12 @@ public:
 
 class pmt_f64vector : public pmt_uniform_vector
 {
-    volk::vector<double> d_v;
+    unv_storage<double> d_v;
 
 public:
     pmt_f64vector(size_t k, double fill);
     pmt_f64vector(size_t k, const double* data);
+    pmt_f64vector(size_t k, double* data, std::function<void()> release);
     // ~pmt_f64vector();
 
     bool is_f64vector() const override { return true; }
@@ -274,11 +317,12 @@ public:
 
 class pmt_c32vector : public pmt_uniform_vector
 {
-    volk::vector<std::complex<float>> d_v;
+    unv_storage<std::complex<float>> d_v;
 
 public:
     pmt_c32vector(size_t k, std::complex<float> fill);
     pmt_c32vector(size_t k, const std::complex<float>* data);
+    pmt_c32vector(size_t k, std::complex<float>* data, std::function<void()> release);
     // ~pmt_c32vector();
 
     bool is_c32vector() const override { return true; }
@@ -299,11 +343,12 @@ public:
 
 class pmt_c64vector : public pmt_uniform_vector
 {
-    volk::vector<std::complex<double>> d_v;
+    unv_storage<std::complex<double>> d_v;
 
 public:
     pmt_c64vector(size_t k, std::complex<double> fill);
     pmt_c64vector(size_t k, const std::complex<double>* data);
+    pmt_c64vector(size_t k, std::complex<double>* data, std::function<void()> release);
     // ~pmt_c64vector();
 
     bool is_c64vector() const override { return true; }
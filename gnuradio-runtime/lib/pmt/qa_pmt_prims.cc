@@ -10,9 +10,13 @@
 
 #include <gnuradio/messages/msg_passing.h>
 #include <pmt/api.h> //reason: suppress warnings
+#include <pmt/pmt_pool.h>
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 #include <cstring>
+#include <set>
 #include <sstream>
+#include <thread>
 
 BOOST_AUTO_TEST_CASE(test_symbols)
 {
@@ -81,6 +85,8 @@ BOOST_AUTO_TEST_CASE(test_integers)
     BOOST_CHECK_THROW(pmt::to_long(pmt::PMT_T), pmt::wrong_type);
     BOOST_CHECK_EQUAL(-1L, pmt::to_long(m1));
     BOOST_CHECK_EQUAL(1L, pmt::to_long(p1));
+    for (long i : { -129L, -128L, 0L, 1023L, 1024L })
+        BOOST_CHECK_EQUAL(i, pmt::to_long(pmt::from_long(i)));
 }
 
 BOOST_AUTO_TEST_CASE(test_uint64s)
@@ -115,6 +121,35 @@ BOOST_AUTO_TEST_CASE(test_reals)
     BOOST_CHECK_EQUAL(float(-1.0), pmt::to_float(m2));
     BOOST_CHECK_EQUAL(float(1.0), pmt::to_float(p2));
     BOOST_CHECK_EQUAL(float(1.0), pmt::to_float(pmt::from_long(1)));
+
+    // small integral values are shared, but keep their sign
+    BOOST_CHECK_EQUAL(-3.0, pmt::to_double(pmt::from_double(-3.0)));
+    BOOST_CHECK_EQUAL(1023.5, pmt::to_double(pmt::from_double(1023.5)));
+    BOOST_CHECK(std::signbit(pmt::to_double(pmt::from_double(-0.0))));
+    BOOST_CHECK(!std::signbit(pmt::to_double(pmt::from_double(0.0))));
+    BOOST_CHECK(pmt::eqv(pmt::from_double(-0.0), pmt::from_double(0.0)));
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_small_numbers)
+{
+    // integral values in [-128, 1023] are shared objects, so eq() holds
+    BOOST_CHECK(pmt::eq(pmt::from_long(-128), pmt::from_long(-128)));
+    BOOST_CHECK(pmt::eq(pmt::from_long(1023), pmt::from_long(1023)));
+    BOOST_CHECK(!pmt::eq(pmt::from_long(-129), pmt::from_long(-129)));
+    BOOST_CHECK(!pmt::eq(pmt::from_long(1024), pmt::from_long(1024)));
+    BOOST_CHECK(pmt::eqv(pmt::from_long(1024), pmt::from_long(1024)));
+    BOOST_CHECK(pmt::eq(pmt::from_uint64(7), pmt::from_uint64(7)));
+    BOOST_CHECK(!pmt::eq(pmt::from_uint64(1024), pmt::from_uint64(1024)));
+    BOOST_CHECK(pmt::eq(pmt::from_double(3.0), pmt::from_double(3.0)));
+    BOOST_CHECK(!pmt::eq(pmt::from_double(3.5), pmt::from_double(3.5)));
+    BOOST_CHECK(!pmt::eq(pmt::from_double(-0.0), pmt::from_double(-0.0)));
+    BOOST_CHECK(!pmt::eq(pmt::from_double(-0.0), pmt::from_double(0.0)));
+
+    // each type has its own
+    BOOST_CHECK(!pmt::eq(pmt::from_long(3), pmt::from_uint64(3)));
+    BOOST_CHECK(!pmt::eq(pmt::from_long(3), pmt::from_double(3.0)));
+    BOOST_CHECK(pmt::is_uint64(pmt::from_uint64(3)));
+    BOOST_CHECK(pmt::is_real(pmt::from_double(3.0)));
 }
 
 BOOST_AUTO_TEST_CASE(test_complexes)
@@ -391,6 +426,112 @@ BOOST_AUTO_TEST_CASE(test_dict)
     BOOST_CHECK(pmt::is_dict(dict));
 }
 
+BOOST_AUTO_TEST_CASE(test_hash_dict)
+{
+    pmt::pmt_t k0 = pmt::mp("k0");
+    pmt::pmt_t k1 = pmt::mp("k1");
+    pmt::pmt_t k2 = pmt::mp("k2");
+    pmt::pmt_t v0 = pmt::mp("v0");
+    pmt::pmt_t v1 = pmt::mp("v1");
+    pmt::pmt_t v2 = pmt::mp("v2");
+    pmt::pmt_t v3 = pmt::mp("v3");
+    pmt::pmt_t not_found = pmt::cons(pmt::PMT_NIL, pmt::PMT_NIL);
+
+    // same keys, same order as the a-list dict_add builds
+    pmt::pmt_t alist = pmt::make_dict();
+    alist = pmt::dict_add(alist, k0, v0);
+    alist = pmt::dict_add(alist, k1, v1);
+    alist = pmt::dict_add(alist, k2, v2);
+    alist = pmt::dict_add(alist, k1, v3);
+    pmt::pmt_t dict =
+        pmt::dict_builder(3).add(k0, v0).add(k1, v1).add(k2, v2).add(k1, v3).build();
+    BOOST_CHECK(pmt::is_dict(dict));
+    BOOST_CHECK(!pmt::is_pair(dict));
+    BOOST_CHECK_EQUAL(pmt::length(dict), 3U);
+    BOOST_CHECK(pmt::equal(pmt::dict_keys(dict), pmt::list3(k1, k2, k0)));
+    BOOST_CHECK(pmt::equal(pmt::dict_values(dict), pmt::list3(v3, v2, v0)));
+    BOOST_CHECK(pmt::equal(pmt::dict_items(dict), alist));
+    BOOST_CHECK(pmt::equal(dict, alist));
+    BOOST_CHECK(pmt::equal(alist, dict));
+    BOOST_CHECK_EQUAL(pmt::write_string(dict), pmt::write_string(alist));
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(dict, k1, not_found), v3));
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(dict, v0, not_found), not_found));
+
+    // numbers are looked up by value
+    pmt::pmt_t nums = pmt::dict_builder()
+                          .add(pmt::from_long(7), v0)
+                          .add(pmt::from_double(-0.0), v1)
+                          .add(pmt::from_uint64(7), v2)
+                          .build();
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(nums, pmt::from_long(7), not_found), v0));
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(nums, pmt::from_double(0.0), not_found), v1));
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(nums, pmt::from_uint64(7), not_found), v2));
+    BOOST_CHECK(!pmt::dict_has_key(nums, pmt::from_double(7)));
+
+    // updates leave the original alone
+    pmt::pmt_t added = pmt::dict_add(dict, k0, v1);
+    pmt::pmt_t deleted = pmt::dict_delete(dict, k2);
+    BOOST_CHECK(pmt::equal(pmt::dict_keys(added), pmt::list3(k0, k1, k2)));
+    BOOST_CHECK(pmt::equal(pmt::dict_keys(deleted), pmt::list2(k1, k0)));
+    BOOST_CHECK(pmt::equal(dict, alist));
+    BOOST_CHECK(pmt::eq(pmt::dict_delete(dict, v0), dict));
+
+    // unless nobody else can see them
+    pmt::pmt_t shared = dict;
+    BOOST_CHECK(pmt::dict_add(std::move(shared), k0, v3) != dict);
+    BOOST_CHECK(pmt::equal(dict, alist));
+    pmt::pmt_t unique = pmt::dict_builder(2).add(k0, v0).build();
+    const pmt::pmt_base* p = unique.get();
+    unique = pmt::dict_add(std::move(unique), k1, v1);
+    BOOST_CHECK_EQUAL(unique.get(), p);
+    pmt::pmt_t grown = pmt::dict_builder(1).build();
+    for (long i = 0; i < 100; i++) {
+        grown = pmt::dict_add(std::move(grown), pmt::from_long(i), pmt::from_long(i));
+        grown =
+            pmt::dict_add(std::move(grown), pmt::from_long(i / 2), pmt::from_long(-i));
+    }
+    BOOST_CHECK_EQUAL(pmt::length(grown), 100U);
+    BOOST_CHECK_EQUAL(pmt::to_long(pmt::dict_ref(grown, pmt::from_long(49), pmt::PMT_F)),
+                      -99);
+    BOOST_CHECK_EQUAL(pmt::to_long(pmt::dict_ref(grown, pmt::from_long(99), pmt::PMT_F)),
+                      99);
+
+    pmt::pmt_t update = pmt::dict_update(alist, nums);
+    BOOST_CHECK_EQUAL(pmt::length(update), 6U);
+    BOOST_CHECK(pmt::eqv(pmt::dict_ref(update, pmt::from_uint64(7), not_found), v2));
+
+    // written as the a-list and read back as one, which car, cdr and nth walk
+    std::stringbuf sb, sb_alist;
+    pmt::serialize(dict, sb);
+    pmt::serialize(alist, sb_alist);
+    BOOST_CHECK_EQUAL(sb.str(), sb_alist.str());
+    pmt::pmt_t read = pmt::deserialize(sb);
+    BOOST_CHECK(pmt::is_dict(read));
+    BOOST_CHECK(pmt::is_pair(read));
+    BOOST_CHECK(pmt::equal(read, alist));
+    BOOST_REQUIRE_EQUAL(pmt::length(read), pmt::length(dict));
+    for (size_t i = 0; i < pmt::length(read); i++) {
+        const pmt::pmt_t item = pmt::nth(i, read);
+        BOOST_CHECK(pmt::equal(pmt::car(item), pmt::nth(i, pmt::dict_keys(dict))));
+        BOOST_CHECK(
+            pmt::equal(pmt::cdr(item), pmt::dict_ref(dict, pmt::car(item), not_found)));
+    }
+    pmt::pmt_t first = pmt::car(pmt::deserialize_str(pmt::serialize_str(dict)));
+    BOOST_CHECK(pmt::equal(first, pmt::car(alist)));
+
+    std::vector<std::pair<pmt::pmt_t, pmt::pmt_t>> mapping{ { k0, v0 }, { k1, v1 } };
+    pmt::pmt_t mapped = pmt::dict_from_mapping(mapping);
+    BOOST_CHECK(pmt::is_pair(mapped));
+    BOOST_CHECK_EQUAL(pmt::length(mapped), 2U);
+    BOOST_CHECK(pmt::equal(pmt::nth(1, mapped), pmt::cons(k0, v0)));
+    mapping.clear();
+    BOOST_CHECK(pmt::eq(pmt::dict_from_mapping(mapping), pmt::PMT_NIL));
+
+    BOOST_CHECK_THROW(pmt::dcons(pmt::cons(k0, v0), dict), pmt::wrong_type);
+    BOOST_CHECK(pmt::is_dict(pmt::reverse(dict)));
+    BOOST_CHECK(pmt::equal(pmt::dict_keys(pmt::reverse(dict)), pmt::list3(k0, k2, k1)));
+}
+
 BOOST_AUTO_TEST_CASE(test_pdu)
 {
     pmt::pmt_t dict = pmt::dict_add(pmt::make_dict(), pmt::mp("k0"), pmt::mp("v0"));
@@ -593,3 +734,90 @@ BOOST_AUTO_TEST_CASE(test_sugar)
     BOOST_CHECK_EQUAL(sizeof(buf), nbytes);
     BOOST_CHECK(memcmp(buf, data, nbytes) == 0);
 }
+
+BOOST_AUTO_TEST_CASE(test_views)
+{
+    uint8_t bytes[5] = { 1, 2, 3, 4, 5 };
+    int released = 0;
+    pmt::pmt_t blob = pmt::make_blob_view(bytes + 1, 3, [&]() { released++; });
+    BOOST_CHECK(pmt::is_blob(blob));
+    BOOST_CHECK_EQUAL(bytes + 1, pmt::blob_data(blob));
+    BOOST_CHECK_EQUAL(3U, pmt::blob_length(blob));
+    BOOST_CHECK(pmt::equal(blob, pmt::make_blob(bytes + 1, 3)));
+
+    pmt::pmt_t copy = pmt::deserialize_str(pmt::serialize_str(blob));
+    pmt::pmt_t pdu = pmt::cons(pmt::PMT_NIL, blob);
+    blob = pmt::PMT_NIL;
+    BOOST_CHECK_EQUAL(0, released);
+    pdu = pmt::PMT_NIL;
+    BOOST_CHECK_EQUAL(1, released);
+    BOOST_CHECK(pmt::equal(copy, pmt::make_blob(bytes + 1, 3)));
+
+    std::vector<std::complex<float>> taps(4, std::complex<float>(1, -1));
+    pmt::pmt_t v =
+        pmt::make_c32vector_view(taps.size(), taps.data(), [&]() { released++; });
+    BOOST_CHECK(pmt::is_c32vector(v));
+    BOOST_CHECK_EQUAL(4U, pmt::length(v));
+    pmt::c32vector_set(v, 2, std::complex<float>(0, 2));
+    BOOST_CHECK_EQUAL(std::complex<float>(0, 2), taps[2]);
+    size_t len;
+    BOOST_CHECK_EQUAL(taps.data(), pmt::c32vector_elements(v, len));
+    BOOST_CHECK_EQUAL(4U, len);
+    BOOST_CHECK_THROW(pmt::c32vector_ref(v, 4), pmt::out_of_range);
+    v.reset();
+    BOOST_CHECK_EQUAL(2, released);
+}
+
+BOOST_AUTO_TEST_CASE(test_pool)
+{
+    pmt::pmt_pool pool(24, 16, 4096);
+    const size_t N = 5000;
+    std::vector<void*> items(N);
+
+    // one thread allocates, another frees
+    std::thread producer([&]() {
+        for (size_t i = 0; i < N; i++) {
+            items[i] = pool.malloc();
+            std::memset(items[i], 0xa5, 24);
+        }
+    });
+    producer.join();
+    std::set<void*> distinct(items.begin(), items.end());
+    BOOST_CHECK_EQUAL(N, distinct.size());
+    for (void* p : items)
+        BOOST_CHECK_EQUAL(0U, reinterpret_cast<uintptr_t>(p) % 16);
+    std::thread consumer([&]() {
+        for (void* p : items)
+            pool.free(p);
+    });
+    consumer.join();
+
+    // threads report their counts and give their items back as they exit
+    pmt::pmt_pool::stats s = pool.get_stats();
+    BOOST_CHECK_EQUAL(32U, s.itemsize);
+    BOOST_CHECK_EQUAL(N, s.mallocs);
+    BOOST_CHECK_EQUAL(N, s.frees);
+    BOOST_CHECK_EQUAL(s.items, s.in_depot);
+    BOOST_CHECK(s.items >= N);
+    BOOST_CHECK(s.handbacks > 0);
+
+    // the items are used again rather than new chunks
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&]() {
+            for (int round = 0; round < 100; round++) {
+                std::vector<void*> mine(N / 4);
+                for (void*& p : mine)
+                    p = pool.malloc();
+                for (void* p : mine)
+                    pool.free(p);
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    BOOST_CHECK_EQUAL(s.chunks, pool.get_stats().chunks);
+    BOOST_CHECK_EQUAL(pool.get_stats().mallocs, pool.get_stats().frees);
+
+    BOOST_CHECK(!pmt::pool_stats().empty());
+}
@@ -0,0 +1,267 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/block.h>
+#include <gnuradio/msg_port_queue.h>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static std::vector<long> pop_all(gr::msg_port_queue& q)
+{
+    std::vector<long> result;
+    pmt::pmt_t msgs[4];
+    size_t n;
+    while ((n = q.pop(msgs, 4)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            result.push_back(pmt::to_long(msgs[i]));
+        }
+    }
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(t0_fifo)
+{
+    gr::msg_port_queue q(pmt::mp("in"), 6, gr::msg_port_queue::OVERFLOW_COUNT);
+    BOOST_CHECK_EQUAL(q.capacity(), 8U);
+    BOOST_CHECK(q.empty());
+    BOOST_CHECK(!q.pop());
+
+    // wrap around the ring a few times
+    long next = 0;
+    for (int lap = 0; lap < 5; lap++) {
+        for (int i = 0; i < 7; i++) {
+            BOOST_CHECK(q.push(pmt::from_long(next++)));
+        }
+        BOOST_CHECK_EQUAL(q.size(), 7U);
+        BOOST_CHECK_EQUAL(pmt::to_long(q.pop()), next - 7);
+        std::vector<long> rest = pop_all(q);
+        BOOST_REQUIRE_EQUAL(rest.size(), 6U);
+        for (size_t i = 0; i < rest.size(); i++) {
+            BOOST_CHECK_EQUAL(rest[i], next - 6 + long(i));
+        }
+        BOOST_CHECK(q.empty());
+    }
+    BOOST_CHECK_EQUAL(q.dropped(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(t1_overflow)
+{
+    gr::msg_port_queue count(pmt::mp("in"), 4, gr::msg_port_queue::OVERFLOW_COUNT);
+    gr::msg_port_queue oldest(pmt::mp("in"), 4, gr::msg_port_queue::OVERFLOW_DROP_OLDEST);
+    for (long i = 0; i < 10; i++) {
+        BOOST_CHECK_EQUAL(count.push(pmt::from_long(i)), i < 4);
+        BOOST_CHECK(oldest.push(pmt::from_long(i)));
+    }
+    BOOST_CHECK_EQUAL(count.dropped(), 6U);
+    BOOST_CHECK_EQUAL(oldest.dropped(), 6U);
+    BOOST_CHECK(pop_all(count) == std::vector<long>({ 0, 1, 2, 3 }));
+    BOOST_CHECK(pop_all(oldest) == std::vector<long>({ 6, 7, 8, 9 }));
+    BOOST_CHECK_EQUAL(oldest.take_dropped(), 6U);
+    BOOST_CHECK_EQUAL(oldest.take_dropped(), 0U);
+
+    // shrinking keeps the newest messages
+    for (long i = 0; i < 4; i++) {
+        oldest.push(pmt::from_long(i));
+    }
+    oldest.configure(2, gr::msg_port_queue::OVERFLOW_COUNT);
+    BOOST_CHECK_EQUAL(oldest.capacity(), 2U);
+    BOOST_CHECK_EQUAL(oldest.policy(), gr::msg_port_queue::OVERFLOW_COUNT);
+    BOOST_CHECK_EQUAL(oldest.take_dropped(), 2U);
+    BOOST_CHECK(pop_all(oldest) == std::vector<long>({ 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(t2_block)
+{
+    gr::msg_port_queue q(pmt::mp("in"), 2, gr::msg_port_queue::OVERFLOW_BLOCK);
+    q.push(pmt::from_long(0));
+    q.push(pmt::from_long(1));
+
+    std::atomic<bool> pushed(false);
+    std::thread producer([&]() {
+        q.push(pmt::from_long(2));
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK(!pushed);
+
+    BOOST_CHECK_EQUAL(pmt::to_long(q.pop()), 0);
+    producer.join();
+    BOOST_CHECK(pushed);
+    BOOST_CHECK(pop_all(q) == std::vector<long>({ 1, 2 }));
+    BOOST_CHECK_EQUAL(q.dropped(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(t3_producers)
+{
+    // Each producer's messages arrive complete and in order.
+    const int nproducers = 4;
+    const long per_producer = 100000;
+    gr::msg_port_queue q(pmt::mp("in"), 64, gr::msg_port_queue::OVERFLOW_BLOCK);
+
+    std::vector<std::thread> producers;
+    for (long p = 0; p < nproducers; p++) {
+        producers.emplace_back([&q, p]() {
+            for (long i = 0; i < per_producer; i++) {
+                q.push(pmt::cons(pmt::from_long(p), pmt::from_long(i)));
+            }
+        });
+    }
+
+    std::vector<long> next(nproducers, 0);
+    long received = 0;
+    bool in_order = true;
+    pmt::pmt_t msgs[16];
+    while (received < nproducers * per_producer) {
+        const size_t n = q.pop(msgs, 16);
+        for (size_t i = 0; i < n; i++) {
+            const long p = pmt::to_long(pmt::car(msgs[i]));
+            in_order &= pmt::to_long(pmt::cdr(msgs[i])) == next[p]++;
+        }
+        received += n;
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    BOOST_CHECK(in_order);
+    BOOST_CHECK(q.empty());
+}
+
+BOOST_AUTO_TEST_CASE(t5_growth)
+{
+    // The ring starts small and grows when messages back up.
+    gr::msg_port_queue q(pmt::mp("in"), 8192, gr::msg_port_queue::OVERFLOW_COUNT);
+    BOOST_CHECK_EQUAL(q.capacity(), 8192U);
+    BOOST_CHECK_EQUAL(q.slots(), 32U);
+    for (long i = 0; i < 100; i++) {
+        BOOST_CHECK(q.push(pmt::from_long(i)));
+    }
+    BOOST_CHECK_EQUAL(q.size(), 100U);
+    BOOST_CHECK_EQUAL(q.slots(), 32U);
+    std::vector<long> expected(100);
+    for (long i = 0; i < 100; i++) {
+        expected[i] = i;
+    }
+    BOOST_CHECK(pop_all(q) == expected);
+    BOOST_CHECK_EQUAL(q.slots(), 128U);
+    BOOST_CHECK(q.empty());
+
+    // spilled messages count toward the capacity
+    gr::msg_port_queue count(pmt::mp("in"), 64, gr::msg_port_queue::OVERFLOW_COUNT);
+    gr::msg_port_queue oldest(pmt::mp("in"), 64, gr::msg_port_queue::OVERFLOW_DROP_OLDEST);
+    for (long i = 0; i < 70; i++) {
+        BOOST_CHECK_EQUAL(count.push(pmt::from_long(i)), i < 64);
+        BOOST_CHECK(oldest.push(pmt::from_long(i)));
+    }
+    BOOST_CHECK_EQUAL(count.size(), 64U);
+    BOOST_CHECK_EQUAL(oldest.dropped(), 6U);
+    expected.resize(64);
+    BOOST_CHECK(pop_all(count) == expected);
+    for (long i = 0; i < 64; i++) {
+        expected[i] = i + 6;
+    }
+    BOOST_CHECK(pop_all(oldest) == expected);
+    BOOST_CHECK_EQUAL(oldest.slots(), 64U);
+}
+
+BOOST_AUTO_TEST_CASE(t6_growing_producers)
+{
+    // Messages stay in order per producer while the ring grows under them.
+    const int nproducers = 4;
+    const long per_producer = 20000;
+    gr::msg_port_queue q(pmt::mp("in"), 1 << 17, gr::msg_port_queue::OVERFLOW_COUNT);
+
+    std::vector<std::thread> producers;
+    for (long p = 0; p < nproducers; p++) {
+        producers.emplace_back([&q, p]() {
+            for (long i = 0; i < per_producer; i++) {
+                q.push(pmt::cons(pmt::from_long(p), pmt::from_long(i)));
+            }
+        });
+    }
+
+    std::vector<long> next(nproducers, 0);
+    long received = 0;
+    bool in_order = true;
+    pmt::pmt_t msgs[16];
+    while (received < nproducers * per_producer) {
+        const size_t n = q.pop(msgs, 16);
+        for (size_t i = 0; i < n; i++) {
+            const long p = pmt::to_long(pmt::car(msgs[i]));
+            in_order &= pmt::to_long(pmt::cdr(msgs[i])) == next[p]++;
+        }
+        received += n;
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    BOOST_CHECK(in_order);
+    BOOST_CHECK_EQUAL(q.dropped(), 0U);
+    BOOST_CHECK(q.empty());
+}
+
+namespace {
+
+class msg_block : public gr::block
+{
+public:
+    msg_block() : gr::block("msg_block", gr::io_signature::make(0, 0, 0),
+                            gr::io_signature::make(0, 0, 0))
+    {
+        message_port_register_in(pmt::mp("in"));
+        message_port_register_out(pmt::mp("out"));
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t4_block_ports)
+{
+    auto src = gnuradio::make_block_sptr<msg_block>();
+    auto dst = gnuradio::make_block_sptr<msg_block>();
+
+    // the system port comes first
+    BOOST_CHECK_EQUAL(dst->msg_port_index(pmt::mp("system")), 0);
+    BOOST_CHECK_EQUAL(dst->msg_port_index(pmt::mp("in")), 1);
+    BOOST_CHECK_EQUAL(dst->msg_port_index(pmt::mp("out")), -1);
+    BOOST_CHECK_THROW(dst->nmsgs(pmt::mp("nope")), std::runtime_error);
+
+    const pmt::pmt_t target = pmt::cons(dst->alias_pmt(), pmt::mp("in"));
+    src->message_port_sub(pmt::mp("out"), target);
+    src->message_port_sub(pmt::mp("out"), target);
+    for (long i = 0; i < 3; i++) {
+        src->message_port_pub(pmt::mp("out"), pmt::from_long(i));
+    }
+    BOOST_CHECK_EQUAL(dst->nmsgs(pmt::mp("in")), 3U);
+    BOOST_CHECK_EQUAL(pmt::to_long(dst->delete_head_nowait(pmt::mp("in"))), 0);
+
+    dst->set_msg_port_overflow(pmt::mp("in"), gr::msg_port_queue::OVERFLOW_COUNT, 2);
+    src->message_port_pub(pmt::mp("out"), pmt::from_long(3));
+    BOOST_CHECK_EQUAL(dst->nmsgs(pmt::mp("in")), 2U);
+    BOOST_CHECK_EQUAL(dst->nmsgs_dropped(pmt::mp("in")), 1U);
+
+    src->message_port_unsub(pmt::mp("out"), target);
+    src->message_port_pub(pmt::mp("out"), pmt::from_long(4));
+    BOOST_CHECK_EQUAL(pmt::to_long(dst->delete_head_nowait(pmt::mp("in"))), 1);
+    BOOST_CHECK_EQUAL(pmt::to_long(dst->delete_head_nowait(pmt::mp("in"))), 2);
+    BOOST_CHECK(dst->empty_p());
+}
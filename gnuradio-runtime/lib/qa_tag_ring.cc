@@ -0,0 +1,219 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/buffer.h>
+#include <gnuradio/buffer_double_mapped.h>
+#include <gnuradio/buffer_reader.h>
+#include <gnuradio/tag_ring.h>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+static gr::tag_t make_tag(uint64_t offset, long value)
+{
+    gr::tag_t tag;
+    tag.offset = offset;
+    tag.key = pmt::mp("key");
+    tag.value = pmt::from_long(value);
+    return tag;
+}
+
+static std::vector<uint64_t> offsets(gr::tag_ring::view v)
+{
+    std::vector<uint64_t> result;
+    for (const auto& tag : v) {
+        result.push_back(tag.offset);
+    }
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(t0_in_order)
+{
+    gr::tag_ring ring;
+    BOOST_CHECK(ring.empty());
+    BOOST_CHECK_EQUAL(ring.capacity(), 0U);
+
+    for (uint64_t i = 0; i < 100; i++) {
+        ring.add(make_tag(10 * i, i));
+    }
+    BOOST_CHECK_EQUAL(ring.size(), 100U);
+    BOOST_CHECK_EQUAL(ring.capacity(), 128U);
+
+    BOOST_CHECK_EQUAL(ring.lower_bound(0), 0U);
+    BOOST_CHECK_EQUAL(ring.lower_bound(15), 2U);
+    BOOST_CHECK_EQUAL(ring.upper_bound(20), 3U);
+    BOOST_CHECK_EQUAL(ring.lower_bound(991), 100U);
+
+    auto v = ring.range(15, 45);
+    std::vector<uint64_t> expected{ 20, 30, 40 };
+    BOOST_CHECK(offsets(v) == expected);
+    BOOST_CHECK_EQUAL(pmt::to_long(v[1].value), 3);
+    BOOST_CHECK(ring.range(45, 15).empty());
+    BOOST_CHECK(ring.range(2000, 3000).empty());
+}
+
+BOOST_AUTO_TEST_CASE(t1_out_of_order)
+{
+    gr::tag_ring ring;
+    ring.add(make_tag(10, 0));
+    ring.add(make_tag(30, 1));
+    ring.add(make_tag(20, 2));
+    ring.add(make_tag(20, 3));
+    ring.add(make_tag(5, 4));
+
+    std::vector<uint64_t> expected{ 5, 10, 20, 20, 30 };
+    BOOST_CHECK(offsets(ring.range(0, 100)) == expected);
+
+    // tags with the same offset keep the order they were added in
+    auto v = ring.range(20, 21);
+    BOOST_REQUIRE_EQUAL(v.size(), 2U);
+    BOOST_CHECK_EQUAL(pmt::to_long(v[0].value), 2);
+    BOOST_CHECK_EQUAL(pmt::to_long(v[1].value), 3);
+}
+
+BOOST_AUTO_TEST_CASE(t2_prune_and_wrap)
+{
+    gr::tag_ring ring;
+    uint64_t next = 0;
+    for (int i = 0; i < 12; i++) {
+        ring.add(make_tag(next++, 0));
+    }
+    ring[11].marked_deleted.push_back(7);
+
+    BOOST_CHECK_EQUAL(ring.prune(8), 8U);
+    BOOST_CHECK_EQUAL(ring.size(), 4U);
+    BOOST_CHECK_EQUAL(ring[0].offset, 8U);
+    BOOST_CHECK_EQUAL(ring.prune(8), 0U);
+
+    // wrap around the end of the slots without growing
+    for (int i = 0; i < 12; i++) {
+        ring.add(make_tag(next++, 0));
+    }
+    BOOST_CHECK_EQUAL(ring.capacity(), 16U);
+    BOOST_CHECK_EQUAL(ring.size(), 16U);
+    for (size_t i = 0; i < ring.size(); i++) {
+        BOOST_CHECK_EQUAL(ring[i].offset, 8 + i);
+    }
+    BOOST_CHECK_EQUAL(ring[3].marked_deleted.size(), 1U);
+
+    // and grow while wrapped
+    ring.add(make_tag(next++, 0));
+    BOOST_CHECK_EQUAL(ring.capacity(), 32U);
+    BOOST_CHECK_EQUAL(ring.range(0, 100).size(), 17U);
+    BOOST_CHECK_EQUAL(ring[3].marked_deleted.size(), 1U);
+
+    // slots reused after a prune do not inherit marks
+    ring.prune(next);
+    BOOST_CHECK(ring.empty());
+    for (int i = 0; i < 32; i++) {
+        ring.add(make_tag(next++, 0));
+        BOOST_CHECK(ring[ring.size() - 1].marked_deleted.empty());
+    }
+
+    ring.clear();
+    BOOST_CHECK(ring.empty());
+}
+
+BOOST_AUTO_TEST_CASE(t3_take)
+{
+    gr::tag_ring ring;
+    ring.reserve(20);
+    BOOST_CHECK_EQUAL(ring.capacity(), 32U);
+
+    auto tag = make_tag(40, 7);
+    const pmt::pmt_t value = tag.value;
+    ring.take(tag);
+    BOOST_CHECK_EQUAL(tag.offset, 40U);
+    BOOST_CHECK(tag.value != value);
+
+    auto late = make_tag(30, 8);
+    ring.take(late);
+    BOOST_REQUIRE_EQUAL(ring.size(), 2U);
+    BOOST_CHECK_EQUAL(ring[0].offset, 30U);
+    BOOST_CHECK_EQUAL(pmt::to_long(ring[0].value), 8);
+    BOOST_CHECK(ring[1].value == value);
+    BOOST_CHECK_EQUAL(ring.capacity(), 32U);
+}
+
+BOOST_AUTO_TEST_CASE(t4_buffer_reader)
+{
+    const int nitems = 4096 / sizeof(int);
+    gr::buffer_sptr buf(gr::buffer_double_mapped::make_buffer(
+        nitems, sizeof(int), nitems, 1, gr::block_sptr()));
+    gr::buffer_reader_sptr r0(gr::buffer_add_reader(buf, 0, gr::block_sptr()));
+    gr::buffer_reader_sptr r1(gr::buffer_add_reader(buf, 0, gr::block_sptr(), 4));
+
+    std::vector<gr::tag_t> added;
+    for (uint64_t i = 0; i < 10; i++) {
+        added.push_back(make_tag(i * 10, i));
+        buf->add_item_tag(added.back());
+    }
+    buf->remove_item_tag(added[2], 1);
+
+    std::vector<gr::tag_t> tags;
+    r0->get_tags_in_range(tags, 10, 40, 1);
+    BOOST_REQUIRE_EQUAL(tags.size(), 2U);
+    BOOST_CHECK_EQUAL(tags[0].offset, 10U);
+    BOOST_CHECK_EQUAL(tags[1].offset, 30U);
+    BOOST_CHECK(tags[0].marked_deleted.empty());
+
+    // another block still sees the removed tag
+    r0->get_tags_in_range(tags, 10, 40, 2);
+    BOOST_CHECK_EQUAL(tags.size(), 3U);
+
+    // the delayed reader sees every tag 4 items later
+    r1->get_tags_in_range(tags, 0, 25, 1);
+    BOOST_REQUIRE_EQUAL(tags.size(), 2U);
+    BOOST_CHECK_EQUAL(tags[0].offset, 4U);
+    BOOST_CHECK_EQUAL(tags[1].offset, 14U);
+    r1->get_tags_in_range(tags, 0, 4, 1);
+    BOOST_CHECK(tags.empty());
+
+    {
+        gr::thread::scoped_lock guard(*buf->mutex());
+        auto v = r1->tags_in_range(0, 25);
+        BOOST_REQUIRE_EQUAL(v.size(), 3U);
+        BOOST_CHECK_EQUAL(v[2].offset, 20U);
+        BOOST_CHECK_EQUAL(v[2].marked_deleted.size(), 1U);
+    }
+
+    // tags are kept for the delay and a whole buffer behind max_time
+    gr::thread::scoped_lock guard(*buf->mutex());
+    buf->prune_tags(4 + buf->bufsize() + 25);
+    BOOST_CHECK_EQUAL(buf->get_tags_end() - buf->get_tags_begin(), 7);
+    BOOST_CHECK_EQUAL(buf->get_tags_begin()->offset, 30U);
+}
+
+BOOST_AUTO_TEST_CASE(t5_buffer_batches)
+{
+    const int nitems = 4096 / sizeof(int);
+    gr::buffer_sptr buf(gr::buffer_double_mapped::make_buffer(
+        nitems, sizeof(int), nitems, 1, gr::block_sptr()));
+    gr::buffer_reader_sptr r0(gr::buffer_add_reader(buf, 0, gr::block_sptr()));
+
+    std::vector<gr::tag_t> batch{ make_tag(5, 0), make_tag(15, 1) };
+    buf->add_item_tags(batch);
+    BOOST_CHECK_EQUAL(pmt::to_long(batch[1].value), 1);
+
+    std::vector<gr::tag_t> late{ make_tag(10, 2), make_tag(20, 3) };
+    buf->move_item_tags(late);
+
+    std::vector<gr::tag_t> tags;
+    r0->get_tags_in_range(tags, 0, 100, 1);
+    BOOST_REQUIRE_EQUAL(tags.size(), 4U);
+    for (size_t i = 0; i < tags.size(); i++) {
+        BOOST_CHECK_EQUAL(tags[i].offset, 5 * (i + 1));
+    }
+    BOOST_CHECK_EQUAL(pmt::to_long(tags[1].value), 2);
+    BOOST_CHECK_EQUAL(pmt::to_long(tags[3].value), 3);
+}
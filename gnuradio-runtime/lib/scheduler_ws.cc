@@ -0,0 +1,443 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "scheduler_ws.h"
+#include <gnuradio/block_detail.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/thread/thread_body_wrapper.h>
+#include <pmt/pmt.h>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <thread>
+
+namespace gr {
+
+namespace {
+
+enum task_state {
+    TASK_IDLE,          // parked; waiting to be woken by a neighbor
+    TASK_QUEUED,        // sitting in some worker's deque
+    TASK_RUNNING,       // being executed by a worker
+    TASK_RUNNING_DIRTY, // being executed, and woken meanwhile
+    TASK_DONE,          // retired; never scheduled again
+};
+
+// Which scheduler and worker (if any) the calling thread belongs to.
+// Tasks woken from one of our own workers go onto that worker's deque.
+struct ws_thread_context {
+    const void* sched = nullptr;
+    size_t index = 0;
+};
+thread_local ws_thread_context t_context;
+
+// Maximum number of consecutive iterations a task runs before it goes
+// back to a deque.
+constexpr int max_iterations = 16;
+
+int64_t ws_now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+struct scheduler_ws::task {
+    block_sptr block;
+    std::optional<block_executor> exec;
+    std::atomic<int> state;
+    std::atomic<int64_t> deadline; // steady clock [ns] to re-poll at; 0 if none
+
+    task(block_sptr blk, int max_noutput_items)
+        : block(blk), state(TASK_QUEUED), deadline(0)
+    {
+        exec.emplace(blk, max_noutput_items);
+    }
+};
+
+struct scheduler_ws::worker {
+    gr::thread::mutex mutex; // protects tasks
+    std::deque<task*> tasks;
+};
+
+scheduler_sptr
+scheduler_ws::make(flat_flowgraph_sptr ffg, int max_noutput_items, bool catch_exceptions)
+{
+    return scheduler_sptr(new scheduler_ws(ffg, max_noutput_items, catch_exceptions));
+}
+
+scheduler_ws::scheduler_ws(flat_flowgraph_sptr ffg,
+                           int max_noutput_items,
+                           bool catch_exceptions)
+    : scheduler(ffg, max_noutput_items, catch_exceptions),
+      d_catch_exceptions(catch_exceptions),
+      d_stop(false),
+      d_nretired(0),
+      d_nqueued(0),
+      d_nsleeping(0),
+      d_next_inject(0),
+      d_released(false)
+{
+    gr::configure_default_loggers(d_logger, d_debug_logger, "scheduler_ws");
+
+    prefs* p = prefs::singleton();
+    long nthreads = p->get_long("Scheduler", "ws_nthreads", 0);
+    if (nthreads <= 0) {
+        nthreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    basic_block_vector_t used_blocks = ffg->calc_used_blocks();
+    used_blocks = ffg->topological_sort(used_blocks);
+    block_vector_t blocks = flat_flowgraph::make_block_vector(used_blocks);
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        blocks[i]->detail()->set_done(false);
+    }
+
+    // No point in having more workers than there are blocks to run.
+    nthreads = std::min<long>(nthreads, blocks.size());
+    for (long i = 0; i < nthreads; i++) {
+        d_workers.emplace_back(std::make_unique<worker>());
+    }
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        int block_max_noutput_items = max_noutput_items;
+        // If set, use internal value instead of global value
+        if (blocks[i]->is_set_max_noutput_items()) {
+            block_max_noutput_items = blocks[i]->max_noutput_items();
+        }
+        if (!blocks[i]->processor_affinity().empty() ||
+            blocks[i]->thread_priority() > 0) {
+            d_logger->debug("{:s}: thread affinity and priority are ignored by the "
+                            "work-stealing scheduler",
+                            blocks[i]->identifier());
+        }
+
+        blocks[i]->clear_finished();
+        d_tasks.emplace_back(std::make_unique<task>(blocks[i], block_max_noutput_items));
+    }
+
+    for (size_t i = 0; i < d_tasks.size(); i++) {
+        task* t = d_tasks[i].get();
+        t->block->detail()->d_tpb.set_wakeup([this, t]() { wake(t); });
+
+        // Spread the initial tasks round-robin over the workers.
+        d_workers[i % d_workers.size()]->tasks.push_back(t);
+        d_nqueued++;
+    }
+
+    d_logger->debug("running {:d} blocks on {:d} workers", d_tasks.size(), nthreads);
+
+    for (size_t i = 0; i < d_workers.size(); i++) {
+        auto body = [this, i]() { worker_main(i); };
+        d_threads.create_thread(thread::thread_body_wrapper<decltype(body)>(
+            body, "work-stealing[" + std::to_string(i) + "]", catch_exceptions));
+    }
+}
+
+scheduler_ws::~scheduler_ws()
+{
+    stop();
+    wait();
+}
+
+void scheduler_ws::stop()
+{
+    d_stop = true;
+    d_threads.interrupt_all();
+
+    gr::thread::scoped_lock guard(d_sleep_mutex);
+    d_sleep_cond.notify_all();
+}
+
+void scheduler_ws::wait()
+{
+    d_threads.join_all();
+    release();
+}
+
+void scheduler_ws::release()
+{
+    {
+        gr::thread::scoped_lock guard(d_sleep_mutex);
+        if (d_released)
+            return;
+        d_released = true;
+    }
+
+    // Detach from the blocks so that a following scheduler (e.g. after
+    // a reconfiguration) can install its own hooks, and stop the
+    // blocks that did not finish on their own. Message posters may
+    // still be calling the hooks; set_wakeup() waits for them, and it
+    // must not be called under d_sleep_mutex, which wake() takes.
+    for (auto& t : d_tasks) {
+        t->block->detail()->d_tpb.set_wakeup(nullptr);
+        t->exec.reset();
+    }
+}
+
+bool scheduler_ws::finished() const
+{
+    return d_stop || d_nretired == d_tasks.size();
+}
+
+void scheduler_ws::worker_main(size_t index)
+{
+    t_context.sched = this;
+    t_context.index = index;
+
+    while (!finished()) {
+        boost::this_thread::interruption_point();
+
+        task* t = pop(index);
+        if (!t) {
+            idle();
+            continue;
+        }
+
+        if (!d_catch_exceptions) {
+            run_task(t);
+            continue;
+        }
+
+        // Mirror thread-per-block: an exception only takes down the
+        // block that threw it, not the worker running it.
+        try {
+            run_task(t);
+        } catch (boost::thread_interrupted const&) {
+            throw;
+        } catch (std::exception const& e) {
+            d_logger->error("ERROR block[{:s}]: {:s}", t->block->identifier(), e.what());
+            retire(t);
+        } catch (...) {
+            d_logger->error("ERROR block[{:s}]: caught unrecognized exception",
+                            t->block->identifier());
+            retire(t);
+        }
+    }
+}
+
+block_executor::state scheduler_ws::run_once(task* t)
+{
+    block* blk = t->block.get();
+    block_detail* d = blk->detail().get();
+    block_executor::state s;
+
+    // handle any queued up messages
+    blk->dispatch_msgs();
+
+    // run one iteration if we are a connected stream block
+    if (d->noutputs() > 0 || d->ninputs() > 0) {
+        s = t->exec->run_one_iteration();
+    } else {
+        s = block_executor::BLKD_IN;
+        // a msg port only block wants to shutdown
+        if (blk->finished()) {
+            s = block_executor::DONE;
+        }
+    }
+
+    if (blk->finished() && s == block_executor::READY_NO_OUTPUT) {
+        s = block_executor::DONE;
+        d->set_done(true);
+    }
+
+    if (!d->ninputs() && s == block_executor::READY_NO_OUTPUT) {
+        s = block_executor::BLKD_IN;
+    }
+
+    return s;
+}
+
+void scheduler_ws::run_task(task* t)
+{
+    block* blk = t->block.get();
+    block_detail* d = blk->detail().get();
+    block_executor::state s;
+
+    t->deadline.store(0, std::memory_order_relaxed);
+    t->state.store(TASK_RUNNING);
+
+    // Keep running a block for as long as it makes progress (up to a
+    // limit), like a thread-per-block thread would, rather than moving
+    // it between deques after every call to work().
+    int n = 1;
+    while ((s = run_once(t)) == block_executor::READY && n++ < max_iterations) {
+        d->d_tpb.notify_neighbors(d);
+    }
+
+    switch (s) {
+    case block_executor::READY: // Tell neighbors we made progress.
+        d->d_tpb.notify_neighbors(d);
+        t->state.store(TASK_QUEUED);
+        push(t, true);
+        return;
+
+    case block_executor::READY_NO_OUTPUT: // Notify upstream only
+        d->d_tpb.notify_upstream(d);
+        t->state.store(TASK_QUEUED);
+        push(t, true);
+        return;
+
+    case block_executor::DONE: // Game over.
+        blk->notify_msg_neighbors();
+        d->d_tpb.notify_neighbors(d);
+        retire(t);
+        return;
+
+    case block_executor::BLKD_IN: // Re-poll after the blocked input timeout.
+        t->deadline.store(ws_now() + int64_t(blk->blkd_input_timer_value()) * 1000000,
+                          std::memory_order_relaxed);
+        break;
+
+    case block_executor::BLKD_OUT: // Wait for output buffer space.
+        break;
+
+    default:
+        throw std::runtime_error("possible memory corruption in scheduler");
+    }
+
+    // Park the task. If a neighbor woke us while we were running, the
+    // wakeup was recorded in the state and we go around again.
+    int expected = TASK_RUNNING;
+    if (!t->state.compare_exchange_strong(expected, TASK_IDLE)) {
+        t->state.store(TASK_QUEUED);
+        push(t, false);
+    }
+}
+
+void scheduler_ws::wake(task* t)
+{
+    int s = t->state.load();
+    while (true) {
+        switch (s) {
+        case TASK_IDLE:
+            if (t->state.compare_exchange_weak(s, TASK_QUEUED)) {
+                push(t, false);
+                return;
+            }
+            break;
+        case TASK_RUNNING:
+            if (t->state.compare_exchange_weak(s, TASK_RUNNING_DIRTY)) {
+                return;
+            }
+            break;
+        default: // already queued, already dirty or retired
+            return;
+        }
+    }
+}
+
+void scheduler_ws::push(task* t, bool front)
+{
+    // Newly runnable neighbors go to the back of our own deque, where
+    // we pop next and find their input still in cache. Tasks that just
+    // ran go to the front, where they are the first to be stolen.
+    worker* w;
+    if (t_context.sched == this) {
+        w = d_workers[t_context.index].get();
+    } else {
+        w = d_workers[d_next_inject++ % d_workers.size()].get();
+    }
+
+    {
+        gr::thread::scoped_lock guard(w->mutex);
+        if (front) {
+            w->tasks.push_front(t);
+        } else {
+            w->tasks.push_back(t);
+        }
+    }
+    d_nqueued++;
+
+    if (d_nsleeping > 0) {
+        gr::thread::scoped_lock guard(d_sleep_mutex);
+        d_sleep_cond.notify_one();
+    }
+}
+
+scheduler_ws::task* scheduler_ws::pop(size_t index)
+{
+    const size_t nworkers = d_workers.size();
+    for (size_t i = 0; i < nworkers; i++) {
+        worker* w = d_workers[(index + i) % nworkers].get();
+        gr::thread::scoped_lock guard(w->mutex);
+        if (w->tasks.empty()) {
+            continue;
+        }
+
+        task* t;
+        if (i == 0) { // our own deque
+            t = w->tasks.back();
+            w->tasks.pop_back();
+        } else { // steal
+            t = w->tasks.front();
+            w->tasks.pop_front();
+        }
+        d_nqueued--;
+        return t;
+    }
+    return nullptr;
+}
+
+void scheduler_ws::idle()
+{
+    // Wake the tasks whose blocked-input timer expired, and find out
+    // how long we may sleep until the next one does.
+    const int64_t now = ws_now();
+    int64_t next = std::numeric_limits<int64_t>::max();
+    for (auto& t : d_tasks) {
+        int64_t deadline = t->deadline.load(std::memory_order_relaxed);
+        if (deadline == 0) {
+            continue;
+        }
+        if (deadline <= now) {
+            if (t->deadline.compare_exchange_strong(deadline, 0)) {
+                wake(t.get());
+            }
+        } else {
+            next = std::min(next, deadline);
+        }
+    }
+
+    gr::thread::scoped_lock guard(d_sleep_mutex);
+    d_nsleeping++;
+    if (d_nqueued == 0 && !finished()) {
+        int64_t timeout_ms = 250;
+        if (next != std::numeric_limits<int64_t>::max()) {
+            timeout_ms = std::clamp<int64_t>((next - now) / 1000000, 1, timeout_ms);
+        }
+        d_sleep_cond.timed_wait(guard, boost::posix_time::milliseconds(timeout_ms));
+    }
+    d_nsleeping--;
+}
+
+void scheduler_ws::retire(task* t)
+{
+    t->state.store(TASK_DONE);
+    t->deadline.store(0, std::memory_order_relaxed);
+    t->exec.reset(); // stop any drivers, etc.
+
+    if (++d_nretired == d_tasks.size()) {
+        gr::thread::scoped_lock guard(d_sleep_mutex);
+        d_sleep_cond.notify_all();
+    }
+}
+
+} /* namespace gr */
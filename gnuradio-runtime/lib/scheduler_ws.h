@@ -0,0 +1,104 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_GR_SCHEDULER_WS_H
+#define INCLUDED_GR_SCHEDULER_WS_H
+
+#include "block_executor.h"
+#include "scheduler.h"
+#include <gnuradio/api.h>
+#include <gnuradio/logger.h>
+#include <gnuradio/thread/thread_group.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace gr {
+
+/*!
+ * \brief Concrete scheduler that runs blocks as tasks on a fixed pool
+ * of worker threads.
+ *
+ * Every block is wrapped in a task that executes
+ * block_executor::run_one_iteration(), exactly like the body of a
+ * thread-per-block thread, so blocks run unchanged. Each worker owns a
+ * deque of runnable tasks: it pops its own work from the back and,
+ * when it runs dry, steals from the front of the other workers'
+ * deques. A task that blocks on input or output buffer space is parked
+ * until one of its neighbors (or a message poster) wakes it through
+ * the hook it installs with tpb_detail::set_wakeup().
+ *
+ * The number of workers is read from the [Scheduler] ws_nthreads
+ * preference; 0 (the default) uses one worker per hardware thread.
+ */
+class GR_RUNTIME_API scheduler_ws : public scheduler
+{
+    struct task;
+    struct worker;
+
+    std::vector<std::unique_ptr<task>> d_tasks;
+    std::vector<std::unique_ptr<worker>> d_workers;
+    gr::thread::thread_group d_threads;
+    bool d_catch_exceptions;
+
+    std::atomic<bool> d_stop;
+    std::atomic<size_t> d_nretired;
+    std::atomic<size_t> d_nqueued;
+    std::atomic<size_t> d_nsleeping;
+    std::atomic<size_t> d_next_inject;
+    bool d_released;
+
+    gr::thread::mutex d_sleep_mutex;
+    gr::thread::condition_variable d_sleep_cond;
+
+    gr::logger_ptr d_logger, d_debug_logger;
+
+protected:
+    /*!
+     * \brief Construct a scheduler and begin evaluating the graph.
+     *
+     * The scheduler will continue running until all blocks
+     * report that they are done or the stop method is called.
+     */
+    scheduler_ws(flat_flowgraph_sptr ffg, int max_noutput_items, bool catch_exceptions);
+
+public:
+    static scheduler_sptr make(flat_flowgraph_sptr ffg,
+                               int max_noutput_items = 100000,
+                               bool catch_exceptions = true);
+
+    ~scheduler_ws() override;
+
+    /*!
+     * \brief Tell the scheduler to stop executing.
+     */
+    void stop() override;
+
+    /*!
+     * \brief Block until the graph is done.
+     */
+    void wait() override;
+
+private:
+    void worker_main(size_t index);
+    void run_task(task* t);
+    block_executor::state run_once(task* t);
+    void wake(task* t);
+    void push(task* t, bool front);
+    task* pop(size_t index);
+    void idle();
+    void retire(task* t);
+    void release();
+    bool finished() const;
+};
+
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_SCHEDULER_WS_H */
@@ -0,0 +1,158 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gnuradio/tag_ring.h>
+#include <algorithm>
+#include <utility>
+
+namespace gr {
+
+namespace {
+
+// Room for the tags of a few work calls; most buffers never carry a tag
+// and so never allocate.
+constexpr size_t initial_capacity = 16;
+
+// tag_t's copy operations deliberately drop marked_deleted; moving a
+// tag between slots must keep it.
+void swap_tags(tag_t& a, tag_t& b)
+{
+    std::swap(a.offset, b.offset);
+    std::swap(a.key, b.key);
+    std::swap(a.value, b.value);
+    std::swap(a.srcid, b.srcid);
+    std::swap(a.marked_deleted, b.marked_deleted);
+}
+
+} // namespace
+
+tag_ring::tag_ring() : d_mask(0), d_head(0), d_size(0) {}
+
+size_t tag_ring::lower_bound(uint64_t offset) const
+{
+    if (d_size == 0 || (*this)[d_size - 1].offset < offset) {
+        return d_size;
+    }
+    return std::partition_point(begin(),
+                                end(),
+                                [offset](const tag_t& t) { return t.offset < offset; }) -
+           begin();
+}
+
+size_t tag_ring::upper_bound(uint64_t offset) const
+{
+    if (d_size == 0 || (*this)[d_size - 1].offset <= offset) {
+        return d_size;
+    }
+    return std::partition_point(begin(),
+                                end(),
+                                [offset](const tag_t& t) { return t.offset <= offset; }) -
+           begin();
+}
+
+tag_ring::view tag_ring::range(uint64_t start, uint64_t end) const
+{
+    if (end <= start) {
+        return view(this->end(), this->end());
+    }
+    return view(begin() + lower_bound(start), begin() + lower_bound(end));
+}
+
+void tag_ring::add(const tag_t& tag)
+{
+    tag_t& slot = push_back();
+    slot = tag;
+    sort_back();
+}
+
+void tag_ring::take(tag_t& tag)
+{
+    tag_t& slot = push_back();
+    slot.offset = tag.offset;
+    std::swap(slot.key, tag.key);
+    std::swap(slot.value, tag.value);
+    std::swap(slot.srcid, tag.srcid);
+    sort_back();
+}
+
+void tag_ring::reserve(size_t n)
+{
+    if (n > d_slots.size()) {
+        grow(n);
+    }
+}
+
+tag_t& tag_ring::push_back()
+{
+    if (d_size == d_slots.size()) {
+        grow(d_size + 1);
+    }
+
+    // A reused slot may still hold the marks of the tag it last carried.
+    tag_t& slot = (*this)[d_size++];
+    slot.marked_deleted.clear();
+    return slot;
+}
+
+void tag_ring::sort_back()
+{
+    // Out-of-order tags are rare and land near the tail; walk them back.
+    size_t pos = d_size - 1;
+    while (pos > 0 && (*this)[pos - 1].offset > (*this)[pos].offset) {
+        swap_tags((*this)[pos - 1], (*this)[pos]);
+        pos--;
+    }
+}
+
+size_t tag_ring::prune(uint64_t offset)
+{
+    const size_t n = lower_bound(offset);
+    drop_front(n);
+    return n;
+}
+
+void tag_ring::clear() { drop_front(d_size); }
+
+void tag_ring::drop_front(size_t n)
+{
+    // Drop the PMTs rather than assigning PMT_NIL, which would contend
+    // on its reference count with every other buffer.
+    for (size_t i = 0; i < n; i++) {
+        tag_t& slot = (*this)[i];
+        slot.key.reset();
+        slot.value.reset();
+        slot.srcid.reset();
+        slot.marked_deleted.clear();
+    }
+    d_head = (d_head + n) & d_mask;
+    d_size -= n;
+}
+
+void tag_ring::grow(size_t min_capacity)
+{
+    size_t capacity = std::max(initial_capacity, d_slots.size());
+    while (capacity < min_capacity) {
+        capacity *= 2;
+    }
+
+    std::vector<tag_t> slots(capacity);
+    for (size_t i = 0; i < d_size; i++) {
+        swap_tags(slots[i], (*this)[i]);
+    }
+    d_slots.swap(slots);
+    d_mask = d_slots.size() - 1;
+    d_head = 0;
+}
+
+} /* namespace gr */
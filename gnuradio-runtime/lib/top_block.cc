@@ -83,6 +83,10 @@ int top_block::max_noutput_items() { return d_impl->max_noutput_items(); }
 
 void top_block::set_max_noutput_items(int nmax) { d_impl->set_max_noutput_items(nmax); }
 
+void top_block::set_scheduler(const std::string& name) { d_impl->set_scheduler(name); }
+
+std::string top_block::scheduler_name() { return d_impl->scheduler_name(); }
+
 top_block_sptr top_block::to_top_block()
 {
     return cast_to_top_block_sptr(shared_from_this());
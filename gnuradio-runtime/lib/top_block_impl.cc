@@ -15,6 +15,7 @@
 
 #include "flat_flowgraph.h"
 #include "scheduler_tpb.h"
+#include "scheduler_ws.h"
 #include "terminate_handler.h"
 #include "top_block_impl.h"
 #include <gnuradio/logger.h>
@@ -34,15 +35,33 @@ typedef scheduler_sptr (*scheduler_maker)(flat_flowgraph_sptr ffg,
 
 
 static std::vector<std::tuple<std::string, scheduler_maker>> scheduler_list{
-    { "TPB", scheduler_tpb::make }
+    { "TPB", scheduler_tpb::make }, { "WS", scheduler_ws::make }
 };
-static scheduler_sptr
-make_scheduler(flat_flowgraph_sptr ffg, int max_noutput_items, bool catch_exceptions)
+
+static scheduler_maker find_scheduler(const std::string& name)
+{
+    for (auto& [sched_name, maker] : scheduler_list) {
+        if (sched_name == name) {
+            return maker;
+        }
+    }
+    return nullptr;
+}
+
+static scheduler_sptr make_scheduler(const std::string& requested,
+                                     flat_flowgraph_sptr ffg,
+                                     int max_noutput_items,
+                                     bool catch_exceptions)
 {
     static scheduler_maker factory = nullptr;
     gr::logger_ptr logger, debug_logger;
     gr::configure_default_loggers(logger, debug_logger, "top_block_impl");
 
+    // A scheduler chosen for this top_block overrides the process-wide default.
+    if (!requested.empty()) {
+        return find_scheduler(requested)(ffg, max_noutput_items, catch_exceptions);
+    }
+
     if (!factory) {
         char* environment_var = std::getenv("GR_SCHEDULER");
         if (!environment_var) {
@@ -50,12 +69,7 @@ make_scheduler(flat_flowgraph_sptr ffg, int max_noutput_items, bool catch_except
             factory = fac;
             logger->debug("Using default scheduler \"{}\"", name);
         } else {
-            for (auto& [name, maker] : scheduler_list) {
-                if (name == environment_var) {
-                    factory = maker;
-                    break;
-                }
-            }
+            factory = find_scheduler(environment_var);
             if (!factory) {
                 const auto& [name, fac] = scheduler_list.at(0);
                 factory = fac;
@@ -118,7 +132,8 @@ void top_block_impl::start(int max_noutput_items)
         p->get_bool("PerfCounters", "export", false))
         d_ffg->enable_pc_rpc();
 
-    d_scheduler = make_scheduler(d_ffg, d_max_noutput_items, d_catch_exceptions);
+    d_scheduler = make_scheduler(
+        d_scheduler_name, d_ffg, d_max_noutput_items, d_catch_exceptions);
     d_state = RUNNING;
 }
 
@@ -200,7 +215,8 @@ void top_block_impl::restart()
     d_ffg = new_ffg;
 
     // Create a new scheduler to execute it
-    d_scheduler = make_scheduler(d_ffg, d_max_noutput_items, d_catch_exceptions);
+    d_scheduler = make_scheduler(
+        d_scheduler_name, d_ffg, d_max_noutput_items, d_catch_exceptions);
     d_retry_wait = true;
 }
 
@@ -230,4 +246,21 @@ int top_block_impl::max_noutput_items() { return d_max_noutput_items; }
 
 void top_block_impl::set_max_noutput_items(int nmax) { d_max_noutput_items = nmax; }
 
+void top_block_impl::set_scheduler(const std::string& name)
+{
+    if (!name.empty() && !find_scheduler(name)) {
+        throw std::invalid_argument("top_block::set_scheduler: unknown scheduler \"" +
+                                    name + "\"");
+    }
+
+    gr::thread::scoped_lock l(d_mutex);
+    d_scheduler_name = name;
+}
+
+std::string top_block_impl::scheduler_name()
+{
+    gr::thread::scoped_lock l(d_mutex);
+    return d_scheduler_name;
+}
+
 } /* namespace gr */
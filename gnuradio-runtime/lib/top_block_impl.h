@@ -60,6 +60,12 @@ public:
     // Set the maximum number of noutput_items in the flowgraph
     void set_max_noutput_items(int nmax);
 
+    // Select the scheduler used by the next start() or reconfiguration
+    void set_scheduler(const std::string& name);
+
+    // Get the scheduler selected with set_scheduler()
+    std::string scheduler_name();
+
 protected:
     enum tb_state { IDLE, RUNNING };
 
@@ -74,6 +80,7 @@ protected:
     boost::condition_variable d_lock_cond;
     int d_max_noutput_items;
     bool d_catch_exceptions;
+    std::string d_scheduler_name;
 
 private:
     void restart();
@@ -55,4 +55,31 @@ void tpb_detail::notify_neighbors(block_detail* d)
     notify_upstream(d);
 }
 
+void tpb_detail::set_wakeup(std::function<void()> hook)
+{
+    gr::thread::scoped_lock guard(mutex);
+    wakeup = std::move(hook);
+    has_wakeup.store(bool(wakeup));
+}
+
+void tpb_detail::wait_input(unsigned int timeout_ms)
+{
+    gr::thread::scoped_lock guard(mutex);
+    parked.store(PARKED_INPUT);
+    if (!input_changed.load()) {
+        cond.timed_wait(guard, boost::posix_time::milliseconds(timeout_ms));
+    }
+    parked.store(NOT_PARKED);
+}
+
+void tpb_detail::wait_output()
+{
+    gr::thread::scoped_lock guard(mutex);
+    parked.store(PARKED_OUTPUT);
+    while (!output_changed.load()) {
+        cond.wait(guard);
+    }
+    parked.store(NOT_PARKED);
+}
+
 } /* namespace gr */
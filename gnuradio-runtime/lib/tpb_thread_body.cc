@@ -13,8 +13,6 @@
 #endif
 
 #include "tpb_thread_body.h"
-#include <gnuradio/pmt_fmt.h>
-#include <gnuradio/prefs.h>
 #include <pmt/pmt.h>
 #include <boost/thread.hpp>
 #include <iostream>
@@ -39,18 +37,10 @@ tpb_thread_body::tpb_thread_body(block_sptr block,
 
     block_detail* d = block->detail().get();
     block_executor::state s;
-    pmt::pmt_t msg;
 
     d->threaded = true;
     d->thread = gr::thread::get_current_thread_id();
 
-    prefs* p = prefs::singleton();
-    size_t max_nmsgs = static_cast<size_t>(p->get_long("DEFAULT", "max_messages", 100));
-
-    // Set up logging
-    auto logger = gr::logger("tpb_thread_body");
-
-
     // Set thread affinity if it was set before fg was started.
     if (!block->processor_affinity().empty()) {
         gr::thread::thread_bind_to_processor(d->thread, block->processor_affinity());
@@ -71,26 +61,7 @@ tpb_thread_body::tpb_thread_body(block_sptr block,
         d->d_tpb.clear_changed();
 
         // handle any queued up messages
-        for (const auto& i : block->msg_queue) {
-            // Check if we have a message handler attached before getting
-            // any messages. This is mostly a protection for the unknown
-            // startup sequence of the threads.
-            if (block->has_msg_handler(i.first)) {
-                while ((msg = block->delete_head_nowait(i.first))) {
-                    block->dispatch_msg(i.first, msg);
-                }
-            } else {
-                // If we don't have a handler but are building up messages,
-                // prune the queue from the front to keep memory in check.
-                if (block->nmsgs(i.first) > max_nmsgs) {
-                    logger.warn("{} received a message to port {} which has no handler "
-                                "registered. Message discarded.",
-                                block->identifier(),
-                                i.first);
-                    msg = block->delete_head_nowait(i.first);
-                }
-            }
-        }
+        block->dispatch_msgs();
 
         // run one iteration if we are a connected stream block
         if (d->noutputs() > 0 || d->ninputs() > 0) {
@@ -127,24 +98,12 @@ tpb_thread_body::tpb_thread_body(block_sptr block,
             return;
 
         case block_executor::BLKD_IN: // Wait for input.
-        {
-            gr::thread::scoped_lock guard(d->d_tpb.mutex);
-
-            if (!d->d_tpb.input_changed) {
-                boost::system_time const timeout =
-                    boost::get_system_time() +
-                    boost::posix_time::milliseconds(block->blkd_input_timer_value());
-                d->d_tpb.input_cond.timed_wait(guard, timeout);
-            }
-        } break;
+            d->d_tpb.wait_input(block->blkd_input_timer_value());
+            break;
 
         case block_executor::BLKD_OUT: // Wait for output buffer space.
-        {
-            gr::thread::scoped_lock guard(d->d_tpb.mutex);
-            while (!d->d_tpb.output_changed) {
-                d->d_tpb.output_cond.wait(guard);
-            }
-        } break;
+            d->d_tpb.wait_output();
+            break;
 
         default:
             throw std::runtime_error("possible memory corruption in scheduler");
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(basic_block.h)                                             */
-/* BINDTOOL_HEADER_FILE_HASH(ec5e22df23ed02772ff9008b0f97b111)                     */
+/* BINDTOOL_HEADER_FILE_HASH(991e812bc18cad04f9009217b28fedc7)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -156,6 +156,26 @@ void bind_basic_block(py::module& m)
              D(basic_block, _post))
 
 
+        .def("msg_port_index",
+             &basic_block::msg_port_index,
+             py::arg("which_port"),
+             D(basic_block, msg_port_index))
+
+
+        .def("set_msg_port_overflow",
+             &basic_block::set_msg_port_overflow,
+             py::arg("which_port"),
+             py::arg("policy"),
+             py::arg("capacity") = 0,
+             D(basic_block, set_msg_port_overflow))
+
+
+        .def("nmsgs_dropped",
+             &basic_block::nmsgs_dropped,
+             py::arg("which_port"),
+             D(basic_block, nmsgs_dropped))
+
+
         .def("empty_p",
              (bool(basic_block::*)(pmt::pmt_t)) & basic_block::empty_p,
              py::arg("which_port"),
@@ -194,28 +214,12 @@ void bind_basic_block(py::module& m)
              D(basic_block, delete_head_nowait))
 
 
-        .def("get_iterator",
-             &basic_block::get_iterator,
-             py::arg("which_port"),
-             D(basic_block, get_iterator))
-
-
-        .def("erase_msg",
-             &basic_block::erase_msg,
-             py::arg("which_port"),
-             py::arg("it"),
-             D(basic_block, erase_msg))
-
-
         .def("has_msg_port",
              &basic_block::has_msg_port,
              py::arg("which_port"),
              D(basic_block, has_msg_port))
 
 
-        .def("get_msg_map", &basic_block::get_msg_map, D(basic_block, get_msg_map))
-
-
         // .def("add_rpc_variable",&basic_block::add_rpc_variable,
         //     py::arg("s"),
         //     D(basic_block,add_rpc_variable)
@@ -271,6 +275,13 @@ void bind_basic_block(py::module& m)
         ;
 
 
+    py::enum_<gr::msg_port_queue::overflow_t>(m, "msg_port_overflow_t")
+        .value("OVERFLOW_DROP_OLDEST", gr::msg_port_queue::OVERFLOW_DROP_OLDEST) // 0
+        .value("OVERFLOW_BLOCK", gr::msg_port_queue::OVERFLOW_BLOCK)             // 1
+        .value("OVERFLOW_COUNT", gr::msg_port_queue::OVERFLOW_COUNT)             // 2
+        .export_values();
+
+
     m.def("basic_block_ncurrently_allocated",
           &::gr::basic_block_ncurrently_allocated,
           D(basic_block_ncurrently_allocated));
@@ -127,7 +127,7 @@ bool block_gateway::stop()
 void block_gateway::set_msg_handler_pybind(const pmt::pmt_t& which_port,
                                            std::string& handler_name)
 {
-    if (msg_queue.find(which_port) == msg_queue.end()) {
+    if (msg_port_index(which_port) < 0) {
         throw std::runtime_error(
             "attempt to set_msg_handler_pybind() on invalid input message port!");
     }
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(block.h)                                                   */
-/* BINDTOOL_HEADER_FILE_HASH(b29641dca27a2281f96841bbfcb9943d)                     */
+/* BINDTOOL_HEADER_FILE_HASH(003873b13b4b4f63e1273f164a0c5cdb)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
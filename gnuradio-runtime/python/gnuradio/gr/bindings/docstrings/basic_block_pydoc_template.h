@@ -90,6 +90,15 @@ static const char* __doc_gr_basic_block_message_ports_out = R"doc()doc";
 static const char* __doc_gr_basic_block__post = R"doc()doc";
 
 
+static const char* __doc_gr_basic_block_msg_port_index = R"doc()doc";
+
+
+static const char* __doc_gr_basic_block_set_msg_port_overflow = R"doc()doc";
+
+
+static const char* __doc_gr_basic_block_nmsgs_dropped = R"doc()doc";
+
+
 static const char* __doc_gr_basic_block_empty_p_0 = R"doc()doc";
 
 
@@ -111,18 +120,9 @@ static const char* __doc_gr_basic_block_insert_tail = R"doc()doc";
 static const char* __doc_gr_basic_block_delete_head_nowait = R"doc()doc";
 
 
-static const char* __doc_gr_basic_block_get_iterator = R"doc()doc";
-
-
-static const char* __doc_gr_basic_block_erase_msg = R"doc()doc";
-
-
 static const char* __doc_gr_basic_block_has_msg_port = R"doc()doc";
 
 
-static const char* __doc_gr_basic_block_get_msg_map = R"doc()doc";
-
-
 static const char* __doc_gr_basic_block_add_rpc_variable = R"doc()doc";
 
 
@@ -63,12 +63,21 @@ static const char* __doc_gr_buffer_get_sizeof_item = R"doc()doc";
 static const char* __doc_gr_buffer_add_item_tag = R"doc()doc";
 
 
+static const char* __doc_gr_buffer_add_item_tags = R"doc()doc";
+
+
+static const char* __doc_gr_buffer_move_item_tags = R"doc()doc";
+
+
 static const char* __doc_gr_buffer_remove_item_tag = R"doc()doc";
 
 
 static const char* __doc_gr_buffer_prune_tags = R"doc()doc";
 
 
+static const char* __doc_gr_buffer_get_tags_in_range = R"doc()doc";
+
+
 static const char* __doc_gr_buffer_get_tags_begin = R"doc()doc";
 
 
@@ -132,6 +141,9 @@ static const char* __doc_gr_buffer_reader_link = R"doc()doc";
 static const char* __doc_gr_buffer_reader_get_tags_in_range = R"doc()doc";
 
 
+static const char* __doc_gr_buffer_reader_tags_in_range = R"doc()doc";
+
+
 static const char* __doc_gr_make_buffer = R"doc()doc";
 
 
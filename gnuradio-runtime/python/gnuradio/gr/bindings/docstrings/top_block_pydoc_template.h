@@ -51,6 +51,12 @@ static const char* __doc_gr_top_block_max_noutput_items = R"doc()doc";
 static const char* __doc_gr_top_block_set_max_noutput_items = R"doc()doc";
 
 
+static const char* __doc_gr_top_block_set_scheduler = R"doc()doc";
+
+
+static const char* __doc_gr_top_block_scheduler_name = R"doc()doc";
+
+
 static const char* __doc_gr_top_block_to_top_block = R"doc()doc";
 
 
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(hier_block2.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(dbc66ee4c3d5ca364dac05a4557c2545)                     */
+/* BINDTOOL_HEADER_FILE_HASH(6dbcff3b4394fa0ef3a4b1bdea04a2ab)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(top_block.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(96d9ff1131a52a5089606f658e0ff48e)                     */
+/* BINDTOOL_HEADER_FILE_HASH(3c7567441e0ea2710e046e06f1e33120)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -125,6 +125,15 @@ void bind_top_block(py::module& m)
              D(top_block, set_max_noutput_items))
 
 
+        .def("set_scheduler",
+             &top_block::set_scheduler,
+             py::arg("name"),
+             D(top_block, set_scheduler))
+
+
+        .def("scheduler_name", &top_block::scheduler_name, D(top_block, scheduler_name))
+
+
         .def("to_top_block", &top_block::to_top_block, D(top_block, to_top_block))
 
 
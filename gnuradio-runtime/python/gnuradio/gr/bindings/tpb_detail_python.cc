@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(tpb_detail.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(e08c6f246b04f1719d3377c5e3992f53)                     */
+/* BINDTOOL_HEADER_FILE_HASH(50ea9beb35b4fdc63438fd6c0f6d5d0c)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -0,0 +1,90 @@
+#!/usr/bin/env python
+#
+# Copyright 2026 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+#
+
+import time
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+
+
+class test_scheduler_ws(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.tb.set_scheduler("WS")
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_000_select(self):
+        self.assertEqual(self.tb.scheduler_name(), "WS")
+        self.tb.set_scheduler("")
+        self.assertEqual(self.tb.scheduler_name(), "")
+        self.assertRaises(ValueError, self.tb.set_scheduler, "no-such-scheduler")
+
+    def test_001_empty_fg(self):
+        self.tb.start()
+        self.tb.stop()
+        self.tb.wait()
+
+    def test_002_chain(self):
+        data = list(range(100000))
+        src = blocks.vector_source_f(data)
+        prev = src
+        for _ in range(20):
+            cpy = blocks.copy(gr.sizeof_float)
+            self.tb.connect(prev, cpy)
+            prev = cpy
+        dst = blocks.vector_sink_f()
+        self.tb.connect(prev, dst)
+        self.tb.run()
+        self.assertFloatTuplesAlmostEqual(data, dst.data())
+
+    def test_003_fan_out_with_tags(self):
+        data = list(range(10000))
+        tags = [gr.tag_utils.python_to_tag(
+            (n, pmt.intern("frame"), pmt.from_long(n), pmt.PMT_F))
+            for n in range(0, len(data), 100)]
+        src = blocks.vector_source_f(data, tags=tags)
+        sinks = []
+        for _ in range(8):
+            cpy = blocks.copy(gr.sizeof_float)
+            dst = blocks.vector_sink_f()
+            self.tb.connect(src, cpy, dst)
+            sinks.append(dst)
+        self.tb.run()
+        for dst in sinks:
+            self.assertFloatTuplesAlmostEqual(data, dst.data())
+            self.assertEqual([t.offset for t in dst.tags()],
+                             [t.offset for t in tags])
+
+    def test_004_messages(self):
+        strobe = blocks.message_strobe(pmt.intern("ping"), 10)
+        dbg = blocks.message_debug()
+        self.tb.msg_connect(strobe, "strobe", dbg, "store")
+        self.tb.start()
+        time.sleep(0.2)
+        self.tb.stop()
+        self.tb.wait()
+        self.assertGreater(dbg.num_messages(), 0)
+
+    def test_005_stop_free_running(self):
+        src = blocks.null_source(gr.sizeof_float)
+        thr = blocks.copy(gr.sizeof_float)
+        dst = blocks.null_sink(gr.sizeof_float)
+        self.tb.connect(src, thr, dst)
+        self.tb.start()
+        time.sleep(0.1)
+        self.tb.stop()
+        self.tb.wait()
+
+
+if __name__ == '__main__':
+    gr_unittest.run(test_scheduler_ws)
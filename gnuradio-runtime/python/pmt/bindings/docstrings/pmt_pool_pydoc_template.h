@@ -25,3 +25,12 @@ static const char* __doc_pmt_pmt_pool_malloc = R"doc()doc";
 
 
 static const char* __doc_pmt_pmt_pool_free = R"doc()doc";
+
+
+static const char* __doc_pmt_pmt_pool_get_stats = R"doc()doc";
+
+
+static const char* __doc_pmt_pmt_pool_stats = R"doc()doc";
+
+
+static const char* __doc_pmt_pool_stats = R"doc()doc";
@@ -25,7 +25,10 @@ void bind_pmt_pool(py::module& m)
     using pmt_pool = ::pmt::pmt_pool;
 
 
-    py::class_<pmt_pool, std::shared_ptr<pmt_pool>>(m, "pmt_pool", D(pmt_pool))
+    py::class_<pmt_pool, std::shared_ptr<pmt_pool>> pmt_pool_class(
+        m, "pmt_pool", D(pmt_pool));
+
+    pmt_pool_class
 
         .def(py::init<size_t, size_t, size_t, size_t>(),
              py::arg("itemsize"),
@@ -38,5 +41,22 @@ void bind_pmt_pool(py::module& m)
         .def("malloc", &pmt_pool::malloc, D(pmt_pool, malloc))
 
 
-        .def("free", &pmt_pool::free, py::arg("p"), D(pmt_pool, free));
+        .def("free", &pmt_pool::free, py::arg("p"), D(pmt_pool, free))
+
+
+        .def("get_stats", &pmt_pool::get_stats, D(pmt_pool, get_stats));
+
+
+    py::class_<pmt_pool::stats>(pmt_pool_class, "stats", D(pmt_pool, stats))
+        .def_readonly("itemsize", &pmt_pool::stats::itemsize)
+        .def_readonly("chunks", &pmt_pool::stats::chunks)
+        .def_readonly("items", &pmt_pool::stats::items)
+        .def_readonly("in_depot", &pmt_pool::stats::in_depot)
+        .def_readonly("mallocs", &pmt_pool::stats::mallocs)
+        .def_readonly("frees", &pmt_pool::stats::frees)
+        .def_readonly("refills", &pmt_pool::stats::refills)
+        .def_readonly("handbacks", &pmt_pool::stats::handbacks);
+
+
+    m.def("pool_stats", &::pmt::pool_stats, D(pool_stats));
 }
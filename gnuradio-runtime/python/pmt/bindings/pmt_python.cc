@@ -1353,7 +1353,8 @@ void bind_pmt(py::module& m)
 
 
     m.def("dict_add",
-          &::pmt::dict_add,
+          (pmt::pmt_t(*)(pmt::pmt_t const&, pmt::pmt_t const&, pmt::pmt_t const&)) &
+              ::pmt::dict_add,
           py::arg("dict").none(false),
           py::arg("key").none(false),
           py::arg("value").none(false),
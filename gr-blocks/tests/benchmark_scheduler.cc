@@ -0,0 +1,115 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/* ensure that tweakme.h is included before the bundled spdlog/fmt header, see
+ * https://github.com/gabime/spdlog/issues/2922 */
+#include <spdlog/tweakme.h>
+
+#include <gnuradio/blocks/copy.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/top_block.h>
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compare the thread-per-block ("TPB") and work-stealing ("WS") schedulers
+// on graphs made of many cheap blocks, where scheduling overhead dominates.
+// The number of WS workers can be set through GR_CONF_SCHEDULER_WS_NTHREADS.
+
+constexpr uint64_t nitems = 20'000'000;
+constexpr int max_noutput_items = 1024; // small chunks, like a latency-bound receiver
+
+enum class topology { chain, fan_out };
+
+// source -> head -> [copy] x nblocks -> sink
+static void build_chain(gr::top_block_sptr tb, int nblocks)
+{
+    auto src = gr::blocks::null_source::make(sizeof(float));
+    auto head = gr::blocks::head::make(sizeof(float), nitems);
+    tb->connect(src, 0, head, 0);
+
+    gr::basic_block_sptr prev = head;
+    for (int i = 0; i < nblocks; i++) {
+        auto copy = gr::blocks::copy::make(sizeof(float));
+        tb->connect(prev, 0, copy, 0);
+        prev = copy;
+    }
+    tb->connect(prev, 0, gr::blocks::null_sink::make(sizeof(float)), 0);
+}
+
+// source -> head -> nblocks x ([copy] -> sink)
+static void build_fan_out(gr::top_block_sptr tb, int nblocks)
+{
+    auto src = gr::blocks::null_source::make(sizeof(float));
+    auto head = gr::blocks::head::make(sizeof(float), nitems);
+    tb->connect(src, 0, head, 0);
+
+    for (int i = 0; i < nblocks; i++) {
+        auto copy = gr::blocks::copy::make(sizeof(float));
+        tb->connect(head, 0, copy, 0);
+        tb->connect(copy, 0, gr::blocks::null_sink::make(sizeof(float)), 0);
+    }
+}
+
+static std::chrono::duration<double>
+run(const std::string& scheduler, topology topo, int nblocks)
+{
+    auto tb = gr::make_top_block("benchmark_scheduler");
+    tb->set_scheduler(scheduler);
+    if (topo == topology::chain) {
+        build_chain(tb, nblocks);
+    } else {
+        build_fan_out(tb, nblocks);
+    }
+
+    auto before = std::chrono::steady_clock::now();
+    tb->run(max_noutput_items);
+    auto after = std::chrono::steady_clock::now();
+    return after - before;
+}
+
+int main(int argc, char** argv)
+{
+    const std::vector<std::string> schedulers{ "TPB", "WS" };
+    const std::vector<std::pair<topology, int>> graphs{ { topology::chain, 4 },
+                                                        { topology::chain, 16 },
+                                                        { topology::chain, 64 },
+                                                        { topology::fan_out, 4 },
+                                                        { topology::fan_out, 16 },
+                                                        { topology::fan_out, 64 } };
+
+    std::vector<std::string> lines;
+    size_t maxlen = 0;
+    for (const auto& [topo, nblocks] : graphs) {
+        for (const auto& scheduler : schedulers) {
+            auto dur = run(scheduler, topo, nblocks);
+            lines.emplace_back(
+                fmt::format(FMT_STRING("{:<8} {:<8} {:>3} blocks  time: {:<8.4e} s  "
+                                       "throughput: {:>6.3e} items/s"),
+                            scheduler,
+                            topo == topology::chain ? "chain" : "fan-out",
+                            nblocks,
+                            dur.count(),
+                            static_cast<double>(nitems) / dur.count()));
+            maxlen = std::max(lines.back().size(), maxlen);
+        }
+    }
+
+    fmt::print("+{1:—^{0}}+\n", maxlen + 2, "");
+    for (const auto& line : lines) {
+        fmt::print("|{1:^{0}}|\n", maxlen + 2, line);
+    }
+    fmt::print("+{1:—^{0}}+\n", maxlen + 2, "");
+}
@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/* ensure that tweakme.h is included before the bundled spdlog/fmt header, see
+ * https://github.com/gabime/spdlog/issues/2922 */
+#include <spdlog/tweakme.h>
+
+#include <gnuradio/blocks/copy.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/thread/thread.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/tpb_detail.h>
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Per-item cost of the readiness handshake between thread-per-block
+// threads: first the bare notify/clear primitives, old (mutex + condition
+// variable per call) against new (atomic flags), then whole flowgraphs at
+// small noutput_items, where the handshake rivals the work itself.
+
+constexpr uint64_t handshake_iterations = 10'000'000;
+constexpr uint64_t nitems = 20'000'000;
+constexpr int chain_length = 8;
+
+// The handshake as tpb_detail implemented it before the atomic flags.
+struct legacy_tpb_detail {
+    gr::thread::mutex mutex;
+    bool input_changed = false;
+    gr::thread::condition_variable input_cond;
+    bool output_changed = false;
+    gr::thread::condition_variable output_cond;
+
+    void notify_msg()
+    {
+        gr::thread::scoped_lock guard(mutex);
+        input_changed = true;
+        input_cond.notify_one();
+        output_changed = true;
+        output_cond.notify_one();
+    }
+
+    void clear_changed()
+    {
+        gr::thread::scoped_lock guard(mutex);
+        input_changed = false;
+        output_changed = false;
+    }
+};
+
+// Two "blocks" on two threads, each clearing its own flags and
+// notifying the other once per iteration, like neighbors in a chain.
+template <typename detail_t>
+static double handshake_ns()
+{
+    detail_t a, b;
+    auto body = [](detail_t& self, detail_t& peer) {
+        for (uint64_t i = 0; i < handshake_iterations; i++) {
+            self.clear_changed();
+            peer.notify_msg();
+        }
+    };
+
+    auto before = std::chrono::steady_clock::now();
+    std::thread other(body, std::ref(b), std::ref(a));
+    body(a, b);
+    other.join();
+    auto after = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(after - before).count() /
+           handshake_iterations;
+}
+
+// source -> head -> [copy] x chain_length -> sink, on thread-per-block
+static double flowgraph_ns_per_item(int max_noutput_items)
+{
+    auto tb = gr::make_top_block("benchmark_tpb_notify");
+    tb->set_scheduler("TPB");
+
+    auto src = gr::blocks::null_source::make(sizeof(float));
+    auto head = gr::blocks::head::make(sizeof(float), nitems);
+    tb->connect(src, 0, head, 0);
+    gr::basic_block_sptr prev = head;
+    for (int i = 0; i < chain_length; i++) {
+        auto copy = gr::blocks::copy::make(sizeof(float));
+        tb->connect(prev, 0, copy, 0);
+        prev = copy;
+    }
+    tb->connect(prev, 0, gr::blocks::null_sink::make(sizeof(float)), 0);
+
+    auto before = std::chrono::steady_clock::now();
+    tb->run(max_noutput_items);
+    auto after = std::chrono::steady_clock::now();
+
+    // per item and per block, so the numbers compare across chain lengths
+    return std::chrono::duration<double, std::nano>(after - before).count() / nitems /
+           (chain_length + 3);
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> lines;
+    lines.emplace_back(fmt::format(FMT_STRING("{:<34} {:>8.2f} ns/iteration"),
+                                   "handshake, mutex + condvar",
+                                   handshake_ns<legacy_tpb_detail>()));
+    lines.emplace_back(fmt::format(FMT_STRING("{:<34} {:>8.2f} ns/iteration"),
+                                   "handshake, atomic flags",
+                                   handshake_ns<gr::tpb_detail>()));
+    for (int max_noutput_items : { 16, 64, 256, 1024, 8192 }) {
+        lines.emplace_back(
+            fmt::format(FMT_STRING("{:<34} {:>8.2f} ns/item/block"),
+                        fmt::format(FMT_STRING("flowgraph, noutput_items <= {}"),
+                                    max_noutput_items),
+                        flowgraph_ns_per_item(max_noutput_items)));
+    }
+
+    size_t maxlen = 0;
+    for (const auto& line : lines) {
+        maxlen = std::max(line.size(), maxlen);
+    }
+    fmt::print("+{1:—^{0}}+\n", maxlen + 2, "");
+    for (const auto& line : lines) {
+        fmt::print("|{1:^{0}}|\n", maxlen + 2, line);
+    }
+    fmt::print("+{1:—^{0}}+\n", maxlen + 2, "");
+}
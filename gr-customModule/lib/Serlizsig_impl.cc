@@ -8,6 +8,9 @@
 #include <gnuradio/io_signature.h>
 #include "Serlizsig_impl.h"
 
+static const pmt::pmt_t CARR_OFFSET_KEY = pmt::mp("ofdm_sync_carr_offset");
+static const pmt::pmt_t CHAN_TAPS_KEY = pmt::mp("ofdm_sync_chan_taps");
+
 namespace gr {
   namespace customModule {
 
@@ -63,16 +66,11 @@ namespace gr {
         d_carr_offset_key(pmt::string_to_symbol(carr_offset_key)),
         d_curr_set(symbols_skipped % occupied_carriers.size()),
         d_symbols_per_set(0),
-        d_channel_state(fft_len, gr_complex(1, 0))
+        d_channel_state(fft_len, gr_complex(1, 0)),
+        d_capture(capture_sink::get()),
+        d_signal_stream(d_capture->add_stream(CAPTURE_SERIALIZED_SIGNAL, signal_filename)),
+        d_taps_stream(d_capture->add_stream(CAPTURE_CHANNEL_TAPS, channel_taps_filename))
     {
-      signal_file.open(signal_filename, std::ios::out | std::ios::app);
-      if(!signal_file.is_open()) {
-        throw std::runtime_error("Failed to open payload File" + signal_filename);
-      }
-      taps_file.open(channel_taps_filename, std::ios::out | std::ios::trunc);
-      if(!taps_file.is_open()) {
-        throw std::runtime_error("Failed to open taps File" + channel_taps_filename);
-      }
       for (unsigned i = 0; i < d_occupied_carriers.size(); i++) {
         for (unsigned k = 0; k < d_occupied_carriers[i].size(); k++) {
             if (input_is_shifted) {
@@ -138,12 +136,14 @@ namespace gr {
               if (tags[i].key == d_carr_offset_key) {
                   carr_offset = pmt::to_long(tags[i].value);
               }
-            if (pmt::symbol_to_string(tags[i].key) == "ofdm_sync_carr_offset") {
+            if (tags[i].key == CARR_OFFSET_KEY) {
                 carrier_offset = pmt::to_long(tags[i].value);
 
             }
-            if (pmt::symbol_to_string(tags[i].key) == "ofdm_sync_chan_taps") {
-                d_channel_state = pmt::c32vector_elements(tags[i].value);// d_channel-state --> channel_taps
+            if (tags[i].key == CHAN_TAPS_KEY) {
+                size_t n_taps;
+                const gr_complex* taps = pmt::c32vector_elements(tags[i].value, n_taps);
+                d_channel_state.assign(taps, taps + n_taps);
 
             }
               if (tags[i].key == d_packet_len_tag_key) {
@@ -164,20 +164,15 @@ namespace gr {
           }
       }
 
-    std::vector<gr_complex> outBuffer(frame_length * d_fft_len, gr_complex(0, 0));
-
           // Copy symbols
     int n_out_symbols = 0;
+    d_signal.clear();
 
-
-    signal_file << "Fine CFO: "  << carrier_offset << "\n " << std::endl;
-
-    signal_file << "baseband_frame starting:  + frame_legnth"  << frame_length << "\n " << std::endl;
     for (int i = 0; i < frame_length; i++) {
 
         for (unsigned k = 0; k < d_occupied_carriers[d_curr_set].size(); k++) {
 
-                signal_file << in[i * d_fft_len + d_occupied_carriers[d_curr_set][k] + carr_offset] << std::endl;
+                d_signal.push_back(in[i * d_fft_len + d_occupied_carriers[d_curr_set][k] + carr_offset]);
                 n_out_symbols++;
         }
         if (packet_length && n_out_symbols > packet_length) {
@@ -186,15 +181,21 @@ namespace gr {
         }
         d_curr_set = (d_curr_set + 1) % d_occupied_carriers.size();
     }
-    signal_file << "baseband_frame end"  << "\n " << std::endl;
 
-    taps_file << "Taps starting: " << std::endl;
-    for (const auto& tap: d_channel_state) {
-        taps_file << tap << std::endl;
+    const int32_t signal_header[2] = { carrier_offset, (int32_t)frame_length };
+    capture_sink::record signal = d_capture->reserve(
+        d_signal_stream,
+        nitems_read(0),
+        sizeof(signal_header) + d_signal.size() * sizeof(gr_complex));
+    if (signal) {
+        signal.append(signal_header, sizeof(signal_header));
+        signal.append(d_signal.data(), d_signal.size() * sizeof(gr_complex));
+        signal.commit();
     }
-        taps_file << "\n";
-        
-  
+    d_capture->post(d_taps_stream,
+                    nitems_read(0),
+                    d_channel_state.data(),
+                    d_channel_state.size() * sizeof(gr_complex));
 
     // Housekeeping
     if (d_length_tag_key_str.empty()) {
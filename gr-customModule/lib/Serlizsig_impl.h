@@ -9,6 +9,7 @@
 #define INCLUDED_CUSTOMMODULE_SERLIZSIG_IMPL_H
 
 #include <gnuradio/customModule/Serlizsig.h>
+#include "capture_sink.h"
 
 namespace gr {
   namespace customModule {
@@ -25,9 +26,11 @@ namespace gr {
       pmt::pmt_t d_carr_offset_key;    //!< Key of the carrier offset tag
       int d_curr_set;                  //!< Current position in d_occupied_carriers
       int d_symbols_per_set;
-      std::ofstream signal_file;
-      std::ofstream taps_file;
       std::vector<gr_complex>d_channel_state;    
+      std::vector<gr_complex> d_signal; //!< Occupied carriers of the current frame
+      capture_sink::sptr d_capture;
+      uint16_t d_signal_stream;
+      uint16_t d_taps_stream;
      protected:
           /*!
           * Calculate the number of scalar complex symbols given a number of
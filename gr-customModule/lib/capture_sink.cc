@@ -0,0 +1,267 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 xinyu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "capture_sink.h"
+#include <gnuradio/prefs.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+namespace customModule {
+
+namespace {
+constexpr size_t RING_BYTES = 64 << 20;
+constexpr char FILE_MAGIC[8] = { 'G', 'R', 'C', 'A', 'P', 'T', 'R', '1' };
+constexpr char INDEX_MAGIC[8] = { 'G', 'R', 'C', 'A', 'P', 'I', 'D', 'X' };
+constexpr char TRAILER_MAGIC[8] = { 'G', 'R', 'C', 'A', 'P', 'E', 'N', 'D' };
+
+size_t padded(size_t size) { return (size + 7) & ~size_t(7); }
+} // namespace
+
+capture_sink::sptr capture_sink::get()
+{
+    static gr::thread::mutex mutex;
+    static std::weak_ptr<capture_sink> current;
+
+    gr::thread::scoped_lock lock(mutex);
+    sptr sink = current.lock();
+    if (!sink) {
+        const std::string path = prefs::singleton()->get_string(
+            "customModule", "capture_file", "customModule_capture.bin");
+        sink = std::make_shared<capture_sink>(path, RING_BYTES);
+        current = sink;
+    }
+    return sink;
+}
+
+capture_sink::capture_sink(const std::string& path, size_t capacity)
+    : d_file_pos(0),
+      d_n_slots(capacity / SLOT_BYTES),
+      d_ring(d_n_slots * SLOT_BYTES),
+      d_published(new std::atomic<uint64_t>[d_n_slots]),
+      d_reserved(0),
+      d_head(0),
+      d_dropped(new std::atomic<uint64_t>[MAX_STREAMS]),
+      d_types(),
+      d_batch(BATCH_BYTES),
+      d_batch_fill(0),
+      d_n_streams(1)
+{
+    for (uint64_t i = 0; i < d_n_slots; i++) {
+        d_published[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < MAX_STREAMS; i++) {
+        d_dropped[i].store(0, std::memory_order_relaxed);
+    }
+    // Stream 0 carries the declarations.
+    d_stream_types.push_back(CAPTURE_STREAM);
+    d_record_offsets.emplace_back();
+
+    d_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!d_file.is_open()) {
+        throw std::runtime_error("Failed to open capture file: " + path);
+    }
+    capture_file_header header = {};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+    header.header_size = sizeof(header);
+    header.version = 1;
+    d_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    d_file_pos = sizeof(header);
+
+    start();
+}
+
+capture_sink::~capture_sink()
+{
+    stop();
+    write_index();
+}
+
+uint16_t capture_sink::add_stream(capture_record_t type, const std::string& name)
+{
+    uint16_t stream;
+    {
+        gr::thread::scoped_lock lock(d_stream_mutex);
+        if (d_n_streams == MAX_STREAMS) {
+            throw std::runtime_error("Too many capture streams");
+        }
+        stream = d_n_streams++;
+        d_types[stream] = type;
+        d_declarations.emplace_back(type, name);
+    }
+    // Records of the stream wait in the ring until the declaration is written.
+    wake();
+    return stream;
+}
+
+capture_sink::record
+capture_sink::reserve(uint16_t stream, uint64_t offset, size_t payload_size)
+{
+    const size_t size = sizeof(capture_record_header) + payload_size;
+    const uint64_t n_slots = (padded(size) + SLOT_BYTES - 1) / SLOT_BYTES;
+
+    uint64_t slot = d_reserved.load(std::memory_order_relaxed);
+    do {
+        if (slot + n_slots - d_head.load(std::memory_order_acquire) > d_n_slots) {
+            d_dropped[stream].fetch_add(1, std::memory_order_relaxed);
+            return record(nullptr, 0, 0);
+        }
+    } while (!d_reserved.compare_exchange_weak(
+        slot, slot + n_slots, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    record r(this, slot, slot * SLOT_BYTES);
+    capture_record_header header = {};
+    header.size = size;
+    header.stream = stream;
+    header.type = d_types[stream];
+    header.offset = offset;
+    r.append(&header, sizeof(header));
+    return r;
+}
+
+bool capture_sink::post(uint16_t stream, uint64_t offset, const void* data, size_t size)
+{
+    record r = reserve(stream, offset, size);
+    if (!r) {
+        return false;
+    }
+    r.append(data, size);
+    r.commit();
+    return true;
+}
+
+void capture_sink::record::append(const void* data, size_t size)
+{
+    d_sink->copy_in(d_pos, data, size);
+    d_pos += size;
+}
+
+void capture_sink::record::commit()
+{
+    static const char zeros[8] = {};
+    append(zeros, padded(d_pos) - d_pos);
+    d_sink->d_published[d_slot % d_sink->d_n_slots].store(d_slot + 1,
+                                                          std::memory_order_release);
+}
+
+void capture_sink::copy_in(uint64_t pos, const void* data, size_t size)
+{
+    // A record may wrap around the end of the ring.
+    const char* src = static_cast<const char*>(data);
+    while (size > 0) {
+        const size_t first = pos % d_ring.size();
+        const size_t count = std::min(size, d_ring.size() - first);
+        std::memcpy(&d_ring[first], src, count);
+        src += count;
+        size -= count;
+        pos += count;
+    }
+}
+
+void capture_sink::copy_out(uint64_t pos, size_t size)
+{
+    while (size > 0) {
+        if (d_batch_fill == d_batch.size()) {
+            write_batch();
+        }
+        const size_t first = pos % d_ring.size();
+        const size_t count = std::min(
+            { size, d_ring.size() - first, d_batch.size() - d_batch_fill });
+        std::memcpy(&d_batch[d_batch_fill], &d_ring[first], count);
+        d_batch_fill += count;
+        pos += count;
+        size -= count;
+    }
+}
+
+void capture_sink::write_batch()
+{
+    d_file.write(d_batch.data(), d_batch_fill);
+    d_file_pos += d_batch_fill;
+    d_batch_fill = 0;
+}
+
+void capture_sink::drain()
+{
+    // Declarations first. A record of a stream declared after this point waits for
+    // the next pass, so it never lands before its declaration.
+    std::vector<std::pair<capture_record_t, std::string>> declarations;
+    {
+        gr::thread::scoped_lock lock(d_stream_mutex);
+        declarations.swap(d_declarations);
+    }
+    for (const auto& declaration : declarations) {
+        const uint32_t type = declaration.first;
+        const std::string& name = declaration.second;
+        capture_record_header header = {};
+        header.size = sizeof(header) + sizeof(type) + name.size();
+        header.stream = 0;
+        header.type = CAPTURE_STREAM;
+        header.offset = d_stream_types.size();
+
+        std::vector<char> bytes(padded(header.size));
+        std::memcpy(&bytes[0], &header, sizeof(header));
+        std::memcpy(&bytes[sizeof(header)], &type, sizeof(type));
+        std::memcpy(&bytes[sizeof(header) + sizeof(type)], name.data(), name.size());
+        if (d_batch.size() - d_batch_fill < bytes.size()) {
+            write_batch();
+        }
+        d_record_offsets[0].push_back(d_file_pos + d_batch_fill);
+        std::memcpy(&d_batch[d_batch_fill], bytes.data(), bytes.size());
+        d_batch_fill += bytes.size();
+
+        d_stream_types.push_back(type);
+        d_record_offsets.emplace_back();
+    }
+
+    uint64_t head = d_head.load(std::memory_order_relaxed);
+    while (d_published[head % d_n_slots].load(std::memory_order_acquire) == head + 1) {
+        capture_record_header header;
+        std::memcpy(&header, &d_ring[(head % d_n_slots) * SLOT_BYTES], sizeof(header));
+        if (header.stream >= d_stream_types.size()) {
+            break;
+        }
+        if (d_batch_fill == d_batch.size()) {
+            write_batch();
+        }
+        d_record_offsets[header.stream].push_back(d_file_pos + d_batch_fill);
+        copy_out(head * SLOT_BYTES, padded(header.size));
+        head += (padded(header.size) + SLOT_BYTES - 1) / SLOT_BYTES;
+        d_head.store(head, std::memory_order_release);
+    }
+    write_batch();
+}
+
+void capture_sink::write_index()
+{
+    const uint64_t index_offset = d_file_pos;
+    capture_index index = {};
+    std::memcpy(index.magic, INDEX_MAGIC, sizeof(index.magic));
+    index.n_streams = d_stream_types.size();
+    d_file.write(reinterpret_cast<const char*>(&index), sizeof(index));
+
+    for (size_t stream = 0; stream < d_stream_types.size(); stream++) {
+        capture_index_entry entry = {};
+        entry.stream = stream;
+        entry.type = d_stream_types[stream];
+        entry.n_records = d_record_offsets[stream].size();
+        entry.n_dropped = dropped(stream);
+        d_file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        d_file.write(reinterpret_cast<const char*>(d_record_offsets[stream].data()),
+                     d_record_offsets[stream].size() * sizeof(uint64_t));
+    }
+
+    capture_trailer trailer = {};
+    trailer.index_offset = index_offset;
+    std::memcpy(trailer.magic, TRAILER_MAGIC, sizeof(trailer.magic));
+    d_file.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    d_file.close();
+}
+
+} // namespace customModule
+} // namespace gr
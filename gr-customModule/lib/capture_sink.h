@@ -0,0 +1,180 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 xinyu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_CUSTOMMODULE_CAPTURE_SINK_H
+#define INCLUDED_CUSTOMMODULE_CAPTURE_SINK_H
+
+#include "ring_writer.h"
+#include <gnuradio/thread/thread.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gr {
+namespace customModule {
+
+/*
+ * Layout of the capture file, little endian, every part 8-byte aligned:
+ *
+ *   capture_file_header
+ *   records: capture_record_header, then the payload, padded with zeros
+ *   capture_index, written when the sink is destroyed:
+ *       per stream a capture_index_entry followed by n_records uint64_t
+ *       file offsets of its records
+ *   capture_trailer
+ *
+ * Stream 0 is reserved: its records (type CAPTURE_STREAM) declare the other streams
+ * before their first record. The offset of a declaration is the id of the stream,
+ * the payload the uint32_t record type of the stream and its name, the file the
+ * probe used to write. A file without the index, from a run that did not shut down,
+ * can still be read sequentially.
+ * python/customModule/capture.py reads capture files.
+ */
+enum capture_record_t : uint16_t {
+    CAPTURE_STREAM = 0,            // declaration of a stream, see above
+    CAPTURE_SAMPLES = 1,           // gr_complex[]
+    CAPTURE_CHANNEL_TAPS = 2,      // gr_complex[fft_len]
+    CAPTURE_CARRIER_OFFSET = 3,    // int32_t, in carriers
+    CAPTURE_FREQ_OFFSET = 4,       // int32_t n_items, float value of the last item
+    CAPTURE_SERIALIZED_SIGNAL = 5, // int32_t carrier offset, int32_t frame length,
+                                   // gr_complex[] of the occupied carriers
+    CAPTURE_TAG = 6,               // serialized PMT tag value, offset of the tag
+    CAPTURE_SYNC_SYMBOLS = 7,      // gr_complex[2 * fft_len], both sync symbols
+                                   // after the carrier offset correction
+};
+
+struct capture_file_header {
+    char magic[8];        // "GRCAPTR1"
+    uint32_t header_size; // sizeof(capture_file_header)
+    uint32_t version;
+};
+
+struct capture_record_header {
+    uint32_t size;   // bytes, this header included, without the padding
+    uint16_t stream;
+    uint16_t type;   // capture_record_t
+    uint64_t offset; // item number of the first captured item
+};
+
+struct capture_index_entry {
+    uint32_t stream;
+    uint32_t type;
+    uint64_t n_records;
+    uint64_t n_dropped;
+};
+
+struct capture_index {
+    char magic[8]; // "GRCAPIDX"
+    uint32_t n_streams;
+    uint32_t reserved;
+};
+
+struct capture_trailer {
+    uint64_t index_offset;
+    char magic[8]; // "GRCAPEND"
+};
+
+/*
+ * The capture service shared by the probe blocks of a flowgraph run.
+ *
+ * Blocks post records from their work threads into a bounded multi-producer ring of
+ * 64-byte slots. A producer claims the slots of a record with one compare-and-swap,
+ * copies into them and publishes the record by storing its sequence number; none of
+ * this locks, allocates or touches the file. If the ring is full the record is
+ * dropped and counted, so a slow disk never stalls a work thread. A background thread
+ * drains the published records in order, in batches of up to BATCH_BYTES per write.
+ *
+ * All blocks alive at the same time share one sink, and so one file. The file is
+ * named by the capture_file option of the [customModule] section of the GNU Radio
+ * config, customModule_capture.bin by default. The last block to go closes it.
+ */
+class capture_sink : public ring_writer
+{
+public:
+    typedef std::shared_ptr<capture_sink> sptr;
+
+    class record
+    {
+    public:
+        explicit operator bool() const { return d_sink != nullptr; }
+        void append(const void* data, size_t size);
+        void commit();
+
+    private:
+        friend class capture_sink;
+        record(capture_sink* sink, uint64_t slot, uint64_t pos)
+            : d_sink(sink), d_slot(slot), d_pos(pos)
+        {
+        }
+
+        capture_sink* d_sink;
+        uint64_t d_slot; // first slot of the record
+        uint64_t d_pos;  // next byte to write
+    };
+
+    static sptr get();
+
+    capture_sink(const std::string& path, size_t capacity);
+    ~capture_sink() override;
+
+    // Declare a stream of records of `type`. `name` is the file the probe used to
+    // write. Not for work threads: it takes a lock.
+    uint16_t add_stream(capture_record_t type, const std::string& name);
+
+    // Claim a record of `payload_size` bytes on `stream`. The result is false, and
+    // the record counted as dropped, if the ring has no room; otherwise append
+    // exactly `payload_size` bytes and commit() right away, as the writer waits for
+    // the record.
+    record reserve(uint16_t stream, uint64_t offset, size_t payload_size);
+    bool post(uint16_t stream, uint64_t offset, const void* data, size_t size);
+
+    uint64_t dropped(uint16_t stream) const
+    {
+        return d_dropped[stream].load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t SLOT_BYTES = 64;
+    static constexpr size_t BATCH_BYTES = 1 << 20;
+    static constexpr size_t MAX_STREAMS = 256;
+
+private:
+    void copy_in(uint64_t pos, const void* data, size_t size);
+    void copy_out(uint64_t pos, size_t size);
+    void drain() override;
+    void write_batch();
+    void write_index();
+
+    uint64_t d_file_pos;
+
+    const uint64_t d_n_slots;
+    std::vector<char> d_ring;
+    std::unique_ptr<std::atomic<uint64_t>[]> d_published; // per slot: first slot + 1
+    std::atomic<uint64_t> d_reserved; // next free slot, shared by the producers
+    std::atomic<uint64_t> d_head;     // next slot to drain, owned by the thread
+    std::unique_ptr<std::atomic<uint64_t>[]> d_dropped;
+    uint16_t d_types[MAX_STREAMS]; // record type per stream, set by add_stream()
+
+    // Owned by the thread
+    std::vector<char> d_batch;
+    size_t d_batch_fill;
+    std::vector<uint16_t> d_stream_types;
+    std::vector<std::vector<uint64_t>> d_record_offsets;
+
+    gr::thread::mutex d_stream_mutex;
+    // Declarations not yet written and the number of streams, guarded by
+    // d_stream_mutex
+    std::vector<std::pair<capture_record_t, std::string>> d_declarations;
+    size_t d_n_streams;
+};
+
+} // namespace customModule
+} // namespace gr
+
+#endif /* INCLUDED_CUSTOMMODULE_CAPTURE_SINK_H */
@@ -30,13 +30,10 @@ namespace gr {
       : gr::sync_block("getBaseband",
               gr::io_signature::make(1 /* min inputs */, 1 /* max inputs */, sizeof(input_type) * fft_len),
               gr::io_signature::make(0 /* min outputs */, 0 /*max outputs */,0 )),
-              d_fft_len(fft_len)
+              d_fft_len(fft_len),
+              d_capture(capture_sink::get()),
+              d_baseband_stream(d_capture->add_stream(CAPTURE_SAMPLES, baseband_filename))
     {
-      std::ofstream(baseband_filename).close();
-      baseband_file.open(baseband_filename, std::ios::out | std::ios::app);
-      if(!baseband_file.is_open()) {
-        throw std::runtime_error("Failed to open payload File" + baseband_filename);
-      }
     }
 
     /*
@@ -52,12 +49,10 @@ namespace gr {
         gr_vector_void_star &output_items)
     {
       const gr_complex* in = (const gr_complex*)input_items[0];
-      gr_complex* out = (gr_complex*)output_items[0];
 
-      for (int i = 0; i < noutput_items; i++) {
-        baseband_file << in[i] << std::endl;
-      }
-      baseband_file << "\n";
+      // The first noutput_items samples, as the text dump had them.
+      d_capture->post(
+          d_baseband_stream, nitems_read(0), in, noutput_items * sizeof(gr_complex));
 
       // Tell runtime system how many output items we produced.
       return noutput_items;
@@ -9,6 +9,7 @@
 #define INCLUDED_CUSTOMMODULE_GETBASEBAND_IMPL_H
 
 #include <gnuradio/customModule/getBaseband.h>
+#include "capture_sink.h"
 
 namespace gr {
   namespace customModule {
@@ -16,8 +17,9 @@ namespace gr {
     class getBaseband_impl : public getBaseband
     {
      private:
-     std::ofstream baseband_file;
      int d_fft_len;
+     capture_sink::sptr d_capture;
+     uint16_t d_baseband_stream;
       
      public:
       getBaseband_impl(int fft_len, const std::string& baseband_filename);
@@ -33,14 +33,11 @@ namespace gr {
               gr::io_signature::make(1 /* min inputs */, 1 /* max inputs */, sizeof(input_type)),
               gr::io_signature::make(0 /* min outputs */, 0 /*max outputs */, 0)),
               d_sensitivity(sensitivity),
-              d_phase(0)
+              d_phase(0),
+              d_capture(capture_sink::get()),
+              d_freq_offsets_stream(
+                  d_capture->add_stream(CAPTURE_FREQ_OFFSET, freq_offsets_filename))
     {
-           std::ofstream(freq_offsets_filename).close();
-          // Open files for writing
-          freq_offsets_file.open(freq_offsets_filename, std::ios::out | std::ios::app);
-          if (!freq_offsets_file.is_open()) {
-              throw std::runtime_error("Failed to open channel taps file: " + freq_offsets_filename);
-          }
     }
 
     /*
@@ -57,10 +54,11 @@ namespace gr {
     {
       const float* in = (const float*)input_items[0];
       gr_complex* out =(gr_complex*)output_items[0];
-      int frame_len = 0;
-      frame_len = noutput_items / 64;
-      freq_offsets_file << "numoutitems: " <<  noutput_items << "\n" << std::endl;
-      freq_offsets_file << "frame_len: " << frame_len << "\n" << std::endl;
+      struct {
+        int32_t n_items;
+        float last;
+      } record = { noutput_items, in[noutput_items - 1] };
+      d_capture->post(d_freq_offsets_stream, nitems_read(0), &record, sizeof(record));
 
       // freq_offsets_file << "Corase grained CFO starting: " << "\n" << std::endl;
  
@@ -73,11 +71,6 @@ namespace gr {
         float oi, oq;
         int32_t angle = gr::fxpt::float_to_fixed(d_phase);
         gr::fxpt::sincos(angle, &oq, &oi);
-        if (i == noutput_items - 1) {
-          freq_offsets_file << in[i] << std::endl;
-          freq_offsets_file << "\n";
-          
-        }
         // freq_offsets_file << oi << " " << oq << " ";
         // out[i] = gr_complex(oi, oq);
         }
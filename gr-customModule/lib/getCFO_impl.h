@@ -9,6 +9,7 @@
 #define INCLUDED_CUSTOMMODULE_GETCFO_IMPL_H
 
 #include <gnuradio/customModule/getCFO.h>
+#include "capture_sink.h"
 
 namespace gr {
   namespace customModule {
@@ -18,7 +19,8 @@ namespace gr {
      private:
      float d_sensitivity;
      float d_phase;
-     std::ofstream freq_offsets_file;
+     capture_sink::sptr d_capture;
+     uint16_t d_freq_offsets_stream;
 
      public:
       getCFO_impl(float sensitivity, 
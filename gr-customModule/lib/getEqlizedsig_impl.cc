@@ -10,10 +10,16 @@
 #include <gnuradio/digital/ofdm_equalizer_base.h>
 #include <gnuradio/expj.h>
 #include <gnuradio/math.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <atomic>
 
 static const pmt::pmt_t CARR_OFFSET_KEY = pmt::mp("ofdm_sync_carr_offset");
 static const pmt::pmt_t CHAN_TAPS_KEY = pmt::mp("ofdm_sync_chan_taps");
 
+// Channel state PMTs kept for reuse. Tags downstream may hold more of them at once.
+static const size_t MAX_CHAN_TAPS_PMTS = 16;
+
 namespace gr {
   namespace customModule {
 
@@ -45,16 +51,12 @@ namespace gr {
         d_fft_len(fft_len),
         d_cp_len(cp_len),
         d_eq(equalizer),
-        d_channel_state(equalizer->fft_len(), gr_complex(1, 0))
+        d_channel_state(equalizer->fft_len(), gr_complex(1, 0)),
+        d_tsb_key(pmt::string_to_symbol(tsb_key)),
+        d_capture(capture_sink::get()),
+        d_eqsignal_stream(d_capture->add_stream(CAPTURE_SAMPLES, equlizedsig_filename))
 
     {
-        std::ofstream(equlizedsig_filename).close();
-        eqsignal_file.open(equlizedsig_filename, std::ios::out | std::ios::app);
-        if(!eqsignal_file.is_open()) {
-          throw std::runtime_error("Faield to open eqsignal Files" + equlizedsig_filename);
-        }
-
-        // eqsignal_file << "111" <<std::endl;
         set_relative_rate(1, 1);
         // Really, we have TPP_ONE_TO_ONE, but the channel state is not propagated
         set_tag_propagation_policy(TPP_DONT);
@@ -72,13 +74,31 @@ namespace gr {
   {
 
         for (unsigned k = 0; k < tags[0].size(); k++) {
-            if (tags[0][k].key == pmt::string_to_symbol(d_length_tag_key_str)) {
+            if (tags[0][k].key == d_tsb_key) {
                 n_input_items_reqd[0] = pmt::to_long(tags[0][k].value);
             }
         }
       
   }
 
+    pmt::pmt_t getEqlizedsig_impl::chan_taps_pmt()
+    {
+        // Only this block holds a PMT with a use count of 1, so nobody can start
+        // referencing it while it is overwritten. The fence orders the overwrite
+        // after the last reads of the thread that released it.
+        for (const auto& v : d_chan_taps_pmts) {
+            if (v.use_count() == 1) {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return v;
+            }
+        }
+        pmt::pmt_t v = pmt::make_c32vector(d_fft_len, gr_complex(0, 0));
+        if (d_chan_taps_pmts.size() < MAX_CHAN_TAPS_PMTS) {
+            d_chan_taps_pmts.push_back(v);
+        }
+        return v;
+    }
+
     int
     getEqlizedsig_impl::work (int noutput_items,
                        gr_vector_int &ninput_items,
@@ -96,37 +116,42 @@ namespace gr {
       std::vector<tag_t> tags;
       get_tags_in_window(tags, 0, 0, 1);
       for (unsigned i = 0; i < tags.size(); i++) {
-          if (pmt::symbol_to_string(tags[i].key) == "ofdm_sync_chan_taps") {
-              d_channel_state = pmt::c32vector_elements(tags[i].value);
+          if (tags[i].key == CHAN_TAPS_KEY) {
+              size_t n_taps;
+              const gr_complex* taps = pmt::c32vector_elements(tags[i].value, n_taps);
+              d_channel_state.assign(taps, taps + n_taps);
           }
-          if (pmt::symbol_to_string(tags[i].key) == "ofdm_sync_carr_offset") {
+          if (tags[i].key == CARR_OFFSET_KEY) {
               carrier_offset = pmt::to_long(tags[i].value);
           }
       }
-      // Copy the frame and the channel state vector such that the symbols are shifted to
-      // the correct position
-      if (carrier_offset < 0) {
-        memset((void*)out, 0x00, sizeof(gr_complex) * (-carrier_offset));
-        memcpy((void*)&out[-carrier_offset],
-              (const void*)in,
-              sizeof(gr_complex) * (d_fft_len * frame_len + carrier_offset));
-    } else {
-        memset((void*)(out + d_fft_len * frame_len - carrier_offset),
-              0x00,
-              sizeof(gr_complex) * carrier_offset);
-        memcpy((void*)out,
-              (const void*)(in + carrier_offset),
-              sizeof(gr_complex) * (d_fft_len * frame_len - carrier_offset));
-            }
-      // Correct the frequency shift on the symbols
+      // Shift the frame by carrier_offset items, so the symbols land on the correct
+      // carriers, and correct the frequency shift on the symbols, in one pass from the
+      // input into the output buffer: out[n] = in[n + carrier_offset] * phase of the
+      // symbol of n, zero where n + carrier_offset falls outside the frame.
+      const int total_len = d_fft_len * frame_len;
       gr_complex phase_correction;
       for (int i = 0; i < frame_len; i++) {
           phase_correction =
               gr_expj(-(2.0 * GR_M_PI) * carrier_offset * d_cp_len / d_fft_len * (i + 1));
-          for (int k = 0; k < d_fft_len; k++) {
-              out[i * d_fft_len + k] *= phase_correction;
-          }
+          const int sym_start = i * d_fft_len;
+          const int begin = std::clamp(-carrier_offset, sym_start, sym_start + d_fft_len);
+          const int end =
+              std::clamp(total_len - carrier_offset, sym_start, sym_start + d_fft_len);
+          std::fill(out + sym_start, out + begin, gr_complex(0, 0));
+#if VOLK_VERSION >= 030100
+          volk_32fc_s32fc_multiply2_32fc(
+              out + begin, in + begin + carrier_offset, &phase_correction, end - begin);
+#else
+          volk_32fc_s32fc_multiply_32fc(
+              out + begin, in + begin + carrier_offset, phase_correction, end - begin);
+#endif
+          std::fill(out + end, out + sym_start + d_fft_len, gr_complex(0, 0));
       }
+      d_capture->post(d_eqsignal_stream,
+                      nitems_read(0),
+                      out,
+                      frame_len * d_fft_len * sizeof(gr_complex));
       // Do the equalizing
       d_eq->reset();
       // d_eq->equalize(out, frame_len, d_channel_state, tags);
@@ -134,24 +159,28 @@ namespace gr {
       // Update the channel state regarding the frequency offset
       phase_correction =
           gr_expj((2.0 * GR_M_PI) * carrier_offset * d_cp_len / d_fft_len * frame_len);
-      for (int k = 0; k < d_fft_len; k++) {
-          d_channel_state[k] *= phase_correction;
-      }
+      const pmt::pmt_t chan_taps = chan_taps_pmt();
+      size_t n_taps;
+      gr_complex* taps = pmt::c32vector_writable_elements(chan_taps, n_taps);
+#if VOLK_VERSION >= 030100
+      volk_32fc_s32fc_multiply2_32fc(
+          taps, d_channel_state.data(), &phase_correction, d_fft_len);
+#else
+      volk_32fc_s32fc_multiply_32fc(
+          taps, d_channel_state.data(), phase_correction, d_fft_len);
+#endif
+      std::copy(taps, taps + d_fft_len, d_channel_state.begin());
 
       // Propagate tags (except for the channel state and the TSB tag)
       get_tags_in_window(tags, 0, 0, frame_len);
       for (size_t i = 0; i < tags.size(); i++) {
-          if (tags[i].key != CHAN_TAPS_KEY &&
-              tags[i].key != pmt::mp(d_length_tag_key_str)) {
+          if (tags[i].key != CHAN_TAPS_KEY && tags[i].key != d_tsb_key) {
               add_item_tag(0, tags[i]);
           }
       }
 
       // Housekeeping
-      add_item_tag(0,
-                  nitems_written(0),
-                  pmt::string_to_symbol("ofdm_sync_chan_taps"),
-                  pmt::init_c32vector(d_fft_len, d_channel_state));
+      add_item_tag(0, nitems_written(0), CHAN_TAPS_KEY, chan_taps);
       
 
 
@@ -10,6 +10,7 @@
 
 #include <gnuradio/customModule/getEqlizedsig.h>
 #include <gnuradio/digital/ofdm_equalizer_base.h>
+#include "capture_sink.h"
 
 
 namespace gr {
@@ -18,12 +19,19 @@ namespace gr {
     class getEqlizedsig_impl : public getEqlizedsig
     {
      private:
-      std::ofstream eqsignal_file;
       gr::digital::ofdm_equalizer_base::sptr d_eq;
       int d_fft_len;
       std::vector<gr_complex> d_channel_state;
       int d_cp_len;
       pmt::pmt_t d_carr_offset_key;
+      pmt::pmt_t d_tsb_key;
+      capture_sink::sptr d_capture;
+      uint16_t d_eqsignal_stream;
+      //! Channel state tag values, reused once no tag holds them any more
+      std::vector<pmt::pmt_t> d_chan_taps_pmts;
+
+      //! Return a c32vector of fft_len elements that nobody else references
+      pmt::pmt_t chan_taps_pmt();
 
      protected:
         void parse_length_tags(const std::vector<std::vector<tag_t>>& tags,
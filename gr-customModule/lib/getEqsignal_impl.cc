@@ -29,13 +29,10 @@ namespace gr {
     getEqsignal_impl::getEqsignal_impl(int fft_len, const std::string& eqsignal_filename)
       : gr::sync_block("getEqsignal",
               gr::io_signature::make(1 /* min inputs */, 1 /* max inputs */, sizeof(input_type)),
-              gr::io_signature::make(0 /* min outputs */, 0 /*max outputs */, 0))
+              gr::io_signature::make(0 /* min outputs */, 0 /*max outputs */, 0)),
+        d_capture(capture_sink::get()),
+        d_eqsignal_stream(d_capture->add_stream(CAPTURE_SAMPLES, eqsignal_filename))
     {
-        std::ofstream(eqsignal_filename).close();
-        eqsignal_file.open(eqsignal_filename, std::ios::out | std::ios::app);
-        if(!eqsignal_file.is_open()) {
-          throw std::runtime_error("Faield to open eqsignal Files" + eqsignal_filename);
-        }
     }
 
     /*
@@ -53,14 +50,9 @@ namespace gr {
 
       
       const gr_complex* in = (const gr_complex*)input_items[0];
-      gr_complex* out = (gr_complex*)output_items[0];
-      
 
-          // Do <+signal processing+>
-      for (int i = 0 ; i < noutput_items; ++i) {
-        eqsignal_file << in[i] <<std::endl;
-      }
-      eqsignal_file << "\n";
+      d_capture->post(
+          d_eqsignal_stream, nitems_read(0), in, noutput_items * sizeof(gr_complex));
       // Tell runtime system how many output items we produced.
       return noutput_items;
     }
@@ -9,6 +9,7 @@
 #define INCLUDED_CUSTOMMODULE_GETEQSIGNAL_IMPL_H
 
 #include <gnuradio/customModule/getEqsignal.h>
+#include "capture_sink.h"
 
 namespace gr {
   namespace customModule {
@@ -16,7 +17,8 @@ namespace gr {
     class getEqsignal_impl : public getEqsignal
     {
      private:
-      std::ofstream eqsignal_file;
+      capture_sink::sptr d_capture;
+      uint16_t d_eqsignal_stream;
       
 
      public:
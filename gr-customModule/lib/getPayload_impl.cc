@@ -28,13 +28,10 @@ namespace gr {
       : gr::sync_block("getPayload",
               gr::io_signature::make(1 /* min inputs */, 1 /* max inputs */, sizeof(input_type) * fft_len),
               gr::io_signature::make(0 /* min outputs */, 0 /*max outputs */, 0)),
-            d_fft_len(fft_len)
+            d_fft_len(fft_len),
+            d_capture(capture_sink::get()),
+            d_payload_stream(d_capture->add_stream(CAPTURE_SAMPLES, payload_filename))
     {
-        std::ofstream(payload_filename).close();
-        payload_file.open(payload_filename, std::ios::out | std::ios::app);
-        if(!payload_file.is_open()) {
-          throw std::runtime_error("Failed to open payload File" + payload_filename);
-        }
     }
 
     /*
@@ -51,19 +48,10 @@ namespace gr {
     {
 
       const gr_complex* in = (const gr_complex*)input_items[0];
-      gr_complex* out = (gr_complex*)output_items[0];
-      payload_file << "frame length: " << noutput_items << "starting" << "\n";
-      // Do <+signal processing+>
-      for (int i = 0 ; i < noutput_items; ++i) {
-        for (int k = 0; k < d_fft_len; k++) 
-        {
-          payload_file << in[i * d_fft_len + k] <<std::endl;
-
-        }
-       
-        // payload_file << noutput_items << std::endl;
-      }
-      payload_file << "frame ending" << "\n";
+      d_capture->post(d_payload_stream,
+                      nitems_read(0),
+                      in,
+                      noutput_items * d_fft_len * sizeof(gr_complex));
 
   
  
@@ -9,6 +9,7 @@
 #define INCLUDED_CUSTOMMODULE_GETPAYLOAD_IMPL_H
 
 #include <gnuradio/customModule/getPayload.h>
+#include "capture_sink.h"
 
 namespace gr {
   namespace customModule {
@@ -16,8 +17,9 @@ namespace gr {
     class getPayload_impl : public getPayload
     {
      private:
-      std::ofstream payload_file;
       int d_fft_len;
+      capture_sink::sptr d_capture;
+      uint16_t d_payload_stream;
 
      public:
       getPayload_impl(int fft_len, const std::string& payload_filename);
@@ -8,6 +8,8 @@
 #include <gnuradio/io_signature.h>
 #include "getSignal_impl.h"
 
+static const pmt::pmt_t WIFI_START_KEY = pmt::mp("wifi_start");
+
 namespace gr {
   namespace customModule {
 
@@ -30,21 +32,11 @@ namespace gr {
               gr::io_signature::make(1 /* min inputs */, 1 /* max inputs */, input_len * item_size),
               gr::io_signature::make(0/* min outputs */, 0 /*max outputs */, 0)),
         d_item_size(item_size),
-        d_input_len(input_len)
-    { 
-        std::ofstream(signal_filename).close();
-        signal_file.open(signal_filename, std::ios::out | std::ios::app);
-
-        if(!signal_file.is_open()) {
-          throw std::runtime_error("Failed to open signal files: " + signal_filename);
-        }
-        
-        std::ofstream(start_index_filename).close();
-        start_index_file.open(start_index_filename, std::ios::out | std::ios::app);
-
-        if(!start_index_file.is_open()) {
-          throw std::runtime_error("Failed to open start_index_filename files: " + start_index_filename);
-        }
+        d_input_len(input_len),
+        d_capture(capture_sink::get()),
+        d_signal_stream(d_capture->add_stream(CAPTURE_SAMPLES, signal_filename)),
+        d_start_index_stream(d_capture->add_stream(CAPTURE_TAG, start_index_filename))
+    {
     }
 
     /*
@@ -66,59 +58,22 @@ namespace gr {
         std::vector<gr::tag_t> tags;
         const uint64_t abs_start = nitems_read(0);
         const uint64_t abs_end   = abs_start + nin;   // end is exclusive
-        get_tags_in_range(tags, 0, abs_start, abs_end);
-        // signal_file << "tags_found=" << tags.size() << " abs_start=" << abs_start << " nin=" << nin << "\n";
-        // start_index_file  << "tags_found=" << tags.size() << " abs_start=" << abs_start << " nin=" << nin << "\n";
-        start_index_file.flush();
-        signal_file.flush();
-        // start_index_file << "tags_found=" << tags.size()
-        //          << " abs_start=" << abs_start
-        //          << " nin=" << nin << "\n";
-        // 2) write tags to start_index file (filter to the key you want)
-        for (const auto& t : tags) {
-            const std::string key = pmt::symbol_to_string(t.key);
-            if (key == "wifi_start") {
-                start_index_file
-                  << "offset=" << t.offset
-                  << " key=" << key
-                  << " coarse_cfo=" << pmt::write_string(t.value)
-                  << "\n";
-
-            }
-            // if (key == "wifi_start_raw_long") {
-            //     start_index_file
-            //       << "offset=" << t.offset
-            //       << " key=" << key
-            //       << " value=" << pmt::write_string(t.value)
-            //       << "\n";
-
-            // }
-            // if (key == "packet_len") {
-            //     start_index_file
-            //       << "offset=" << t.offset
-            //       << " key=" << key
-            //       << " value=" << pmt::write_string(t.value)
-            //       << "\n";
-
-            // }
+        get_tags_in_range(tags, 0, abs_start, abs_end, WIFI_START_KEY);
 
-
-        }
-        start_index_file.flush();
-        signal_file.flush();
-
-
-        // here i need to get all the tags in the input and write these tags 
-        // to start_index file
-
-        for (int item = 0; item < nin; item++) {
-          for (int k = 0; k < d_input_len; k++) {
-            signal_file << in[item * d_input_len + k] << "\n";
-          }
+        // 2) capture the coarse CFO of each start tag
+        for (const auto& t : tags) {
+            d_tag_value.clear();
+            pmt::serialize(t.value, d_tag_value);
+            d_capture->post(d_start_index_stream,
+                            t.offset,
+                            d_tag_value.data(),
+                            d_tag_value.size());
         }
 
-        signal_file << "xx" << "\n";
-
+        d_capture->post(d_signal_stream,
+                        abs_start,
+                        in,
+                        nin * d_input_len * sizeof(gr_complex));
 
         consume_each(nin);
         return 0;   // no output produced
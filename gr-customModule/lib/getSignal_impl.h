@@ -9,18 +9,32 @@
 #define INCLUDED_CUSTOMMODULE_GETSIGNAL_IMPL_H
 
 #include <gnuradio/customModule/getSignal.h>
+#include "capture_sink.h"
+#include <sstream>
 
 namespace gr {
   namespace customModule {
 
+    // Serialized tag value. Unlike pmt::serialize_str(), it keeps its storage from
+    // one tag to the next.
+    class tag_value_buf : public std::stringbuf
+    {
+     public:
+      const char* data() const { return pbase(); }
+      size_t size() const { return pptr() - pbase(); }
+      void clear() { pubseekpos(0, std::ios_base::out); }
+    };
+
     class getSignal_impl : public getSignal
     {
      private:
 
        const size_t d_item_size;
        const int d_input_len;
-       std::ofstream signal_file;
-       std::ofstream start_index_file;
+       capture_sink::sptr d_capture;
+       uint16_t d_signal_stream;
+       uint16_t d_start_index_stream;
+       tag_value_buf d_tag_value;
 
      public:
       getSignal_impl( int input_len,
@@ -7,10 +7,18 @@
 
 #include <gnuradio/io_signature.h>
 #include "getSyncsymbol_impl.h"
+#include <volk/volk.h>
+#include <algorithm>
 
 namespace gr {
   namespace customModule {
 
+    namespace {
+    // Offsets whose FFT metric comes within this fraction of the best one are
+    // evaluated again directly, so the FFT's rounding cannot change the result.
+    constexpr float SCREEN_MARGIN = 0.99f;
+    } // namespace
+
     using input_type = gr_complex;
 
     // using output_type = gr_complex;
@@ -64,25 +72,17 @@ namespace gr {
               d_new_symbol_diffs(0, 0),
               d_first_active_carrier(0),
               d_last_active_carrier(sync_symbol2.size() - 1),
-              d_interpolate(false)
+              d_interpolate(false),
+              d_fwd(d_fft_len),
+              d_rev(d_fft_len),
+              d_ref_spectrum(d_fft_len),
+              d_sync_syms(2 * d_fft_len),
+              d_capture(capture_sink::get()),
+              d_carr_offset_stream(
+                  d_capture->add_stream(CAPTURE_CARRIER_OFFSET, sync_filename1)),
+              d_sync_stream(d_capture->add_stream(CAPTURE_SYNC_SYMBOLS, sync_filename2))
     {   
-        std::ofstream(sync_filename1).close();
-        std::ofstream(sync_filename2).close();
-        std::ofstream(fine_cfo_filename).close();
-
-        //openfiles  for writing
-        sync_file1.open(sync_filename1, std::ios::out | std::ios::app);
-        if(!sync_file1.is_open()) {
-          throw std::runtime_error("Failed to oepn sync1 file: " + sync_filename1);
-        }
-        sync_file2.open(sync_filename2, std::ios::out | std::ios::app);
-        if(!sync_file2.is_open()) {
-          throw std::runtime_error("Failed to open sync2 file" + sync_filename2);
-        }
-        fine_cfo_file.open(fine_cfo_filename, std::ios::out | std::ios::app);
-        if(!fine_cfo_file.is_open()) {
-          throw std::runtime_error("Failed to open cfo file" + fine_cfo_filename);
-        }
+        // Nothing was ever written to fine_cfo_filename, so it gets no stream.
         
               // Set index of first and last active carrier
         for (int i = 0; i < d_fft_len; i++) {
@@ -144,6 +144,18 @@ namespace gr {
                 d_known_symbol_diffs[i] = std::norm(sync_symbol1[i] - sync_symbol1[i + 2]);
             }
         }
+
+        // Spectrum of the reference the received sequence is correlated with
+        gr_complex* ref = d_fwd.get_inbuf();
+        for (int i = 0; i < d_fft_len; i++) {
+            ref[i] = d_corr_v.empty() ? gr_complex(d_known_symbol_diffs[i], 0) : d_corr_v[i];
+        }
+        d_fwd.execute();
+        for (int i = 0; i < d_fft_len; i++) {
+            d_ref_spectrum[i] = std::conj(d_fwd.get_outbuf()[i]) / float(d_fft_len);
+        }
+        d_offset_metrics.resize(
+            std::max(0, (d_max_pos_carr_offset - d_max_neg_carr_offset) / 2 + 1));
     }
 
     /*
@@ -151,51 +163,85 @@ namespace gr {
      */
     getSyncsymbol_impl::~getSyncsymbol_impl() {}
     
-    int getSyncsymbol_impl::get_carr_offset(const gr_complex* sync_sym1,
-                                            const gr_complex* sync_sym2)
+    float getSyncsymbol_impl::carr_offset_metric(int carr_offset,
+                                                 const gr_complex* sync_sym1,
+                                                 const gr_complex* sync_sym2)
     {
-        int carr_offset = 0;
+        const int g = carr_offset;
         if (!d_corr_v.empty()) {
-            // Use Schmidl & Cox method
-            float Bg_max = 0;
-            // g here is 2g in the paper
-            for (int g = d_max_neg_carr_offset; g <= d_max_pos_carr_offset; g += 2) {
-                gr_complex tmp = gr_complex(0, 0);
-                for (int k = 0; k < d_fft_len; k++) {
-                    if (d_corr_v[k] != gr_complex(0, 0)) {
-                        tmp += std::conj(sync_sym1[k + g]) * std::conj(d_corr_v[k]) *
-                              sync_sym2[k + g];
-                    }
-                }
-                if (std::abs(tmp) > Bg_max) {
-                    Bg_max = std::abs(tmp);
-                    carr_offset = g;
+            // Schmidl & Cox
+            gr_complex tmp = gr_complex(0, 0);
+            for (int k = 0; k < d_fft_len; k++) {
+                if (d_corr_v[k] != gr_complex(0, 0)) {
+                    tmp += std::conj(sync_sym1[k + g]) * std::conj(d_corr_v[k]) *
+                          sync_sym2[k + g];
                 }
             }
+            return std::abs(tmp);
+        }
+        float sum = 0;
+        for (int j = 0; j < d_fft_len; j++) {
+            if (d_known_symbol_diffs[j]) {
+                sum += (d_known_symbol_diffs[j] * d_new_symbol_diffs[j + g]);
+            }
+        }
+        return sum;
+    }
+
+    int getSyncsymbol_impl::get_carr_offset(const gr_complex* sync_sym1,
+                                            const gr_complex* sync_sym2)
+    {
+        // The metric of offset g is sum_k conj(r[k]) * x[k + g], with the reference r
+        // and the received sequence x:
+        // - two sync symbols (Schmidl & Cox): r = d_corr_v, x = conj(sym1) * sym2,
+        //   metric |.|
+        // - one sync symbol: r and x are the differences of every other carrier of
+        //   the known and the received symbol, metric Re(.)
+        // For all offsets at once, that is IFFT(FFT(x) * conj(FFT(r))). The offset
+        // limits keep k + g inside the symbol, so the circular correlation is exact.
+        gr_complex* x = d_fwd.get_inbuf();
+        if (!d_corr_v.empty()) {
+            volk_32fc_x2_multiply_conjugate_32fc(x, sync_sym2, sync_sym1, d_fft_len);
         } else {
-            // Correlate
             std::fill(d_new_symbol_diffs.begin(), d_new_symbol_diffs.end(), 0);
             for (int i = 0; i < d_fft_len - 2; i++) {
                 d_new_symbol_diffs[i] = std::norm(sync_sym1[i] - sync_sym1[i + 2]);
             }
+            for (int i = 0; i < d_fft_len; i++) {
+                x[i] = gr_complex(d_new_symbol_diffs[i], 0);
+            }
+        }
+        d_fwd.execute();
+        volk_32fc_x2_multiply_32fc(
+            d_rev.get_inbuf(), d_fwd.get_outbuf(), d_ref_spectrum.data(), d_fft_len);
+        d_rev.execute();
+        const gr_complex* corr = d_rev.get_outbuf();
 
-            float sum;
-            float max = 0;
-            for (int g = d_max_neg_carr_offset; g <= d_max_pos_carr_offset; g += 2) {
-                sum = 0;
-                for (int j = 0; j < d_fft_len; j++) {
-                    if (d_known_symbol_diffs[j]) {
-                        sum += (d_known_symbol_diffs[j] * d_new_symbol_diffs[j + g]);
-                    }
-                    if (sum > max) {
-                        max = sum;
-                        carr_offset = g;
-                    }
-                }
+        float best = 0;
+        for (size_t n = 0; n < d_offset_metrics.size(); n++) {
+            const int g = d_max_neg_carr_offset + 2 * n;
+            const gr_complex c = corr[(g + d_fft_len) % d_fft_len];
+            d_offset_metrics[n] = d_corr_v.empty() ? c.real() : std::abs(c);
+            best = std::max(best, d_offset_metrics[n]);
+        }
+
+        // The strongest offsets, directly and in the order of the plain search: the
+        // first one with the largest metric wins.
+        int carr_offset = 0;
+        float max = 0;
+        for (size_t n = 0; n < d_offset_metrics.size(); n++) {
+            if (d_offset_metrics[n] < best * SCREEN_MARGIN) {
+                continue;
+            }
+            const int g = d_max_neg_carr_offset + 2 * n;
+            const float metric = carr_offset_metric(g, sync_sym1, sync_sym2);
+            if (metric > max) {
+                max = metric;
+                carr_offset = g;
             }
         }
         return carr_offset;
-    } 
+    }
 
     void getSyncsymbol_impl::get_syncwords(const gr_complex* sync_sym1,
                                               const gr_complex* sync_sym2,
@@ -205,8 +251,9 @@ namespace gr {
         // const gr_complex* sym = ((d_n_sync_syms == 2) ? sync_sym2 : sync_sym1);
         const gr_complex* sym1 = sync_sym1;
         const gr_complex* sym2 = sync_sym2;
-        std::vector<gr_complex> sym1_temp(d_fft_len, gr_complex(0, 0));
-        std::vector<gr_complex> sym2_temp(d_fft_len, gr_complex(0, 0)); 
+        gr_complex* sym1_temp = d_sync_syms.data();
+        gr_complex* sym2_temp = d_sync_syms.data() + d_fft_len;
+        std::fill(d_sync_syms.begin(), d_sync_syms.end(), gr_complex(0, 0));
         std::fill(taps.begin(), taps.end(), gr_complex(0, 0));
         int loop_start = 0;
         int loop_end = d_fft_len;
@@ -223,14 +270,11 @@ namespace gr {
               sym2_temp[i - carr_offset] = sym2[i];
             }
         }
-        for(int i = 0; i < d_fft_len; i++){
-          // store the two received symbols sym1 and sym2 after carrier_offset correction into two files 
-          // namely syn1.txt and syn2.txt
-            sync_file1 << sym1_temp[i] << std::endl;
-            sync_file2 << sym2_temp[i] << std::endl;
-        }
-        sync_file1 << "\n";
-        sync_file2 << "\n";
+        // store the two received symbols sym1 and sym2 after carrier_offset correction
+        d_capture->post(d_sync_stream,
+                        nitems_read(0),
+                        d_sync_syms.data(),
+                        d_sync_syms.size() * sizeof(gr_complex));
     }
 
     int
@@ -251,8 +295,8 @@ namespace gr {
           //   sync_file2 << "noutput_items: "  << noutput_items;
 
         //   sync_file1 <<  "Fine grained CFO: starting: " <<  "\n" <<std::endl;
-        sync_file1 <<  carr_offset  <<std::endl;
-        sync_file1 << "\n" << std::endl;
+        const int32_t record = carr_offset;
+        d_capture->post(d_carr_offset_stream, nitems_read(0), &record, sizeof(record));
     //   sync_file1 <<  "Fine grained CFO ending" <<  "\n" <<std::endl;
     //   sync_file1 << "\n";
 
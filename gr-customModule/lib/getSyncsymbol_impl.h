@@ -9,6 +9,8 @@
 #define INCLUDED_CUSTOMMODULE_GETSYNCSYMBOL_IMPL_H
 
 #include <gnuradio/customModule/getSyncsymbol.h>
+#include <gnuradio/fft/fft.h>
+#include "capture_sink.h"
 
 namespace gr {
   namespace customModule {
@@ -45,12 +47,25 @@ namespace gr {
         int d_max_neg_carr_offset;
         //! Maximum carrier offset (positive value!)
         int d_max_pos_carr_offset;
-        std::ofstream sync_file1;
-        std::ofstream sync_file2;
-        std::ofstream fine_cfo_file;
+        //! Correlates the received sequence with the reference for all offsets at once
+        gr::fft::fft_complex_fwd d_fwd;
+        gr::fft::fft_complex_rev d_rev;
+        //! conj(FFT(d_corr_v or d_known_symbol_diffs)) / d_fft_len
+        std::vector<gr_complex> d_ref_spectrum;
+        //! FFT-based metric per even carrier offset, from d_max_neg_carr_offset on
+        std::vector<float> d_offset_metrics;
+        //! Both sync symbols after the carrier offset correction
+        std::vector<gr_complex> d_sync_syms;
+        capture_sink::sptr d_capture;
+        uint16_t d_carr_offset_stream;
+        uint16_t d_sync_stream;
 
         //! Calculate the coarse frequency offset in number of carriers
         int get_carr_offset(const gr_complex* sync_sym1, const gr_complex* sync_sym2);
+        //! The metric of one carrier offset, computed directly
+        float carr_offset_metric(int carr_offset,
+                                 const gr_complex* sync_sym1,
+                                 const gr_complex* sync_sym2);
         //! Estimate the channel (phase and amplitude offset per carrier)
         void get_syncwords(const gr_complex* sync_sym1,
                           const gr_complex* sync_sym2,
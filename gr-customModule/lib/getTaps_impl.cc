@@ -15,6 +15,9 @@
 namespace gr {
 namespace customModule {
 
+static const pmt::pmt_t CHAN_TAPS_KEY = pmt::mp("ofdm_sync_chan_taps");
+static const pmt::pmt_t CARR_OFFSET_KEY = pmt::mp("ofdm_sync_carr_offset");
+
 using input_type = gr_complex;
 getTaps::sptr 
 getTaps::make(
@@ -54,7 +57,7 @@ getTaps_impl::getTaps_impl(
 
      d_propagate_channel_state(propagate_channel_state),
      d_fixed_frame_len(fixed_frame_len),
-     d_channel_state(fft_len, gr_complex(1,0))                
+     d_capture(capture_sink::get())
   
 {   
     // std::cout << "working" <<std::endl;
@@ -62,20 +65,8 @@ getTaps_impl::getTaps_impl(
     if (d_fixed_frame_len < 0) {
         throw std::invalid_argument("Invalid frame length!");
     }
-    // Create the files by opening them in "out" mode and immediately closing
-    std::ofstream(channel_taps_filename).close();
-    std::ofstream(carrier_offsets_filename).close();
-
-    // Open files for writing
-    channel_taps_file.open(channel_taps_filename, std::ios::out | std::ios::app);
-    if (!channel_taps_file.is_open()) {
-        throw std::runtime_error("Failed to open channel taps file: " + channel_taps_filename);
-    }
-
-    carrier_offset_file.open(carrier_offsets_filename, std::ios::out | std::ios::app);
-    if (!carrier_offset_file.is_open()) {
-        throw std::runtime_error("Failed to open carrier offsets file: " + carrier_offsets_filename);
-    }
+    // The carrier offsets were never written, so they get no stream.
+    d_taps_stream = d_capture->add_stream(CAPTURE_CHANNEL_TAPS, channel_taps_filename);
 }
 
 /*
@@ -100,15 +91,12 @@ int getTaps_impl::work(int noutput_items, // the length in items of all input an
     get_tags_in_window(tags, 0, 0, 1);
 
     for (unsigned i = 0; i < tags.size(); i++) {
-        if (pmt::symbol_to_string(tags[i].key) == "ofdm_sync_chan_taps") {
-            d_channel_state = pmt::c32vector_elements(tags[i].value);// d_channel-state --> channel_taps
-            
-            for (const auto& tap: d_channel_state) {
-                channel_taps_file << tap.real() << " " << tap.imag() << " ";
-            }
-            channel_taps_file << "\n";
+        if (tags[i].key == CHAN_TAPS_KEY) {
+            size_t n_taps;
+            const gr_complex* taps = pmt::c32vector_elements(tags[i].value, n_taps);
+            d_capture->post(d_taps_stream, tags[i].offset, taps, n_taps * sizeof(gr_complex));
         }
-        if (pmt::symbol_to_string(tags[i].key) == "ofdm_sync_carr_offset") {
+        if (tags[i].key == CARR_OFFSET_KEY) {
             
        
             // carrier_offset = pmt::to_long(tags[i].value);//print out this value
@@ -11,6 +11,7 @@
 #define INCLUDED_CUSTOMMODULE_GETTAPS_IMPL_H
 
 #include <gnuradio/customModule/getTaps.h>
+#include "capture_sink.h"
 
 namespace gr {
 namespace customModule {
@@ -25,11 +26,10 @@ private:
     const int d_fixed_frame_len;
     // const std::string& chaneel_taps_filename;
     // const std::string& carrier_offsets_filename;
-    std::vector<gr_complex>d_channel_state;    
     std::vector<std::vector<gr_complex>> d_all_channel_taps; // For storing all ofdm_sync_chan_taps
     std::vector<int> d_all_carrier_offsets; // For storing all ofdm_sync_carr_offset values
-    std::ofstream channel_taps_file;
-    std::ofstream carrier_offset_file;
+    capture_sink::sptr d_capture;
+    uint16_t d_taps_stream;
 
 
 public:
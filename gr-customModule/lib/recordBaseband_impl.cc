@@ -30,6 +30,30 @@
 namespace gr {
   namespace customModule {
 
+namespace {
+// Ring sizes of the recordings. The writer thread drains them every 20 ms, which
+// is 3.2 MB of raw IQ at 20 Msps; the rest absorbs stalls of the disk.
+constexpr size_t RAWIQ_RING_BYTES = 64 << 20;
+constexpr size_t CFO_RING_BYTES = 32 << 20;
+
+std::string make_file_header(baseband_item_type_t item_type,
+                             size_t item_size,
+                             int items_per_symbol,
+                             int guard_interval,
+                             double samp_rate)
+{
+    baseband_file_header header = {};
+    std::memcpy(header.magic, BASEBAND_MAGIC, sizeof(header.magic));
+    header.header_size = sizeof(baseband_file_header);
+    header.item_type = item_type;
+    header.item_size = item_size;
+    header.items_per_symbol = items_per_symbol;
+    header.guard_interval = guard_interval;
+    header.samp_rate = samp_rate;
+    return std::string(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+} // namespace
+
 const pmt::pmt_t recordBaseband_impl::msg_port_id()
 {
     static const pmt::pmt_t msg_port_id = pmt::mp("header_data");
@@ -161,22 +185,27 @@ enum demux_states_t {
               d_sampling_time(1.0 / samp_rate)
     {
             std::ofstream(payload_filename).close();
-            std::ofstream(cfo_filename).close();
             //openfiles  for writing
             payload_file.open(payload_filename, std::ios::out | std::ios::app);
             if(!payload_file.is_open()) {
             throw std::runtime_error("Failed to oepn payload_file file: " + payload_filename);
             }
-            cfo_file.open(cfo_filename, std::ios::out | std::ios::app);
-            if(!cfo_file.is_open()) {
+            d_cfo_writer.reset(new record_writer(
+                cfo_filename,
+                make_file_header(
+                    BASEBAND_FLOAT, sizeof(float), items_per_symbol, guard_interval, samp_rate),
+                CFO_RING_BYTES));
+            if(!d_cfo_writer->is_open()) {
             throw std::runtime_error("Failed to open cfo_file file" + cfo_filename);
             }
-            rawiq_file.open(rawiq_filename, std::ios::out | std::ios::app);
-            if(!rawiq_file.is_open()) {
+            d_rawiq_writer.reset(new record_writer(
+                rawiq_filename,
+                make_file_header(
+                    BASEBAND_COMPLEX, itemsize, items_per_symbol, guard_interval, samp_rate),
+                RAWIQ_RING_BYTES));
+            if(!d_rawiq_writer->is_open()) {
             throw std::runtime_error("Failed to open rawiq file" + rawiq_filename);
             }
-          // Initialize the CFO buffer.
-          d_cfo_buffer.clear();
 
           if (d_header_len < 1) {
               throw std::invalid_argument("Header length must be at least 1 symbol.");
@@ -212,6 +241,21 @@ enum demux_states_t {
     {
     }
 
+    bool recordBaseband_impl::stop()
+    {
+      d_cfo_writer->flush();
+      d_rawiq_writer->flush();
+      if (d_cfo_writer->dropped() || d_rawiq_writer->dropped()) {
+          d_logger->warn("Recording fell behind: dropped {:d} of {:d} cfo and {:d} of {:d} "
+                         "raw iq records",
+                         d_cfo_writer->dropped(),
+                         d_cfo_writer->written() + d_cfo_writer->dropped(),
+                         d_rawiq_writer->dropped(),
+                         d_rawiq_writer->written() + d_rawiq_writer->dropped());
+      }
+      return true;
+    }
+
     // forecast() now sets different requirements for the new CFO port.
     void recordBaseband_impl::forecast(int noutput_items, 
                                        gr_vector_int& ninput_items_required)
@@ -368,15 +412,17 @@ enum demux_states_t {
             }
             break;
     
-        case STATE_PAYLOAD:
-            // For payload processing, also check that the CFO port has enough items.
-            if (ninput_items[IN_PORT_CFO] < d_curr_payload_len) {
+        case STATE_PAYLOAD: {
+            // The recordings take the whole payload from the raw and CFO ports too.
+            const int payload_items = d_curr_payload_len * (d_items_per_symbol + d_gi);
+            if (ninput_items[IN_PORT_RAW] - n_items_read < payload_items ||
+                ninput_items[IN_PORT_CFO] - n_items_read < payload_items) {
                 return 0;
             }
             if (check_buffers_ready(d_curr_payload_len,
                                     0,
                                     noutput_items,
-                                    d_curr_payload_len * (d_items_per_symbol + d_gi),
+                                    payload_items,
                                     ninput_items,
                                     n_items_read)) {
                 // Write payload from main data input.
@@ -384,31 +430,29 @@ enum demux_states_t {
                                out_payload,
                                PORT_PAYLOAD,
                                n_items_read_base + n_items_read,
-                               d_curr_payload_len);              
-                // Record CFO values from the CFO port.
-                // const float* in_cfo_1 = (const float*)input_items[IN_PORT_CFO];
-                cfo_file << "frame_length: " << d_curr_payload_len << " + CFO value: " << "\n" << std::endl;
-                for (int i = 0; i < d_curr_payload_len; i++) {
-                    //start at i = i + d_gi, then do the loop item_per_symbol times, then start at i + dgi + items_per_symbol
-                    for (int j = 0; j < d_items_per_symbol; j++) {           
-                        // d_cfo_buffer.push_back(in_cfo[i]);
-                        //write the cfo value into the files here
-                        cfo_file << in_cfo_1[j + (i * d_items_per_symbol + d_gi)]  << std::endl; // how to 
-                    }
-    
-                }
-                rawiq_file << "frame_length: " << d_curr_payload_len << " + Raw Iq starting: " << "\n" << std::endl;
-                // how to make a cast here, 
-                for (int i = 0; i < d_curr_payload_len; i++) {
-                    //start at i = i + d_gi, then do the loop item_per_symbol times, then start at i + dgi + items_per_symbol
-                    for (int j = 0; j < d_items_per_symbol; j++) {           
-                        // d_cfo_buffer.push_back(in_cfo[i]);
-                        //write the cfo value into the files here
-                        rawiq_file << in_raw[j + (i * d_items_per_symbol + d_gi)]  << std::endl; // how to 
-                    }
-    
-                }
-                //TODO 
+                               d_curr_payload_len);
+                // Record the CFO values and the raw IQ of the payload.
+                const uint64_t payload_offset = n_items_read_base + n_items_read;
+                const pmt::pmt_t payload_time =
+                    d_track_time
+                        ? _update_pmt_time(d_last_time,
+                                           d_sampling_time *
+                                               (payload_offset - d_last_time_offset))
+                        : pmt::PMT_NIL;
+                record_payload(*d_cfo_writer,
+                               in_cfo_1,
+                               sizeof(float),
+                               payload_offset,
+                               payload_items,
+                               d_payload_tags,
+                               payload_time);
+                record_payload(*d_rawiq_writer,
+                               in_raw,
+                               d_itemsize,
+                               payload_offset,
+                               payload_items,
+                               d_payload_tags,
+                               payload_time);
                 // Consume payload items from the other three input ports.
                 const int items_padding = std::max(d_header_padding_total_items, 1);
                 const int items_to_consume =
@@ -419,6 +463,7 @@ enum demux_states_t {
             }
             
             break;
+        } /* case STATE_PAYLOAD */
     
         default:
             throw std::runtime_error("invalid state");
@@ -492,6 +537,13 @@ enum demux_states_t {
                         pmt::write_string(header_data));
     }
     if (d_state == STATE_HEADER_RX_SUCCESS) {
+        // Serialized here, off the work thread, for the recordings.
+        pmt::pmt_t payload_tags = pmt::make_dict();
+        for (size_t i = 0; i < d_payload_tag_keys.size(); i++) {
+            payload_tags =
+                pmt::dict_add(payload_tags, d_payload_tag_keys[i], d_payload_tag_values[i]);
+        }
+        d_payload_tags = pmt::serialize_str(payload_tags);
         if (d_curr_payload_len < 0) {
             d_logger->warn("Received negative payload length: ({:d} symbols)",
                            d_curr_payload_len);
@@ -606,6 +658,41 @@ void recordBaseband_impl::add_special_tags()
     }
 } /* add_special_tags() */
 
+void recordBaseband_impl::record_payload(record_writer& writer,
+                                         const void* samples,
+                                         size_t item_size,
+                                         uint64_t offset,
+                                         int n_items,
+                                         const std::string& tags,
+                                         const pmt::pmt_t& time)
+{
+    static const char zeros[8] = {};
+    const size_t tags_padding = (8 - tags.size() % 8) % 8;
+    const size_t samples_size = n_items * item_size;
+
+    baseband_frame_header header = {};
+    header.record_size =
+        sizeof(baseband_frame_header) + tags.size() + tags_padding + samples_size;
+    header.tags_size = tags.size();
+    header.offset = offset;
+    header.payload_len = d_curr_payload_len;
+    header.n_items = n_items;
+    if (pmt::is_tuple(time)) {
+        header.time_seconds = pmt::to_uint64(pmt::tuple_ref(time, 0));
+        header.time_frac = pmt::to_double(pmt::tuple_ref(time, 1));
+    }
+
+    // A full ring drops the record; stop() reports how many.
+    if (!writer.begin(header.record_size)) {
+        return;
+    }
+    writer.append(&header, sizeof(header));
+    writer.append(tags.data(), tags.size());
+    writer.append(zeros, tags_padding);
+    writer.append(samples, samples_size);
+    writer.commit();
+} /* record_payload() */
+
 
 
   } /* namespace customModule */
@@ -11,10 +11,47 @@
 #define INCLUDED_CUSTOMMODULE_RECORDBASEBAND_IMPL_H
 #include <gnuradio/io_signature.h>
 #include <gnuradio/customModule/recordBaseband.h>
+#include "record_writer.h"
+#include <memory>
 
 namespace gr {
   namespace customModule {
 
+    /*
+     * Layout of the cfo and rawiq recordings, little endian:
+     *
+     *   baseband_file_header
+     *   per payload: baseband_frame_header, tags_size bytes of the payload tags as
+     *       a serialized PMT dict (padded with zeros to a multiple of 8), then
+     *       n_items raw samples of item_size bytes, guard intervals included
+     *
+     * python/customModule/baseband_recording.py reads these files and converts
+     * them to the former text format.
+     */
+    struct baseband_file_header {
+      char magic[8];            // BASEBAND_MAGIC
+      uint32_t header_size;     // sizeof(baseband_file_header)
+      uint32_t item_type;       // BASEBAND_COMPLEX or BASEBAND_FLOAT
+      uint32_t item_size;
+      uint32_t items_per_symbol;
+      uint32_t guard_interval;
+      uint32_t reserved;
+      double samp_rate;
+    };
+
+    struct baseband_frame_header {
+      uint32_t record_size;     // bytes, this header included
+      uint32_t tags_size;       // bytes, without the padding
+      uint64_t offset;          // item number of the first payload sample
+      uint32_t payload_len;     // symbols
+      uint32_t n_items;
+      uint64_t time_seconds;    // rx time of the first payload sample,
+      double time_frac;         // 0 without a timing tag key
+    };
+
+    constexpr char BASEBAND_MAGIC[8] = { 'B', 'B', 'R', 'E', 'C', 'O', 'R', 'D' };
+    enum baseband_item_type_t { BASEBAND_COMPLEX = 0, BASEBAND_FLOAT = 1 };
+
     class recordBaseband_impl : public recordBaseband
     {
      private:
@@ -37,6 +74,7 @@ namespace gr {
           d_payload_tag_keys; //!< Temporary buffer for PMTs that go on the payload (keys)
       std::vector<pmt::pmt_t> d_payload_tag_values; //!< Temporary buffer for PMTs that go
                                                     //!< on the payload (values)
+      std::string d_payload_tags;      //!< The payload tags, serialized for the recordings
       bool d_track_time;               //!< Whether or not to keep track of the rx time
       pmt::pmt_t d_timing_key;         //!< Key of the timing tag (usually 'rx_time')
       pmt::pmt_t d_payload_offset_key; //!< Key of payload offset (usually 'payload_offset')
@@ -46,10 +84,9 @@ namespace gr {
       std::vector<pmt::pmt_t> d_special_tags; //!< List of special tags
       std::vector<pmt::pmt_t>
       d_special_tags_last_value; //!< The current value of the special tags
-      std::vector<float> d_cfo_buffer;
       std::ofstream payload_file;
-      std::ofstream cfo_file;
-      std::ofstream rawiq_file;
+      std::unique_ptr<record_writer> d_cfo_writer;
+      std::unique_ptr<record_writer> d_rawiq_writer;
       static const pmt::pmt_t msg_port_id(); //!< Message Port Id
       void parse_header_data_msg(pmt::pmt_t header_data);
 
@@ -70,7 +107,14 @@ namespace gr {
                           const uint64_t n_items_read_base,
                           int n_symbols,
                           int n_padding_items = 0);
-      void add_special_tags();                   
+      void add_special_tags();
+      void record_payload(record_writer& writer,
+                          const void* samples,
+                          size_t item_size,
+                          uint64_t offset,
+                          int n_items,
+                          const std::string& tags,
+                          const pmt::pmt_t& time);
 
      public:
       recordBaseband_impl(int header_len,
@@ -90,6 +134,8 @@ namespace gr {
                           const std::string& rawiq_filename);
       ~recordBaseband_impl();
 
+      bool stop() override;
+
       // Where all the action really happens
       // void forecast (int noutput_items, gr_vector_int &ninput_items_required);
       void forecast(int noutput_items, gr_vector_int& ninput_items_required) override;
@@ -0,0 +1,85 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 xinyu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "record_writer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace gr {
+namespace customModule {
+
+record_writer::record_writer(const std::string& path,
+                             const std::string& file_header,
+                             size_t capacity)
+    : d_ring(capacity),
+      d_head(0),
+      d_tail(0),
+      d_fill(0),
+      d_records(0),
+      d_dropped(0)
+{
+    if (!path.empty()) {
+        d_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+    if (d_file.is_open()) {
+        d_file.write(file_header.data(), file_header.size());
+        d_file.flush();
+    }
+
+    start();
+}
+
+record_writer::~record_writer() { stop(); }
+
+bool record_writer::begin(size_t size)
+{
+    const uint64_t tail = d_tail.load(std::memory_order_relaxed);
+    if (!d_file.is_open() ||
+        tail + size - d_head.load(std::memory_order_acquire) > d_ring.size()) {
+        d_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    d_fill = tail;
+    return true;
+}
+
+void record_writer::append(const void* data, size_t size)
+{
+    // A record may wrap around the end of the ring.
+    const char* src = static_cast<const char*>(data);
+    while (size > 0) {
+        const size_t pos = d_fill % d_ring.size();
+        const size_t count = std::min(size, d_ring.size() - pos);
+        std::memcpy(&d_ring[pos], src, count);
+        src += count;
+        size -= count;
+        d_fill += count;
+    }
+}
+
+void record_writer::commit()
+{
+    d_tail.store(d_fill, std::memory_order_release);
+    d_records.fetch_add(1, std::memory_order_relaxed);
+}
+
+void record_writer::drain()
+{
+    const uint64_t tail = d_tail.load(std::memory_order_acquire);
+    uint64_t head = d_head.load(std::memory_order_relaxed);
+    while (head != tail) {
+        // Committed bytes that wrap around take a second write.
+        const size_t first = head % d_ring.size();
+        const size_t count = std::min<uint64_t>(tail - head, d_ring.size() - first);
+        d_file.write(&d_ring[first], count);
+        head += count;
+        d_head.store(head, std::memory_order_release);
+    }
+}
+
+} // namespace customModule
+} // namespace gr
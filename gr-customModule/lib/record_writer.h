@@ -0,0 +1,62 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 xinyu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_CUSTOMMODULE_RECORD_WRITER_H
+#define INCLUDED_CUSTOMMODULE_RECORD_WRITER_H
+
+#include "ring_writer.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace customModule {
+
+/*
+ * Writes variable-size records to a binary file from a background thread.
+ *
+ * The block copies each record into a preallocated single-producer,
+ * single-consumer byte ring: begin() checks that the whole record fits, append()
+ * copies its parts and commit() publishes it. None of these lock, allocate or
+ * touch the file. If the ring is full the record is dropped and counted, so a
+ * slow disk never stalls the scheduler thread.
+ */
+class record_writer : public ring_writer
+{
+public:
+    // Writes `file_header` to a truncated `path` first. An empty path writes
+    // nothing; begin() then always fails.
+    record_writer(const std::string& path,
+                  const std::string& file_header,
+                  size_t capacity);
+    ~record_writer() override;
+
+    // Start a record of `size` bytes. Returns false, and counts the record as
+    // dropped, if the file is not open or the ring has no room for it.
+    bool begin(size_t size);
+    void append(const void* data, size_t size);
+    void commit();
+
+    uint64_t written() const { return d_records.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return d_dropped.load(std::memory_order_relaxed); }
+
+private:
+    void drain() override;
+
+    std::vector<char> d_ring;
+    std::atomic<uint64_t> d_head; // next byte to write, owned by the thread
+    std::atomic<uint64_t> d_tail; // end of the committed bytes, owned by the block
+    uint64_t d_fill;              // end of the record being appended
+    std::atomic<uint64_t> d_records;
+    std::atomic<uint64_t> d_dropped;
+};
+
+} // namespace customModule
+} // namespace gr
+
+#endif /* INCLUDED_CUSTOMMODULE_RECORD_WRITER_H */
@@ -0,0 +1,91 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 xinyu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "ring_writer.h"
+#include <boost/chrono.hpp>
+
+namespace gr {
+namespace customModule {
+
+namespace {
+// The work() functions only publish their records and never signal the writer, so
+// the writer checks the ring on this period instead. Between two checks the
+// records pile up in the ring (see RAWIQ_RING_BYTES in recordBaseband_impl.cc).
+constexpr int POLL_MS = 20;
+} // namespace
+
+ring_writer::ring_writer()
+    : d_flush_requested(0), d_flush_done(0), d_woken(false), d_stop(false)
+{
+}
+
+ring_writer::~ring_writer() {}
+
+void ring_writer::start()
+{
+    d_thread = gr::thread::thread([this]() { thread_main(); });
+}
+
+void ring_writer::stop()
+{
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_stop = true;
+    }
+    d_wake.notify_one();
+    d_thread.join();
+}
+
+void ring_writer::wake()
+{
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_woken = true;
+    }
+    d_wake.notify_one();
+}
+
+void ring_writer::flush()
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    const uint64_t request = ++d_flush_requested;
+    d_wake.notify_one();
+    while (d_flush_done < request) {
+        d_flushed.wait(lock);
+    }
+}
+
+void ring_writer::thread_main()
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    for (;;) {
+        const bool stop = d_stop;
+        const uint64_t flush_request = d_flush_requested;
+        d_woken = false;
+        lock.unlock();
+
+        if (d_file.is_open()) {
+            drain();
+            if (stop || flush_request != d_flush_done) {
+                d_file.flush();
+            }
+        }
+
+        lock.lock();
+        d_flush_done = flush_request;
+        d_flushed.notify_all();
+        if (stop) {
+            return;
+        }
+        if (!d_stop && !d_woken && d_flush_requested == flush_request) {
+            d_wake.wait_for(lock, boost::chrono::milliseconds(POLL_MS));
+        }
+    }
+}
+
+} // namespace customModule
+} // namespace gr
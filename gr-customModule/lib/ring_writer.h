@@ -0,0 +1,68 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2025 xinyu.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_CUSTOMMODULE_RING_WRITER_H
+#define INCLUDED_CUSTOMMODULE_RING_WRITER_H
+
+#include <gnuradio/thread/thread.h>
+#include <cstdint>
+#include <fstream>
+
+namespace gr {
+namespace customModule {
+
+/*
+ * The file and the background thread of a writer whose producers fill a lock-free
+ * ring in memory. The thread calls drain() of the derived class to move what was
+ * committed into d_file, on a timer and on flush(), so producers never signal it.
+ *
+ * A derived class calls start() once its ring is set up and stop() at the top of
+ * its destructor, since the thread calls into it.
+ */
+class ring_writer
+{
+public:
+    ring_writer(const ring_writer&) = delete;
+    ring_writer& operator=(const ring_writer&) = delete;
+
+    bool is_open() const { return d_file.is_open(); }
+
+    // Return once everything committed so far is on disk.
+    void flush();
+
+protected:
+    ring_writer();
+    virtual ~ring_writer();
+
+    void start();
+    // Drain once more and join the thread.
+    void stop();
+    // Drain now rather than at the end of the period. It locks, so not for work().
+    void wake();
+
+    // Write the committed contents of the ring to d_file. Runs on the thread.
+    virtual void drain() = 0;
+
+    std::ofstream d_file;
+
+private:
+    void thread_main();
+
+    gr::thread::mutex d_mutex;
+    gr::thread::condition_variable d_wake;
+    gr::thread::condition_variable d_flushed;
+    uint64_t d_flush_requested;
+    uint64_t d_flush_done;
+    bool d_woken;
+    bool d_stop;
+    gr::thread::thread d_thread;
+};
+
+} // namespace customModule
+} // namespace gr
+
+#endif /* INCLUDED_CUSTOMMODULE_RING_WRITER_H */
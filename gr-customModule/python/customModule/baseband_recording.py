@@ -0,0 +1,117 @@
+#
+# Copyright 2025 xinyu.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+# Reader for the cfo and rawiq recordings of recordBaseband, and a converter to the
+# text format the block used to write. A recording is a file header followed by one
+# record per payload: a frame header, the payload tags as a serialized PMT dict and
+# the raw samples, guard intervals included. See recordBaseband_impl.h.
+
+import argparse
+import struct
+import sys
+
+import numpy as np
+
+BASEBAND_MAGIC = b"BBRECORD"
+BASEBAND_COMPLEX = 0
+BASEBAND_FLOAT = 1
+
+_FILE_HEADER = struct.Struct("<8sIIIIIId")
+_FRAME_HEADER = struct.Struct("<IIQIIQd")
+
+
+def read_recording_header(f):
+    """Return the file header of an open recording as a dict."""
+    (magic, header_size, item_type, item_size, items_per_symbol, guard_interval,
+     _, samp_rate) = _FILE_HEADER.unpack(f.read(_FILE_HEADER.size))
+    if magic != BASEBAND_MAGIC:
+        raise ValueError("not a recordBaseband recording")
+    f.seek(header_size)
+    return {
+        "item_type": item_type,
+        "item_size": item_size,
+        "items_per_symbol": items_per_symbol,
+        "guard_interval": guard_interval,
+        "samp_rate": samp_rate,
+    }
+
+
+def _sample_dtype(header):
+    if header["item_type"] == BASEBAND_COMPLEX:
+        return np.dtype("<c%d" % header["item_size"])
+    return np.dtype("<f%d" % header["item_size"])
+
+
+def read_recording(path):
+    """Yield (frame, tags, samples) for each payload of a recording.
+
+    frame is a dict of the frame header fields, tags the serialized PMT dict of the
+    payload tags (bytes, see pmt.deserialize_str) and samples a numpy array. A record
+    the writer was still appending when the file was read is left out.
+    """
+    with open(path, "rb") as f:
+        header = read_recording_header(f)
+        dtype = _sample_dtype(header)
+        while True:
+            raw = f.read(_FRAME_HEADER.size)
+            if len(raw) < _FRAME_HEADER.size:
+                return
+            (record_size, tags_size, offset, payload_len, n_items, time_seconds,
+             time_frac) = _FRAME_HEADER.unpack(raw)
+            body = f.read(record_size - _FRAME_HEADER.size)
+            if len(body) < record_size - _FRAME_HEADER.size:
+                return
+            samples_start = len(body) - n_items * header["item_size"]
+            frame = {
+                "offset": offset,
+                "payload_len": payload_len,
+                "n_items": n_items,
+                "rx_time": (time_seconds, time_frac),
+            }
+            yield frame, body[:tags_size], np.frombuffer(body[samples_start:], dtype)
+
+
+def _format_value(value):
+    # Matches the default formatting of std::ostream for float and
+    # std::complex<float>.
+    if np.iscomplexobj(value):
+        return "(%g,%g)" % (value.real, value.imag)
+    return "%g" % value
+
+
+def to_text(path, out):
+    """Write a recording to `out` in the former text format of recordBaseband."""
+    with open(path, "rb") as f:
+        header = read_recording_header(f)
+    is_cfo = header["item_type"] == BASEBAND_FLOAT
+    title = " + CFO value: " if is_cfo else " + Raw Iq starting: "
+    items_per_symbol = header["items_per_symbol"]
+    guard_interval = header["guard_interval"]
+
+    for frame, _, samples in read_recording(path):
+        out.write("frame_length: %d%s\n\n" % (frame["payload_len"], title))
+        # The same items the block used to pick from each payload.
+        for i in range(frame["payload_len"]):
+            for j in range(items_per_symbol):
+                out.write(_format_value(samples[j + i * items_per_symbol + guard_interval]))
+                out.write("\n")
+
+
+def main(args=None):
+    parser = argparse.ArgumentParser(
+        description="Convert a recordBaseband cfo or rawiq recording to text.")
+    parser.add_argument("recording")
+    parser.add_argument("output", nargs="?", help="text file, stdout by default")
+    args = parser.parse_args(args)
+    if args.output:
+        with open(args.output, "w") as out:
+            to_text(args.recording, out)
+    else:
+        to_text(args.recording, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,110 @@
+#
+# Copyright 2025 xinyu.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+# Reader for the capture file the customModule probe blocks share (see
+# lib/capture_sink.h). The file holds one stream per former probe output file, named
+# after it. The records are scanned in order; the index at the end of the file, from
+# a run that shut down, adds the number of records each stream dropped.
+
+import struct
+
+import numpy as np
+
+CAPTURE_STREAM = 0
+CAPTURE_SAMPLES = 1
+CAPTURE_CHANNEL_TAPS = 2
+CAPTURE_CARRIER_OFFSET = 3
+CAPTURE_FREQ_OFFSET = 4
+CAPTURE_SERIALIZED_SIGNAL = 5
+CAPTURE_TAG = 6
+CAPTURE_SYNC_SYMBOLS = 7
+
+_FILE_HEADER = struct.Struct("<8sII")
+_RECORD_HEADER = struct.Struct("<IHHQ")
+_INDEX = struct.Struct("<8sII")
+_INDEX_ENTRY = struct.Struct("<IIQQ")
+_TRAILER = struct.Struct("<Q8s")
+
+
+def _padded(size):
+    return (size + 7) & ~7
+
+
+def _decode(record_type, payload):
+    """Return the payload of a record as numpy data, or a dict for the composite
+    record types. Tag values stay serialized PMTs (see pmt.deserialize_str)."""
+    if record_type in (CAPTURE_SAMPLES, CAPTURE_CHANNEL_TAPS, CAPTURE_SYNC_SYMBOLS):
+        return np.frombuffer(payload, dtype="<c8")
+    if record_type == CAPTURE_CARRIER_OFFSET:
+        return struct.unpack("<i", payload)[0]
+    if record_type == CAPTURE_FREQ_OFFSET:
+        n_items, last = struct.unpack("<if", payload)
+        return {"n_items": n_items, "last": last}
+    if record_type == CAPTURE_SERIALIZED_SIGNAL:
+        carrier_offset, frame_length = struct.unpack_from("<ii", payload)
+        return {"carrier_offset": carrier_offset,
+                "frame_length": frame_length,
+                "signal": np.frombuffer(payload[8:], dtype="<c8")}
+    return payload
+
+
+def _read_record(data, pos):
+    size, stream, record_type, offset = _RECORD_HEADER.unpack_from(data, pos)
+    return stream, record_type, offset, data[pos + _RECORD_HEADER.size:pos + size], size
+
+
+def load_capture(path):
+    """Read a capture file.
+
+    Returns a dict from stream name to a dict with the record type, the number of
+    dropped records (None without an index) and the list of (offset, payload)
+    records. A record the sink was still writing when the file was read is left out.
+    """
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, header_size, _ = _FILE_HEADER.unpack_from(data)
+    if magic != b"GRCAPTR1":
+        raise ValueError("%s is not a customModule capture" % path)
+
+    streams = {}
+    records = {}
+    end = len(data)
+    index_offset = None
+    if len(data) >= header_size + _TRAILER.size:
+        offset, trailer_magic = _TRAILER.unpack_from(data, len(data) - _TRAILER.size)
+        if trailer_magic == b"GRCAPEND":
+            index_offset = end = offset
+
+    pos = header_size
+    while pos + _RECORD_HEADER.size <= end:
+        stream, record_type, offset, payload, size = _read_record(data, pos)
+        if size < _RECORD_HEADER.size or pos + size > end:
+            break
+        if stream == CAPTURE_STREAM:
+            declared_type = struct.unpack_from("<I", payload)[0]
+            streams[offset] = (payload[4:].decode("utf-8"), declared_type)
+        else:
+            records.setdefault(stream, []).append(
+                (offset, _decode(record_type, payload)))
+        pos += _padded(size)
+
+    dropped = {}
+    if index_offset is not None:
+        _, n_streams, _ = _INDEX.unpack_from(data, index_offset)
+        pos = index_offset + _INDEX.size
+        for _ in range(n_streams):
+            stream, _, n_records, n_dropped = _INDEX_ENTRY.unpack_from(data, pos)
+            dropped[stream] = n_dropped
+            pos += _INDEX_ENTRY.size + 8 * n_records
+
+    result = {}
+    for stream, (name, record_type) in streams.items():
+        result[name] = {
+            "type": record_type,
+            "dropped": dropped.get(stream),
+            "records": records.get(stream, []),
+        }
+    return result
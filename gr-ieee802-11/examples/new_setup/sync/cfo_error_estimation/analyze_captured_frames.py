@@ -2,14 +2,10 @@
 """Compare raw (pre-equalizer) WiFi frames that PASSED the CRC against those that
 reached the salvage/erasure stage but still FAILED.
 
-Reads the two capture files written by frame_equalizer_impl.cc:
-    captured_good_frames.txt   (outcome=GOOD)
-    captured_fail_frames.txt   (outcome=FAIL)
-
-Each frame block is:
-    FRAME idx=.. outcome=.. tier=.. M=.. bytes=.. enc=.. nsym=.. total_sym=.. score=..
-    S <sym> re0 im0 re1 im1 ... re63 im63     (one line per OFDM symbol, 64 FFT bins)
-    END
+Reads the binary frame capture written by frame_equalizer_impl.cc
+(captured_frames.bin, both outcomes in one file; see gnuradio.ieee802_11.capture).
+Each record holds the frame's header fields (outcome, tier, M, bytes, enc, nsym,
+total/stored symbols, score) and its first 64 OFDM symbols, 64 FFT bins each.
 
 The samples are the FFT'd, SFO/common-phase-corrected symbols BEFORE channel
 equalization or ZigBee cancellation -- so good and failed frames are on equal footing.
@@ -20,11 +16,12 @@ What it answers:
   * i.e. is the failure a coverage problem (erase wider) or an SNR problem (no fix)?
 
 Usage:
-    python3 analyze_captured_frames.py [good.txt] [fail.txt]
-    (defaults to captured_good_frames.txt / captured_fail_frames.txt in CWD)
+    python3 analyze_captured_frames.py [captured_frames.bin]
+    (defaults to captured_frames.bin in CWD)
 """
 import sys
 import numpy as np
+from gnuradio.ieee802_11.capture import load_capture
 
 # Subcarrier layout (matches ls.cc / the veto): DC=32, occupied 6..58, ZigBee core
 # treated as [28..36]. "Outer" = occupied minus the ZigBee band minus pilots/DC.
@@ -50,34 +47,32 @@ EXPECTED_NSYM = 9
 REAL_M_MIN = 0.8
 
 # Restrict the GOOD bucket to frames that passed CRC via a specific decode tier (the
-# `tier=` header field): CLEAN / SALVAGE_CANCEL / ERASURE / ERASURE_CANCEL. Set to
+# `tier` field): CLEAN / SALVAGE_CANCEL. Set to
 # "SALVAGE_CANCEL" to compare frames the ZigBee-cancellation rescued against the frames
 # nothing could rescue (FAIL) -- this isolates what makes a frame cancellable vs not.
 # Set to None to use all good frames.
 GOOD_TIER = "SALVAGE_CANCEL"
 
 
-def load_frames(path):
-    """Yield dicts: {meta fields..., 'sym': complex ndarray (total_sym, 64)}."""
+def load_frames(path, outcome):
+    """List of dicts: {meta fields..., 'sym': complex ndarray (stored_sym, 64)}."""
+    records, metadata = load_capture(path)
+    codes = metadata["global"]["ieee802_11:codes"]
     frames = []
-    hdr, rows = None, []
-    with open(path) as f:
-        for line in f:
-            line = line.strip()
-            if line.startswith("FRAME"):
-                hdr, rows = {}, []
-                for tok in line.split()[1:]:
-                    if "=" in tok:
-                        k, v = tok.split("=", 1)
-                        hdr[k] = v
-            elif line.startswith("S "):
-                vals = line.split()[2:]
-                c = np.array([float(x) for x in vals], dtype=np.float64)
-                rows.append(c[0::2] + 1j * c[1::2])           # 64 complex bins
-            elif line == "END" and hdr is not None:
-                hdr["sym"] = np.array(rows)
-                frames.append(hdr)
-                hdr, rows = None, []
+    for rec in records[records["outcome"] == codes["outcome"].index(outcome)]:
+        frames.append({
+            "idx": int(rec["index"]),
+            "outcome": outcome,
+            "tier": codes["tier"][rec["tier"]],
+            "sigsrc": codes["signal_source"][rec["signal_source"]],
+            "M": float(rec["m"]),
+            "bytes": int(rec["frame_bytes"]),
+            "enc": int(rec["encoding"]),
+            "nsym": int(rec["n_sym"]),
+            "total_sym": int(rec["total_symbols"]),
+            "score": float(rec["score"]),
+            "sym": np.array(rec["raw"][:rec["stored_symbols"]], dtype=np.complex128),
+        })
     return frames
 
 
@@ -171,14 +166,13 @@ def summarize(frames, label):
 
 
 def main():
-    good_path = sys.argv[1] if len(sys.argv) > 1 else "captured_good_frames.txt"
-    fail_path = sys.argv[2] if len(sys.argv) > 2 else "captured_fail_frames.txt"
+    path = sys.argv[1] if len(sys.argv) > 1 else "captured_frames.bin"
 
-    good = load_frames(good_path)
-    fail = load_frames(fail_path)
+    good = load_frames(path, "GOOD")
+    fail = load_frames(path, "FAIL")
 
     # Keep only genuine WiFi frames in the FAIL bucket (drop garbage-SIGNAL false
-    # detections). Header fields are strings; compare as ints/floats.
+    # detections).
     def _int(fr, key):
         try:
             return int(fr.get(key))
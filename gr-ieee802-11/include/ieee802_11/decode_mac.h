@@ -27,7 +27,18 @@ class IEEE802_11_API decode_mac : virtual public block
 {
 public:
     typedef std::shared_ptr<decode_mac> sptr;
-    static sptr make(bool log = false, bool debug = false);
+
+    /*!
+     * \param log log decoded frames
+     * \param debug print debug output
+     * \param batch_size decode up to this many frames together. Frames that complete
+     *        within one call to the block are decoded as a batch, several frames in
+     *        the vector lanes of one Viterbi pass, and published in order; a batch is
+     *        never held back waiting for more input. The Viterbi pass has 16 lanes,
+     *        so batches of 16 frames or more pay off. 1 decodes each frame as it
+     *        completes.
+     */
+    static sptr make(bool log = false, bool debug = false, int batch_size = 1);
 };
 
 } // namespace ieee802_11
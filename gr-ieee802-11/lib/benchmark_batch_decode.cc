@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Frames/s of the payload decode in decode_mac: the demapped symbols of a frame are
+ * deinterleaved, Viterbi decoded, descrambled and CRC checked, either one frame at a
+ * time with the per-frame decoder (batch size 1) or in batches with the
+ * frame-parallel decoder. The frames mix all encodings and lengths and have a few
+ * bit errors, so that the CRC pass counts of the two paths can be compared too.
+ */
+
+#include "utils.h"
+#include "viterbi_decoder/viterbi_decoder.h"
+#include "viterbi_decoder/viterbi_decoder_batch.h"
+
+#include <boost/crc.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace gr::ieee802_11;
+
+namespace {
+
+constexpr int nframes = 2048;
+constexpr double bit_error_rate = 0.002;
+constexpr int batch_sizes[] = { 1, 4, 16, 64 };
+
+struct test_frame {
+    test_frame(Encoding e, int psdu_size) : ofdm(e), frame(ofdm, psdu_size) {}
+
+    ofdm_param ofdm;
+    frame_param frame;
+    std::vector<uint8_t> symbols; // 48 per OFDM symbol, as decode_mac receives them
+};
+
+// Random payload plus its FCS, through the transmit chain of the mapper block.
+test_frame make_frame(std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> encoding(BPSK_1_2, QAM64_3_4);
+    std::uniform_int_distribution<int> length(24, 1500);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::bernoulli_distribution error(bit_error_rate);
+
+    std::vector<char> psdu(length(rng));
+    for (auto& b : psdu) {
+        b = byte(rng);
+    }
+    boost::crc_32_type fcs;
+    fcs.process_bytes(psdu.data(), psdu.size());
+    for (int i = 0; i < 4; i++) {
+        psdu.push_back((fcs.checksum() >> (8 * i)) & 0xff);
+    }
+
+    test_frame f((Encoding)encoding(rng), psdu.size());
+    std::vector<char> data(f.frame.n_data_bits), scrambled(f.frame.n_data_bits);
+    std::vector<char> encoded(f.frame.n_data_bits * 2);
+    std::vector<char> punctured(f.frame.n_encoded_bits);
+    std::vector<char> interleaved(f.frame.n_encoded_bits);
+    std::vector<char> symbols(f.frame.n_sym * 48);
+
+    generate_bits(psdu.data(), data.data(), f.frame);
+    scramble(data.data(), scrambled.data(), f.frame, 1 + rng() % 127);
+    reset_tail_bits(scrambled.data(), f.frame);
+    convolutional_encoding(scrambled.data(), encoded.data(), f.frame);
+    puncturing(encoded.data(), punctured.data(), f.frame, f.ofdm);
+    interleave(punctured.data(), interleaved.data(), f.frame, f.ofdm);
+    split_symbols(interleaved.data(), symbols.data(), f.frame, f.ofdm);
+
+    f.symbols.assign(symbols.begin(), symbols.end());
+    for (auto& s : f.symbols) {
+        for (int k = 0; k < f.ofdm.n_bpsc; k++) {
+            if (error(rng)) {
+                s ^= 1 << k;
+            }
+        }
+    }
+    return f;
+}
+
+// decode_mac's steps around the Viterbi decoder.
+void demap_deinterleave(const test_frame& f, uint8_t one, uint8_t* out)
+{
+    static uint8_t bits[MAX_ENCODED_BITS];
+    const int n_cbps = f.ofdm.n_cbps;
+    for (int i = 0; i < f.frame.n_sym * 48; i++) {
+        for (int k = 0; k < f.ofdm.n_bpsc; k++) {
+            bits[i * f.ofdm.n_bpsc + k] = (f.symbols[i] & (1 << k)) ? one : 0;
+        }
+    }
+
+    int first[MAX_BITS_PER_SYM];
+    int second[MAX_BITS_PER_SYM];
+    int s = std::max(f.ofdm.n_bpsc / 2, 1);
+    for (int j = 0; j < n_cbps; j++) {
+        first[j] = s * (j / s) + ((j + int(floor(16.0 * j / n_cbps))) % s);
+    }
+    for (int i = 0; i < n_cbps; i++) {
+        second[i] = 16 * i - (n_cbps - 1) * int(floor(16.0 * i / n_cbps));
+    }
+    for (int i = 0; i < f.frame.n_sym; i++) {
+        for (int k = 0; k < n_cbps; k++) {
+            out[i * n_cbps + second[first[k]]] = bits[i * n_cbps + k];
+        }
+    }
+}
+
+bool descramble_check(const test_frame& f, const uint8_t* decoded)
+{
+    static uint8_t out_bytes[MAX_PSDU_SIZE + 2];
+    int state = 0;
+    std::memset(out_bytes, 0, f.frame.psdu_size + 2);
+    for (int i = 0; i < 7; i++) {
+        if (decoded[i]) {
+            state |= 1 << (6 - i);
+        }
+    }
+    for (int i = 7; i < f.frame.psdu_size * 8 + 16; i++) {
+        int feedback = ((!!(state & 64))) ^ (!!(state & 8));
+        out_bytes[i / 8] |= (feedback ^ (decoded[i] & 0x1)) << (i % 8);
+        state = ((state << 1) & 0x7e) | feedback;
+    }
+
+    boost::crc_32_type result;
+    result.process_bytes(out_bytes + 2, f.frame.psdu_size);
+    return result.checksum() == 558161692;
+}
+
+int decode_per_frame(std::vector<test_frame>& frames)
+{
+    static viterbi_decoder decoder;
+    static uint8_t deinterleaved[MAX_ENCODED_BITS];
+    int ok = 0;
+    for (auto& f : frames) {
+        demap_deinterleave(f, 1, deinterleaved);
+        ok += descramble_check(f, decoder.decode(&f.ofdm, &f.frame, deinterleaved));
+    }
+    return ok;
+}
+
+int decode_batched(std::vector<test_frame>& frames, int batch_size)
+{
+    static batch_viterbi_decoder decoder;
+    static std::vector<std::vector<uint8_t>> deinterleaved, decoded;
+    deinterleaved.resize(batch_size, std::vector<uint8_t>(MAX_ENCODED_BITS));
+    decoded.resize(batch_size, std::vector<uint8_t>(16 + 8 * MAX_PSDU_SIZE));
+
+    int ok = 0;
+    for (size_t start = 0; start < frames.size(); start += batch_size) {
+        int n = std::min<size_t>(batch_size, frames.size() - start);
+        for (int i = 0; i < n; i++) {
+            demap_deinterleave(frames[start + i], SOFT_MAX, deinterleaved[i].data());
+        }
+
+        std::vector<batch_viterbi_decoder::job> jobs(n);
+        for (int i = 0; i < n; i++) {
+            test_frame& f = frames[start + i];
+            jobs[i] = { &f.ofdm, &f.frame, deinterleaved[i].data(), decoded[i].data() };
+        }
+        decoder.decode(jobs.data(), n);
+
+        for (int i = 0; i < n; i++) {
+            ok += descramble_check(frames[start + i], decoded[i].data());
+        }
+    }
+    return ok;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(42);
+    std::vector<test_frame> frames;
+    for (int i = 0; i < nframes; i++) {
+        frames.push_back(make_frame(rng));
+    }
+
+    for (int batch_size : batch_sizes) {
+        auto start = std::chrono::steady_clock::now();
+        int ok = batch_size == 1 ? decode_per_frame(frames)
+                                 : decode_batched(frames, batch_size);
+        double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                .count();
+        std::printf("batch size %3d: %9.0f frames/s, %d of %d frames pass the CRC\n",
+                    batch_size,
+                    nframes / seconds,
+                    ok,
+                    nframes);
+    }
+
+    return 0;
+}
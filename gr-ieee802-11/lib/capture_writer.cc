@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "capture_writer.h"
+#include <boost/chrono.hpp>
+#include <chrono>
+#include <cstring>
+
+namespace gr {
+namespace ieee802_11 {
+
+namespace {
+// How long the thread sleeps when the ring is empty. The block never wakes it, so
+// committing stays free of system calls; the ring has to hold this much traffic.
+constexpr int POLL_MS = 20;
+} // namespace
+
+capture_writer::capture_writer(const std::string& path,
+                               const std::string& metadata,
+                               size_t record_size,
+                               size_t capacity,
+                               std::function<void()> periodic)
+    : d_record_size(record_size),
+      d_capacity(capacity),
+      d_ring(record_size * capacity),
+      d_head(0),
+      d_tail(0),
+      d_dropped(0),
+      d_periodic(std::move(periodic)),
+      d_flush_requested(0),
+      d_flush_done(0),
+      d_stop(false)
+{
+    if (!path.empty()) {
+        d_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+    if (d_file.is_open()) {
+        capture_file_header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+        header.metadata_size = metadata.size();
+        header.header_size = (sizeof(header) + metadata.size() + 63) / 64 * 64;
+        header.record_size = record_size;
+
+        d_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        d_file << metadata;
+        d_file << std::string(header.header_size - sizeof(header) - metadata.size(), ' ');
+        d_file.flush();
+    }
+
+    d_thread = gr::thread::thread([this]() { thread_main(); });
+}
+
+capture_writer::~capture_writer()
+{
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_stop = true;
+    }
+    d_wake.notify_one();
+    d_thread.join();
+}
+
+void* capture_writer::reserve()
+{
+    if (!d_file.is_open()) {
+        return nullptr;
+    }
+    const uint64_t tail = d_tail.load(std::memory_order_relaxed);
+    if (tail - d_head.load(std::memory_order_acquire) == d_capacity) {
+        d_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &d_ring[(tail % d_capacity) * d_record_size];
+}
+
+void capture_writer::commit()
+{
+    d_tail.store(d_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void capture_writer::flush()
+{
+    gr::thread::scoped_lock lock(d_mutex);
+    const uint64_t request = ++d_flush_requested;
+    d_wake.notify_one();
+    while (d_flush_done < request) {
+        d_flushed.wait(lock);
+    }
+}
+
+void capture_writer::drain()
+{
+    const uint64_t tail = d_tail.load(std::memory_order_acquire);
+    uint64_t head = d_head.load(std::memory_order_relaxed);
+    while (head != tail) {
+        // Up to the end of the ring in one write.
+        const size_t first = head % d_capacity;
+        const size_t count = std::min<uint64_t>(tail - head, d_capacity - first);
+        d_file.write(&d_ring[first * d_record_size], count * d_record_size);
+        head += count;
+        d_head.store(head, std::memory_order_release);
+    }
+}
+
+void capture_writer::thread_main()
+{
+    auto next_periodic =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(PERIOD_MS);
+
+    gr::thread::scoped_lock lock(d_mutex);
+    for (;;) {
+        const bool stop = d_stop;
+        const uint64_t flush_request = d_flush_requested;
+        lock.unlock();
+
+        drain();
+        const auto now = std::chrono::steady_clock::now();
+        if (stop || flush_request != d_flush_done || now >= next_periodic) {
+            if (d_file.is_open()) {
+                d_file.flush();
+            }
+            if (d_periodic) {
+                d_periodic();
+            }
+            next_periodic = now + std::chrono::milliseconds(PERIOD_MS);
+        }
+
+        lock.lock();
+        d_flush_done = flush_request;
+        d_flushed.notify_all();
+        if (stop) {
+            return;
+        }
+        if (!d_stop && d_flush_requested == flush_request) {
+            d_wake.wait_for(lock, boost::chrono::milliseconds(POLL_MS));
+        }
+    }
+}
+
+} // namespace ieee802_11
+} // namespace gr
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_IEEE802_11_CAPTURE_WRITER_H
+#define INCLUDED_IEEE802_11_CAPTURE_WRITER_H
+
+#include <gnuradio/thread/thread.h>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace ieee802_11 {
+
+/*
+ * Capture file layout, little endian:
+ *
+ *   capture_file_header
+ *   metadata_size bytes of SigMF-style JSON ({"global": {...}}) describing the
+ *       records, padded with spaces to header_size
+ *   records of record_size bytes each, up to the end of the file
+ *
+ * header_size is a multiple of 64, so the records can be mapped in place
+ * (python/capture.py does that).
+ */
+struct capture_file_header {
+    char magic[8]; // CAPTURE_MAGIC
+    uint32_t header_size;
+    uint32_t metadata_size;
+    uint32_t record_size;
+    uint32_t reserved;
+};
+
+constexpr char CAPTURE_MAGIC[8] = { 'W', 'I', 'F', 'I', 'C', 'A', 'P', '1' };
+
+/*
+ * Writes fixed-size records to a capture file from a background thread. The block
+ * fills each record in place in a single-producer, single-consumer ring and
+ * commits it; neither call locks or touches the file. If the ring is full the
+ * record is dropped and counted, rather than stalling the decode path.
+ *
+ * The thread also calls `periodic` about once per PERIOD and on flush(), for state
+ * that is kept in memory and written out on a timer (statistics).
+ */
+class capture_writer
+{
+public:
+    static constexpr int PERIOD_MS = 1000;
+
+    // An empty path writes no records but still runs `periodic`.
+    capture_writer(const std::string& path,
+                   const std::string& metadata,
+                   size_t record_size,
+                   size_t capacity,
+                   std::function<void()> periodic = nullptr);
+    ~capture_writer();
+    capture_writer(const capture_writer&) = delete;
+    capture_writer& operator=(const capture_writer&) = delete;
+
+    bool is_open() const { return d_file.is_open(); }
+
+    // Space for the next record, or nullptr if the file is not open or the ring is
+    // full. Fill it and commit() it before the next reserve().
+    void* reserve();
+    void commit();
+
+    uint64_t written() const { return d_head.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return d_dropped.load(std::memory_order_relaxed); }
+
+    // Return once everything committed so far is on disk and `periodic` has run.
+    void flush();
+
+private:
+    void thread_main();
+    void drain();
+
+    std::ofstream d_file;
+    const size_t d_record_size;
+    const size_t d_capacity;
+    std::vector<char> d_ring;
+    std::atomic<uint64_t> d_head; // next record to write, owned by the thread
+    std::atomic<uint64_t> d_tail; // next record to fill, owned by the block
+    std::atomic<uint64_t> d_dropped;
+    std::function<void()> d_periodic;
+
+    gr::thread::mutex d_mutex;
+    gr::thread::condition_variable d_wake;
+    gr::thread::condition_variable d_flushed;
+    uint64_t d_flush_requested;
+    uint64_t d_flush_done;
+    bool d_stop;
+    gr::thread::thread d_thread;
+};
+
+} // namespace ieee802_11
+} // namespace gr
+
+#endif /* INCLUDED_IEEE802_11_CAPTURE_WRITER_H */
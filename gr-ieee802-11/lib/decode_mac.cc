@@ -18,10 +18,15 @@
 
 #include "utils.h"
 #include "viterbi_decoder/viterbi_decoder.h"
+#include "viterbi_decoder/viterbi_decoder_batch.h"
 
 #include <gnuradio/io_signature.h>
+#include <gnuradio/thread/thread.h>
 #include <boost/crc.hpp>
 #include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 using namespace gr::ieee802_11;
 
@@ -31,7 +36,7 @@ class decode_mac_impl : public decode_mac
 {
 
 public:
-    decode_mac_impl(bool log, bool debug)
+    decode_mac_impl(bool log, bool debug, int batch_size)
         : block("decode_mac",
                 gr::io_signature::make(1, 1, 48),
                 gr::io_signature::make(0, 0, 0)),
@@ -39,11 +44,20 @@ public:
           d_debug(debug),
           d_ofdm(BPSK_1_2),
           d_frame(d_ofdm, 0),
+          d_n_pending(0),
+          d_buffers(std::make_shared<psdu_buffers>()),
+          out_bytes(d_buffers->take()),
           d_frame_complete(true)
     {
+        if (batch_size < 1) {
+            throw std::invalid_argument("decode_mac: batch size must be at least 1");
+        }
+        d_pending.resize(batch_size);
         message_port_register_out(pmt::mp("out"));
     }
 
+    ~decode_mac_impl() { delete[] out_bytes; }
+
     int general_work(int noutput_items,
                      gr_vector_int& ninput_items,
                      gr_vector_const_void_star& input_items,
@@ -74,9 +88,10 @@ public:
                 d_frame_complete = false;
 
                 // Enter tags into metadata dictionary
-                d_meta = pmt::make_dict();
-                for (auto tag : tags)
-                    d_meta = pmt::dict_add(d_meta, tag.key, tag.value);
+                pmt::dict_builder meta(tags.size());
+                for (const auto& tag : tags)
+                    meta.add(tag.key, tag.value);
+                d_meta = meta.build();
 
                 int len_data = pmt::to_uint64(pmt::dict_ref(
                     d_meta, pmt::mp("frame bytes"), pmt::from_uint64(MAX_PSDU_SIZE + 1)));
@@ -106,12 +121,26 @@ public:
                 copied++;
 
                 if (copied == d_frame.n_sym) {
-                    dout << "received complete frame - decoding" << std::endl;
-                    decode();
                     in += 48;
                     i++;
                     d_frame_complete = true;
-                    break;
+                    if (d_pending.size() == 1) {
+                        dout << "received complete frame - decoding" << std::endl;
+                        decode(d_ofdm, d_frame, d_meta, d_rx_symbols);
+                        break;
+                    }
+
+                    dout << "received complete frame - queueing for batch decode"
+                         << std::endl;
+                    pending_frame& frame = d_pending[d_n_pending++];
+                    frame.ofdm = d_ofdm;
+                    frame.frame = d_frame;
+                    frame.meta = d_meta;
+                    std::memcpy(frame.symbols, d_rx_symbols, d_frame.n_sym * 48);
+                    if (d_n_pending == (int)d_pending.size()) {
+                        decode_pending();
+                    }
+                    continue;
                 }
             }
 
@@ -119,53 +148,118 @@ public:
             i++;
         }
 
+        // Never hold frames back waiting for more input: a batch holds the frames
+        // that completed in this call, up to the batch size.
+        if (d_n_pending) {
+            decode_pending();
+        }
+
         consume(0, i);
 
         return 0;
     }
 
-    void decode()
+    void decode(ofdm_param& ofdm,
+                frame_param& frame,
+                pmt::pmt_t meta,
+                const uint8_t* rx_symbols)
     {
+        demap(ofdm, frame, rx_symbols, 1, d_rx_bits);
+        deinterleave(ofdm, frame, d_rx_bits, d_deinterleaved_bits);
+        uint8_t* decoded = d_decoder.decode(&ofdm, &frame, d_deinterleaved_bits);
+        publish(ofdm, frame, meta, decoded);
+    }
 
-        for (int i = 0; i < d_frame.n_sym * 48; i++) {
-            for (int k = 0; k < d_ofdm.n_bpsc; k++) {
-                d_rx_bits[i * d_ofdm.n_bpsc + k] = !!(d_rx_symbols[i] & (1 << k));
-            }
+    // Decode the queued frames together in the batch Viterbi decoder and publish
+    // them in the order they were received.
+    void decode_pending()
+    {
+        if (d_n_pending == 1) {
+            pending_frame& f = d_pending[0];
+            decode(f.ofdm, f.frame, f.meta, f.symbols);
+            d_n_pending = 0;
+            return;
         }
 
-        deinterleave();
-        uint8_t* decoded = d_decoder.decode(&d_ofdm, &d_frame, d_deinterleaved_bits);
-        descramble(decoded);
-        print_output();
+        for (int i = 0; i < d_n_pending; i++) {
+            pending_frame& f = d_pending[i];
+            demap(f.ofdm, f.frame, f.symbols, SOFT_MAX, d_rx_bits);
+            deinterleave(f.ofdm, f.frame, d_rx_bits, f.deinterleaved_bits);
+        }
+
+        d_jobs.resize(d_n_pending);
+        for (int i = 0; i < d_n_pending; i++) {
+            pending_frame& f = d_pending[i];
+            d_jobs[i] = { &f.ofdm, &f.frame, f.deinterleaved_bits, f.decoded };
+        }
+        d_batch_decoder.decode(d_jobs.data(), d_n_pending);
+
+        for (int i = 0; i < d_n_pending; i++) {
+            pending_frame& f = d_pending[i];
+            publish(f.ofdm, f.frame, f.meta, f.decoded);
+            f.meta = pmt::PMT_NIL;
+        }
+        d_n_pending = 0;
+    }
+
+    void publish(const ofdm_param& ofdm,
+                 const frame_param& frame,
+                 pmt::pmt_t meta,
+                 uint8_t* decoded)
+    {
+        descramble(frame, decoded);
+        print_output(frame);
 
         // skip service field
         boost::crc_32_type result;
-        result.process_bytes(out_bytes + 2, d_frame.psdu_size);
+        result.process_bytes(out_bytes + 2, frame.psdu_size);
         if (result.checksum() != 558161692) {
             dout << "checksum wrong -- dropping" << std::endl;
             return;
         }
 
         mylog("encoding: {} - length: {} - symbols: {}",
-              d_ofdm.encoding,
-              d_frame.psdu_size,
-              d_frame.n_sym);
-
-        // create PDU
-        pmt::pmt_t blob = pmt::make_blob(out_bytes + 2, d_frame.psdu_size - 4);
-        d_meta =
-            pmt::dict_add(d_meta, pmt::mp("dlt"), pmt::from_long(LINKTYPE_IEEE802_11));
+              ofdm.encoding,
+              frame.psdu_size,
+              frame.n_sym);
+
+        // create PDU, a view of the buffer, and continue in another one
+        uint8_t* psdu = out_bytes;
+        out_bytes = d_buffers->take();
+        pmt::pmt_t blob = pmt::make_blob_view(
+            psdu + 2, frame.psdu_size - 4, [buffers = d_buffers, psdu]() {
+                buffers->give_back(psdu);
+            });
+        meta = pmt::dict_add(meta, pmt::mp("dlt"), pmt::from_long(LINKTYPE_IEEE802_11));
+
+        message_port_pub(pmt::mp("out"), pmt::cons(meta, blob));
+    }
 
-        message_port_pub(pmt::mp("out"), pmt::cons(d_meta, blob));
+    // One bit per byte, `one` standing for a 1: 1 for the hard decoder, SOFT_MAX for
+    // the batch decoder, which takes soft decisions.
+    void demap(const ofdm_param& ofdm,
+               const frame_param& frame,
+               const uint8_t* rx_symbols,
+               uint8_t one,
+               uint8_t* rx_bits)
+    {
+        for (int i = 0; i < frame.n_sym * 48; i++) {
+            for (int k = 0; k < ofdm.n_bpsc; k++) {
+                rx_bits[i * ofdm.n_bpsc + k] = (rx_symbols[i] & (1 << k)) ? one : 0;
+            }
+        }
     }
 
-    void deinterleave()
+    void deinterleave(const ofdm_param& ofdm,
+                      const frame_param& frame,
+                      const uint8_t* rx_bits,
+                      uint8_t* deinterleaved_bits)
     {
 
-        int n_cbps = d_ofdm.n_cbps;
+        int n_cbps = ofdm.n_cbps;
         int first[MAX_BITS_PER_SYM];
         int second[MAX_BITS_PER_SYM];
-        int s = std::max(d_ofdm.n_bpsc / 2, 1);
+        int s = std::max(ofdm.n_bpsc / 2, 1);
 
         for (int j = 0; j < n_cbps; j++) {
             first[j] = s * (j / s) + ((j + int(floor(16.0 * j / n_cbps))) % s);
@@ -175,21 +269,20 @@ public:
             second[i] = 16 * i - (n_cbps - 1) * int(floor(16.0 * i / n_cbps));
         }
 
-        int count = 0;
-        for (int i = 0; i < d_frame.n_sym; i++) {
+        for (int i = 0; i < frame.n_sym; i++) {
             for (int k = 0; k < n_cbps; k++) {
-                d_deinterleaved_bits[i * n_cbps + second[first[k]]] =
-                    d_rx_bits[i * n_cbps + k];
+                deinterleaved_bits[i * n_cbps + second[first[k]]] =
+                    rx_bits[i * n_cbps + k];
             }
         }
     }
 
 
-    void descramble(uint8_t* decoded_bits)
+    void descramble(const frame_param& frame, const uint8_t* decoded_bits)
     {
 
         int state = 0;
-        std::memset(out_bytes, 0, d_frame.psdu_size + 2);
+        std::memset(out_bytes, 0, frame.psdu_size + 2);
 
         for (int i = 0; i < 7; i++) {
             if (decoded_bits[i]) {
@@ -201,7 +294,7 @@ public:
         int feedback;
         int bit;
 
-        for (int i = 7; i < d_frame.psdu_size * 8 + 16; i++) {
+        for (int i = 7; i < frame.psdu_size * 8 + 16; i++) {
             feedback = ((!!(state & 64))) ^ (!!(state & 8));
             bit = feedback ^ (decoded_bits[i] & 0x1);
             out_bytes[i / 8] |= bit << (i % 8);
@@ -209,12 +302,12 @@ public:
         }
     }
 
-    void print_output()
+    void print_output(const frame_param& frame)
     {
 
         dout << std::endl;
-        dout << "psdu size" << d_frame.psdu_size << std::endl;
-        for (int i = 2; i < d_frame.psdu_size + 2; i++) {
+        dout << "psdu size" << frame.psdu_size << std::endl;
+        for (int i = 2; i < frame.psdu_size + 2; i++) {
             dout << std::setfill('0') << std::setw(2) << std::hex
                  << ((unsigned int)out_bytes[i] & 0xFF) << std::dec << " ";
             if (i % 16 == 15) {
@@ -222,7 +315,7 @@ public:
             }
         }
         dout << std::endl;
-        for (int i = 2; i < d_frame.psdu_size + 2; i++) {
+        for (int i = 2; i < frame.psdu_size + 2; i++) {
             if ((out_bytes[i] > 31) && (out_bytes[i] < 127)) {
                 dout << ((char)out_bytes[i]);
             } else {
@@ -233,6 +326,58 @@ public:
     }
 
 private:
+    // Buffers PSDUs are descrambled into. A published blob is a view of its buffer,
+    // which comes back here once every receiver dropped the blob, on whichever
+    // thread that happens.
+    struct psdu_buffers {
+        static constexpr size_t MAX_KEPT = 16;
+
+        ~psdu_buffers()
+        {
+            for (uint8_t* buffer : free) {
+                delete[] buffer;
+            }
+        }
+
+        uint8_t* take()
+        {
+            {
+                gr::thread::scoped_lock lock(mutex);
+                if (!free.empty()) {
+                    uint8_t* buffer = free.back();
+                    free.pop_back();
+                    return buffer;
+                }
+            }
+            return new uint8_t[MAX_PSDU_SIZE + 2]; // 2 for signal field
+        }
+
+        void give_back(uint8_t* buffer)
+        {
+            gr::thread::scoped_lock lock(mutex);
+            if (free.size() < MAX_KEPT) {
+                free.push_back(buffer);
+            } else {
+                delete[] buffer;
+            }
+        }
+
+        gr::thread::mutex mutex;
+        std::vector<uint8_t*> free;
+    };
+
+    // A complete frame waiting for the batch decoder.
+    struct pending_frame {
+        pending_frame() : ofdm(BPSK_1_2), frame(ofdm, 0) {}
+
+        ofdm_param ofdm;
+        frame_param frame;
+        pmt::pmt_t meta;
+        uint8_t symbols[48 * MAX_SYM];
+        uint8_t deinterleaved_bits[MAX_ENCODED_BITS];
+        uint8_t decoded[16 + 8 * MAX_PSDU_SIZE];
+    };
+
     bool d_debug;
     bool d_log;
 
@@ -242,17 +387,22 @@ private:
     ofdm_param d_ofdm;
 
     viterbi_decoder d_decoder;
+    batch_viterbi_decoder d_batch_decoder;
+    std::vector<batch_viterbi_decoder::job> d_jobs;
+    std::vector<pending_frame> d_pending; // one entry per frame of a batch
+    int d_n_pending;
 
     uint8_t d_rx_symbols[48 * MAX_SYM];
     uint8_t d_rx_bits[MAX_ENCODED_BITS];
     uint8_t d_deinterleaved_bits[MAX_ENCODED_BITS];
-    uint8_t out_bytes[MAX_PSDU_SIZE + 2]; // 2 for signal field
+    std::shared_ptr<psdu_buffers> d_buffers;
+    uint8_t* out_bytes; // from d_buffers
 
     int copied;
     bool d_frame_complete;
 };
 
-decode_mac::sptr decode_mac::make(bool log, bool debug)
+decode_mac::sptr decode_mac::make(bool log, bool debug, int batch_size)
 {
-    return gnuradio::get_initial_sptr(new decode_mac_impl(log, debug));
+    return gnuradio::get_initial_sptr(new decode_mac_impl(log, debug, batch_size));
 }
@@ -16,8 +16,12 @@
  */
 
 #include "base.h"
+#include "../utils.h"
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iostream>
+#include <limits>
 
 using namespace gr::ieee802_11::equalizer;
 // base::LONG[] equals the long_norm
@@ -48,3 +52,54 @@ std::vector<gr_complex> base::get_csi()
     }
     return csi;
 }
+
+void base::soft_bits(const gr_complex* symbols,
+                     const float* noise,
+                     const std::vector<gr_complex>& points,
+                     uint8_t* soft) const
+{
+    const int n_points = points.size();
+    int n_bits = 0;
+    while ((1 << n_bits) < n_points) {
+        n_bits++;
+    }
+
+    // squared minimum distance: the LLR of a bit right on a point is about this
+    float dmin2 = std::numeric_limits<float>::max();
+    for (int p = 1; p < n_points; p++) {
+        dmin2 = std::min(dmin2, std::norm(points[p] - points[0]));
+    }
+
+    float weight[48];
+    float total = 0;
+    int c = 0;
+    for (int i = 0; i < 64; i++) {
+        if ((i == 11) || (i == 25) || (i == 32) || (i == 39) || (i == 53) || (i < 6) ||
+            (i > 58)) {
+            continue;
+        }
+        weight[c] = std::norm(d_H[i]) / std::max(noise[i], 1e-12f);
+        total += weight[c];
+        c++;
+    }
+    const float scale = total > 0 ? 48 / total / dmin2 : 0;
+
+    for (c = 0; c < 48; c++) {
+        float d0[6], d1[6];
+        std::fill(d0, d0 + n_bits, std::numeric_limits<float>::max());
+        std::fill(d1, d1 + n_bits, std::numeric_limits<float>::max());
+        for (int p = 0; p < n_points; p++) {
+            const float d = std::norm(symbols[c] - points[p]);
+            for (int k = 0; k < n_bits; k++) {
+                float& best = (p >> k) & 1 ? d1[k] : d0[k];
+                best = std::min(best, d);
+            }
+        }
+
+        for (int k = 0; k < n_bits; k++) {
+            const float llr = weight[c] * scale * (d0[k] - d1[k]);
+            const long s = std::lround(SOFT_ERASURE * (1 + llr));
+            soft[c * n_bits + k] = std::max(0L, std::min(long(SOFT_MAX), s));
+        }
+    }
+}
@@ -40,6 +40,20 @@ public:
 
     std::vector<gr_complex> get_csi();
 
+    /*
+     * Soft decisions (see SOFT_MAX) for the 48 equalized data carriers in `symbols`,
+     * log2(points.size()) per carrier in the bit order of the `bits` equalize()
+     * returns. Each carrier's max-log LLR is weighted by its reliability
+     * |H|^2 / noise, normalized to a mean of 1 over the symbol, so that a typical
+     * carrier right on a constellation point gives a certain bit. `noise` is the
+     * noise + interference power of each of the 64 input bins and `points` the
+     * constellation points by value, as from constellation::points().
+     */
+    void soft_bits(const gr_complex* symbols,
+                   const float* noise,
+                   const std::vector<gr_complex>& points,
+                   uint8_t* soft) const;
+
 protected:
     static const gr_complex LONG[64];
 
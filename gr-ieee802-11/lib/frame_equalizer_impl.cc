@@ -24,10 +24,14 @@
 #include "utils.h"
 #include <algorithm>
 #include <boost/crc.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <fstream>
 #include <gnuradio/io_signature.h>
 #include <memory>
 #include <sstream>
+#include <thread>
 
 namespace gr {
 namespace ieee802_11 {
@@ -38,6 +42,24 @@ constexpr int ZIGBEE_SEARCH_RADIUS = 144;
 constexpr int ZIGBEE_MAX_SALVAGE_DECODE_ATTEMPTS = 289; // search radius * 2 + 1
 constexpr int ZIGBEE_NFFT = 64;
 
+// Spectra of the ZigBee reference, computed once and reused by later runs as long as
+// the reference CSV does not change (see zigbee_reference_spectra). Written in the
+// launch directory, like the diagnostics and captures.
+constexpr const char* ZIGBEE_REF_SPECTRA_CACHE = "zigbee_ref_spectra.cache";
+
+// Salvage parallelism: the payload salvage tries up to a few hundred ZigBee
+// candidates, each a full equalize + Viterbi pass. They are
+// independent, so they run on a small pool (the block thread plus up to
+// SALVAGE_MAX_WORKERS - 1 helpers). More workers than this mostly steal cores from
+// the rest of the flowgraph: a frame usually passes within the first few candidates.
+constexpr int SALVAGE_MAX_WORKERS = 4;
+
+int salvage_workers()
+{
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, std::min(SALVAGE_MAX_WORKERS, cores));
+}
+
 // Clean-band LTF veto (Layer 2): exclude FFT bins LTF_VETO_BIN_LO..HI (DC and the
 // central subcarriers ZigBee occupies) when checking whether the two LTF symbols
 // agree. The remaining outer bins are ZigBee-free, so the agreement separates a
@@ -57,7 +79,50 @@ constexpr double LTF_VETO_THRESH = 0.25;
 // cannot rescue the hard frames (wider ZigBee? low outer-bin SNR? residual CFO?).
 constexpr int CAPTURE_MAX_PER_BUCKET = 400;
 
-// Erasure band: which central FFT bins to ERASE in the decoder. Kept INDEPENDENT of the
+// Binary captures, written by a background thread (capture_writer): the per-frame
+// diagnostics (M + outcome of every detected frame) and the raw frames of both
+// buckets. The ring sizes cover the writer's poll interval at any realistic frame
+// rate; a record that does not fit is dropped and counted in the stats file.
+constexpr const char* DIAG_CAPTURE_FILE = "ltf_diag.bin";
+constexpr const char* FRAME_CAPTURE_FILE = "captured_frames.bin";
+constexpr size_t DIAG_CAPTURE_RING = 4096;
+constexpr size_t FRAME_CAPTURE_RING = 64;
+
+// Result codes of the capture records. The names go into the capture metadata, in
+// this order.
+enum diag_kind : uint8_t { DIAG_SIGNAL, DIAG_FRAME, DIAG_PAYLOAD };
+enum signal_result : uint8_t { SIGNAL_DECODED, SIGNAL_KNOWN_FALLBACK, SIGNAL_FAIL };
+enum frame_result : uint8_t { FRAME_ACCEPT, FRAME_REJECT };
+enum payload_tier : uint8_t { TIER_CLEAN, TIER_SALVAGE_CANCEL, TIER_NONE };
+enum capture_outcome : uint8_t { OUTCOME_GOOD, OUTCOME_FAIL };
+
+// SigMF-style metadata of a capture: what the file holds, the record fields as numpy
+// type strings, and the names of the codes above.
+std::string capture_metadata(const std::string& record,
+                             const std::string& description,
+                             const std::string& fields)
+{
+    std::ostringstream json;
+    json << "{\"global\": {"
+         << "\"core:version\": \"1.0.0\", "
+         << "\"core:datatype\": \"cf32_le\", "
+         << "\"core:recorder\": \"gr-ieee802-11 frame_equalizer\", "
+         << "\"core:description\": \"" << description << "\", "
+         << "\"ieee802_11:record\": \"" << record << "\", "
+         << "\"ieee802_11:fields\": [" << fields << "], "
+         << "\"ieee802_11:codes\": {"
+         << "\"kind\": [\"SIGNAL\", \"FRAME\", \"PAYLOAD\"], "
+         << "\"SIGNAL\": [\"DECODED\", \"KNOWN_FALLBACK\", \"FAIL\"], "
+         << "\"FRAME\": [\"ACCEPT\", \"REJECT\"], "
+         << "\"PAYLOAD\": [\"CLEAN\", \"SALVAGE_CANCEL\", \"FAIL\"], "
+         << "\"tier\": [\"CLEAN\", \"SALVAGE_CANCEL\", \"NONE\"], "
+         << "\"outcome\": [\"GOOD\", \"FAIL\"], "
+         << "\"signal_source\": [\"DECODED\", \"KNOWN_FALLBACK\"]}}}";
+    return json.str();
+}
+
+// Erasure band: which central FFT bins to ERASE when decoding the SIGNAL field (the
+// payload is soft-decoded and weights its carriers instead). Kept INDEPENDENT of the
 // Layer-2 veto band (LTF_VETO_BIN_LO/HI) so we can erase a wider ring than we exclude
 // from the veto. Captures show ZigBee leaking just past [28..36] into the adjacent
 // carriers (~bins 26-27, 37-38) at ~13 dB; erasing them (cost 1 each in the 2e+f<d_free
@@ -66,6 +131,14 @@ constexpr int CAPTURE_MAX_PER_BUCKET = 400;
 constexpr int ERASE_BIN_LO = 26;
 constexpr int ERASE_BIN_HI = 38;
 
+// Soft payload decoding weights each carrier by |H|^2 / noise. The noise (+ ZigBee) of
+// a carrier is how much the two LTF symbols disagree there, averaged over the
+// NOISE_SMOOTH_BINS bins on either side -- one sample per bin is far too noisy to
+// weight by -- and floored at NOISE_FLOOR_FRACTION of the mean over the band, so that
+// no carrier is trusted without bound.
+constexpr int NOISE_SMOOTH_BINS = 2;
+constexpr float NOISE_FLOOR_FRACTION = 0.1f;
+
 // Known-frame knowledge. The experimental TX always sends a fixed frame, so the SIGNAL
 // field (rate + length) is known in advance: bytes==22, encoding 0 (BPSK rate-1/2; SIGNAL
 // rate code 11). Two independent uses:
@@ -116,10 +189,11 @@ frame_equalizer_impl::frame_equalizer_impl(
       d_correction_crc_success_count(0),
       d_last_correlation_score(0.0),
       d_last_zigbee_ltf_start_raw(ZIGBEE_DEFAULT_LTF_START_RAW),
-      d_zigbee_ref_fft_cache_min_ltf_start_raw(0),
-      d_zigbee_ref_fft_cache_max_ltf_start_raw(-1),
-      d_zigbee_ref_fft_cache_symbol_count(0),
-      d_zigbee_ref_fft_cache_ready(false),
+      d_salvage_count(0),
+      d_salvage_latency_last_us(0.0),
+      d_salvage_latency_total_us(0.0),
+      d_salvage_latency_max_us(0.0),
+      d_salvage_pool(salvage_workers()),
       d_reference_ready(false)
 {
 
@@ -131,15 +205,38 @@ frame_equalizer_impl::frame_equalizer_impl(
         throw std::runtime_error("Failed to open signal files: " + signal_filename);
     }
     // Unconditional per-frame diagnostics (independent of the debug flag): the
-    // clean-band LTF agreement M for every detected frame, plus the payload
-    // outcome (CLEAN / SALVAGE / ERASURE / FAIL). Lets us tell whether the frames
-    // that fail the clean decode are real corrupted WiFi (high M) or noise (low M).
-    d_diag_file.open("ltf_diag.txt", std::ios::out | std::ios::trunc);
+    // clean-band LTF agreement M for every detected frame, plus the SIGNAL and
+    // payload outcomes. Lets us tell whether the frames that fail the clean decode
+    // are real corrupted WiFi (high M) or noise (low M). Its thread also writes the
+    // correction stats file once a second.
+    d_diag_writer.reset(new capture_writer(
+        DIAG_CAPTURE_FILE,
+        capture_metadata("diag",
+                         "per-frame LTF agreement M and decode outcome",
+                         "[\"kind\", \"u1\"], [\"result\", \"u1\"], "
+                         "[\"encoding\", \"u1\"], [\"reserved0\", \"u1\"], "
+                         "[\"frame_bytes\", \"<u2\"], [\"reserved1\", \"<u2\"], "
+                         "[\"m\", \"<f4\"], [\"score\", \"<f4\"]"),
+        sizeof(diag_record),
+        DIAG_CAPTURE_RING,
+        [this]() { write_correction_stats_file(); }));
     // Raw (pre-equalizer) frame captures, split into the two buckets we want to
-    // compare offline: frames that pass the CRC vs frames that reach salvage/erasure
-    // but still fail it. Truncated each run, written in the launch directory.
-    d_good_frames_file.open("captured_good_frames.txt", std::ios::out | std::ios::trunc);
-    d_fail_frames_file.open("captured_fail_frames.txt", std::ios::out | std::ios::trunc);
+    // compare offline: frames that pass the CRC vs frames that reach salvage but
+    // still fail it. Truncated each run, written in the launch directory.
+    d_frame_writer.reset(new capture_writer(
+        FRAME_CAPTURE_FILE,
+        capture_metadata("frame",
+                         "raw pre-equalizer frames, FFT bins 0..63 per OFDM symbol",
+                         "[\"index\", \"<u4\"], [\"outcome\", \"u1\"], "
+                         "[\"tier\", \"u1\"], [\"signal_source\", \"u1\"], "
+                         "[\"encoding\", \"u1\"], [\"frame_bytes\", \"<u2\"], "
+                         "[\"n_sym\", \"<u2\"], [\"total_symbols\", \"<u2\"], "
+                         "[\"stored_symbols\", \"<u2\"], [\"m\", \"<f4\"], "
+                         "[\"score\", \"<f4\"], [\"reserved\", \"<u4\", [2]], "
+                         "[\"raw\", \"<c8\", [" +
+                             std::to_string(CAPTURE_RECORD_SYMBOLS) + ", 64]]"),
+        sizeof(frame_record),
+        FRAME_CAPTURE_RING));
     message_port_register_out(pmt::mp("symbols"));
     message_port_register_out(pmt::mp("tx_feedback"));
 
@@ -150,17 +247,29 @@ frame_equalizer_impl::frame_equalizer_impl(
 
     d_frame_mod = d_bpsk;
 
+    for (int worker = 0; worker < d_salvage_pool.size(); worker++) {
+        d_scratch.emplace_back(new decode_scratch);
+    }
+
     set_tag_propagation_policy(block::TPP_DONT);
     compute_erasure_carriers();
     d_reference_ready = load_reference_data();
     precompute_zigbee_reference_ffts();
     reset_frame_capture();
-    write_correction_stats();
+    update_correction_stats();
     set_algorithm(algo);
 }
 
 frame_equalizer_impl::~frame_equalizer_impl() {}
 
+bool frame_equalizer_impl::stop()
+{
+    update_correction_stats();
+    d_frame_writer->flush();
+    d_diag_writer->flush();
+    return true;
+}
+
 
 void frame_equalizer_impl::set_algorithm(Equalizer algo)
 {
@@ -168,6 +277,9 @@ void frame_equalizer_impl::set_algorithm(Equalizer algo)
     d_algorithm = algo;
     delete d_equalizer;
     d_equalizer = create_equalizer(algo);
+    for (auto& scratch : d_scratch) {
+        scratch->equalizer.reset(create_equalizer(algo));
+    }
 }
 
 void frame_equalizer_impl::set_bandwidth(double bw)
@@ -376,35 +488,26 @@ int frame_equalizer_impl::general_work(int noutput_items,
                 }
             }
             d_signal_was_known_fallback = used_known_fallback;
-            d_diag_file << "SIGNAL "
-                        << (signal_ok ? (used_known_fallback ? "KNOWN_FALLBACK" : "DECODED")
-                                      : "FAIL")
-                        << " bytes=" << d_frame_bytes << " enc=" << d_frame_encoding
-                        << "\n";
-            d_diag_file.flush();
+            record_diag(DIAG_SIGNAL,
+                        signal_ok ? (used_known_fallback ? SIGNAL_KNOWN_FALLBACK
+                                                         : SIGNAL_DECODED)
+                                  : SIGNAL_FAIL);
 
             if (signal_ok) {
                 d_signal_valid = true;
                 dout << "dsignal_ok; True  /n";
-                d_pending_meta = pmt::make_dict();
-
-                d_pending_meta = pmt::dict_add(
-                    d_pending_meta, pmt::mp("frame bytes"), pmt::from_uint64(d_frame_bytes));
-                d_pending_meta = pmt::dict_add(
-                    d_pending_meta, pmt::mp("encoding"), pmt::from_uint64(d_frame_encoding));
-                d_pending_meta = pmt::dict_add(
-                    d_pending_meta, pmt::mp("snr"), pmt::from_double(d_equalizer->get_snr()));
-                d_pending_meta = pmt::dict_add(
-                    d_pending_meta, pmt::mp("nominal frequency"), pmt::from_double(d_freq));
-                d_pending_meta = pmt::dict_add(d_pending_meta,
-                                               pmt::mp("frequency offset"),
-                                               pmt::from_double(d_freq_offset_from_synclong));
-                d_pending_meta =
-                    pmt::dict_add(d_pending_meta, pmt::mp("beta"), pmt::from_double(beta));
-
                 std::vector<gr_complex> csi = d_equalizer->get_csi();
-                d_pending_meta = pmt::dict_add(
-                    d_pending_meta, pmt::mp("csi"), pmt::init_c32vector(csi.size(), csi));
+                d_pending_meta =
+                    pmt::dict_builder(7)
+                        .add(pmt::mp("frame bytes"), pmt::from_uint64(d_frame_bytes))
+                        .add(pmt::mp("encoding"), pmt::from_uint64(d_frame_encoding))
+                        .add(pmt::mp("snr"), pmt::from_double(d_equalizer->get_snr()))
+                        .add(pmt::mp("nominal frequency"), pmt::from_double(d_freq))
+                        .add(pmt::mp("frequency offset"),
+                             pmt::from_double(d_freq_offset_from_synclong))
+                        .add(pmt::mp("beta"), pmt::from_double(beta))
+                        .add(pmt::mp("csi"), pmt::init_c32vector(csi.size(), csi))
+                        .build();
             } else if (d_signal_symbols_pending) {
                 message_port_pub(pmt::mp("tx_feedback"), pmt::intern("nack"));
                 d_signal_symbols_pending = false;
@@ -514,42 +617,15 @@ bool frame_equalizer_impl::load_reference_data()
 
 void frame_equalizer_impl::precompute_zigbee_reference_ffts()
 {
-    d_zigbee_ref_fft_cache.clear();
-    d_zigbee_ref_fft_cache_valid.clear();
-    d_zigbee_ref_fft_cache_ready = false;
-
+    d_zigbee_ref_spectra.clear();
     if (!d_reference_ready) {
         return;
     }
 
-    d_zigbee_ref_fft_cache_min_ltf_start_raw =
-        ZIGBEE_DEFAULT_LTF_START_RAW - ZIGBEE_SEARCH_RADIUS;
-    d_zigbee_ref_fft_cache_max_ltf_start_raw =
-        ZIGBEE_DEFAULT_LTF_START_RAW + ZIGBEE_SEARCH_RADIUS;
-    d_zigbee_ref_fft_cache_symbol_count = MAX_SYM + 3;
-
-    const int offset_count = d_zigbee_ref_fft_cache_max_ltf_start_raw -
-                             d_zigbee_ref_fft_cache_min_ltf_start_raw + 1;
-    const int cache_items = offset_count * d_zigbee_ref_fft_cache_symbol_count;
-    d_zigbee_ref_fft_cache.resize(cache_items);
-    d_zigbee_ref_fft_cache_valid.assign(cache_items, 0);
-
-    for (int ltf_start_raw = d_zigbee_ref_fft_cache_min_ltf_start_raw;
-         ltf_start_raw <= d_zigbee_ref_fft_cache_max_ltf_start_raw;
-         ltf_start_raw++) {
-        const int offset_idx = ltf_start_raw - d_zigbee_ref_fft_cache_min_ltf_start_raw;
-        for (int symbol_idx = 0; symbol_idx < d_zigbee_ref_fft_cache_symbol_count;
-             symbol_idx++) {
-            const int cache_idx =
-                offset_idx * d_zigbee_ref_fft_cache_symbol_count + symbol_idx;
-            if (compute_zigbee_reference_symbol_fft_uncached(
-                    symbol_idx, ltf_start_raw, d_zigbee_ref_fft_cache[cache_idx])) {
-                d_zigbee_ref_fft_cache_valid[cache_idx] = 1;
-            }
-        }
-    }
-
-    d_zigbee_ref_fft_cache_ready = true;
+    d_zigbee_ref_spectra.load(d_ref_wifi_rx_from_zigbee, ZIGBEE_REF_SPECTRA_CACHE);
+    dout << "ZigBee reference spectra: " << d_zigbee_ref_spectra.windows()
+         << " windows" << (d_zigbee_ref_spectra.mapped() ? " (cached)" : "")
+         << std::endl;
 }
 
 void frame_equalizer_impl::reset_frame_capture()
@@ -595,19 +671,34 @@ bool frame_equalizer_impl::ltf_clean_band_ok()
     const double denom = std::sqrt(e0 * e1);
     const double m = (denom > 1e-12) ? std::abs(num) / denom : 0.0;
     d_diag_m = (float)m;
-    d_diag_file << "FRAME M=" << m
-                << (m >= LTF_VETO_THRESH ? " ACCEPT" : " REJECT") << "\n";
-    d_diag_file.flush();
+    record_diag(DIAG_FRAME, m >= LTF_VETO_THRESH ? FRAME_ACCEPT : FRAME_REJECT);
     dout << "LTF clean-band agreement M=" << m
          << (m >= LTF_VETO_THRESH ? "  ACCEPT" : "  REJECT") << std::endl;
     return m >= LTF_VETO_THRESH;
 }
 
-bool frame_equalizer_impl::run_equalizer_attempt(gr_complex* frame_symbols,
-                                                 uint8_t* out_bits,
-                                                 std::vector<gr_complex>& out_symbols)
+// Equalize the captured frame into scratch.bits / scratch.symbols, first cancelling the
+// ZigBee interference of candidate `cancel` if given. Only touches `scratch` and reads
+// the frame state, so attempts on different scratches may run concurrently.
+void frame_equalizer_impl::run_equalizer_attempt(decode_scratch& scratch,
+                                                 const ZigbeeCandidate* cancel)
 {
-    std::unique_ptr<equalizer::base> eq(create_equalizer(d_algorithm));
+    gr_complex* frame_symbols = scratch.frame;
+    std::memcpy(frame_symbols,
+                d_captured_symbols,
+                d_captured_symbol_count * 64 * sizeof(gr_complex));
+    if (cancel) {
+        subtract_zigbee_interference(
+            cancel->h, cancel->ltf_start_raw, frame_symbols, d_frame.n_sym + 3);
+    }
+    estimate_carrier_noise(frame_symbols, scratch.noise);
+    scratch.points = d_frame_mod->points();
+
+    // Each worker reuses its equalizer: every algorithm restarts its channel
+    // estimate from scratch on the first LTF symbol (n == 0).
+    equalizer::base* eq = scratch.equalizer.get();
+    std::vector<gr_complex>& out_symbols = scratch.symbols;
+    uint8_t* out_bits = scratch.bits;
     uint8_t scratch_bits[48];
     gr_complex scratch_symbols[48];
     // using the two ltf build dH
@@ -630,12 +721,48 @@ bool frame_equalizer_impl::run_equalizer_attempt(gr_complex* frame_symbols,
                      scratch_symbols,
                      out_bits + sym * 48,
                      d_frame_mod);
+        eq->soft_bits(scratch_symbols,
+                      scratch.noise,
+                      scratch.points,
+                      scratch.soft_bits + sym * d_ofdm.n_cbps);
         for (int k = 0; k < 48; k++) {
             out_symbols.push_back(scratch_symbols[k]);
         }
     }
+}
 
-    return true;
+// Noise + interference power of each bin, from the two LTF symbols (frame symbols 0
+// and 1): they carry the same sequence, so what differs between them is noise, and
+// E|Y0 - Y1|^2 is twice its power. See NOISE_SMOOTH_BINS.
+void frame_equalizer_impl::estimate_carrier_noise(const gr_complex* frame_symbols,
+                                                  float* noise) const
+{
+    float raw[64];
+    float total = 0;
+    int used = 0;
+    for (int i = 0; i < 64; i++) {
+        raw[i] = 0;
+        if ((i == 32) || (i < 6) || (i > 58)) {
+            continue;
+        }
+        raw[i] = std::norm(frame_symbols[i] - frame_symbols[64 + i]) / 2;
+        total += raw[i];
+        used++;
+    }
+    const float floor = NOISE_FLOOR_FRACTION * total / used;
+
+    for (int i = 0; i < 64; i++) {
+        float sum = 0;
+        int n = 0;
+        for (int k = i - NOISE_SMOOTH_BINS; k <= i + NOISE_SMOOTH_BINS; k++) {
+            if ((k == 32) || (k < 6) || (k > 58)) {
+                continue;
+            }
+            sum += raw[k];
+            n++;
+        }
+        noise[i] = std::max(n ? sum / n : 0.0f, floor);
+    }
 }
 
 int frame_equalizer_impl::raw_fft_start_from_symbol_idx(int ltf_start_raw,
@@ -701,58 +828,17 @@ bool frame_equalizer_impl::get_zigbee_reference_symbol_fft(int symbol_idx,
                                                            int ltf_start_raw,
                                                            gr_complex* fft_symbol) const
 {
-    if (!d_zigbee_ref_fft_cache_ready || symbol_idx < 0 ||
-        symbol_idx >= d_zigbee_ref_fft_cache_symbol_count ||
-        ltf_start_raw < d_zigbee_ref_fft_cache_min_ltf_start_raw ||
-        ltf_start_raw > d_zigbee_ref_fft_cache_max_ltf_start_raw) {
+    if (symbol_idx < 0 || symbol_idx >= MAX_SYM + 3) {
         return false;
     }
 
-    const int offset_idx = ltf_start_raw - d_zigbee_ref_fft_cache_min_ltf_start_raw;
-    const int cache_idx = offset_idx * d_zigbee_ref_fft_cache_symbol_count + symbol_idx;
-    if (cache_idx < 0 || cache_idx >= (int)d_zigbee_ref_fft_cache.size() ||
-        !d_zigbee_ref_fft_cache_valid[cache_idx]) {
+    const gr_complex* spectrum = d_zigbee_ref_spectra.window(
+        raw_fft_start_from_symbol_idx(ltf_start_raw, symbol_idx));
+    if (!spectrum) {
         return false;
     }
 
-    std::copy(d_zigbee_ref_fft_cache[cache_idx].begin(),
-              d_zigbee_ref_fft_cache[cache_idx].end(),
-              fft_symbol);
-    return true;
-}
-
-bool frame_equalizer_impl::compute_zigbee_reference_symbol_fft_uncached(
-    int symbol_idx,
-    int ltf_start_raw,
-    std::array<gr_complex, 64>& fft_symbol) const
-{
-    if (!d_reference_ready) {
-        return false;
-    }
-
-    const int start = raw_fft_start_from_symbol_idx(ltf_start_raw, symbol_idx);
-    if (start < 0 || start + ZIGBEE_NFFT > (int)d_ref_wifi_rx_from_zigbee.size()) {
-        return false;
-    }
-
-    gr_complex unshifted_fft[ZIGBEE_NFFT];
-    for (int k = 0; k < ZIGBEE_NFFT; k++) {
-        fft_symbol[k] = gr_complex(0, 0);
-        unshifted_fft[k] = gr_complex(0, 0);
-    }
-
-    for (int bin = 0; bin < ZIGBEE_NFFT; bin++) {
-        gr_complex acc(0, 0);
-        for (int n = 0; n < ZIGBEE_NFFT; n++) {
-            const float angle = -2 * M_PI * bin * n / ZIGBEE_NFFT;
-            acc += d_ref_wifi_rx_from_zigbee[start + n] * exp(gr_complex(0, angle));
-        }
-        unshifted_fft[bin] = acc;
-    }
-
-    for (int bin = 0; bin < ZIGBEE_NFFT; bin++) {
-        fft_symbol[bin] = unshifted_fft[(bin + ZIGBEE_NFFT / 2) % ZIGBEE_NFFT];
-    }
+    std::copy(spectrum, spectrum + ZIGBEE_NFFT, fft_symbol);
     return true;
 }
 
@@ -863,41 +949,31 @@ bool frame_equalizer_impl::try_decode_with_salvage(uint8_t* final_bits,
 
 
     d_correction_attempt_count++;
-    uint8_t attempt_bits[48 * MAX_SYM];
     salvaged = false;
     // dout << "222222222222222222222222222222222 /n";
 
-    // Snapshot the raw (pre-equalizer) frame before any decode tier runs, so the
-    // capture at each return reflects exactly what the tiers received -- robust even
-    // if an equalizer were to touch its input buffer.
+    // The tiers work on copies of d_captured_symbols (run_equalizer_attempt), so the
+    // capture at each return is exactly what they received.
     const int capture_total_symbols = std::min(d_frame.n_sym + 3, MAX_SYM + 3);
-    std::memcpy(d_raw_snapshot,
-                d_captured_symbols,
-                capture_total_symbols * 64 * sizeof(gr_complex));
-
-    run_equalizer_attempt(d_captured_symbols, attempt_bits, final_symbols);
-    if (decode_payload(attempt_bits, false)) {
-        std::memcpy(final_bits, attempt_bits, d_frame.n_sym * 48);
-        d_diag_file << "PAYLOAD M=" << d_diag_m << " CLEAN\n";
-        d_diag_file.flush();
-        capture_raw_frame(d_good_frames_file, d_good_capture_count, d_raw_snapshot,
-                          capture_total_symbols, "GOOD", "CLEAN", 0.0);
+
+    decode_scratch& clean = *d_scratch[0];
+    run_equalizer_attempt(clean);
+    if (decode_payload(clean)) {
+        std::memcpy(final_bits, clean.bits, d_frame.n_sym * 48);
+        final_symbols = clean.symbols;
+        record_diag(DIAG_PAYLOAD, TIER_CLEAN);
+        capture_raw_frame(
+            d_good_capture_count, capture_total_symbols, OUTCOME_GOOD, TIER_CLEAN, 0.0);
         message_port_pub(pmt::mp("tx_feedback"), pmt::intern("ack"));
         return true;
     }
 
-    std::vector<gr_complex> salvaged_symbols;
-    gr_complex salvaged_frame[(MAX_SYM + 3) * 64];
+    const auto salvage_start = std::chrono::steady_clock::now();
     double best_failed_score = -1.0;
     int best_failed_ltf_start_raw = ZIGBEE_DEFAULT_LTF_START_RAW;
-    
-    write_correction_stats();
 
-    struct ZigbeeCandidate {
-        int ltf_start_raw;
-        gr_complex h;
-        double score;
-    };
+    update_correction_stats();
+
     std::vector<ZigbeeCandidate> candidates;
     candidates.reserve(2 * ZIGBEE_SEARCH_RADIUS + 1);
 
@@ -926,93 +1002,69 @@ bool frame_equalizer_impl::try_decode_with_salvage(uint8_t* final_bits,
                   });
     }
 
+    // The salvage attempts are the ZigBee cancellation of each candidate, best score
+    // first. They run concurrently on the pool; the lowest-numbered attempt that passes
+    // the CRC wins, so the outcome is the same as trying them one after the other.
+    // Once an attempt passes, the ones after it are skipped.
     const int decode_attempts =
         std::min(ZIGBEE_MAX_SALVAGE_DECODE_ATTEMPTS,
                  static_cast<int>(candidates.size()));
-    for (int idx = 0; idx < decode_attempts; idx++) {
-        const ZigbeeCandidate& candidate = candidates[idx];
-        d_last_zigbee_ltf_start_raw = candidate.ltf_start_raw;
-        d_last_correlation_score = candidate.score;
 
-        std::memcpy(salvaged_frame,
-                    d_captured_symbols,
-                    d_captured_symbol_count * 64 * sizeof(gr_complex));
-        subtract_zigbee_interference(
-            candidate.h, candidate.ltf_start_raw, salvaged_frame, d_frame.n_sym + 3);
-
-        salvaged_symbols.clear();
-        run_equalizer_attempt(salvaged_frame, attempt_bits, salvaged_symbols);
-        if (decode_payload(attempt_bits, false)) {
-            std::memcpy(final_bits, attempt_bits, d_frame.n_sym * 48);
-            final_symbols.swap(salvaged_symbols);
-            salvaged = true;
-            d_correction_crc_success_count++;
-            write_correction_stats();
-            d_diag_file << "PAYLOAD M=" << d_diag_m << " SALVAGE_CANCEL\n";
-            d_diag_file.flush();
-            capture_raw_frame(d_good_frames_file, d_good_capture_count, d_raw_snapshot,
-                              capture_total_symbols, "GOOD", "SALVAGE_CANCEL",
-                              candidate.score);
-            message_port_pub(pmt::mp("tx_feedback"), pmt::intern("ack"));
-            return true;
+    std::atomic<int> winner(decode_attempts);
+    gr::thread::mutex winner_mutex;
+    d_salvage_pool.run(decode_attempts, [&](int worker, int attempt) {
+        if (attempt > winner.load()) {
+            return;
+        }
+
+        decode_scratch& scratch = *d_scratch[worker];
+        run_equalizer_attempt(scratch, &candidates[attempt]);
+        if (attempt > winner.load() || !decode_payload(scratch)) {
+            return;
         }
-    }
 
-    // Erasure fallback: mark the ZigBee-corrupted central subcarriers as unknown
-    // (decoder value 2) and let the convolutional code + interleaver fill them in.
-    // Reference-free; the Viterbi handles erasures natively. Try the clean frame,
-    // then the best ZigBee-cancelled frame (cancellation + erasure combined).
-    run_equalizer_attempt(d_captured_symbols, attempt_bits, final_symbols);
-    if (decode_payload(attempt_bits, false, /*erase_central=*/true)) {
-        std::memcpy(final_bits, attempt_bits, d_frame.n_sym * 48);
+        gr::thread::scoped_lock lock(winner_mutex);
+        if (attempt < winner.load()) {
+            winner.store(attempt);
+            std::memcpy(final_bits, scratch.bits, d_frame.n_sym * 48);
+            final_symbols.swap(scratch.symbols);
+        }
+    });
+
+    record_salvage_latency(std::chrono::duration<double, std::micro>(
+                               std::chrono::steady_clock::now() - salvage_start)
+                               .count());
+
+    const int won = winner.load();
+    if (won < decode_attempts) {
+        const ZigbeeCandidate& candidate = candidates[won];
+        d_last_zigbee_ltf_start_raw = candidate.ltf_start_raw;
+        d_last_correlation_score = candidate.score;
         salvaged = true;
         d_correction_crc_success_count++;
-        write_correction_stats();
-        dout << "payload erasure decode (clean) OK" << std::endl;
-        d_diag_file << "PAYLOAD M=" << d_diag_m << " ERASURE\n";
-        d_diag_file.flush();
-        capture_raw_frame(d_good_frames_file, d_good_capture_count, d_raw_snapshot,
-                          capture_total_symbols, "GOOD", "ERASURE", 0.0);
+        update_correction_stats();
+        record_diag(DIAG_PAYLOAD, TIER_SALVAGE_CANCEL, candidate.score);
+        capture_raw_frame(d_good_capture_count,
+                          capture_total_symbols,
+                          OUTCOME_GOOD,
+                          TIER_SALVAGE_CANCEL,
+                          candidate.score);
         message_port_pub(pmt::mp("tx_feedback"), pmt::intern("ack"));
         return true;
     }
-    if (!candidates.empty()) {
-        const ZigbeeCandidate& best = candidates.front();
-        std::memcpy(salvaged_frame,
-                    d_captured_symbols,
-                    d_captured_symbol_count * 64 * sizeof(gr_complex));
-        subtract_zigbee_interference(
-            best.h, best.ltf_start_raw, salvaged_frame, d_frame.n_sym + 3);
-        salvaged_symbols.clear();
-        run_equalizer_attempt(salvaged_frame, attempt_bits, salvaged_symbols);
-        if (decode_payload(attempt_bits, false, /*erase_central=*/true)) {
-            std::memcpy(final_bits, attempt_bits, d_frame.n_sym * 48);
-            final_symbols.swap(salvaged_symbols);
-            salvaged = true;
-            d_correction_crc_success_count++;
-            write_correction_stats();
-            dout << "payload erasure decode (cancelled) OK" << std::endl;
-            d_diag_file << "PAYLOAD M=" << d_diag_m << " ERASURE_CANCEL\n";
-            d_diag_file.flush();
-            capture_raw_frame(d_good_frames_file, d_good_capture_count, d_raw_snapshot,
-                              capture_total_symbols, "GOOD", "ERASURE_CANCEL",
-                              best.score);
-            message_port_pub(pmt::mp("tx_feedback"), pmt::intern("ack"));
-            return true;
-        }
-    }
 
     if (best_failed_score >= 0.0) {
         d_last_zigbee_ltf_start_raw = best_failed_ltf_start_raw;
         d_last_correlation_score = best_failed_score;
-        write_correction_stats();
     }
-
-    d_diag_file << "PAYLOAD M=" << d_diag_m << " FAIL score=" << best_failed_score
-                << "\n";
-    d_diag_file.flush();
-    capture_raw_frame(d_fail_frames_file, d_fail_capture_count, d_raw_snapshot,
-                      capture_total_symbols, "FAIL", "NONE", best_failed_score);
+    update_correction_stats();
+
+    record_diag(DIAG_PAYLOAD, TIER_NONE, best_failed_score);
+    capture_raw_frame(d_fail_capture_count,
+                      capture_total_symbols,
+                      OUTCOME_FAIL,
+                      TIER_NONE,
+                      best_failed_score);
     message_port_pub(pmt::mp("tx_feedback"), pmt::intern("nack"));
     return false;
 }
@@ -1030,9 +1082,9 @@ int frame_equalizer_impl::flush_pending_output(uint8_t* out, int noutput_items)
                 produced * 48);
 
     if (d_pending_output_offset == 0) {
-        pmt::pmt_t pairs = pmt::dict_items(d_pending_meta);
-        for (int idx = 0; idx < pmt::length(pairs); idx++) {
-            pmt::pmt_t pair = pmt::nth(idx, pairs);
+        for (pmt::pmt_t pairs = pmt::dict_items(d_pending_meta); pmt::is_pair(pairs);
+             pairs = pmt::cdr(pairs)) {
+            pmt::pmt_t pair = pmt::car(pairs);
             add_item_tag(0,
                          nitems_written(0),
                          pmt::car(pair),
@@ -1063,62 +1115,117 @@ void frame_equalizer_impl::publish_payload_symbols(
     }
 }
 
-void frame_equalizer_impl::write_correction_stats()
+// Called by the block whenever the counters change; cheap, the file is written by
+// the diag writer's thread.
+void frame_equalizer_impl::update_correction_stats()
+{
+    gr::thread::scoped_lock lock(d_stats_mutex);
+    d_stats.attempt_count = d_correction_attempt_count;
+    d_stats.crc_success_count = d_correction_crc_success_count;
+    d_stats.last_correlation_score = d_last_correlation_score;
+    d_stats.last_ltf_start_raw = d_last_zigbee_ltf_start_raw;
+    d_stats.salvage_workers = d_salvage_pool.size();
+    d_stats.salvage_count = d_salvage_count;
+    d_stats.salvage_latency_last_us = d_salvage_latency_last_us;
+    d_stats.salvage_latency_total_us = d_salvage_latency_total_us;
+    d_stats.salvage_latency_max_us = d_salvage_latency_max_us;
+    d_stats.diag_records_dropped = d_diag_writer ? d_diag_writer->dropped() : 0;
+    d_stats.frame_records_dropped = d_frame_writer ? d_frame_writer->dropped() : 0;
+}
+
+// Runs on the diag writer's thread, once a second and on stop().
+void frame_equalizer_impl::write_correction_stats_file()
 {
+    correction_stats stats;
+    {
+        gr::thread::scoped_lock lock(d_stats_mutex);
+        stats = d_stats;
+    }
+
     std::ofstream stats_file(d_correction_stats_filename, std::ios::out | std::ios::trunc);
     if (!stats_file.is_open()) {
         return;
     }
 
-    stats_file << "correction_attempt_count=" << d_correction_attempt_count << "\n";
-    stats_file << "correction_crc_success_count=" << d_correction_crc_success_count
-               << "\n";
+    stats_file << "correction_attempt_count=" << stats.attempt_count << "\n";
+    stats_file << "correction_crc_success_count=" << stats.crc_success_count << "\n";
     const double recovery_rate =
-        d_correction_attempt_count == 0
-            ? 0.0
-            : static_cast<double>(d_correction_crc_success_count) /
-                  static_cast<double>(d_correction_attempt_count);
+        stats.attempt_count == 0 ? 0.0
+                                 : static_cast<double>(stats.crc_success_count) /
+                                       static_cast<double>(stats.attempt_count);
     stats_file << "recovery_rate=" << recovery_rate << "\n";
-    stats_file << "last_correlation_score=" << d_last_correlation_score << "\n";
-    stats_file << "last_ltf_start_raw=" << d_last_zigbee_ltf_start_raw << "\n";
+    stats_file << "last_correlation_score=" << stats.last_correlation_score << "\n";
+    stats_file << "last_ltf_start_raw=" << stats.last_ltf_start_raw << "\n";
+    stats_file << "salvage_workers=" << stats.salvage_workers << "\n";
+    stats_file << "salvage_count=" << stats.salvage_count << "\n";
+    stats_file << "salvage_latency_last_us=" << stats.salvage_latency_last_us << "\n";
+    const double mean_latency = stats.salvage_count == 0
+                                    ? 0.0
+                                    : stats.salvage_latency_total_us / stats.salvage_count;
+    stats_file << "salvage_latency_mean_us=" << mean_latency << "\n";
+    stats_file << "salvage_latency_max_us=" << stats.salvage_latency_max_us << "\n";
+    stats_file << "diag_records_dropped=" << stats.diag_records_dropped << "\n";
+    stats_file << "frame_records_dropped=" << stats.frame_records_dropped << "\n";
+}
+
+void frame_equalizer_impl::record_salvage_latency(double us)
+{
+    d_salvage_count++;
+    d_salvage_latency_last_us = us;
+    d_salvage_latency_total_us += us;
+    d_salvage_latency_max_us = std::max(d_salvage_latency_max_us, us);
 }
 
-// Dump one raw (pre-equalizer) frame to a capture file for offline analysis. The
-// samples are the FFT'd, SFO/common-phase-corrected symbols from d_captured_symbols
-// BEFORE any channel equalization or ZigBee cancellation -- the same input the decode
-// tiers see -- so a good frame and a failed frame can be compared on equal footing.
-// Format per frame:
-//   FRAME idx=.. outcome=GOOD|FAIL tier=.. M=.. bytes=.. enc=.. nsym=.. total_sym=.. score=..
-//   S <sym> re0 im0 re1 im1 ... re63 im63      (one line per OFDM symbol, 64 bins)
-//   END
-void frame_equalizer_impl::capture_raw_frame(std::ofstream& file,
-                                             int& counter,
-                                             const gr_complex* raw,
-                                             int total_symbols,
-                                             const char* outcome,
-                                             const char* tier,
-                                             double score)
+void frame_equalizer_impl::record_diag(uint8_t kind, uint8_t result, double score)
 {
-    if (!file.is_open() || counter >= CAPTURE_MAX_PER_BUCKET) {
+    auto* record = static_cast<diag_record*>(d_diag_writer->reserve());
+    if (!record) {
         return;
     }
-    counter++;
-    file << "FRAME idx=" << counter << " outcome=" << outcome << " tier=" << tier
-         << " M=" << d_diag_m << " bytes=" << d_frame_bytes
-         << " enc=" << d_frame_encoding << " nsym=" << d_frame.n_sym
-         << " total_sym=" << total_symbols << " score=" << score
-         << " sigsrc=" << (d_signal_was_known_fallback ? "KNOWN_FALLBACK" : "DECODED")
-         << "\n";
-    for (int sym = 0; sym < total_symbols; sym++) {
-        file << "S " << sym;
-        for (int k = 0; k < 64; k++) {
-            const gr_complex v = raw[sym * 64 + k];
-            file << " " << v.real() << " " << v.imag();
-        }
-        file << "\n";
+    std::memset(record, 0, sizeof(*record));
+    record->kind = kind;
+    record->result = result;
+    record->encoding = d_frame_encoding;
+    record->frame_bytes = d_frame_bytes;
+    record->m = d_diag_m;
+    record->score = score;
+    d_diag_writer->commit();
+}
+
+// Queue one raw (pre-equalizer) frame for the frame capture. The samples are the
+// FFT'd, SFO/common-phase-corrected symbols from d_captured_symbols BEFORE any
+// channel equalization or ZigBee cancellation -- the same input the decode tiers see
+// -- so a good frame and a failed frame can be compared on equal footing.
+void frame_equalizer_impl::capture_raw_frame(
+    int& counter, int total_symbols, uint8_t outcome, uint8_t tier, double score)
+{
+    if (counter >= CAPTURE_MAX_PER_BUCKET) {
+        return;
     }
-    file << "END\n";
-    file.flush();
+    auto* record = static_cast<frame_record*>(d_frame_writer->reserve());
+    if (!record) {
+        return;
+    }
+    counter++;
+
+    const int stored = std::min(total_symbols, CAPTURE_RECORD_SYMBOLS);
+    std::memset(record, 0, offsetof(frame_record, raw));
+    record->index = counter;
+    record->outcome = outcome;
+    record->tier = tier;
+    record->signal_source = d_signal_was_known_fallback ? 1 : 0;
+    record->encoding = d_frame_encoding;
+    record->frame_bytes = d_frame_bytes;
+    record->n_sym = d_frame.n_sym;
+    record->total_symbols = total_symbols;
+    record->stored_symbols = stored;
+    record->m = d_diag_m;
+    record->score = score;
+    std::memcpy(record->raw, d_captured_symbols, stored * 64 * sizeof(gr_complex));
+    std::memset(record->raw + stored * 64,
+                0,
+                (CAPTURE_RECORD_SYMBOLS - stored) * 64 * sizeof(gr_complex));
+    d_frame_writer->commit();
 }
 
 bool frame_equalizer_impl::decode_signal_field(uint8_t* rx_bits)
@@ -1331,7 +1438,7 @@ bool frame_equalizer_impl::set_known_frame_params()
     return true;
 }
 
-void frame_equalizer_impl::deinterleave(bool erase_central)
+void frame_equalizer_impl::deinterleave(decode_scratch& scratch)
 {
     int n_cbps = d_ofdm.n_cbps;
     int first[MAX_BITS_PER_SYM];
@@ -1346,37 +1453,18 @@ void frame_equalizer_impl::deinterleave(bool erase_central)
         second[i] = 16 * i - (n_cbps - 1) * int(floor(16.0 * i / n_cbps));
     }
 
-    for (int i = 0; i < d_frame.n_sym * 48; i++) {
-        for (int k = 0; k < d_ofdm.n_bpsc; k++) {
-            d_rx_bits[i * d_ofdm.n_bpsc + k] = !!(d_rx_symbols[i] & (1 << k));
-        }
-    }
-
-    // Erasure: replace the ZigBee-corrupted central carriers' coded bits with the
-    // decoder's erasure marker (value 2) so the Viterbi treats them as unknown.
-    // Done after the 0/1 unpacking above (which would otherwise force them to 0/1)
-    // and before the interleave permutation below (which preserves the value).
-    if (erase_central) {
-        for (int sym = 0; sym < d_frame.n_sym; sym++) {
-            for (int c : d_erasure_carriers) {
-                const int carrier = sym * 48 + c;
-                for (int k = 0; k < d_ofdm.n_bpsc; k++) {
-                    d_rx_bits[carrier * d_ofdm.n_bpsc + k] = 2;
-                }
-            }
-        }
-    }
-
     for (int i = 0; i < d_frame.n_sym; i++) {
         for (int k = 0; k < n_cbps; k++) {
-            d_deinterleaved_bits[i * n_cbps + second[first[k]]] =
-                d_rx_bits[i * n_cbps + k];
+            scratch.deinterleaved_bits[i * n_cbps + second[first[k]]] =
+                scratch.soft_bits[i * n_cbps + k];
         }
     }
 }
 
-void frame_equalizer_impl::descramble(uint8_t* decoded_bits)
+void frame_equalizer_impl::descramble(decode_scratch& scratch,
+                                      const uint8_t* decoded_bits)
 {
+    uint8_t* out_bytes = scratch.out_bytes;
     int state = 0;
     std::memset(out_bytes, 0, d_frame.psdu_size + 2);
 
@@ -1398,29 +1486,20 @@ void frame_equalizer_impl::descramble(uint8_t* decoded_bits)
     }
 }
 
-bool frame_equalizer_impl::decode_payload(const uint8_t* rx_symbols,
-                                          bool publish_feedback,
-                                          bool erase_central)
+bool frame_equalizer_impl::decode_payload(decode_scratch& scratch)
 {
-    std::memcpy(d_rx_symbols, rx_symbols, d_frame.n_sym * 48);
-    deinterleave(erase_central);
-    uint8_t* decoded = d_decoder.decode(&d_ofdm, &d_frame, d_deinterleaved_bits);
-    descramble(decoded);
+    deinterleave(scratch);
+    uint8_t* decoded =
+        scratch.decoder.decode_soft(&d_ofdm, &d_frame, scratch.deinterleaved_bits);
+    descramble(scratch, decoded);
 
     boost::crc_32_type result;
-    result.process_bytes(out_bytes + 2, d_frame.psdu_size);
+    result.process_bytes(scratch.out_bytes + 2, d_frame.psdu_size);
 
     if (result.checksum() != 558161692) {
         dout << "payload checksum wrong -- dropping saved signal symbols" << std::endl;
-        if (publish_feedback) {
-            message_port_pub(pmt::mp("tx_feedback"), pmt::intern("nack"));
-        }
         return false;
     }
-
-    if (publish_feedback) {
-        message_port_pub(pmt::mp("tx_feedback"), pmt::intern("ack"));
-    }
     return true;
 }
 
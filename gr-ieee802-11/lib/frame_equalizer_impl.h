@@ -18,12 +18,15 @@
 #ifndef INCLUDED_IEEE802_11_FRAME_EQUALIZER_IMPL_H
 #define INCLUDED_IEEE802_11_FRAME_EQUALIZER_IMPL_H
 
+#include "capture_writer.h"
 #include "equalizer/base.h"
 #include "utils.h"
 #include "viterbi_decoder/viterbi_decoder.h"
+#include "worker_pool.h"
+#include "zigbee_reference_spectra.h"
 #include <ieee802_11/constellations.h>
 #include <ieee802_11/frame_equalizer.h>
-#include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -42,23 +45,43 @@ public:
     void set_frequency(double freq);
 
     void forecast(int noutput_items, gr_vector_int& ninput_items_required);
+    bool stop();
     int general_work(int noutput_items,
                      gr_vector_int& ninput_items,
                      gr_vector_const_void_star& input_items,
                      gr_vector_void_star& output_items);
 
 private:
+    struct ZigbeeCandidate {
+        int ltf_start_raw;
+        gr_complex h;
+        double score;
+    };
+
+    // Everything one payload decode attempt writes. The salvage tiers run their
+    // attempts side by side on d_salvage_pool, one scratch per worker.
+    struct decode_scratch {
+        std::unique_ptr<equalizer::base> equalizer;
+        viterbi_decoder decoder;
+        gr_complex frame[(MAX_SYM + 3) * 64];
+        uint8_t bits[48 * MAX_SYM];
+        std::vector<gr_complex> symbols;
+        float noise[64];                 // per-bin noise + interference power
+        std::vector<gr_complex> points;  // constellation of the payload
+        uint8_t soft_bits[MAX_ENCODED_BITS];
+        uint8_t deinterleaved_bits[MAX_ENCODED_BITS];
+        uint8_t out_bytes[MAX_PSDU_SIZE + 2];
+    };
+
     bool parse_signal(uint8_t* signal);
     bool decode_signal_field(uint8_t* rx_bits);
     bool decode_signal_field_erased(const uint8_t* rx_bits);
     bool signal_matches_known() const;   // decoded SIGNAL equals the known fixed frame?
     bool set_known_frame_params();       // force the known frame params (knowledge-aided)
     void deinterleave(uint8_t* rx_bits);
-    void deinterleave(bool erase_central = false);
-    void descramble(uint8_t* decoded_bits);
-    bool decode_payload(const uint8_t* rx_symbols,
-                        bool publish_feedback,
-                        bool erase_central = false);
+    void deinterleave(decode_scratch& scratch);
+    void descramble(decode_scratch& scratch, const uint8_t* decoded_bits);
+    bool decode_payload(decode_scratch& scratch);
     void compute_erasure_carriers();
     void write_signal_symbols();
     equalizer::base* create_equalizer(Equalizer algo) const;
@@ -69,9 +92,9 @@ private:
     bool load_reference_data();
     void precompute_zigbee_reference_ffts();
     void reset_frame_capture();
-    bool run_equalizer_attempt(gr_complex* frame_symbols,
-                               uint8_t* out_bits,
-                               std::vector<gr_complex>& out_symbols);
+    void estimate_carrier_noise(const gr_complex* frame_symbols, float* noise) const;
+    void run_equalizer_attempt(decode_scratch& scratch,
+                               const ZigbeeCandidate* cancel = nullptr);
     int raw_fft_start_from_symbol_idx(int ltf_start_raw, int symbol_idx) const;
     bool estimate_zigbee_channel_for_offset(int ltf_start_raw,
                                             gr_complex& h,
@@ -80,10 +103,6 @@ private:
     bool get_zigbee_reference_symbol_fft(int symbol_idx,
                                          int ltf_start_raw,
                                          gr_complex* fft_symbol) const;
-    bool compute_zigbee_reference_symbol_fft_uncached(
-        int symbol_idx,
-        int ltf_start_raw,
-        std::array<gr_complex, 64>& fft_symbol) const;
     void subtract_zigbee_interference(gr_complex h,
                                       gr_complex* frame_symbols,
                                       int total_symbols) const;
@@ -98,15 +117,61 @@ private:
                                  bool& salvaged);
     int flush_pending_output(uint8_t* out, int noutput_items);
     void publish_payload_symbols(const std::vector<gr_complex>& payload_symbols);
-    void write_correction_stats();
-    void capture_raw_frame(std::ofstream& file,
-                           int& counter,
-                           const gr_complex* raw,
+    void update_correction_stats();
+    void write_correction_stats_file();
+    void record_salvage_latency(double us);
+    void record_diag(uint8_t kind, uint8_t result, double score = 0.0);
+    void capture_raw_frame(int& counter,
                            int total_symbols,
-                           const char* outcome,
-                           const char* tier,
+                           uint8_t outcome,
+                           uint8_t tier,
                            double score);
 
+    // Binary capture records (see capture_writer.h); the capture metadata lists the
+    // fields and the names of the result codes for python/capture.py.
+    static constexpr int CAPTURE_RECORD_SYMBOLS = 64; // longer frames are truncated
+    struct diag_record {
+        uint8_t kind;   // SIGNAL, FRAME or PAYLOAD
+        uint8_t result; // per kind
+        uint8_t encoding;
+        uint8_t reserved0;
+        uint16_t frame_bytes;
+        uint16_t reserved1;
+        float m;
+        float score;
+    };
+    struct frame_record {
+        uint32_t index; // per outcome, from 1
+        uint8_t outcome;
+        uint8_t tier;
+        uint8_t signal_source;
+        uint8_t encoding;
+        uint16_t frame_bytes;
+        uint16_t n_sym;
+        uint16_t total_symbols;
+        uint16_t stored_symbols;
+        float m;
+        float score;
+        uint32_t reserved[2];
+        gr_complex raw[CAPTURE_RECORD_SYMBOLS * 64];
+    };
+
+    // What write_correction_stats_file() writes, copied from the block's counters
+    // so that the writer thread never reads them while the block updates them.
+    struct correction_stats {
+        uint64_t attempt_count = 0;
+        uint64_t crc_success_count = 0;
+        double last_correlation_score = 0.0;
+        int last_ltf_start_raw = 0;
+        int salvage_workers = 0;
+        uint64_t salvage_count = 0;
+        double salvage_latency_last_us = 0.0;
+        double salvage_latency_total_us = 0.0;
+        double salvage_latency_max_us = 0.0;
+        uint64_t diag_records_dropped = 0;
+        uint64_t frame_records_dropped = 0;
+    };
+
     equalizer::base* d_equalizer;
     gr::thread::mutex d_mutex;
     std::vector<gr::tag_t> tags;
@@ -115,10 +180,7 @@ private:
     Equalizer d_algorithm;
     int d_current_symbol;
     std::ofstream signal_file;
-    std::ofstream d_diag_file;       // unconditional per-frame diagnostics (M + outcome)
     float d_diag_m = 0.0f;           // clean-band LTF agreement M of the current frame
-    std::ofstream d_good_frames_file; // raw (pre-equalizer) frames that passed CRC
-    std::ofstream d_fail_frames_file; // raw frames that reached salvage/erasure but failed CRC
     int d_good_capture_count = 0;
     int d_fail_capture_count = 0;
     viterbi_decoder d_decoder;
@@ -139,13 +201,8 @@ private:
 
     uint8_t d_deinterleaved[48];
     gr_complex symbols[48];
-    uint8_t d_rx_symbols[48 * MAX_SYM];
-    uint8_t d_rx_bits[MAX_ENCODED_BITS];
-    uint8_t d_deinterleaved_bits[MAX_ENCODED_BITS];
-    uint8_t out_bytes[MAX_PSDU_SIZE + 2];
     gr_complex d_saved_signal_symbols[2 * 64];
     gr_complex d_captured_symbols[(MAX_SYM + 3) * 64];
-    gr_complex d_raw_snapshot[(MAX_SYM + 3) * 64]; // pre-equalizer copy for frame capture
     uint8_t d_pending_output_bits[48 * MAX_SYM];
     std::vector<gr_complex> d_pending_payload_symbols;
     bool d_signal_symbols_pending;
@@ -162,15 +219,16 @@ private:
     uint64_t d_correction_crc_success_count;
     double d_last_correlation_score;
     int d_last_zigbee_ltf_start_raw;
+    uint64_t d_salvage_count;              // frames that went past the clean decode
+    double d_salvage_latency_last_us;      // wall time of the last salvage
+    double d_salvage_latency_total_us;
+    double d_salvage_latency_max_us;
+    worker_pool d_salvage_pool;
+    std::vector<std::unique_ptr<decode_scratch>> d_scratch; // one per pool worker
     std::vector<gr_complex> d_ref_ltf1;
     std::vector<gr_complex> d_ref_ltf2;
     std::vector<gr_complex> d_ref_wifi_rx_from_zigbee;
-    std::vector<std::array<gr_complex, 64>> d_zigbee_ref_fft_cache;
-    std::vector<uint8_t> d_zigbee_ref_fft_cache_valid;
-    int d_zigbee_ref_fft_cache_min_ltf_start_raw;
-    int d_zigbee_ref_fft_cache_max_ltf_start_raw;
-    int d_zigbee_ref_fft_cache_symbol_count;
-    bool d_zigbee_ref_fft_cache_ready;
+    zigbee_reference_spectra d_zigbee_ref_spectra;
     bool d_reference_ready;
 
     std::shared_ptr<gr::digital::constellation> d_frame_mod;
@@ -180,6 +238,12 @@ private:
     constellation_64qam::sptr d_64qam;
 
     static const int interleaver_pattern[48];
+
+    gr::thread::mutex d_stats_mutex;
+    correction_stats d_stats;
+    // Declared last: their threads use the members above until they are joined.
+    std::unique_ptr<capture_writer> d_diag_writer;  // per-frame M + outcome, and stats
+    std::unique_ptr<capture_writer> d_frame_writer; // raw (pre-equalizer) frames
 };
 
 } // namespace ieee802_11
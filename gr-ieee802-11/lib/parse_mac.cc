@@ -72,7 +72,7 @@ public:
             return;
         }
 
-        d_meta = pmt::dict_add(d_meta, pmt::mp("duration"), pmt::mp(h->duration));
+        add_meta("duration", pmt::mp(h->duration));
 
 #define HEX(a) std::hex << std::setfill('0') << std::setw(2) << int(a) << std::dec
         dout << "duration: " << HEX(h->duration >> 8) << " " << HEX(h->duration & 0xff)
@@ -83,24 +83,24 @@ public:
         switch ((h->frame_control >> 2) & 3) {
 
         case 0:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("type"), pmt::mp("management"));
+            add_meta("type", pmt::mp("management"));
             dout << " (MANAGEMENT)" << std::endl;
             parse_management((char*)h, frame_len);
             break;
         case 1:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("type"), pmt::mp("Control"));
+            add_meta("type", pmt::mp("Control"));
             dout << " (CONTROL)" << std::endl;
             parse_control((char*)h, frame_len);
             break;
 
         case 2:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("type"), pmt::mp("Data"));
+            add_meta("type", pmt::mp("Data"));
             dout << " (DATA)" << std::endl;
             parse_data((char*)h, frame_len);
             break;
 
         default:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("type"), pmt::mp("Unknown"));
+            add_meta("type", pmt::mp("Unknown"));
             dout << " (unknown)" << std::endl;
             break;
         }
@@ -130,44 +130,39 @@ public:
         dout << "Subtype: ";
         switch (((h->frame_control) >> 4) & 0xf) {
         case 0:
-            d_meta =
-                pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Association Request"));
+            add_meta("subtype", pmt::mp("Association Request"));
             dout << "Association Request";
             break;
         case 1:
-            d_meta = pmt::dict_add(
-                d_meta, pmt::mp("subtype"), pmt::mp("Association Response"));
+            add_meta("subtype", pmt::mp("Association Response"));
             dout << "Association Response";
             break;
         case 2:
-            d_meta = pmt::dict_add(
-                d_meta, pmt::mp("subtype"), pmt::mp("Reassociation Request"));
+            add_meta("subtype", pmt::mp("Reassociation Request"));
             dout << "Reassociation Request";
             break;
         case 3:
-            d_meta = pmt::dict_add(
-                d_meta, pmt::mp("subtype"), pmt::mp("Reassociation Response"));
+            add_meta("subtype", pmt::mp("Reassociation Response"));
             dout << "Reassociation Response";
             break;
         case 4:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Probe Request"));
+            add_meta("subtype", pmt::mp("Probe Request"));
             dout << "Probe Request";
             break;
         case 5:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Probe Response"));
+            add_meta("subtype", pmt::mp("Probe Response"));
             dout << "Probe Response";
             break;
         case 6:
-            d_meta = pmt::dict_add(
-                d_meta, pmt::mp("subtype"), pmt::mp("Timing Advertisement"));
+            add_meta("subtype", pmt::mp("Timing Advertisement"));
             dout << "Timing Advertisement";
             break;
         case 7:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Reserved"));
+            add_meta("subtype", pmt::mp("Reserved"));
             dout << "Reserved";
             break;
         case 8:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Beacon"));
+            add_meta("subtype", pmt::mp("Beacon"));
             dout << "Beacon" << std::endl;
             if (length < 38) {
                 return;
@@ -178,37 +173,36 @@ public:
                     return;
                 }
                 std::string s(buf + 24 + 14, *len);
-                d_meta = pmt::dict_add(d_meta, pmt::mp("ssid"), pmt::mp(s));
+                add_meta("ssid", pmt::mp(s));
                 dout << "SSID: " << s;
             }
             break;
         case 9:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("ATIM"));
+            add_meta("subtype", pmt::mp("ATIM"));
             dout << "ATIM";
             break;
         case 10:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Disassociation"));
+            add_meta("subtype", pmt::mp("Disassociation"));
             dout << "Disassociation";
             break;
         case 11:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Authentication"));
+            add_meta("subtype", pmt::mp("Authentication"));
             dout << "Authentication";
             break;
         case 12:
-            d_meta =
-                pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Deauthentication"));
+            add_meta("subtype", pmt::mp("Deauthentication"));
             dout << "Deauthentication";
             break;
         case 13:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Action"));
+            add_meta("subtype", pmt::mp("Action"));
             dout << "Action";
             break;
         case 14:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Action No Ack"));
+            add_meta("subtype", pmt::mp("Action No Ack"));
             dout << "Action No Ack";
             break;
         case 15:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Reserved"));
+            add_meta("subtype", pmt::mp("Reserved"));
             dout << "Reserved";
             break;
         default:
@@ -217,19 +211,19 @@ public:
         dout << std::endl;
 
         int seq_no = int(h->seq_nr >> 4);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("sequence number"), pmt::mp(seq_no));
+        add_meta("sequence number", pmt::mp(seq_no));
         dout << "seq nr: " << seq_no << std::endl;
 
         auto address = format_mac_address(h->addr1);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("address 1"), pmt::mp(address));
+        add_meta("address 1", pmt::mp(address));
         dout << "address 1: " << address << std::endl;
 
         address = format_mac_address(h->addr2);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("address 2"), pmt::mp(address));
+        add_meta("address 2", pmt::mp(address));
         dout << "address 2: " << address << std::endl;
 
         address = format_mac_address(h->addr3);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("address 3"), pmt::mp(address));
+        add_meta("address 3", pmt::mp(address));
         dout << "address 3: " << address << std::endl;
     }
 
@@ -245,73 +239,67 @@ public:
         dout << "Subtype: ";
         switch (((h->frame_control) >> 4) & 0xf) {
         case 0:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Data"));
+            add_meta("subtype", pmt::mp("Data"));
             dout << "Data";
             break;
         case 1:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Data + CF-ACK"));
+            add_meta("subtype", pmt::mp("Data + CF-ACK"));
             dout << "Data + CF-ACK";
             break;
         case 2:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Data + CR-Poll"));
+            add_meta("subtype", pmt::mp("Data + CR-Poll"));
             dout << "Data + CR-Poll";
             break;
         case 3:
-            d_meta = pmt::dict_add(
-                d_meta, pmt::mp("subtype"), pmt::mp("Data + CF-ACK + CF-Poll"));
+            add_meta("subtype", pmt::mp("Data + CF-ACK + CF-Poll"));
             dout << "Data + CF-ACK + CF-Poll";
             break;
         case 4:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Null"));
+            add_meta("subtype", pmt::mp("Null"));
             dout << "Null";
             break;
         case 5:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("CF-ACK"));
+            add_meta("subtype", pmt::mp("CF-ACK"));
             dout << "CF-ACK";
             break;
         case 6:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("CF-Poll"));
+            add_meta("subtype", pmt::mp("CF-Poll"));
             dout << "CF-Poll";
             break;
         case 7:
-            d_meta =
-                pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("CF-ACK + CF-Poll"));
+            add_meta("subtype", pmt::mp("CF-ACK + CF-Poll"));
             dout << "CF-ACK + CF-Poll";
             break;
         case 8:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("QoS Data"));
+            add_meta("subtype", pmt::mp("QoS Data"));
             dout << "QoS Data";
             break;
         case 9:
-            d_meta =
-                pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("QoS Data + CF-ACK"));
+            add_meta("subtype", pmt::mp("QoS Data + CF-ACK"));
             dout << "QoS Data + CF-ACK";
             break;
         case 10:
-            d_meta =
-                pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("QoS Data + CF-Poll"));
+            add_meta("subtype", pmt::mp("QoS Data + CF-Poll"));
             dout << "QoS Data + CF-Poll";
             break;
         case 11:
-            d_meta = pmt::dict_add(
-                d_meta, pmt::mp("subtype"), pmt::mp("QoS Data + CF-ACK + CF-Poll"));
+            add_meta("subtype", pmt::mp("QoS Data + CF-ACK + CF-Poll"));
             dout << "QoS Data + CF-ACK + CF-Poll";
             break;
         case 12:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("QoS Null"));
+            add_meta("subtype", pmt::mp("QoS Null"));
             dout << "QoS Null";
             break;
         case 13:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Reserved"));
+            add_meta("subtype", pmt::mp("Reserved"));
             dout << "Reserved";
             break;
         case 14:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("QoS CF-Poll"));
+            add_meta("subtype", pmt::mp("QoS CF-Poll"));
             dout << "QoS CF-Poll";
             break;
         case 15:
-            d_meta = pmt::dict_add(
-                d_meta, pmt::mp("subtype"), pmt::mp("QoS CF-ACK + CF-Poll"));
+            add_meta("subtype", pmt::mp("QoS CF-ACK + CF-Poll"));
             dout << "QoS CF-ACK + CF-Poll";
             break;
         default:
@@ -321,31 +309,31 @@ public:
 
 
         int seq_no = int(h->seq_nr >> 4);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("sequence number"), pmt::mp(seq_no));
+        add_meta("sequence number", pmt::mp(seq_no));
         dout << "seq nr: " << seq_no << std::endl;
 
         auto address = format_mac_address(h->addr1);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("address 1"), pmt::mp(address));
+        add_meta("address 1", pmt::mp(address));
         dout << "address 1: " << address << std::endl;
 
         address = format_mac_address(h->addr2);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("address 2"), pmt::mp(address));
+        add_meta("address 2", pmt::mp(address));
         dout << "address 2: " << address << std::endl;
 
         address = format_mac_address(h->addr3);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("address 3"), pmt::mp(address));
+        add_meta("address 3", pmt::mp(address));
         dout << "address 3: " << address << std::endl;
 
 
         float lost_frames = seq_no - d_last_seq_no - 1;
         if (lost_frames < 0)
             lost_frames += 1 << 12;
-        d_meta = pmt::dict_add(d_meta, pmt::mp("lost frames"), pmt::mp(lost_frames));
+        add_meta("lost frames", pmt::mp(lost_frames));
 
         // calculate frame error rate
         float fer = lost_frames / (lost_frames + 1);
         dout << "instantaneous fer: " << fer << std::endl;
-        d_meta = pmt::dict_add(d_meta, pmt::mp("instantaneous fer"), pmt::mp(fer));
+        add_meta("instantaneous fer", pmt::mp(fer));
 
         // keep track of sequence numbers
         d_last_seq_no = seq_no;
@@ -358,46 +346,43 @@ public:
         dout << "Subtype: ";
         switch (((h->frame_control) >> 4) & 0xf) {
         case 7:
-            d_meta =
-                pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Control Wrapper"));
+            add_meta("subtype", pmt::mp("Control Wrapper"));
             dout << "Control Wrapper";
             break;
         case 8:
-            d_meta =
-                pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Block ACK Request"));
+            add_meta("subtype", pmt::mp("Block ACK Request"));
             dout << "Block ACK Request";
             break;
         case 9:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Block ACK"));
+            add_meta("subtype", pmt::mp("Block ACK"));
             dout << "Block ACK";
             break;
         case 10:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("PS Poll"));
+            add_meta("subtype", pmt::mp("PS Poll"));
             dout << "PS Poll";
             break;
         case 11:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("RTS"));
+            add_meta("subtype", pmt::mp("RTS"));
             dout << "RTS";
             break;
         case 12:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("CTS"));
+            add_meta("subtype", pmt::mp("CTS"));
             dout << "CTS";
             break;
         case 13:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("ACK"));
+            add_meta("subtype", pmt::mp("ACK"));
             dout << "ACK";
             break;
         case 14:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("CF-End"));
+            add_meta("subtype", pmt::mp("CF-End"));
             dout << "CF-End";
             break;
         case 15:
-            d_meta =
-                pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("CF-End + CF-ACK"));
+            add_meta("subtype", pmt::mp("CF-End + CF-ACK"));
             dout << "CF-End + CF-ACK";
             break;
         default:
-            d_meta = pmt::dict_add(d_meta, pmt::mp("subtype"), pmt::mp("Reserved"));
+            add_meta("subtype", pmt::mp("Reserved"));
             dout << "Reserved";
             break;
         }
@@ -405,14 +390,21 @@ public:
 
 
         auto address = format_mac_address(h->addr1);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("ra"), pmt::mp(address));
+        add_meta("ra", pmt::mp(address));
         dout << "RA: " << address << std::endl;
 
         address = format_mac_address(h->addr2);
-        d_meta = pmt::dict_add(d_meta, pmt::mp("ta"), pmt::mp(address));
+        add_meta("ta", pmt::mp(address));
         dout << "TA: " << address << std::endl;
     }
 
+    // The first key copies the frame's metadata, which is shared with the
+    // incoming PDU; later ones go into that copy in place.
+    void add_meta(const char* key, const pmt::pmt_t& value)
+    {
+        d_meta = pmt::dict_add(std::move(d_meta), pmt::mp(key), value);
+    }
+
     std::string format_mac_address(uint8_t* addr)
     {
         std::stringstream str;
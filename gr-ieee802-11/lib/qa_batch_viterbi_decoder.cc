@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils.h"
+#include "viterbi_decoder/viterbi_decoder.h"
+#include "viterbi_decoder/viterbi_decoder_batch.h"
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace gr::ieee802_11;
+
+namespace {
+
+struct test_frame {
+    test_frame(Encoding e, int psdu_size) : ofdm(e), frame(ofdm, psdu_size) {}
+
+    ofdm_param ofdm;
+    frame_param frame;
+    std::vector<uint8_t> data; // SERVICE and PSDU bits
+    // Deinterleaved soft decisions, 0 to SOFT_MAX, followed by those of a run of zero
+    // bits, see check_batch().
+    std::vector<uint8_t> in;
+};
+
+// Random bits through the encoder and the puncturer, as soft decisions of random
+// confidence with a few erasures and, if errors, a few weakly wrong ones. The draws
+// use the generator directly, so that the frames are the same with every standard
+// library.
+std::unique_ptr<test_frame> make_frame(std::mt19937& rng, bool errors)
+{
+    const Encoding encoding = Encoding(BPSK_1_2 + rng() % 8);
+    auto f = std::make_unique<test_frame>(encoding, 1 + rng() % 300);
+    std::vector<char> bits(f->frame.n_data_bits);
+    std::vector<char> encoded(f->frame.n_data_bits * 2);
+    std::vector<char> punctured(f->frame.n_encoded_bits);
+    for (int i = 0; i < 16 + 8 * f->frame.psdu_size; i++) {
+        bits[i] = rng() & 1;
+    }
+    f->data.assign(bits.begin(), bits.begin() + 16 + 8 * f->frame.psdu_size);
+    reset_tail_bits(bits.data(), f->frame);
+    convolutional_encoding(bits.data(), encoded.data(), f->frame);
+    puncturing(encoded.data(), punctured.data(), f->frame, f->ofdm);
+
+    for (char b : punctured) {
+        uint8_t s = 1 + rng() % (SOFT_ERASURE - 1);
+        if (rng() % 100 == 0) {
+            s = SOFT_ERASURE;
+        } else if (errors && rng() % 2000 == 0) {
+            s = SOFT_ERASURE + 1;
+        }
+        f->in.push_back(b ? SOFT_MAX - s : s);
+    }
+    f->in.resize(MAX_ENCODED_BITS, 0);
+    return f;
+}
+
+// Decodes nframes frames with both decoders and requires the same bits from both,
+// and without errors the bits that were sent.
+void check_batch(int nframes, bool errors)
+{
+    std::mt19937 rng(nframes);
+    viterbi_decoder reference;
+    batch_viterbi_decoder decoder;
+
+    std::vector<std::unique_ptr<test_frame>> frames;
+    std::vector<std::vector<uint8_t>> out(nframes);
+    std::vector<batch_viterbi_decoder::job> jobs;
+    for (int i = 0; i < nframes; i++) {
+        frames.push_back(make_frame(rng, errors));
+        test_frame& f = *frames.back();
+        out[i].resize(f.data.size());
+        jobs.push_back({ &f.ofdm, &f.frame, f.in.data(), out[i].data() });
+    }
+    decoder.decode(jobs.data(), nframes);
+
+    for (int i = 0; i < nframes; i++) {
+        test_frame& f = *frames[i];
+        // The per-frame decoder traces back from its best state rather than from the
+        // end of the tail, reading ahead of the bits it returns, so it gets the frame
+        // followed by the code of zero bits. The batch decoder must not need them.
+        frame_param longer(f.ofdm, f.frame.psdu_size + 32);
+        const uint8_t* expected = reference.decode_soft(&f.ofdm, &longer, f.in.data());
+        BOOST_TEST_CONTEXT("frame " << i << " of " << nframes << ", encoding "
+                                    << f.ofdm.encoding << ", " << f.frame.psdu_size
+                                    << " bytes")
+        {
+            BOOST_REQUIRE_EQUAL_COLLECTIONS(
+                out[i].begin(), out[i].end(), expected, expected + out[i].size());
+            if (!errors) {
+                BOOST_REQUIRE_EQUAL_COLLECTIONS(
+                    out[i].begin(), out[i].end(), f.data.begin(), f.data.end());
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t0_erasures)
+{
+    // Passes of one lane, of full lanes and with some lanes left empty.
+    for (int nframes : { 1, 5, 16, 17, 37 }) {
+        check_batch(nframes, false);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(t1_bit_errors)
+{
+    for (int nframes : { 3, 16, 29, 50 }) {
+        check_batch(nframes, true);
+    }
+}
@@ -15,16 +15,85 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "utils.h"
+#include <gnuradio/blocks/rotator.h>
 #include <gnuradio/io_signature.h>
 #include <ieee802_11/sync_short.h>
 
+#include <algorithm>
 #include <iostream>
 
+#ifdef IEEE80211_MSSE2
+#include <xmmintrin.h>
+#endif
+
 using namespace gr::ieee802_11;
 
 static const int MIN_GAP = 480;
 static const int MAX_SAMPLES = 540 * 80;
 
+namespace {
+
+// Bit k is set if cor[k] > threshold, for k < n <= 64.
+uint64_t above_threshold(const float* cor, int n, float threshold)
+{
+    uint64_t mask = 0;
+    int k = 0;
+#ifdef IEEE80211_MSSE2
+    const __m128 t = _mm_set1_ps(threshold);
+    for (; k + 4 <= n; k += 4) {
+        uint64_t bits = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(cor + k), t));
+        mask |= bits << k;
+    }
+#endif
+    for (; k < n; k++) {
+        mask |= uint64_t(cor[k] > threshold) << k;
+    }
+    return mask;
+}
+
+// Advance the plateau counter -- the number of consecutive samples above threshold, up
+// to min_plateau -- over cor[0, n). If detect is set, stop at the first sample above
+// threshold that finds the counter at min_plateau and return its index; otherwise, or
+// if there is none, return n.
+//
+// The samples are compared 64 at a time; blocks entirely below threshold (noise) or
+// entirely above (a plateau) are settled without looking at single samples.
+int scan_plateau(const float* cor,
+                 int n,
+                 float threshold,
+                 int min_plateau,
+                 int& plateau,
+                 bool detect)
+{
+    for (int start = 0; start < n; start += 64) {
+        const int len = std::min(64, n - start);
+        const uint64_t all = len == 64 ? ~uint64_t(0) : (uint64_t(1) << len) - 1;
+        const uint64_t mask = above_threshold(cor + start, len, threshold);
+
+        if (mask == 0) {
+            plateau = 0;
+        } else if (mask == all) {
+            if (detect && plateau + len > min_plateau) {
+                return start + min_plateau - plateau;
+            }
+            plateau = std::min(min_plateau, plateau + len);
+        } else {
+            for (int k = 0; k < len; k++) {
+                if (!((mask >> k) & 1)) {
+                    plateau = 0;
+                } else if (plateau < min_plateau) {
+                    plateau++;
+                } else if (detect) {
+                    return start + k;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+} // namespace
+
 class sync_short_impl : public sync_short
 {
 
@@ -68,27 +137,16 @@ public:
         switch (d_state) {
 
         case SEARCH: {
-            int i;
-
-            for (i = 0; i < ninput; i++) {
-                if (in_cor[i] > d_threshold) {
-                    if (d_plateau < MIN_PLATEAU) {
-                        d_plateau++;
-
-                    } else {
-                        d_state = COPY;
-                        d_copied = 0;
-                        d_freq_offset = arg(in_abs[i]) / 16;
-                        d_plateau = 0;
-                        // nitems_written(0) how many items produced so far by this block
-                        // nitems_read(0) + i, the absolute index on the input port
-                        insert_tag(nitems_written(0), d_freq_offset, nitems_read(0) + i);
-                        dout << "SHORT Frame!" << std::endl;
-                        break;
-                    }
-                } else {
-                    d_plateau = 0;
-                }
+            int i =
+                scan_plateau(in_cor, ninput, d_threshold, MIN_PLATEAU, d_plateau, true);
+
+            if (i < ninput) {
+                d_state = COPY;
+                start_frame(in_abs[i]);
+                // nitems_written(0) how many items produced so far by this block
+                // nitems_read(0) + i, the absolute index on the input port
+                insert_tag(nitems_written(0), d_freq_offset, nitems_read(0) + i);
+                dout << "SHORT Frame!" << std::endl;
             }
 
             consume_each(i);
@@ -97,30 +155,26 @@ public:
 
         case COPY: {
 
-            int o = 0;
-            while (o < ninput && o < noutput && d_copied < MAX_SAMPLES) {
-                if (in_cor[o] > d_threshold) {
-                    if (d_plateau < MIN_PLATEAU) {
-                        d_plateau++;
-
-                        // there's another frame
-                    } else if (d_copied > MIN_GAP) {
-                        d_copied = 0;
-                        d_plateau = 0;
-                        d_freq_offset = arg(in_abs[o]) / 16;
-                        insert_tag(
-                            nitems_written(0) + o, d_freq_offset, nitems_read(0) + o);
-                        dout << "SHORT Frame!" << std::endl;
-                        break;
-                    }
-
-                } else {
-                    d_plateau = 0;
-                }
-
-                out[o] = in[o] * exp(gr_complex(0, -d_freq_offset * d_copied));
-                o++;
-                d_copied++;
+            int n = std::min(std::min(ninput, noutput), MAX_SAMPLES - d_copied);
+
+            // No other frame can start within MIN_GAP samples of this one.
+            int gap = std::min(n, std::max(0, MIN_GAP + 1 - d_copied));
+            scan_plateau(in_cor, gap, d_threshold, MIN_PLATEAU, d_plateau, false);
+            int o = gap + scan_plateau(in_cor + gap,
+                                       n - gap,
+                                       d_threshold,
+                                       MIN_PLATEAU,
+                                       d_plateau,
+                                       true);
+
+            d_rotator.rotateN(out, in, o);
+            d_copied += o;
+
+            // there's another frame
+            if (o < n) {
+                start_frame(in_abs[o]);
+                insert_tag(nitems_written(0) + o, d_freq_offset, nitems_read(0) + o);
+                dout << "SHORT Frame!" << std::endl;
             }
 
             if (d_copied == MAX_SAMPLES) {
@@ -138,6 +192,17 @@ public:
         return 0;
     }
 
+    // The frame's samples are rotated by -d_freq_offset per sample, starting with
+    // phase 0 at the sample that completed the plateau.
+    void start_frame(gr_complex autocorrelation)
+    {
+        d_copied = 0;
+        d_plateau = 0;
+        d_freq_offset = arg(autocorrelation) / 16;
+        d_rotator.set_phase(gr_complex(1, 0));
+        d_rotator.set_phase_incr(exp(gr_complex(0, -d_freq_offset)));
+    }
+
     void insert_tag(uint64_t item, double freq_offset, uint64_t input_item)
     {
         mylog("frame start at in: {} out: {}", input_item, item);
@@ -157,6 +222,7 @@ private:
     int d_copied;
     int d_plateau;
     float d_freq_offset;
+    gr::blocks::rotator d_rotator;
     const double d_threshold;
     const bool d_log;
     const bool d_debug;
@@ -31,6 +31,12 @@ using gr::ieee802_11::Encoding;
 #define MAX_BITS_PER_SYM 288
 #define MAX_ENCODED_BITS ((16 + 8 * MAX_PSDU_SIZE + 6) * 2 + MAX_BITS_PER_SYM)
 
+// Soft decisions, one byte per coded bit: 0 is a certain 0, SOFT_MAX a certain 1 and
+// SOFT_ERASURE carries no information. Small enough that the Viterbi's 8-bit path
+// metrics cannot wrap between renormalizations.
+#define SOFT_MAX 8
+#define SOFT_ERASURE (SOFT_MAX / 2)
+
 #define dout d_debug&& std::cout
 #define mylog(...)                      \
     do {                                \
@@ -21,11 +21,11 @@
 
 using namespace gr::ieee802_11;
 
-base::base() : d_store_pos(0) {}
+base::base() : d_store_pos(0), d_soft(false) {}
 
 base::~base() {}
 
-uint8_t* base::depuncture(uint8_t* in)
+uint8_t* base::depuncture(uint8_t* in, uint8_t erasure)
 {
 
     int count;
@@ -42,7 +42,7 @@ uint8_t* base::depuncture(uint8_t* in)
         for (int i = 0; i < d_frame->n_sym; i++) {
             for (int k = 0; k < n_cbps; k++) {
                 while (d_depuncture_pattern[count % (2 * d_k)] == 0) {
-                    depunctured[count] = 2;
+                    depunctured[count] = erasure;
                     count++;
                 }
 
@@ -51,7 +51,7 @@ uint8_t* base::depuncture(uint8_t* in)
                 count++;
 
                 while (d_depuncture_pattern[count % (2 * d_k)] == 0) {
-                    depunctured[count] = 2;
+                    depunctured[count] = erasure;
                     count++;
                 }
             }
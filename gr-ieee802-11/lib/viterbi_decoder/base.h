@@ -36,6 +36,8 @@ public:
     base();
     ~base();
     virtual uint8_t* decode(ofdm_param* ofdm, frame_param* frame, uint8_t* in) = 0;
+    // Like decode(), but `in` holds soft decisions from 0 to SOFT_MAX (see utils.h).
+    virtual uint8_t* decode_soft(ofdm_param* ofdm, frame_param* frame, uint8_t* in) = 0;
 
 protected:
     // Position in circular buffer where the current decoded byte is stored
@@ -50,6 +52,7 @@ protected:
     ofdm_param* d_ofdm;
     frame_param* d_frame;
     const unsigned char* d_depuncture_pattern;
+    bool d_soft; // branch metrics from soft decisions rather than hard bits
 
     uint8_t d_depunctured[MAX_ENCODED_BITS];
     uint8_t d_decoded[MAX_ENCODED_BITS * 3 / 4];
@@ -60,7 +63,7 @@ protected:
     static const unsigned char PUNCTURE_3_4[6];
 
     virtual void reset() = 0;
-    uint8_t* depuncture(uint8_t* in);
+    uint8_t* depuncture(uint8_t* in, uint8_t erasure);
 };
 
 } // namespace ieee802_11
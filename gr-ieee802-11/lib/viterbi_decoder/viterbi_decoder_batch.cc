@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "viterbi_decoder_batch.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef IEEE80211_MSSE2
+#include <emmintrin.h>
+#endif
+
+using namespace gr::ieee802_11;
+
+namespace {
+// Puncturing patterns over the rate 1/2 mother code, as in base.cc.
+const uint8_t PUNCTURE_1_2[2] = { 1, 1 };
+const uint8_t PUNCTURE_2_3[4] = { 1, 1, 1, 0 };
+const uint8_t PUNCTURE_3_4[6] = { 1, 1, 1, 0, 0, 1 };
+
+// Trellis steps of a frame that are decoded: SERVICE, PSDU and the tail that ends in
+// state 0. The pad bits after the tail are skipped.
+int trellis_steps(const frame_param& frame) { return 16 + 8 * frame.psdu_size + 6; }
+
+int parity(int x)
+{
+    int p = 0;
+    for (; x; x >>= 1) {
+        p ^= x & 1;
+    }
+    return p;
+}
+} // namespace
+
+batch_viterbi_decoder::batch_viterbi_decoder() : d_steps(0)
+{
+    // Same register as convolutional_encoding() in utils.cc: the newest bit in bit 0,
+    // the state is the six newest bits.
+    for (int n = 0; n < 64; n++) {
+        for (int x = 0; x < 2; x++) {
+            int reg = (x << 6) | n;
+            d_branch[n][x] = 2 * parity(reg & 0155) + parity(reg & 0117);
+        }
+    }
+}
+
+void batch_viterbi_decoder::decode(const job* jobs, int njobs)
+{
+    // A pass lasts as long as its longest frame, so frames of similar length share
+    // passes.
+    d_order.resize(njobs);
+    for (int i = 0; i < njobs; i++) {
+        d_order[i] = i;
+    }
+    std::stable_sort(d_order.begin(), d_order.end(), [jobs](int a, int b) {
+        return trellis_steps(*jobs[a].frame) < trellis_steps(*jobs[b].frame);
+    });
+
+    for (int start = 0; start < njobs; start += LANES) {
+        const int lanes = std::min(njobs - start, LANES);
+        for (int lane = 0; lane < lanes; lane++) {
+            d_lanes[lane] = &jobs[d_order[start + lane]];
+        }
+        decode_pass(lanes);
+    }
+}
+
+void batch_viterbi_decoder::decode_pass(int lanes)
+{
+    d_steps = 0;
+    for (int lane = 0; lane < lanes; lane++) {
+        d_steps = std::max(d_steps, trellis_steps(*d_lanes[lane]->frame));
+    }
+
+    d_symbols.assign(static_cast<size_t>(d_steps) * 2 * LANES, SOFT_ERASURE);
+    d_decisions.resize(static_cast<size_t>(d_steps) * 64);
+    for (int lane = 0; lane < lanes; lane++) {
+        load_lane(lane, *d_lanes[lane]);
+    }
+
+    run_trellis();
+    traceback(lanes);
+}
+
+void batch_viterbi_decoder::load_lane(int lane, const job& j)
+{
+    const uint8_t* pattern;
+    int period;
+    switch (j.ofdm->encoding) {
+    case QAM64_2_3:
+        pattern = PUNCTURE_2_3;
+        period = 4;
+        break;
+    case BPSK_3_4:
+    case QPSK_3_4:
+    case QAM16_3_4:
+    case QAM64_3_4:
+        pattern = PUNCTURE_3_4;
+        period = 6;
+        break;
+    default:
+        pattern = PUNCTURE_1_2;
+        period = 2;
+        break;
+    }
+
+    const uint8_t* in = j.in;
+    const int coded = 2 * trellis_steps(*j.frame);
+    for (int pos = 0; pos < coded; pos++) {
+        if (pattern[pos % period]) {
+            d_symbols[(pos / 2) * 2 * LANES + (pos % 2) * LANES + lane] = *in++;
+        }
+    }
+}
+
+// Path metrics are 8-bit and wrap around; they are only ever compared through their
+// signed 8-bit difference. Any state can be reached from any other in six steps, so
+// the metrics of the 64 states never spread by more than 6 * 2 * SOFT_MAX = 96, and
+// two candidates differ by less than 128.
+//
+// During the first six steps the predecessor's top bit would be an input from before
+// the frame, which is 0: those steps take no decision, which starts every path in
+// state 0 whatever the initial metrics.
+#ifdef IEEE80211_MSSE2
+void batch_viterbi_decoder::run_trellis()
+{
+    alignas(16) __m128i metric[2][64];
+    for (int n = 0; n < 64; n++) {
+        metric[0][n] = _mm_setzero_si128();
+    }
+
+    const __m128i soft_max = _mm_set1_epi8(SOFT_MAX);
+    const __m128i zero = _mm_setzero_si128();
+    for (int t = 0; t < d_steps; t++) {
+        const __m128i* old = metric[t & 1];
+        __m128i* next = metric[(t + 1) & 1];
+        uint16_t* decisions = &d_decisions[static_cast<size_t>(t) * 64];
+        // No decisions before step 6, see above.
+        const __m128i decide = t < 6 ? zero : _mm_set1_epi8(-1);
+
+        const __m128i* sym = reinterpret_cast<const __m128i*>(
+            &d_symbols[static_cast<size_t>(t) * 2 * LANES]);
+        const __m128i s0 = _mm_loadu_si128(sym);
+        const __m128i s1 = _mm_loadu_si128(sym + 1);
+        const __m128i r0 = _mm_sub_epi8(soft_max, s0);
+        const __m128i r1 = _mm_sub_epi8(soft_max, s1);
+        const __m128i branch[4] = { _mm_add_epi8(s0, s1),
+                                    _mm_add_epi8(s0, r1),
+                                    _mm_add_epi8(r0, s1),
+                                    _mm_add_epi8(r0, r1) };
+
+        // Butterfly: states 2q and 2q + 1 both come from q and q + 32, and since
+        // both polynomials tap the newest and the oldest bit, the code bits of the
+        // four transitions are one pair and its complement.
+        for (int q = 0; q < 32; q++) {
+            const __m128i a = old[q];
+            const __m128i b = old[q + 32];
+            const __m128i x = branch[d_branch[2 * q][0]];
+            const __m128i y = branch[3 - d_branch[2 * q][0]];
+
+            __m128i m0 = _mm_add_epi8(a, x);
+            __m128i m1 = _mm_add_epi8(b, y);
+            __m128i dec =
+                _mm_and_si128(decide, _mm_cmpgt_epi8(_mm_sub_epi8(m0, m1), zero));
+            next[2 * q] = _mm_or_si128(_mm_and_si128(dec, m1), _mm_andnot_si128(dec, m0));
+            decisions[2 * q] = _mm_movemask_epi8(dec);
+
+            m0 = _mm_add_epi8(a, y);
+            m1 = _mm_add_epi8(b, x);
+            dec = _mm_and_si128(decide, _mm_cmpgt_epi8(_mm_sub_epi8(m0, m1), zero));
+            next[2 * q + 1] =
+                _mm_or_si128(_mm_and_si128(dec, m1), _mm_andnot_si128(dec, m0));
+            decisions[2 * q + 1] = _mm_movemask_epi8(dec);
+        }
+    }
+}
+#else
+// Branch-free lane loops, so that the compiler can vectorize them.
+void batch_viterbi_decoder::run_trellis()
+{
+    uint8_t metric[2][64][LANES];
+    std::memset(metric[0], 0, sizeof(metric[0]));
+
+    for (int t = 0; t < d_steps; t++) {
+        uint8_t(*old)[LANES] = metric[t & 1];
+        uint8_t(*next)[LANES] = metric[(t + 1) & 1];
+        uint16_t* decisions = &d_decisions[static_cast<size_t>(t) * 64];
+        // No decisions before step 6, see above.
+        const uint8_t decide = t < 6 ? 0 : 0xff;
+        const uint8_t* s0 = &d_symbols[static_cast<size_t>(t) * 2 * LANES];
+        const uint8_t* s1 = s0 + LANES;
+
+        uint8_t branch[4][LANES];
+        for (int l = 0; l < LANES; l++) {
+            branch[0][l] = s0[l] + s1[l];
+            branch[1][l] = s0[l] + (SOFT_MAX - s1[l]);
+            branch[2][l] = (SOFT_MAX - s0[l]) + s1[l];
+            branch[3][l] = (SOFT_MAX - s0[l]) + (SOFT_MAX - s1[l]);
+        }
+
+        for (int n = 0; n < 64; n++) {
+            const uint8_t* a = old[n >> 1];
+            const uint8_t* b = old[(n >> 1) | 32];
+            const uint8_t* b0 = branch[d_branch[n][0]];
+            const uint8_t* b1 = branch[d_branch[n][1]];
+            uint8_t dec[LANES];
+            for (int l = 0; l < LANES; l++) {
+                uint8_t m0 = a[l] + b0[l];
+                uint8_t m1 = b[l] + b1[l];
+                dec[l] = decide & (static_cast<int8_t>(m0 - m1) > 0 ? 0xff : 0);
+                next[n][l] = (dec[l] & m1) | (~dec[l] & m0);
+            }
+
+            uint16_t mask = 0;
+            for (int l = 0; l < LANES; l++) {
+                mask |= (dec[l] & 1) << l;
+            }
+            decisions[n] = mask;
+        }
+    }
+}
+#endif
+
+// All lanes walk back together, each from state 0 at the end of its tail, so the
+// decisions are read in one sequential pass.
+void batch_viterbi_decoder::traceback(int lanes)
+{
+    int steps[LANES];
+    int state[LANES];
+    for (int lane = 0; lane < lanes; lane++) {
+        steps[lane] = trellis_steps(*d_lanes[lane]->frame);
+        state[lane] = 0;
+    }
+
+    for (int t = d_steps - 1; t >= 0; t--) {
+        const uint16_t* decisions = &d_decisions[static_cast<size_t>(t) * 64];
+        for (int lane = 0; lane < lanes; lane++) {
+            if (t >= steps[lane]) {
+                continue;
+            }
+            int s = state[lane];
+            if (t < steps[lane] - 6) {
+                d_lanes[lane]->out[t] = s & 1;
+            }
+            int x = (decisions[s] >> lane) & 1;
+            state[lane] = (s >> 1) | (x << 5);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef INCLUDED_IEEE802_11_VITERBI_DECODER_BATCH_H
+#define INCLUDED_IEEE802_11_VITERBI_DECODER_BATCH_H
+
+#include "../utils.h"
+#include <vector>
+
+namespace gr {
+namespace ieee802_11 {
+
+/*
+ * Frame-parallel Viterbi decoder: up to LANES frames are decoded together, one frame
+ * per byte lane of the SIMD registers, so every add-compare-select of the 64-state
+ * trellis advances all of them at once. Frames may differ in length and coding rate;
+ * each is depunctured into its own lane, and a lane whose frame has ended carries
+ * erasures until the longest frame of its pass is done.
+ *
+ * Unlike the per-frame decoders, which trace back in short chunks, each lane keeps
+ * its decisions for the whole frame and traces back once from state 0, where the six
+ * tail bits leave the encoder.
+ */
+class batch_viterbi_decoder
+{
+public:
+    static constexpr int LANES = 16;
+
+    struct job {
+        const ofdm_param* ofdm;
+        const frame_param* frame;
+        // Deinterleaved soft decisions (see SOFT_MAX), n_sym * n_cbps of them.
+        const uint8_t* in;
+        // Receives the 16 + 8 * psdu_size decoded SERVICE and PSDU bits, one per byte.
+        uint8_t* out;
+    };
+
+    batch_viterbi_decoder();
+
+    // Decode njobs frames, in passes of up to LANES frames.
+    void decode(const job* jobs, int njobs);
+
+private:
+    void decode_pass(int lanes);
+    void load_lane(int lane, const job& j);
+    void run_trellis();
+    void traceback(int lanes);
+
+    // Index 2 * c0 + c1 of the two code bits emitted when entering state n from its
+    // predecessor with top bit x.
+    uint8_t d_branch[64][2];
+
+    std::vector<int> d_order;
+    const job* d_lanes[LANES];
+
+    int d_steps;
+    // Depunctured soft symbols: per trellis step, LANES first then LANES second code
+    // bits.
+    std::vector<uint8_t> d_symbols;
+    // Per trellis step and state, bit l set if lane l came from the predecessor with
+    // top bit 1.
+    std::vector<uint16_t> d_decisions;
+};
+
+} // namespace ieee802_11
+} // namespace gr
+
+#endif /* INCLUDED_IEEE802_11_VITERBI_DECODER_BATCH_H */
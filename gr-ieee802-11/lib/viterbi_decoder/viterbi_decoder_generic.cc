@@ -84,6 +84,23 @@
 using namespace gr::ieee802_11;
 
 
+// Soft branch metrics for the two coded bits in symbols[0..1]: the branch whose code
+// bits equal the branch table earns s for each table bit 1 and SOFT_MAX - s for each
+// 0; the complementary branch earns the rest of 2 * SOFT_MAX.
+void viterbi_decoder::soft_branch_metrics_generic(const unsigned char* symbols,
+                                                  int i,
+                                                  unsigned char* metsv,
+                                                  unsigned char* metsvm)
+{
+    for (int j = 0; j < 16; j++) {
+        const unsigned char b0 = d_branchtab27_generic[0].c[(i * 16) + j];
+        const unsigned char b1 = d_branchtab27_generic[1].c[(i * 16) + j];
+        metsv[j] = (b0 ? symbols[0] : SOFT_MAX - symbols[0]) +
+                   (b1 ? symbols[1] : SOFT_MAX - symbols[1]);
+        metsvm[j] = 2 * SOFT_MAX - metsv[j];
+    }
+}
+
 void viterbi_decoder::viterbi_butterfly2_generic(unsigned char* symbols,
                                                  unsigned char* mm0,
                                                  unsigned char* mm1,
@@ -116,7 +133,9 @@ void viterbi_decoder::viterbi_butterfly2_generic(unsigned char* symbols,
     }
 
     for (i = 0; i < 2; i++) {
-        if (symbols[0] == 2 && symbols[1] == 2) {
+        if (d_soft) {
+            soft_branch_metrics_generic(symbols, i, metsv, metsvm);
+        } else if (symbols[0] == 2 && symbols[1] == 2) {
             // both coded bits erased -> neutral step (equal metric on every branch)
             for (j = 0; j < 16; j++) {
                 metsvm[j] = 1;
@@ -208,7 +227,9 @@ void viterbi_decoder::viterbi_butterfly2_generic(unsigned char* symbols,
     }
 
     for (i = 0; i < 2; i++) {
-        if (symbols[2] == 2 && symbols[3] == 2) {
+        if (d_soft) {
+            soft_branch_metrics_generic(symbols + 2, i, metsv, metsvm);
+        } else if (symbols[2] == 2 && symbols[3] == 2) {
             // both coded bits erased -> neutral step (see block above)
             for (j = 0; j < 16; j++) {
                 metsvm[j] = 1;
@@ -349,13 +370,26 @@ unsigned char viterbi_decoder::viterbi_get_output_generic(unsigned char* mm0,
 }
 
 uint8_t* viterbi_decoder::decode(ofdm_param* ofdm, frame_param* frame, uint8_t* in)
+{
+    d_soft = false;
+    return decode_trellis(ofdm, frame, in);
+}
+
+uint8_t* viterbi_decoder::decode_soft(ofdm_param* ofdm, frame_param* frame, uint8_t* in)
+{
+    d_soft = true;
+    return decode_trellis(ofdm, frame, in);
+}
+
+uint8_t*
+viterbi_decoder::decode_trellis(ofdm_param* ofdm, frame_param* frame, uint8_t* in)
 {
 
     d_ofdm = ofdm;
     d_frame = frame;
 
     reset();
-    uint8_t* depunctured = depuncture(in);
+    uint8_t* depunctured = depuncture(in, d_soft ? SOFT_ERASURE : 2);
 
     int in_count = 0;
     int out_count = 0;
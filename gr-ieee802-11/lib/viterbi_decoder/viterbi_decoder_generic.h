@@ -31,6 +31,7 @@ class viterbi_decoder : public base
 {
 public:
     virtual uint8_t* decode(ofdm_param* ofdm, frame_param* frame, uint8_t* in);
+    virtual uint8_t* decode_soft(ofdm_param* ofdm, frame_param* frame, uint8_t* in);
 
 private:
     union branchtab27 {
@@ -43,8 +44,13 @@ private:
     alignas(16) unsigned char d_path1_generic[64];
 
     void reset();
+    uint8_t* decode_trellis(ofdm_param* ofdm, frame_param* frame, uint8_t* in);
 
     void viterbi_chunks_init_generic();
+    void soft_branch_metrics_generic(const unsigned char* symbols,
+                                     int i,
+                                     unsigned char* metsv,
+                                     unsigned char* metsvm);
     void viterbi_butterfly2_generic(unsigned char* symbols,
                                     unsigned char m0[],
                                     unsigned char m1[],
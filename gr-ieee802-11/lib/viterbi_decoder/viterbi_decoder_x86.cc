@@ -83,6 +83,37 @@
 
 using namespace gr::ieee802_11;
 
+// Soft branch metrics for the two coded bits in symbols[0..1], 16 states at a time:
+// the branch whose code bits equal the branch table earns s for each table bit 1 and
+// SOFT_MAX - s for each 0; the complementary branch earns the rest of 2 * SOFT_MAX.
+// With SOFT_MAX = 8 a trellis step adds at most 16, which keeps the 8-bit metrics of
+// the 64 states within 128 of each other and below 256 until the next
+// renormalization in viterbi_get_output_sse2().
+void viterbi_decoder::soft_branch_metrics_sse2(const unsigned char* symbols,
+                                               int i,
+                                               __m128i& metsv,
+                                               __m128i& metsvm)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i soft_max = _mm_set1_epi8(SOFT_MAX);
+    const __m128i sym0v = _mm_set1_epi8(symbols[0]);
+    const __m128i sym1v = _mm_set1_epi8(symbols[1]);
+
+    // reward for a table bit 0, and what a table bit 1 earns on top of it
+    const __m128i reward0 = _mm_sub_epi8(soft_max, sym0v);
+    const __m128i reward1 = _mm_sub_epi8(soft_max, sym1v);
+    const __m128i delta0 = _mm_sub_epi8(sym0v, reward0);
+    const __m128i delta1 = _mm_sub_epi8(sym1v, reward1);
+
+    // the table holds 0/1 per state; 0 - bit is an all-ones lane mask
+    const __m128i ones0 = _mm_sub_epi8(zero, d_branchtab27_sse2[0].v[i]);
+    const __m128i ones1 = _mm_sub_epi8(zero, d_branchtab27_sse2[1].v[i]);
+
+    metsv = _mm_add_epi8(_mm_add_epi8(reward0, _mm_and_si128(ones0, delta0)),
+                         _mm_add_epi8(reward1, _mm_and_si128(ones1, delta1)));
+    metsvm = _mm_sub_epi8(_mm_set1_epi8(2 * SOFT_MAX), metsv);
+}
+
 void viterbi_decoder::viterbi_butterfly2_sse2(
     unsigned char* symbols, __m128i* mm0, __m128i* mm1, __m128i* pp0, __m128i* pp1)
 {
@@ -108,7 +139,9 @@ void viterbi_decoder::viterbi_butterfly2_sse2(
     sym1v = _mm_set1_epi8(symbols[1]);
 
     for (i = 0; i < 2; i++) {
-        if (symbols[0] == 2 && symbols[1] == 2) {
+        if (d_soft) {
+            soft_branch_metrics_sse2(symbols, i, metsv, metsvm);
+        } else if (symbols[0] == 2 && symbols[1] == 2) {
             // both coded bits erased -> neutral step: equal metric on every branch
             // so the survivor depends only on the prior path metrics. (Without this
             // the symbols[0]==2 branch would compute 1-(branchtab^2) -> ~255 and
@@ -164,7 +197,9 @@ void viterbi_decoder::viterbi_butterfly2_sse2(
     sym1v = _mm_set1_epi8(symbols[3]);
 
     for (i = 0; i < 2; i++) {
-        if (symbols[2] == 2 && symbols[3] == 2) {
+        if (d_soft) {
+            soft_branch_metrics_sse2(symbols + 2, i, metsv, metsvm);
+        } else if (symbols[2] == 2 && symbols[3] == 2) {
             // both coded bits erased -> neutral step (see block above).
             metsvm = _mm_set1_epi8(1);
             metsv = _mm_set1_epi8(1);
@@ -269,13 +304,26 @@ unsigned char viterbi_decoder::viterbi_get_output_sse2(__m128i* mm0,
 
 
 uint8_t* viterbi_decoder::decode(ofdm_param* ofdm, frame_param* frame, uint8_t* in)
+{
+    d_soft = false;
+    return decode_trellis(ofdm, frame, in);
+}
+
+uint8_t* viterbi_decoder::decode_soft(ofdm_param* ofdm, frame_param* frame, uint8_t* in)
+{
+    d_soft = true;
+    return decode_trellis(ofdm, frame, in);
+}
+
+uint8_t*
+viterbi_decoder::decode_trellis(ofdm_param* ofdm, frame_param* frame, uint8_t* in)
 {
 
     d_ofdm = ofdm;
     d_frame = frame;
 
     reset();
-    uint8_t* depunctured = depuncture(in);
+    uint8_t* depunctured = depuncture(in, d_soft ? SOFT_ERASURE : 2);
 
     int in_count = 0;
     int out_count = 0;
@@ -32,6 +32,7 @@ class viterbi_decoder : public base
 {
 public:
     virtual uint8_t* decode(ofdm_param* ofdm, frame_param* frame, uint8_t* in);
+    virtual uint8_t* decode_soft(ofdm_param* ofdm, frame_param* frame, uint8_t* in);
 
 private:
     union branchtab27 {
@@ -45,8 +46,13 @@ private:
     alignas(16) __m128i d_path1[4];
 
     virtual void reset();
+    uint8_t* decode_trellis(ofdm_param* ofdm, frame_param* frame, uint8_t* in);
 
     void viterbi_chunks_init_sse2();
+    void soft_branch_metrics_sse2(const unsigned char* symbols,
+                                  int i,
+                                  __m128i& metsv,
+                                  __m128i& metsvm);
     void viterbi_butterfly2_sse2(
         unsigned char* symbols, __m128i m0[], __m128i m1[], __m128i p0[], __m128i p1[]);
     unsigned char viterbi_get_output_sse2(__m128i* mm0,
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "worker_pool.h"
+
+namespace gr {
+namespace ieee802_11 {
+
+worker_pool::worker_pool(int nworkers)
+    : d_task(nullptr), d_ntasks(0), d_next(0), d_busy(0), d_batch(0), d_stop(false)
+{
+    for (int worker = 1; worker < nworkers; worker++) {
+        d_threads.emplace_back(
+            new gr::thread::thread([this, worker]() { thread_main(worker); }));
+    }
+}
+
+worker_pool::~worker_pool()
+{
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_stop = true;
+    }
+    d_start.notify_all();
+    for (auto& thread : d_threads) {
+        thread->join();
+    }
+}
+
+void worker_pool::run(int ntasks, const std::function<void(int, int)>& task)
+{
+    if (ntasks <= 0) {
+        return;
+    }
+
+    {
+        gr::thread::scoped_lock lock(d_mutex);
+        d_task = &task;
+        d_ntasks = ntasks;
+        d_next.store(0);
+        d_busy = d_threads.size();
+        d_batch++;
+    }
+    d_start.notify_all();
+
+    drain(0);
+
+    gr::thread::scoped_lock lock(d_mutex);
+    while (d_busy > 0) {
+        d_done.wait(lock);
+    }
+    d_task = nullptr;
+}
+
+void worker_pool::thread_main(int worker)
+{
+    uint64_t batch = 0;
+    for (;;) {
+        {
+            gr::thread::scoped_lock lock(d_mutex);
+            while (!d_stop && d_batch == batch) {
+                d_start.wait(lock);
+            }
+            if (d_stop) {
+                return;
+            }
+            batch = d_batch;
+        }
+
+        drain(worker);
+
+        gr::thread::scoped_lock lock(d_mutex);
+        if (--d_busy == 0) {
+            d_done.notify_one();
+        }
+    }
+}
+
+void worker_pool::drain(int worker)
+{
+    for (int index = d_next.fetch_add(1); index < d_ntasks; index = d_next.fetch_add(1)) {
+        (*d_task)(worker, index);
+    }
+}
+
+} // namespace ieee802_11
+} // namespace gr
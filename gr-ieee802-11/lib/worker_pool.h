@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_IEEE802_11_WORKER_POOL_H
+#define INCLUDED_IEEE802_11_WORKER_POOL_H
+
+#include <gnuradio/thread/thread.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace gr {
+namespace ieee802_11 {
+
+/*
+ * A few threads that a block keeps around to spread one batch of independent
+ * tasks over. run() hands the tasks out one at a time in index order, so low
+ * indices start first, and the calling thread works on the batch too. Each
+ * participant has a fixed worker index in [0, size()), the caller being 0, so
+ * that tasks can use per-worker scratch state without locking.
+ */
+class worker_pool
+{
+public:
+    // nworkers counts the caller: nworkers - 1 threads are started.
+    explicit worker_pool(int nworkers);
+    ~worker_pool();
+
+    int size() const { return d_threads.size() + 1; }
+
+    // Call task(worker, index) for every index in [0, ntasks) and return once
+    // all calls have returned. Not reentrant.
+    void run(int ntasks, const std::function<void(int, int)>& task);
+
+private:
+    void thread_main(int worker);
+    void drain(int worker);
+
+    std::vector<std::unique_ptr<gr::thread::thread>> d_threads;
+    gr::thread::mutex d_mutex;
+    gr::thread::condition_variable d_start;
+    gr::thread::condition_variable d_done;
+    const std::function<void(int, int)>* d_task;
+    int d_ntasks;
+    std::atomic<int> d_next;
+    int d_busy;
+    uint64_t d_batch;
+    bool d_stop;
+};
+
+} // namespace ieee802_11
+} // namespace gr
+
+#endif /* INCLUDED_IEEE802_11_WORKER_POOL_H */
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "zigbee_reference_spectra.h"
+#include <gnuradio/fft/fft.h>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gr {
+namespace ieee802_11 {
+
+namespace {
+// Cache file layout: this header, then windows * NFFT complex floats. Bump the magic
+// whenever the layout or the meaning of the spectra changes.
+struct cache_header {
+    char magic[8];
+    uint64_t reference_hash;
+    uint32_t nfft;
+    uint32_t windows;
+    uint64_t reserved;
+};
+constexpr char CACHE_MAGIC[8] = { 'Z', 'B', 'R', 'E', 'F', 'F', 'T', '1' };
+
+// FNV-1a over the reference samples, as parsed from the CSV.
+uint64_t hash_reference(const std::vector<gr_complex>& reference)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(reference.data());
+    for (size_t i = 0; i < reference.size() * sizeof(gr_complex); i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+} // namespace
+
+zigbee_reference_spectra::zigbee_reference_spectra()
+    : d_spectra(nullptr), d_windows(0), d_map(nullptr), d_map_size(0)
+{
+}
+
+zigbee_reference_spectra::~zigbee_reference_spectra() { clear(); }
+
+void zigbee_reference_spectra::clear()
+{
+    if (d_map) {
+        munmap(d_map, d_map_size);
+        d_map = nullptr;
+        d_map_size = 0;
+    }
+    std::vector<gr_complex>().swap(d_storage);
+    d_spectra = nullptr;
+    d_windows = 0;
+}
+
+bool zigbee_reference_spectra::load(const std::vector<gr_complex>& reference,
+                                    const std::string& cache_path)
+{
+    clear();
+    if ((int)reference.size() < NFFT) {
+        return false;
+    }
+
+    const int windows = reference.size() - NFFT + 1;
+    const uint64_t hash = hash_reference(reference);
+    if (!cache_path.empty() && map_cache(cache_path, hash, windows)) {
+        return true;
+    }
+
+    compute(reference);
+    if (!cache_path.empty()) {
+        write_cache(cache_path, hash);
+    }
+    return true;
+}
+
+bool zigbee_reference_spectra::map_cache(const std::string& path,
+                                         uint64_t hash,
+                                         int windows)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    const size_t size =
+        sizeof(cache_header) + static_cast<size_t>(windows) * NFFT * sizeof(gr_complex);
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == size) {
+        map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    const auto* header = static_cast<const cache_header*>(map);
+    if (std::memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header->reference_hash != hash || header->nfft != NFFT ||
+        header->windows != static_cast<uint32_t>(windows)) {
+        munmap(map, size);
+        return false;
+    }
+
+    d_map = map;
+    d_map_size = size;
+    d_spectra = reinterpret_cast<const gr_complex*>(static_cast<const char*>(map) +
+                                                     sizeof(cache_header));
+    d_windows = windows;
+    return true;
+}
+
+void zigbee_reference_spectra::compute(const std::vector<gr_complex>& reference)
+{
+    const int windows = reference.size() - NFFT + 1;
+    d_storage.resize(static_cast<size_t>(windows) * NFFT);
+
+    // One plan for all windows; a 64-point FFTW transform replaces the direct DFT,
+    // which took NFFT * NFFT complex exponentials per window.
+    gr::fft::fft_complex_fwd fft(NFFT);
+    for (int start = 0; start < windows; start++) {
+        std::memcpy(fft.get_inbuf(), &reference[start], NFFT * sizeof(gr_complex));
+        fft.execute();
+
+        // fftshift: bin k of the table is FFT bin (k + 32) % 64
+        const gr_complex* out = fft.get_outbuf();
+        gr_complex* dst = &d_storage[static_cast<size_t>(start) * NFFT];
+        std::memcpy(dst, out + NFFT / 2, NFFT / 2 * sizeof(gr_complex));
+        std::memcpy(dst + NFFT / 2, out, NFFT / 2 * sizeof(gr_complex));
+    }
+
+    d_spectra = d_storage.data();
+    d_windows = windows;
+}
+
+void zigbee_reference_spectra::write_cache(const std::string& path, uint64_t hash) const
+{
+    cache_header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.reference_hash = hash;
+    header.nfft = NFFT;
+    header.windows = d_windows;
+
+    // Write a temporary file and rename it into place, so that a block starting at
+    // the same time never maps a half-written cache.
+    const std::string tmp_path = path + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(d_spectra),
+                  static_cast<std::streamsize>(d_windows) * NFFT * sizeof(gr_complex));
+        if (!out) {
+            out.close();
+            std::remove(tmp_path.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+    }
+}
+
+} // namespace ieee802_11
+} // namespace gr
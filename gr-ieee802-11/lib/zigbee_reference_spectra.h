@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_IEEE802_11_ZIGBEE_REFERENCE_SPECTRA_H
+#define INCLUDED_IEEE802_11_ZIGBEE_REFERENCE_SPECTRA_H
+
+#include <gnuradio/gr_complex.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace ieee802_11 {
+
+/*
+ * The 64-point spectrum of every 64-sample window of the recorded ZigBee reference,
+ * FFT-shifted like the equalizer's input (DC in bin 32), indexed by the window's
+ * first sample. Whatever LTF offset a ZigBee candidate assumes, each of its symbols
+ * starts at some raw sample, so this one table serves every offset.
+ *
+ * Computing the table takes one FFT per window. It is stored in cache_path, keyed by
+ * a hash of the reference samples, and later starts map that file instead.
+ */
+class zigbee_reference_spectra
+{
+public:
+    static constexpr int NFFT = 64;
+
+    zigbee_reference_spectra();
+    ~zigbee_reference_spectra();
+    zigbee_reference_spectra(const zigbee_reference_spectra&) = delete;
+    zigbee_reference_spectra& operator=(const zigbee_reference_spectra&) = delete;
+
+    // Map the cache if it matches `reference`, else compute the table and try to
+    // write the cache. Returns false if the reference is shorter than one window.
+    bool load(const std::vector<gr_complex>& reference, const std::string& cache_path);
+    void clear();
+
+    bool ready() const { return d_spectra != nullptr; }
+    bool mapped() const { return d_map != nullptr; }
+    int windows() const { return d_windows; }
+
+    // Spectrum of the window starting at sample `start`, or nullptr if that window
+    // does not lie within the reference.
+    const gr_complex* window(int start) const
+    {
+        if (!d_spectra || start < 0 || start >= d_windows) {
+            return nullptr;
+        }
+        return d_spectra + static_cast<size_t>(start) * NFFT;
+    }
+
+private:
+    bool map_cache(const std::string& path, uint64_t hash, int windows);
+    void compute(const std::vector<gr_complex>& reference);
+    void write_cache(const std::string& path, uint64_t hash) const;
+
+    const gr_complex* d_spectra;
+    int d_windows;
+    std::vector<gr_complex> d_storage; // when computed rather than mapped
+    void* d_map;
+    size_t d_map_size;
+};
+
+} // namespace ieee802_11
+} // namespace gr
+
+#endif /* INCLUDED_IEEE802_11_ZIGBEE_REFERENCE_SPECTRA_H */
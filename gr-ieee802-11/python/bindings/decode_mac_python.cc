@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(decode_mac.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(cace2c32f544fb653ce489c979eb4082)                     */
+/* BINDTOOL_HEADER_FILE_HASH(2e2f719f8a3a5e2dd0a554873c549eb6)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -39,6 +39,7 @@ void bind_decode_mac(py::module& m)
         .def(py::init(&decode_mac::make),
            py::arg("log") = false,
            py::arg("debug") = false,
+           py::arg("batch_size") = 1,
            D(decode_mac,make)
         )
         
@@ -0,0 +1,56 @@
+#
+# Copyright 2026 Free Software Foundation, Inc.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+# Readers for the binary captures written by frame_equalizer (ltf_diag.bin,
+# captured_frames.bin). A capture is a fixed header, a JSON metadata block and then
+# fixed-size records; the metadata lists the record fields as numpy types, so the
+# records can be mapped as a structured array without copying.
+
+import json
+import os
+import struct
+
+import numpy as np
+
+CAPTURE_MAGIC = b"WIFICAP1"
+_HEADER = struct.Struct("<8sIIII")
+
+
+def read_capture_header(path):
+    """Return (header_size, record_size, metadata) of a capture file."""
+    with open(path, "rb") as f:
+        magic, header_size, metadata_size, record_size, _ = _HEADER.unpack(
+            f.read(_HEADER.size))
+        if magic != CAPTURE_MAGIC:
+            raise ValueError("%s is not a frame_equalizer capture" % path)
+        metadata = json.loads(f.read(metadata_size).decode("utf-8"))
+    return header_size, record_size, metadata
+
+
+def capture_dtype(metadata):
+    fields = []
+    for field in metadata["global"]["ieee802_11:fields"]:
+        fields.append(tuple(field[:2]) + ((tuple(field[2]),) if len(field) > 2 else ()))
+    return np.dtype(fields)
+
+
+def load_capture(path):
+    """Map the records of a capture as a read-only structured array.
+
+    Returns (records, metadata). A record the writer was still appending when the
+    file was read is left out.
+    """
+    header_size, record_size, metadata = read_capture_header(path)
+    dtype = capture_dtype(metadata)
+    if dtype.itemsize != record_size:
+        raise ValueError("%s: fields describe %d-byte records, header says %d"
+                         % (path, dtype.itemsize, record_size))
+    count = (os.path.getsize(path) - header_size) // record_size
+    if count == 0:
+        return np.zeros(0, dtype=dtype), metadata
+    records = np.memmap(path, dtype=dtype, mode="r", offset=header_size,
+                        shape=(count,))
+    return records, metadata
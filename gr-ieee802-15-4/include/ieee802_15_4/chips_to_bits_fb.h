@@ -30,9 +30,12 @@ namespace gr {
 namespace ieee802_15_4 {
 
 /*!
- * \brief <+description of block+>
+ * \brief Maps blocks of soft chips to the bits (lsb first) of the best-correlated
+ * chip sequence.
  * \ingroup ieee802_15_4
  *
+ * The optional second output carries the max-log LLR of every output bit, positive
+ * for a 1.
  */
 class IEEE802_15_4_API chips_to_bits_fb : virtual public gr::sync_decimator
 {
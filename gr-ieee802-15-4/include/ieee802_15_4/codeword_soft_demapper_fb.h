@@ -30,9 +30,12 @@ namespace gr {
 namespace ieee802_15_4 {
 
 /*!
- * \brief <+description of block+>
+ * \brief Maps received soft codewords to the bits (msb first) of the best-correlated
+ * codeword.
  * \ingroup ieee802_15_4
  *
+ * The optional second output carries the max-log LLR of every output bit, positive
+ * for a 1.
  */
 class IEEE802_15_4_API codeword_soft_demapper_fb : virtual public gr::block
 {
@@ -33,6 +33,11 @@ namespace ieee802_15_4 {
  * \brief <+description of block+>
  * \ingroup ieee802_15_4
  *
+ * Besides the subchirps of the chirp sequence it tracks, the block reports every
+ * chirp of any user on the "chirps" message port, as a dictionary with its input
+ * "offset", the bit mask of the detected "subchirps", the correlation "power" of the
+ * strongest one and, if it follows an earlier chirp by one of the time gaps, that
+ * "time_gap".
  */
 class IEEE802_15_4_API multiuser_chirp_detector_cc : virtual public gr::block
 {
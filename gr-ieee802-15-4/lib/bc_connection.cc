@@ -40,31 +40,28 @@ std::array<uint8_t, 256> bc_connection::make_msgbuf(uint16_t channel,
 
 void bc_connection::pack(pmt::pmt_t msg)
 {
-    std::array<uint8_t, 256> buf = bc_connection::make_msgbuf(d_channel, d_rime_add_mine);
-
     if (pmt::is_eof_object(msg)) {
         d_block->message_port_pub(d_mac_outport, pmt::PMT_EOF);
         d_block->detail().get()->set_done(true);
         return;
     }
 
-    std::string tmp = rime_connection::msg_to_string(msg);
-    size_t data_len = tmp.length();
-    assert(data_len);
-    assert(data_len < 256 - header_length);
+    std::array<uint8_t, 256> buf = bc_connection::make_msgbuf(d_channel, d_rime_add_mine);
 
-    std::memcpy(buf.data() + header_length, tmp.data(), data_len);
-    pmt::pmt_t rime_msg = pmt::make_blob(buf.data(), data_len + header_length);
+    std::string storage;
+    msg_view data = rime_connection::view(msg, storage);
+    assert(data.len);
+    assert(data.len < 256 - header_length);
 
-    d_block->message_port_pub(d_mac_outport, pmt::cons(pmt::PMT_NIL, rime_msg));
+    d_block->message_port_pub(
+        d_mac_outport,
+        d_pool.make_pdu(pmt::PMT_NIL, buf.data(), header_length, data.data, data.len));
 }
 
-void bc_connection::unpack(pmt::pmt_t msg)
+void bc_connection::unpack(msg_view frame)
 {
-    unsigned char buf[256];
-    size_t data_len = pmt::blob_length(msg);
-    std::memcpy(buf, pmt::blob_data(msg), data_len);
-    pmt::pmt_t rime_payload =
-        pmt::make_blob(buf + header_length, data_len - header_length);
-    d_block->message_port_pub(d_outport, pmt::cons(pmt::PMT_NIL, rime_payload));
+    d_block->message_port_pub(
+        d_outport,
+        d_pool.make_pdu(
+            pmt::PMT_NIL, frame.data + header_length, frame.len - header_length));
 }
@@ -35,7 +35,7 @@ public:
                   pmt::pmt_t outport,
                   const uint8_t rime_add_mine[2]);
     void pack(pmt::pmt_t msg);
-    void unpack(pmt::pmt_t msg);
+    void unpack(msg_view frame);
 };
 } // namespace ieee802_15_4
 } // namespace gr
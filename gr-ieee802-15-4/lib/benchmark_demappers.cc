@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Input Msamples/s of the CSS demappers, each run alone in a flowgraph between a
+ * repeating vector source and a null sink. The DQCSK demapper uses the subchirp
+ * length and time gaps of chirp sequence 1 at 32 MHz (css_phy.py) with a random
+ * unit-magnitude chirp sequence, which costs the same as the real one.
+ */
+
+#include <ieee802_15_4/dqcsk_demapper_cc.h>
+#include <ieee802_15_4/dqpsk_soft_demapper_cc.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/top_block.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace gr;
+
+namespace {
+
+constexpr uint64_t nsamples = 64 << 20;
+constexpr int nrepeat = 3;
+constexpr int framelen = 1024; // DQPSK symbols per frame
+
+constexpr int len_subchirp = 38;
+constexpr int num_subchirps = 4;
+constexpr int time_gap_1 = 10;
+constexpr int time_gap_2 = 70;
+
+std::vector<gr_complex> random_samples(std::mt19937& rng, size_t n, bool unit)
+{
+    std::normal_distribution<float> noise;
+    std::vector<gr_complex> samples(n);
+    for (auto& s : samples) {
+        s = gr_complex(noise(rng), noise(rng));
+        if (unit) {
+            s /= std::abs(s);
+        }
+    }
+    return samples;
+}
+
+// Best of nrepeat runs, in Msamples/s
+double run(const std::vector<gr_complex>& input, basic_block_sptr block)
+{
+    double best = 0;
+    for (int r = 0; r < nrepeat; r++) {
+        auto tb = make_top_block("benchmark_demappers");
+        auto src = blocks::vector_source_c::make(input, true);
+        auto head = blocks::head::make(sizeof(gr_complex), nsamples);
+        auto sink = blocks::null_sink::make(sizeof(gr_complex));
+        tb->connect(src, 0, head, 0);
+        tb->connect(head, 0, block, 0);
+        tb->connect(block, 0, sink, 0);
+
+        auto start = std::chrono::steady_clock::now();
+        tb->run();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::max(best, nsamples / elapsed.count() / 1e6);
+    }
+    return best;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(42);
+    const std::vector<gr_complex> input = random_samples(rng, 1 << 16, false);
+    const std::vector<gr_complex> chirp_seq =
+        random_samples(rng, len_subchirp * num_subchirps, true);
+
+    printf("%-24s %10s\n", "block", "Msamples/s");
+    printf("%-24s %10.1f\n",
+           "dqpsk_soft_demapper_cc",
+           run(input, ieee802_15_4::dqpsk_soft_demapper_cc::make(framelen)));
+    printf("%-24s %10.1f\n",
+           "dqcsk_demapper_cc",
+           run(input,
+               ieee802_15_4::dqcsk_demapper_cc::make(
+                   chirp_seq,
+                   std::vector<gr_complex>(time_gap_1),
+                   std::vector<gr_complex>(time_gap_2),
+                   len_subchirp,
+                   num_subchirps)));
+    return 0;
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Throughput of the O-QPSK receiver of ieee802_15_4_OQPSK_PHY.grc: quadrature demod,
+ * DC removal, M&M clock recovery, packet_sink and mac, at 4 Msamples/s.
+ *
+ * The frames are modulated like zigbee_tx_chain_generator.py does, as MAC data
+ * frames with the default addresses of the mac block, a "%06d HELLO WORLD" payload
+ * and a valid FCS. With --template the frame is instead read from a .npy file such
+ * as zigbee_tx_final.npy; frames without an FCS then count as CRC errors. The frames
+ * are separated by a gap, complex Gaussian noise at the given SNR (over the frame
+ * samples) is added everywhere, and the result is written to an IQ file before the
+ * flowgraph reads it back, so only the receiver is timed.
+ *
+ * --channels runs that many receivers on the file at once, to see how many
+ * channels a machine keeps up with. The work time of each block comes from the
+ * performance counters of the runtime, which this program turns on. The mac block
+ * decodes in its message handler, which the counters do not time.
+ *
+ *   benchmark_oqpsk_rx [--frames N] [--snr DB] [--gap SAMPLES] [--channels N]
+ *                      [--template FRAME.npy] [--iq FILE]
+ */
+
+#include <ieee802_15_4/mac.h>
+#include <ieee802_15_4/packet_sink.h>
+#include <gnuradio/analog/quadrature_demod_cf.h>
+#include <gnuradio/blocks/file_source.h>
+#include <gnuradio/blocks/sub.h>
+#include <gnuradio/digital/clock_recovery_mm_ff.h>
+#include <gnuradio/filter/single_pole_iir_filter_ff.h>
+#include <gnuradio/high_res_timer.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/top_block.h>
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace gr;
+
+namespace {
+
+constexpr double samp_rate = 4e6;
+
+// Chip sequences of the 16 symbols, chip k in bit k. The even chips go to I, the odd
+// ones to Q; this is the symbol table of ieee802_15_4_OQPSK_PHY.grc.
+constexpr uint32_t CHIP_SEQUENCES[16] = {
+    0x744AC39B, 0xDEE06931, 0xC39B744A, 0x6931DEE0, 0x4AC39B74, 0xE06931DE,
+    0x9B744AC3, 0x31DEE069, 0x44AC39B7, 0xEE06931D, 0x39B744AC, 0x931DEE06,
+    0xAC39B744, 0x06931DEE, 0xB744AC39, 0x1DEE0693
+};
+
+struct options {
+    int frames = 1000;
+    double snr_db = 20;
+    int gap = 2000;
+    int channels = 1;
+    std::string frame_template;
+    std::string iq_file = "benchmark_oqpsk_rx.cfile";
+};
+
+void usage(const char* name)
+{
+    fprintf(stderr,
+            "usage: %s [--frames N] [--snr DB] [--gap SAMPLES] [--channels N]\n"
+            "          [--template FRAME.npy] [--iq FILE]\n",
+            name);
+    exit(1);
+}
+
+options parse_options(int argc, char** argv)
+{
+    options opt;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 == argc) {
+            usage(argv[0]);
+        }
+        const std::string arg = argv[i];
+        const char* value = argv[i + 1];
+        if (arg == "--frames") {
+            opt.frames = std::atoi(value);
+        } else if (arg == "--snr") {
+            opt.snr_db = std::atof(value);
+        } else if (arg == "--gap") {
+            opt.gap = std::atoi(value);
+        } else if (arg == "--channels") {
+            opt.channels = std::atoi(value);
+        } else if (arg == "--template") {
+            opt.frame_template = value;
+        } else if (arg == "--iq") {
+            opt.iq_file = value;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (opt.frames < 1 || opt.gap < 0 || opt.channels < 1) {
+        usage(argv[0]);
+    }
+    return opt;
+}
+
+// The FCS of the mac block
+uint16_t crc16(const uint8_t* buf, int len)
+{
+    uint16_t crc = 0;
+    for (int i = 0; i < len; i++) {
+        for (int k = 0; k < 8; k++) {
+            int input_bit = (!!(buf[i] & (1 << k)) ^ (crc & 1));
+            crc = crc >> 1;
+            if (input_bit) {
+                crc ^= (1 << 15);
+                crc ^= (1 << 10);
+                crc ^= (1 << 3);
+            }
+        }
+    }
+    return crc;
+}
+
+// What the access_code_prefixer hands to the modulator: pad byte, preamble, SFD,
+// length, then the MAC frame.
+std::vector<uint8_t> make_frame(int seq)
+{
+    char payload[32];
+    snprintf(payload, sizeof(payload), "%06d HELLO WORLD", seq % 1000000);
+
+    std::vector<uint8_t> psdu = { 0x41, 0x88, uint8_t(seq), 0xaa, 0x1a,
+                                  0xff, 0xff, 0x44,         0x33 };
+    psdu.insert(psdu.end(), payload, payload + strlen(payload));
+    const uint16_t fcs = crc16(psdu.data(), psdu.size());
+    psdu.push_back(fcs & 0xff);
+    psdu.push_back(fcs >> 8);
+
+    std::vector<uint8_t> frame = { 0x00, 0x00, 0x00, 0x00, 0xa7, uint8_t(psdu.size()) };
+    frame.insert(frame.end(), psdu.begin(), psdu.end());
+    return frame;
+}
+
+// Low nibble first, 16 chip pairs per nibble, 4 samples per chip pair shaped with a
+// half sine, 8 samples of tail and Q delayed by 2 samples.
+std::vector<gr_complex> modulate(const std::vector<uint8_t>& frame)
+{
+    const float pulse[4] = { 0, float(std::sin(M_PI / 4)), 1, float(std::sin(3 * M_PI / 4)) };
+    std::vector<float> i_branch, q_branch;
+    for (uint8_t byte : frame) {
+        for (int nibble : { byte & 0x0f, byte >> 4 }) {
+            const uint32_t chips = CHIP_SEQUENCES[nibble];
+            for (int k = 0; k < 16; k++) {
+                const float i_chip = (chips >> (2 * k)) & 1 ? 1 : -1;
+                const float q_chip = (chips >> (2 * k + 1)) & 1 ? 1 : -1;
+                for (int s = 0; s < 4; s++) {
+                    i_branch.push_back(i_chip * pulse[s]);
+                    q_branch.push_back(q_chip * pulse[s]);
+                }
+            }
+        }
+    }
+    i_branch.resize(i_branch.size() + 8, 0);
+    q_branch.insert(q_branch.begin(), 2, 0);
+
+    std::vector<gr_complex> samples(i_branch.size());
+    for (size_t n = 0; n < samples.size(); n++) {
+        samples[n] = gr_complex(i_branch[n], q_branch[n]);
+    }
+    return samples;
+}
+
+// A 1-d complex array in .npy format, as numpy.save writes it.
+std::vector<gr_complex> load_npy(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[8];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, "\x93NUMPY", 6) != 0) {
+        throw std::runtime_error(path + " is not a .npy file");
+    }
+    uint32_t header_len = 0;
+    file.read(reinterpret_cast<char*>(&header_len), magic[6] == 1 ? 2 : 4);
+    std::string header(header_len, ' ');
+    file.read(&header[0], header_len);
+
+    const bool is_c16 = header.find("'<c16'") != std::string::npos;
+    if (!is_c16 && header.find("'<c8'") == std::string::npos) {
+        throw std::runtime_error(path + ": expected a complex64 or complex128 array");
+    }
+    if (header.find("'fortran_order': False") == std::string::npos) {
+        throw std::runtime_error(path + ": expected a C-ordered array");
+    }
+
+    std::vector<gr_complex> samples;
+    if (is_c16) {
+        std::complex<double> s;
+        while (file.read(reinterpret_cast<char*>(&s), sizeof(s))) {
+            samples.push_back(gr_complex(s));
+        }
+    } else {
+        gr_complex s;
+        while (file.read(reinterpret_cast<char*>(&s), sizeof(s))) {
+            samples.push_back(s);
+        }
+    }
+    return samples;
+}
+
+// Writes the frames with their gaps and the noise, returns the number of samples.
+uint64_t write_iq(const options& opt)
+{
+    std::vector<gr_complex> frame_template;
+    if (!opt.frame_template.empty()) {
+        frame_template = load_npy(opt.frame_template);
+    }
+
+    FILE* file = fopen(opt.iq_file.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("cannot open " + opt.iq_file);
+    }
+
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise;
+    std::vector<gr_complex> samples;
+    uint64_t nsamples = 0;
+    for (int f = 0; f < opt.frames; f++) {
+        samples = frame_template.empty() ? modulate(make_frame(f)) : frame_template;
+        double power = 0;
+        for (const auto& s : samples) {
+            power += std::norm(s);
+        }
+        power /= samples.size();
+        const float sigma = std::sqrt(power / std::pow(10, opt.snr_db / 10) / 2);
+
+        samples.resize(samples.size() + opt.gap, 0);
+        for (auto& s : samples) {
+            s += sigma * gr_complex(noise(rng), noise(rng));
+        }
+        fwrite(samples.data(), sizeof(gr_complex), samples.size(), file);
+        nsamples += samples.size();
+    }
+    fclose(file);
+    return nsamples;
+}
+
+struct receiver {
+    std::vector<block_sptr> blocks; // in flowgraph order
+    ieee802_15_4::mac::sptr mac;
+};
+
+receiver connect_receiver(top_block_sptr tb, const std::string& iq_file)
+{
+    auto src = blocks::file_source::make(sizeof(gr_complex), iq_file.c_str());
+    auto demod = analog::quadrature_demod_cf::make(1);
+    auto dc = filter::single_pole_iir_filter_ff::make(0.00016);
+    auto sub = blocks::sub_ff::make();
+    auto clock = digital::clock_recovery_mm_ff::make(2, 0.000225, 0.5, 0.03, 0.0002);
+    auto sink = ieee802_15_4::packet_sink::make(10);
+    auto mac = ieee802_15_4::mac::make();
+
+    tb->connect(src, 0, demod, 0);
+    tb->connect(demod, 0, sub, 0);
+    tb->connect(demod, 0, dc, 0);
+    tb->connect(dc, 0, sub, 1);
+    tb->connect(sub, 0, clock, 0);
+    tb->connect(clock, 0, sink, 0);
+    tb->msg_connect(sink, "out", mac, "pdu in");
+
+    return { { src, demod, dc, sub, clock, sink, mac }, mac };
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const options opt = parse_options(argc, argv);
+
+    const uint64_t nsamples = write_iq(opt);
+    printf("%d frames, %.1f dB SNR, %llu samples (%.3f s of air time) in %s\n",
+           opt.frames,
+           opt.snr_db,
+           (unsigned long long)nsamples,
+           nsamples / samp_rate,
+           opt.iq_file.c_str());
+
+    // read when the flowgraph starts
+    prefs::singleton()->set_bool("PerfCounters", "on", true);
+
+    auto tb = make_top_block("benchmark_oqpsk_rx");
+    std::vector<receiver> receivers;
+    for (int c = 0; c < opt.channels; c++) {
+        receivers.push_back(connect_receiver(tb, opt.iq_file));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    tb->run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    int received = 0, errors = 0;
+    for (const auto& r : receivers) {
+        received += r.mac->get_num_packets_received();
+        errors += r.mac->get_num_packet_errors();
+    }
+    const int sent = opt.frames * opt.channels;
+    const int decoded = received - errors;
+
+    printf("%d channels in %.3f s, %.2fx real time\n",
+           opt.channels,
+           elapsed.count(),
+           nsamples / samp_rate / elapsed.count());
+    printf("%-24s %10.2f Msamples/s\n",
+           "throughput",
+           nsamples * opt.channels / elapsed.count() / 1e6);
+    printf("%-24s %10.1f frames/s\n", "decoded", decoded / elapsed.count());
+    printf("%-24s %10.2f %% (%d of %d, %d CRC errors)\n",
+           "decode rate",
+           100.0 * decoded / sent,
+           decoded,
+           sent,
+           errors);
+
+    // work time per block, summed over the channels
+    const double tps = high_res_timer_tps();
+    std::vector<double> work(receivers[0].blocks.size(), 0);
+    double total = 0;
+    for (const auto& r : receivers) {
+        for (size_t b = 0; b < r.blocks.size(); b++) {
+            work[b] += r.blocks[b]->pc_work_time_total() / tps;
+            total += r.blocks[b]->pc_work_time_total() / tps;
+        }
+    }
+    printf("\n%-24s %10s %8s %12s\n", "block", "work [s]", "share", "ns/sample");
+    for (size_t b = 0; b < work.size(); b++) {
+        printf("%-24s %10.3f %7.1f%% %12.2f\n",
+               receivers[0].blocks[b]->name().c_str(),
+               work[b],
+               total > 0 ? 100 * work[b] / total : 0,
+               1e9 * work[b] / (nsamples * opt.channels));
+    }
+    if (total == 0) {
+        printf("(no work times: the runtime was built without performance counters)\n");
+    }
+    return 0;
+}
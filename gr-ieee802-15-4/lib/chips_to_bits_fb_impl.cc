@@ -25,11 +25,28 @@
 
 #include "chips_to_bits_fb_impl.h"
 #include <gnuradio/io_signature.h>
-#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
 
 namespace gr {
 namespace ieee802_15_4 {
 
+namespace {
+// Chip blocks correlated per batch.
+constexpr int BATCH = 64;
+
+// The chip sequences as nrz.
+std::vector<std::vector<float>> nrz(std::vector<std::vector<float>> chip_seq)
+{
+    for (auto& seq : chip_seq) {
+        for (float& chip : seq) {
+            chip = 2 * chip - 1;
+        }
+    }
+    return chip_seq;
+}
+} // namespace
+
 chips_to_bits_fb::sptr chips_to_bits_fb::make(std::vector<std::vector<float>> chip_seq)
 {
     return gnuradio::get_initial_sptr(new chips_to_bits_fb_impl(chip_seq));
@@ -42,21 +59,16 @@ chips_to_bits_fb_impl::chips_to_bits_fb_impl(std::vector<std::vector<float>> chi
     : gr::sync_decimator(
           "chips_to_bits_fb",
           gr::io_signature::make(1, 1, sizeof(float)),
-          gr::io_signature::make(1, 1, sizeof(unsigned char)),
+          gr::io_signature::makev(1, 2, { sizeof(unsigned char), sizeof(float) }),
           (unsigned)(((float)chip_seq[0].size()) / std::log2((float)chip_seq.size()))),
-      d_chip_seq(chip_seq),
+      d_chip_seq(nrz(chip_seq)),
       d_bits_per_seq(std::log2(chip_seq.size())),
       d_len_chip_seq(chip_seq[0].size()),
-      d_num_chip_seq(chip_seq.size())
+      d_num_chip_seq(chip_seq.size()),
+      d_correlator(d_chip_seq),
+      d_corr(BATCH * d_num_chip_seq)
 {
     set_output_multiple(d_bits_per_seq);
-
-    // encode the chip sequence as nrz
-    for (int i = 0; i < d_num_chip_seq; i++) {
-        for (int k = 0; k < d_len_chip_seq; k++) {
-            d_chip_seq[i][k] = 2 * d_chip_seq[i][k] - 1;
-        }
-    }
 }
 
 /*
@@ -64,48 +76,34 @@ chips_to_bits_fb_impl::chips_to_bits_fb_impl(std::vector<std::vector<float>> chi
  */
 chips_to_bits_fb_impl::~chips_to_bits_fb_impl() {}
 
-std::vector<unsigned char> chips_to_bits_fb_impl::dec2bin_lsb(int dec, int nbit)
-{
-    std::vector<unsigned char> bin(nbit, 0);
-    for (int i = 0; i < nbit; i++)
-        bin[i] = (dec >> i) & 0x01;
-    return bin;
-}
-
 int chips_to_bits_fb_impl::work(int noutput_items,
                                 gr_vector_const_void_star& input_items,
                                 gr_vector_void_star& output_items)
 {
     const float* in = (const float*)input_items[0];
     unsigned char* out = (unsigned char*)output_items[0];
+    // optional max-log LLR of every output bit
+    float* llr = output_items.size() > 1 ? (float*)output_items[1] : nullptr;
 
     int nblocks = noutput_items / d_bits_per_seq;
 
-    std::vector<float> dist(d_num_chip_seq, 0.0);
-    int idx;
-    std::vector<unsigned char> idx_bin(d_bits_per_seq, 0);
-    for (int n = 0; n < nblocks; n++) {
-        // std::cout << "in: ";
-        // for(int i=0; i<d_len_chip_seq; i++)
-        //   std::cout << in[n*d_len_chip_seq+i] << " ";
-        // std::cout << std::endl;
+    for (int n0 = 0; n0 < nblocks; n0 += BATCH) {
+        const int batch = std::min(BATCH, nblocks - n0);
+        d_correlator.correlate(in + n0 * d_len_chip_seq, batch, d_corr.data());
 
-        memset(&dist[0], 0, sizeof(float) * dist.size());
-        for (int i = 0; i < d_num_chip_seq; i++) {
-            volk_32f_x2_dot_prod_32f(
-                &dist[i], &d_chip_seq[i][0], in + n * d_len_chip_seq, d_len_chip_seq);
-            // std::cout << "dist[" << i << "]=" << dist[i] << std::endl;
+        for (int n = 0; n < batch; n++) {
+            const float* corr = &d_corr[n * d_num_chip_seq];
+            const int idx = d_correlator.best(corr);
+            // bits lsb first
+            unsigned char* bits = out + (n0 + n) * d_bits_per_seq;
+            for (int i = 0; i < d_bits_per_seq; i++) {
+                bits[i] = (idx >> i) & 0x01;
+            }
+            if (llr) {
+                d_correlator.bit_llrs(
+                    corr, d_bits_per_seq, false, llr + (n0 + n) * d_bits_per_seq);
+            }
         }
-
-        idx = std::distance(dist.begin(), std::max_element(dist.begin(), dist.end()));
-        idx_bin = dec2bin_lsb(idx, d_bits_per_seq);
-        // std::cout << "max_i: " << idx << ", bit arr: ";
-        // for(int i=0;i<d_bits_per_seq;i++)
-        //   std::cout << int(idx_bin[i]) << " ";
-        // std::cout << std::endl;
-        memcpy(out + n * d_bits_per_seq,
-               &idx_bin[0],
-               sizeof(unsigned char) * d_bits_per_seq);
     }
 
     return nblocks * d_bits_per_seq;
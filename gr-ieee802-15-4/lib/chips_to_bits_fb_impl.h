@@ -22,6 +22,7 @@
 #ifndef INCLUDED_IEEE802_15_4_CHIPS_TO_BITS_FB_IMPL_H
 #define INCLUDED_IEEE802_15_4_CHIPS_TO_BITS_FB_IMPL_H
 
+#include "codeword_correlator.h"
 #include <ieee802_15_4/chips_to_bits_fb.h>
 
 namespace gr {
@@ -34,7 +35,8 @@ private:
     int d_bits_per_seq;
     int d_len_chip_seq;
     int d_num_chip_seq;
-    std::vector<unsigned char> dec2bin_lsb(int dec, int nbit);
+    codeword_correlator d_correlator;
+    std::vector<float> d_corr; // correlations of one batch of blocks
 
 public:
     chips_to_bits_fb_impl(std::vector<std::vector<float>> chip_seq);
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "codeword_correlator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace gr {
+namespace ieee802_15_4 {
+
+namespace {
+// Blocks correlated together in the matrix product, sharing each codeword chip load.
+constexpr int GEMM_BLOCKS = 4;
+
+bool hadamard_positive(int row, int chip)
+{
+    int parity = row & chip;
+    parity ^= parity >> 16;
+    parity ^= parity >> 8;
+    parity ^= parity >> 4;
+    parity ^= parity >> 2;
+    parity ^= parity >> 1;
+    return !(parity & 1);
+}
+} // namespace
+
+codeword_correlator::codeword_correlator(const std::vector<std::vector<float>>& codewords)
+    : d_size(codewords.size()), d_length(codewords.empty() ? 0 : codewords[0].size())
+{
+    // Try the Walsh form: chip 0 gives the gain, chips 2^k the bits of the row.
+    const bool pow2 = d_length > 0 && (d_length & (d_length - 1)) == 0;
+    for (int m = 0; pow2 && m < d_size; m++) {
+        const std::vector<float>& cw = codewords[m];
+        const float gain = cw[0];
+        int row = 0;
+        for (int bit = 1; bit < d_length; bit <<= 1) {
+            if (cw[bit] != gain) {
+                row |= bit;
+            }
+        }
+        bool match = gain != 0 && (int)cw.size() == d_length;
+        for (int c = 0; match && c < d_length; c++) {
+            match = cw[c] == (hadamard_positive(row, c) ? gain : -gain);
+        }
+        if (!match) {
+            d_walsh_row.clear();
+            d_walsh_gain.clear();
+            break;
+        }
+        d_walsh_row.push_back(row);
+        d_walsh_gain.push_back(gain);
+    }
+
+    if (walsh()) {
+        d_transform.resize(d_length);
+        return;
+    }
+
+    d_codewords_t.resize(d_length * d_size);
+    for (int m = 0; m < d_size; m++) {
+        for (int c = 0; c < d_length; c++) {
+            d_codewords_t[c * d_size + m] = codewords[m][c];
+        }
+    }
+}
+
+void codeword_correlator::correlate(const float* in, int nblocks, float* corr)
+{
+    if (walsh()) {
+        correlate_walsh(in, nblocks, corr);
+    } else {
+        correlate_gemm(in, nblocks, corr);
+    }
+}
+
+void codeword_correlator::correlate_walsh(const float* in, int nblocks, float* corr)
+{
+    float* x = d_transform.data();
+    for (int n = 0; n < nblocks; n++) {
+        std::copy(in + n * d_length, in + (n + 1) * d_length, x);
+        for (int half = 1; half < d_length; half <<= 1) {
+            for (int i = 0; i < d_length; i += 2 * half) {
+                for (int j = i; j < i + half; j++) {
+                    const float a = x[j];
+                    const float b = x[j + half];
+                    x[j] = a + b;
+                    x[j + half] = a - b;
+                }
+            }
+        }
+
+        float* out = corr + n * d_size;
+        for (int m = 0; m < d_size; m++) {
+            out[m] = d_walsh_gain[m] * x[d_walsh_row[m]];
+        }
+    }
+}
+
+void codeword_correlator::correlate_gemm(const float* in, int nblocks, float* corr) const
+{
+    std::fill(corr, corr + nblocks * d_size, 0.0f);
+
+    // corr (blocks x codewords) += in (blocks x chips) * codewords_t (chips x
+    // codewords), GEMM_BLOCKS rows of corr at a time; the inner loop runs along a
+    // row of codewords_t and vectorizes.
+    int n = 0;
+    for (; n + GEMM_BLOCKS <= nblocks; n += GEMM_BLOCKS) {
+        const float* x0 = in + n * d_length;
+        const float* x1 = x0 + d_length;
+        const float* x2 = x1 + d_length;
+        const float* x3 = x2 + d_length;
+        float* c0 = corr + n * d_size;
+        float* c1 = c0 + d_size;
+        float* c2 = c1 + d_size;
+        float* c3 = c2 + d_size;
+        for (int c = 0; c < d_length; c++) {
+            const float* cw = &d_codewords_t[c * d_size];
+            const float a0 = x0[c], a1 = x1[c], a2 = x2[c], a3 = x3[c];
+            for (int m = 0; m < d_size; m++) {
+                c0[m] += a0 * cw[m];
+                c1[m] += a1 * cw[m];
+                c2[m] += a2 * cw[m];
+                c3[m] += a3 * cw[m];
+            }
+        }
+    }
+    for (; n < nblocks; n++) {
+        const float* x = in + n * d_length;
+        float* out = corr + n * d_size;
+        for (int c = 0; c < d_length; c++) {
+            const float* cw = &d_codewords_t[c * d_size];
+            for (int m = 0; m < d_size; m++) {
+                out[m] += x[c] * cw[m];
+            }
+        }
+    }
+}
+
+int codeword_correlator::best(const float* corr) const
+{
+    return std::distance(corr, std::max_element(corr, corr + d_size));
+}
+
+void codeword_correlator::bit_llrs(const float* corr,
+                                   int nbits,
+                                   bool msb_first,
+                                   float* llr) const
+{
+    // A bit value no codeword takes, as in codebooks whose size is not a power of
+    // two, makes the other value certain. Its LLR is clamped to the largest any
+    // decision on this block can reach, twice the largest correlation magnitude.
+    float certain = 0.0f;
+    for (int m = 0; m < d_size; m++) {
+        certain = std::max(certain, 2.0f * std::abs(corr[m]));
+    }
+
+    const float none = -std::numeric_limits<float>::infinity();
+    for (int j = 0; j < nbits; j++) {
+        const int shift = msb_first ? nbits - 1 - j : j;
+        float best0 = none;
+        float best1 = none;
+        for (int m = 0; m < d_size; m++) {
+            if ((m >> shift) & 1) {
+                best1 = std::max(best1, corr[m]);
+            } else {
+                best0 = std::max(best0, corr[m]);
+            }
+        }
+        if (best1 == none) {
+            llr[j] = -certain;
+        } else if (best0 == none) {
+            llr[j] = certain;
+        } else {
+            llr[j] = best1 - best0;
+        }
+    }
+}
+
+} // namespace ieee802_15_4
+} // namespace gr
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_IEEE802_15_4_CODEWORD_CORRELATOR_H
+#define INCLUDED_IEEE802_15_4_CODEWORD_CORRELATOR_H
+
+#include <vector>
+
+namespace gr {
+namespace ieee802_15_4 {
+
+/*
+ * Correlates blocks of soft chips with every codeword of an antipodal code, many
+ * blocks per call. If each codeword is a scaled row of the Sylvester-Hadamard
+ * matrix, as in the CSS PHY's (bi)orthogonal codes, a fast Walsh-Hadamard transform
+ * of each block yields all correlations at once; any other code goes through a
+ * small blocks x codewords matrix product.
+ */
+class codeword_correlator
+{
+public:
+    // codewords: one antipodal chip sequence per codeword, all of the same length
+    explicit codeword_correlator(const std::vector<std::vector<float>>& codewords);
+
+    int size() const { return d_size; }
+    int length() const { return d_length; }
+    bool walsh() const { return !d_walsh_row.empty(); }
+
+    // corr[n * size() + m] = correlation of in[n * length() ...] with codeword m, for
+    // n < nblocks. Does not allocate.
+    void correlate(const float* in, int nblocks, float* corr);
+
+    // Index of the first best-correlated codeword.
+    int best(const float* corr) const;
+
+    // Max-log LLRs of the nbits bits of the codeword index, positive for a 1: the
+    // best correlation among the codewords whose bit is 1 minus the best among
+    // those whose bit is 0. Bit j is index bit j, or index bit nbits - 1 - j if
+    // msb_first. A bit no codeword sets, or none clears, gets a finite LLR.
+    void bit_llrs(const float* corr, int nbits, bool msb_first, float* llr) const;
+
+private:
+    void correlate_walsh(const float* in, int nblocks, float* corr);
+    void correlate_gemm(const float* in, int nblocks, float* corr) const;
+
+    int d_size;
+    int d_length;
+    // Walsh codes: codeword m is d_walsh_gain[m] times Hadamard row d_walsh_row[m]
+    std::vector<int> d_walsh_row;
+    std::vector<float> d_walsh_gain;
+    std::vector<float> d_transform; // one block, transformed in place
+    // other codes: the codewords, chip-major (d_length x d_size)
+    std::vector<float> d_codewords_t;
+};
+
+} // namespace ieee802_15_4
+} // namespace gr
+
+#endif /* INCLUDED_IEEE802_15_4_CODEWORD_CORRELATOR_H */
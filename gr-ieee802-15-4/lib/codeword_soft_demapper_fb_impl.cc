@@ -25,11 +25,16 @@
 
 #include "codeword_soft_demapper_fb_impl.h"
 #include <gnuradio/io_signature.h>
-#include <volk/volk.h>
+#include <algorithm>
 
 namespace gr {
 namespace ieee802_15_4 {
 
+namespace {
+// Received words correlated per batch.
+constexpr int BATCH = 64;
+} // namespace
+
 codeword_soft_demapper_fb::sptr
 codeword_soft_demapper_fb::make(int bits_per_cw,
                                 std::vector<std::vector<float>> codewords)
@@ -45,9 +50,11 @@ codeword_soft_demapper_fb_impl::codeword_soft_demapper_fb_impl(
     int bits_per_cw, std::vector<std::vector<float>> codewords)
     : gr::block("codeword_soft_demapper_fb",
                 gr::io_signature::make(1, 1, sizeof(float)),
-                gr::io_signature::make(1, 1, sizeof(unsigned char))),
+                gr::io_signature::makev(1, 2, { sizeof(unsigned char), sizeof(float) })),
       d_bits_per_cw(bits_per_cw),
-      d_codewords(codewords)
+      d_codewords(codewords),
+      d_correlator(codewords),
+      d_weights(BATCH * codewords.size())
 {
     // describes the I/O ratio (<=1)
     d_len_cw = d_codewords[0].size();
@@ -67,24 +74,6 @@ void codeword_soft_demapper_fb_impl::forecast(int noutput_items,
     ninput_items_required[0] = d_len_cw;
 }
 
-std::vector<float> codeword_soft_demapper_fb_impl::calc_weights(const float* in)
-{
-    std::vector<float> w(d_codewords.size(), 0);
-    for (int i = 0; i < d_codewords.size(); i++) {
-        volk_32f_x2_dot_prod_32f(&w[i], in, &d_codewords[i][0], d_len_cw);
-    }
-    return w;
-}
-
-
-std::vector<unsigned char> codeword_soft_demapper_fb_impl::dec2bin(int dec, int nbit)
-{
-    std::vector<unsigned char> bin(nbit, 0);
-    for (int i = 0; i < nbit; i++)
-        bin[nbit - i - 1] = (dec >> i) & 0x01;
-    return bin;
-}
-
 int codeword_soft_demapper_fb_impl::general_work(int noutput_items,
                                                  gr_vector_int& ninput_items,
                                                  gr_vector_const_void_star& input_items,
@@ -92,20 +81,30 @@ int codeword_soft_demapper_fb_impl::general_work(int noutput_items,
 {
     const float* in = (const float*)input_items[0];
     unsigned char* out = (unsigned char*)output_items[0];
+    // optional max-log LLR of every output bit
+    float* llr = output_items.size() > 1 ? (float*)output_items[1] : nullptr;
 
     int nwords = std::min(ninput_items[0] / d_len_cw, noutput_items / d_bits_per_cw);
+    const int ncw = d_codewords.size();
 
     // this implements the search for the minimum hamming distance
-    std::vector<float> w;               // weights
-    int idx;                            // index of maximum weight
-    std::vector<unsigned char> idx_bin; // binary representation of idx
-    for (int i = 0; i < nwords; i++) {
-        w = calc_weights(in + i * d_len_cw);
-        idx = std::distance(w.begin(), std::max_element(w.begin(), w.end()));
-        // std::cout << "sym: " << idx << std::endl;
-        idx_bin = dec2bin(idx, d_bits_per_cw);
-        memcpy(
-            out + i * d_bits_per_cw, &idx_bin[0], sizeof(unsigned char) * d_bits_per_cw);
+    for (int i0 = 0; i0 < nwords; i0 += BATCH) {
+        const int batch = std::min(BATCH, nwords - i0);
+        d_correlator.correlate(in + i0 * d_len_cw, batch, d_weights.data());
+
+        for (int i = 0; i < batch; i++) {
+            const float* w = &d_weights[i * ncw];
+            const int idx = d_correlator.best(w); // index of maximum weight
+            // bits msb first
+            unsigned char* bits = out + (i0 + i) * d_bits_per_cw;
+            for (int k = 0; k < d_bits_per_cw; k++) {
+                bits[d_bits_per_cw - k - 1] = (idx >> k) & 0x01;
+            }
+            if (llr) {
+                d_correlator.bit_llrs(
+                    w, d_bits_per_cw, true, llr + (i0 + i) * d_bits_per_cw);
+            }
+        }
     }
 
     consume_each(nwords * d_len_cw);
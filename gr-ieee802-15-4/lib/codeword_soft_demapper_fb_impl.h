@@ -22,6 +22,7 @@
 #ifndef INCLUDED_IEEE802_15_4_CODEWORD_SOFT_DEMAPPER_FB_IMPL_H
 #define INCLUDED_IEEE802_15_4_CODEWORD_SOFT_DEMAPPER_FB_IMPL_H
 
+#include "codeword_correlator.h"
 #include <ieee802_15_4/codeword_soft_demapper_fb.h>
 
 namespace gr {
@@ -34,8 +35,8 @@ private:
     std::vector<std::vector<float>> d_codewords;
     int d_len_cw;
     float d_coderate;
-    std::vector<float> calc_weights(const float* in);
-    std::vector<unsigned char> dec2bin(int dec, int nbit);
+    codeword_correlator d_correlator;
+    std::vector<float> d_weights; // of one batch of codewords
 
 public:
     codeword_soft_demapper_fb_impl(int bits_per_cw,
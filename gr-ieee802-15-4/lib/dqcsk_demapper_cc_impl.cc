@@ -26,6 +26,7 @@
 #include "dqcsk_demapper_cc_impl.h"
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
+#include <algorithm>
 
 namespace gr {
 namespace ieee802_15_4 {
@@ -59,6 +60,7 @@ dqcsk_demapper_cc_impl::dqcsk_demapper_cc_impl(std::vector<gr_complex> chirp_seq
       d_chirp_seq_ctr(0)
 {
     set_min_output_buffer(d_num_subchirps);
+    set_output_multiple(d_num_subchirps);
 }
 
 /*
@@ -66,13 +68,21 @@ dqcsk_demapper_cc_impl::dqcsk_demapper_cc_impl(std::vector<gr_complex> chirp_seq
  */
 dqcsk_demapper_cc_impl::~dqcsk_demapper_cc_impl() {}
 
+int dqcsk_demapper_cc_impl::input_len(int nsym) const
+{
+    // the symbols alternate between the two time gaps, starting with the current one
+    const int ngap_cur = (nsym + 1) / 2;
+    const int ngap_next = nsym / 2;
+    const int gap_cur = d_chirp_seq_ctr % 2 == 0 ? d_time_gap_1.size() : d_time_gap_2.size();
+    const int gap_next = d_chirp_seq_ctr % 2 == 0 ? d_time_gap_2.size() : d_time_gap_1.size();
+    return nsym * d_num_subchirps * d_len_subchirp + ngap_cur * gap_cur +
+           ngap_next * gap_next;
+}
+
 void dqcsk_demapper_cc_impl::forecast(int noutput_items,
                                       gr_vector_int& ninput_items_required)
 {
-    if (d_chirp_seq_ctr % 2 == 0)
-        ninput_items_required[0] = d_num_subchirps * d_len_subchirp + d_time_gap_1.size();
-    else
-        ninput_items_required[0] = d_num_subchirps * d_len_subchirp + d_time_gap_2.size();
+    ninput_items_required[0] = input_len(std::max(1, noutput_items / d_num_subchirps));
 }
 
 int dqcsk_demapper_cc_impl::general_work(int noutput_items,
@@ -83,27 +93,35 @@ int dqcsk_demapper_cc_impl::general_work(int noutput_items,
     const gr_complex* in = (const gr_complex*)input_items[0];
     gr_complex* out = (gr_complex*)output_items[0];
 
-    // correlate signal with chirp sequence to extract the DQPSK symbol phase
-    gr_complex corrval;
-    for (int i = 0; i < d_num_subchirps; i++) {
-        volk_32fc_x2_conjugate_dot_prod_32fc(&corrval,
-                                             in + i * d_len_subchirp,
-                                             &d_chirp_seq[i * d_len_subchirp],
-                                             d_len_subchirp);
-        out[i] = corrval;
-    }
+    // demap as many symbols as the buffers hold; a pair of symbols takes
+    // input_len(2) items whatever the current time gap
+    int nsym = std::min(noutput_items / d_num_subchirps,
+                        2 * ninput_items[0] / input_len(2) + 1);
+    while (nsym > 0 && input_len(nsym) > ninput_items[0])
+        nsym--;
+    const int nitems_consumed = input_len(nsym);
 
-    int nitems_consumed = d_num_subchirps * d_len_subchirp;
+    for (int s = 0; s < nsym; s++) {
+        // correlate signal with chirp sequence to extract the DQPSK symbol phase
+        for (int i = 0; i < d_num_subchirps; i++) {
+            volk_32fc_x2_conjugate_dot_prod_32fc(out + i,
+                                                 in + i * d_len_subchirp,
+                                                 &d_chirp_seq[i * d_len_subchirp],
+                                                 d_len_subchirp);
+        }
+        out += d_num_subchirps;
+        in += d_num_subchirps * d_len_subchirp;
 
-    // drop the time gap
-    if (d_chirp_seq_ctr % 2 == 0)
-        nitems_consumed += d_time_gap_1.size();
-    else
-        nitems_consumed += d_time_gap_2.size();
-    d_chirp_seq_ctr = (d_chirp_seq_ctr + 1) % 2;
+        // drop the time gap
+        if (d_chirp_seq_ctr % 2 == 0)
+            in += d_time_gap_1.size();
+        else
+            in += d_time_gap_2.size();
+        d_chirp_seq_ctr = (d_chirp_seq_ctr + 1) % 2;
+    }
 
     consume_each(nitems_consumed);
-    return d_num_subchirps;
+    return nsym * d_num_subchirps;
 }
 
 } /* namespace ieee802_15_4 */
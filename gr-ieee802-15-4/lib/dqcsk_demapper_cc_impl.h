@@ -37,6 +37,9 @@ private:
     int d_num_subchirps;
     int d_chirp_seq_ctr;
 
+    // input items of the next nsym symbols, their time gaps included
+    int input_len(int nsym) const;
+
 public:
     dqcsk_demapper_cc_impl(std::vector<gr_complex> chirp_seq,
                            std::vector<gr_complex> time_gap_1,
@@ -25,6 +25,8 @@
 
 #include "dqpsk_soft_demapper_cc_impl.h"
 #include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <algorithm>
 
 namespace gr {
 namespace ieee802_15_4 {
@@ -67,9 +69,25 @@ int dqpsk_soft_demapper_cc_impl::work(int noutput_items,
     const gr_complex* in = (const gr_complex*)input_items[0];
     gr_complex* out = (gr_complex*)output_items[0];
 
-    for (int i = 0; i < noutput_items; i++) {
-        out[i] = in[i] * d_mem[3];
-        d_mem.push_front(conj(in[i]));
+    // out[i] = in[i] * conj(in[i - d_nmem]) within a frame. The first d_nmem symbols
+    // of a frame, and those whose predecessor came in the previous call, take it
+    // from the memory; the rest of the frame is one volk multiply straight from the
+    // input buffer.
+    int i = 0;
+    while (i < noutput_items) {
+        if (d_symctr < d_nmem || i < d_nmem) {
+            out[i] = in[i] * d_mem[d_nmem - 1];
+            d_mem.push_front(conj(in[i]));
+            i++;
+        } else {
+            const int n = std::min(noutput_items - i, d_framelen - d_symctr);
+            volk_32fc_x2_multiply_conjugate_32fc(out + i, in + i, in + i - d_nmem, n);
+            i += n;
+            d_symctr += n - 1;
+            for (int k = i - d_nmem; k < i; k++) {
+                d_mem.push_front(conj(in[k]));
+            }
+        }
         d_symctr++;
         if (d_symctr == d_framelen) {
             reset_mem();
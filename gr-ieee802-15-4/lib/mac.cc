@@ -14,6 +14,7 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include "pdu_pool.h"
 #include <gnuradio/block_detail.h>
 #include <gnuradio/io_signature.h>
 #include <ieee802_15_4/mac.h>
@@ -23,6 +24,11 @@
 
 using namespace gr::ieee802_15_4;
 
+static const pmt::pmt_t APP_IN = pmt::mp("app in");
+static const pmt::pmt_t APP_OUT = pmt::mp("app out");
+static const pmt::pmt_t PDU_IN = pmt::mp("pdu in");
+static const pmt::pmt_t PDU_OUT = pmt::mp("pdu out");
+
 class mac_impl : public mac
 {
 public:
@@ -41,15 +47,15 @@ public:
           d_num_packets_received(0)
     {
 
-        message_port_register_in(pmt::mp("app in"));
-        set_msg_handler(pmt::mp("app in"),
+        message_port_register_in(APP_IN);
+        set_msg_handler(APP_IN,
                         boost::bind(&mac_impl::app_in, this, boost::placeholders::_1));
-        message_port_register_in(pmt::mp("pdu in"));
-        set_msg_handler(pmt::mp("pdu in"),
+        message_port_register_in(PDU_IN);
+        set_msg_handler(PDU_IN,
                         boost::bind(&mac_impl::mac_in, this, boost::placeholders::_1));
 
-        message_port_register_out(pmt::mp("app out"));
-        message_port_register_out(pmt::mp("pdu out"));
+        message_port_register_out(APP_OUT);
+        message_port_register_out(PDU_OUT);
     }
 
     ~mac_impl(void) {}
@@ -80,10 +86,10 @@ public:
             dout << "MAC: correct crc. Propagate packet to APP layer." << std::endl;
         }
 
-        pmt::pmt_t mac_payload =
-            pmt::make_blob((char*)pmt::blob_data(blob) + 9, data_len - 9 - 2);
-
-        message_port_pub(pmt::mp("app out"), pmt::cons(pmt::PMT_NIL, mac_payload));
+        message_port_pub(
+            APP_OUT,
+            d_pool.make_pdu(
+                pmt::PMT_NIL, (char*)pmt::blob_data(blob) + 9, data_len - 9 - 2));
     }
 
     void app_in(pmt::pmt_t msg)
@@ -107,8 +113,7 @@ public:
 
         generate_mac((const char*)pmt::blob_data(blob), pmt::blob_length(blob));
         // print_message();
-        message_port_pub(pmt::mp("pdu out"),
-                         pmt::cons(pmt::PMT_NIL, pmt::make_blob(d_msg, d_msg_len)));
+        message_port_pub(PDU_OUT, d_pool.make_pdu(pmt::PMT_NIL, d_msg, d_msg_len));
     }
 
     uint16_t crc16(char* buf, int len)
@@ -193,6 +198,9 @@ private:
 
     int d_num_packet_errors;
     int d_num_packets_received;
+
+    // messages of both directions, from the message handlers
+    pdu_pool d_pool;
 };
 
 mac::sptr mac::make(bool debug, int fcf, int seq_nr, int dst_pan, int dst, int src)
@@ -25,8 +25,7 @@
 
 #include "multiuser_chirp_detector_cc_impl.h"
 #include <gnuradio/io_signature.h>
-#include <volk/volk.h>
-
+#include <algorithm>
 
 namespace gr {
 namespace ieee802_15_4 {
@@ -58,17 +57,19 @@ multiuser_chirp_detector_cc_impl::multiuser_chirp_detector_cc_impl(
       d_time_gap_1(time_gap_1),
       d_time_gap_2(time_gap_2),
       d_len_subchirp(len_subchirp),
-      d_threshold(threshold)
+      d_threshold(threshold),
+      d_chirps_port(pmt::mp("chirps"))
 {
     if (d_chirp_seq.size() != NUM_SUBCHIRPS * d_len_subchirp)
         throw std::runtime_error("Chirp sequence has invalid length");
 
-    // calculate energy per subchirp
-    volk_32fc_x2_conjugate_dot_prod_32fc(
-        &d_e_subchirp, &d_chirp_seq[0], &d_chirp_seq[0], d_len_subchirp);
+    d_search.reset(new subchirp_correlator(d_chirp_seq, d_len_subchirp));
+    message_port_register_out(d_chirps_port);
 
     reset();
     set_output_multiple(d_len_subchirp);
+    // the windows that end in the consumed samples are scanned for all users
+    set_history(d_len_subchirp);
 }
 
 /*
@@ -79,8 +80,9 @@ multiuser_chirp_detector_cc_impl::~multiuser_chirp_detector_cc_impl() {}
 void multiuser_chirp_detector_cc_impl::forecast(int noutput_items,
                                                 gr_vector_int& ninput_items_required)
 {
-    ninput_items_required[0] = required_input_items();
-    dout << "forecast() requests at least " << required_input_items() << " input items"
+    // the scheduler counts the history in
+    ninput_items_required[0] = required_input_items() + history() - 1;
+    dout << "forecast() requests at least " << ninput_items_required[0] << " input items"
          << std::endl;
 }
 
@@ -94,17 +96,7 @@ void multiuser_chirp_detector_cc_impl::reset()
 gr_complex
 multiuser_chirp_detector_cc_impl::correlate_current_subchirp(const gr_complex* buf)
 {
-    gr_complex corrval = 0;
-    volk_32fc_x2_conjugate_dot_prod_32fc(
-        &corrval, buf, &d_chirp_seq[d_subchirp_ctr * d_len_subchirp], d_len_subchirp);
-    gr_complex e_buf = 0;
-    volk_32fc_x2_conjugate_dot_prod_32fc(&e_buf, buf, buf, d_len_subchirp);
-    // dout << "correlation result:" << corrval << "/" << std::sqrt(e_buf*d_e_subchirp) <<
-    // "=> norm = " <<
-    // std::norm(corrval/(std::sqrt(e_buf*d_e_subchirp)+gr_complex(1e-6,0))) << std::endl;
-    // normalize using standard deviations of both signals (assuming mean==0)
-    // add 1e-6 to avoid divide-by-zero errors
-    return corrval / (std::sqrt(e_buf * d_e_subchirp) + gr_complex(1e-6, 0));
+    return d_search->correlate(buf, d_subchirp_ctr);
 }
 
 bool multiuser_chirp_detector_cc_impl::corr_over_threshold(gr_complex corrval)
@@ -147,22 +139,119 @@ int multiuser_chirp_detector_cc_impl::required_input_items()
         throw std::runtime_error("Invalid state");
     return ret;
 }
+
+void multiuser_chirp_detector_cc_impl::scan_users(const gr_complex* hist, int nconsumed)
+{
+    // hist[p] is the input sample at offset first + p
+    const int64_t first = int64_t(nitems_read(0)) - (d_len_subchirp - 1);
+    const int tolerance = d_len_subchirp / 2;
+
+    d_hits.clear();
+    d_search->scan(hist, nconsumed, d_threshold, d_hits);
+    for (const auto& h : d_hits) {
+        const int64_t start = first + h.position - int64_t(h.subchirp) * d_len_subchirp;
+        if (start < 0) {
+            continue;
+        }
+        // neighboring positions of one chirp's correlation peaks are merged
+        auto chirp = std::find_if(d_pending.begin(), d_pending.end(), [&](const auto& c) {
+            return std::abs(c.start - start) <= tolerance;
+        });
+        if (chirp == d_pending.end()) {
+            d_pending.push_back(chirp_hit{ start, h.power, 1u << h.subchirp });
+            continue;
+        }
+        chirp->subchirps |= 1u << h.subchirp;
+        if (h.power > chirp->power) {
+            chirp->start = start;
+            chirp->power = h.power;
+        }
+    }
+
+    // a chirp is complete once the positions of all its subchirps are scanned
+    const int64_t scanned = first + nconsumed;
+    auto complete = [&](const chirp_hit& c) {
+        return c.start + (NUM_SUBCHIRPS - 1) * d_len_subchirp + tolerance < scanned;
+    };
+    std::sort(d_pending.begin(), d_pending.end(), [](const auto& a, const auto& b) {
+        return a.start < b.start;
+    });
+    for (const auto& chirp : d_pending) {
+        if (complete(chirp)) {
+            report_chirp(chirp);
+        }
+    }
+    d_pending.erase(std::remove_if(d_pending.begin(), d_pending.end(), complete),
+                    d_pending.end());
+}
+
+void multiuser_chirp_detector_cc_impl::report_chirp(const chirp_hit& chirp)
+{
+    // a chirp that follows an earlier one by one of the time gaps continues that
+    // user's sequence
+    const int64_t chirp_len = NUM_SUBCHIRPS * d_len_subchirp;
+    const int tolerance = d_len_subchirp / 2;
+    int time_gap = -1;
+    int64_t best = tolerance + 1;
+    for (int64_t prev : d_recent) {
+        for (int gap : { d_time_gap_1, d_time_gap_2 }) {
+            const int64_t err = std::abs(chirp.start - (prev + chirp_len + gap));
+            if (err < best) {
+                best = err;
+                time_gap = gap;
+            }
+        }
+    }
+
+    pmt::pmt_t msg = pmt::make_dict();
+    msg = pmt::dict_add(msg, pmt::mp("offset"), pmt::from_uint64(chirp.start));
+    msg = pmt::dict_add(msg, pmt::mp("subchirps"), pmt::from_long(chirp.subchirps));
+    msg = pmt::dict_add(msg, pmt::mp("power"), pmt::from_double(chirp.power));
+    if (time_gap >= 0) {
+        msg = pmt::dict_add(msg, pmt::mp("time_gap"), pmt::from_long(time_gap));
+    }
+    dout << "#USERS# chirp at " << chirp.start << ", time gap " << time_gap << std::endl;
+    message_port_pub(d_chirps_port, msg);
+
+    // only chirps that a later one can still follow are kept
+    const int64_t horizon = chirp_len + std::max(d_time_gap_1, d_time_gap_2) + tolerance;
+    auto expired = [&](int64_t prev) { return prev + horizon < chirp.start; };
+    d_recent.erase(std::remove_if(d_recent.begin(), d_recent.end(), expired),
+                   d_recent.end());
+    d_recent.push_back(chirp.start);
+}
+
 int multiuser_chirp_detector_cc_impl::general_work(int noutput_items,
                                                    gr_vector_int& ninput_items,
                                                    gr_vector_const_void_star& input_items,
                                                    gr_vector_void_star& output_items)
 {
-    const gr_complex* in = (const gr_complex*)input_items[0];
+    // history of d_len_subchirp - 1 samples before the current input
+    const gr_complex* hist = (const gr_complex*)input_items[0];
+    const gr_complex* in = hist + d_len_subchirp - 1;
+    // ninput_items counts the history, in does not
+    const int ninput = ninput_items[0] - (history() - 1);
     gr_complex* out = (gr_complex*)output_items[0];
 
-    int available_samples = ninput_items[0];
     int samples_consumed = 0;
     int samples_produced = 0;
 
-    while (available_samples >= required_input_items() &&
+    while (ninput - samples_consumed >= required_input_items() &&
            samples_produced < noutput_items) {
         if (d_state == STATE_SEARCH) // look for first subchirp of chosen chirp sequence
         {
+            // skip the positions that the FFT screening rules out, as if advancing by
+            // 1 sample after each of them
+            const int npos = ninput - samples_consumed - d_len_subchirp + 1;
+            const int skip =
+                d_search->find(in + samples_consumed, npos, d_subchirp_ctr, d_threshold);
+            samples_consumed += skip;
+            if (skip == npos) {
+                dout << "#SEARCH# no symbol detected in " << npos << " samples"
+                     << std::endl;
+                break;
+            }
+
             gr_complex sym = correlate_current_subchirp(in + samples_consumed);
             if (corr_over_threshold(sym)) {
                 dout << "#SEARCH# " << std::norm(sym) << ": chirp #" << d_subchirp_ctr
@@ -208,11 +297,11 @@ int multiuser_chirp_detector_cc_impl::general_work(int noutput_items,
             }
         } else
             throw std::runtime_error("Invalid state");
-        available_samples -= samples_consumed;
     }
 
-    dout << "consume: " << samples_consumed << "/" << ninput_items[0] << std::endl;
+    dout << "consume: " << samples_consumed << "/" << ninput << std::endl;
     dout << "produce: " << samples_produced << "/" << noutput_items << std::endl;
+    scan_users(hist, samples_consumed);
     consume_each(samples_consumed);
     return samples_produced;
 }
@@ -22,7 +22,9 @@
 #ifndef INCLUDED_IEEE802_15_4_MULTIUSER_CHIRP_DETECTOR_CC_IMPL_H
 #define INCLUDED_IEEE802_15_4_MULTIUSER_CHIRP_DETECTOR_CC_IMPL_H
 
+#include "subchirp_correlator.h"
 #include <ieee802_15_4/multiuser_chirp_detector_cc.h>
+#include <memory>
 
 namespace gr {
 namespace ieee802_15_4 {
@@ -41,8 +43,22 @@ private:
     int d_state;
     int d_chirp_ctr;
     int d_subchirp_ctr;
-    gr_complex d_e_subchirp; // actually is a float, but needs to be complex for the /
-                             // operator to be defined
+    // screens many positions at once in STATE_SEARCH, and finds the chirps of all
+    // users in the consumed samples
+    std::unique_ptr<subchirp_correlator> d_search;
+
+    struct chirp_hit {
+        int64_t start;      // input offset of the chirp's first subchirp
+        float power;        // of its strongest subchirp
+        unsigned subchirps; // bit s is set if subchirp s was detected
+    };
+    const pmt::pmt_t d_chirps_port;
+    std::vector<subchirp_correlator::hit> d_hits;
+    std::vector<chirp_hit> d_pending; // chirps whose subchirps are not all scanned yet
+    std::vector<int64_t> d_recent;    // starts of the chirps reported last
+    void scan_users(const gr_complex* hist, int nconsumed);
+    void report_chirp(const chirp_hit& chirp);
+
     void reset();
     gr_complex
     correlate_current_subchirp(const gr_complex* buf); // normalized correlation
@@ -14,18 +14,24 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <gnuradio/blocks/count_bits.h>
+#include "pdu_pool.h"
 #include <gnuradio/io_signature.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <ieee802_15_4/packet_sink.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
 
+#ifdef IEEE802154_MSSE2
+#include <emmintrin.h>
+#endif
+
 using namespace gr::ieee802_15_4;
 
 // very verbose output for almost each sample
@@ -49,6 +55,147 @@ static const unsigned int CHIP_MAPPING[] = {
 static const int MAX_PKT_LEN = 128 - 1; // remove header and CRC
 static const int MAX_LQI_SAMPLES = 8;   // Number of chip correlation samples to take
 
+static const pmt::pmt_t OUT_PORT = pmt::mp("out");
+static const pmt::pmt_t LQI_KEY = pmt::mp("lqi");
+
+// The first and the last chip of a symbol depend on the previous symbol, so they are
+// ignored when matching chip sequences.
+static const uint32_t CHIP_MASK = 0x7FFFFFFE;
+
+namespace {
+
+// CHIP_MAPPING & CHIP_MASK, for matching all codewords at once.
+alignas(16) const uint32_t MASKED_CHIP_MAPPING[16] = {
+    CHIP_MAPPING[0] & CHIP_MASK,  CHIP_MAPPING[1] & CHIP_MASK,
+    CHIP_MAPPING[2] & CHIP_MASK,  CHIP_MAPPING[3] & CHIP_MASK,
+    CHIP_MAPPING[4] & CHIP_MASK,  CHIP_MAPPING[5] & CHIP_MASK,
+    CHIP_MAPPING[6] & CHIP_MASK,  CHIP_MAPPING[7] & CHIP_MASK,
+    CHIP_MAPPING[8] & CHIP_MASK,  CHIP_MAPPING[9] & CHIP_MASK,
+    CHIP_MAPPING[10] & CHIP_MASK, CHIP_MAPPING[11] & CHIP_MASK,
+    CHIP_MAPPING[12] & CHIP_MASK, CHIP_MAPPING[13] & CHIP_MASK,
+    CHIP_MAPPING[14] & CHIP_MASK, CHIP_MAPPING[15] & CHIP_MASK
+};
+
+inline unsigned int popcount32(uint32_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555);
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+    return (((x + (x >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+}
+
+inline int highest_bit(uint32_t x)
+{
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(x);
+#else
+    int bit = 0;
+    while (x >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Slice n <= 32 chips into the low n bits of a word, the first chip in the most
+// significant of them.
+inline uint32_t slice_chips(const float* in, int n)
+{
+    uint32_t chips = 0;
+    int i = 0;
+#ifdef IEEE802154_MSSE2
+    // movemask puts the first chip of a group in bit 0; reverse the group
+    static const uint8_t REVERSE4[16] = { 0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+                                          0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF };
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        const int bits = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(in + i), zero));
+        chips = (chips << 4) | REVERSE4[bits];
+    }
+#endif
+    for (; i < n; i++) {
+        chips = (chips << 1) | (in[i] > 0 ? 1 : 0);
+    }
+    return chips;
+}
+
+// Hamming distances of a chip sequence to all 16 codewords.
+inline void codeword_distances(uint32_t chips, unsigned int distances[16])
+{
+#ifdef IEEE802154_MSSE2
+    // SWAR popcount on four codewords per register
+    const __m128i x = _mm_set1_epi32(chips & CHIP_MASK);
+    const __m128i m1 = _mm_set1_epi32(0x55555555);
+    const __m128i m2 = _mm_set1_epi32(0x33333333);
+    const __m128i m4 = _mm_set1_epi32(0x0F0F0F0F);
+    const __m128i m6 = _mm_set1_epi32(0x3F);
+    for (int i = 0; i < 16; i += 4) {
+        __m128i v = _mm_xor_si128(
+            x, _mm_load_si128(reinterpret_cast<const __m128i*>(&MASKED_CHIP_MAPPING[i])));
+        v = _mm_sub_epi32(v, _mm_and_si128(_mm_srli_epi32(v, 1), m1));
+        v = _mm_add_epi32(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi32(v, 2), m2));
+        v = _mm_and_si128(_mm_add_epi32(v, _mm_srli_epi32(v, 4)), m4);
+        v = _mm_add_epi32(v, _mm_srli_epi32(v, 8));
+        v = _mm_and_si128(_mm_add_epi32(v, _mm_srli_epi32(v, 16)), m6);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&distances[i]), v);
+    }
+#else
+    for (int i = 0; i < 16; i++) {
+        distances[i] = popcount32((chips & CHIP_MASK) ^ MASKED_CHIP_MAPPING[i]);
+    }
+#endif
+}
+
+inline unsigned int codeword_distance(uint32_t chips, int codeword)
+{
+    return popcount32((chips & CHIP_MASK) ^ MASKED_CHIP_MAPPING[codeword]);
+}
+
+// Bit p of the result is set if the 32-chip window (chips >> p) is closer than
+// `threshold` to the codeword, for all p < 32 at once: bit p of the word for chip b
+// is the mismatch of chip b of window p, and a bit-sliced counter adds them up.
+inline uint32_t match_windows(uint64_t chips, int codeword, unsigned int threshold)
+{
+    if (threshold >= 32) {
+        return 0xFFFFFFFF;
+    }
+
+    // 5-bit counters: bit p of count[k] is bit k of the mismatches of window p
+    uint32_t count[5] = { 0, 0, 0, 0, 0 };
+    const uint32_t ref = MASKED_CHIP_MAPPING[codeword];
+    for (int b = 1; b < 31; b += 2) {
+        const uint32_t x = uint32_t(chips >> b) ^ (0u - ((ref >> b) & 1));
+        const uint32_t y = uint32_t(chips >> (b + 1)) ^ (0u - ((ref >> (b + 1)) & 1));
+        // carry-save add of x and y to the ones, then ripple the carry
+        const uint32_t u = count[0] ^ x;
+        uint32_t carry = (count[0] & x) | (u & y);
+        count[0] = u ^ y;
+        for (int k = 1; k < 5; k++) {
+            const uint32_t next = count[k] & carry;
+            count[k] ^= carry;
+            carry = next;
+        }
+    }
+
+    // count < threshold, from the most significant bit down
+    uint32_t less = 0;
+    uint32_t equal = 0xFFFFFFFF;
+    for (int k = 4; k >= 0; k--) {
+        if ((threshold >> k) & 1) {
+            less |= equal & ~count[k];
+            equal &= count[k];
+        } else {
+            equal &= ~count[k];
+        }
+    }
+    return less;
+}
+
+} // namespace
+
 class packet_sink_impl : public packet_sink
 {
 public:
@@ -96,18 +243,15 @@ public:
     {
         int i;
         int best_match = 0xFF;
-        int min_threshold =
+        unsigned int min_threshold =
             33; // Matching to 32 chips, could never have a error of 33 chips
 
+        unsigned int distances[16];
+        codeword_distances(chips, distances);
         for (i = 0; i < 16; i++) {
-            // FIXME: we can store the last chip
-            // ignore the first and last chip since it depends on the last chip.
-            unsigned int threshold = gr::blocks::count_bits32(
-                (chips & 0x7FFFFFFE) ^ (CHIP_MAPPING[i] & 0x7FFFFFFE));
-
-            if (threshold < min_threshold) {
+            if (distances[i] < min_threshold) {
                 best_match = i;
-                min_threshold = threshold;
+                min_threshold = distances[i];
             }
         }
 
@@ -116,7 +260,7 @@ public:
                 fprintf(stderr,
                         "Found sequence with %d errors at 0x%x\n",
                         min_threshold,
-                        (chips & 0x7FFFFFFE) ^ (CHIP_MAPPING[best_match] & 0x7FFFFFFE)),
+                        (chips & CHIP_MASK) ^ MASKED_CHIP_MAPPING[best_match]),
                     fflush(stderr);
             // LQI: Average number of chips correct * MAX_LQI_SAMPLES
             //
@@ -131,7 +275,52 @@ public:
         return 0xFF;
     }
 
-    int slice(float x) { return x > 0 ? 1 : 0; }
+    // Look for the first 0 symbol of the preamble, 32 chips at a time. On a match,
+    // d_shift_reg holds the matching chips and count points past them.
+    void search_preamble(const float* inbuf, int ninput, int& count)
+    {
+        while (count < ninput) {
+            const int n = std::min(32, ninput - count);
+            const uint64_t chips =
+                (uint64_t(d_shift_reg) << n) | slice_chips(inbuf + count, n);
+
+            // window p ends at chip n - 1 - p of this slice
+            uint32_t found = match_windows(chips, 0, d_threshold);
+            if (n < 32) {
+                found &= (1u << n) - 1;
+            }
+            if (!found) {
+                d_shift_reg = uint32_t(chips);
+                count += n;
+                continue;
+            }
+
+            const int p = highest_bit(found);
+            d_shift_reg = uint32_t(chips >> p);
+            count += n - p;
+            if (VERBOSE2)
+                fprintf(stderr, "Found 0 in chip sequence\n"), fflush(stderr);
+            // we found a 0 in the chip sequence
+            d_preamble_cnt += 1;
+            return;
+        }
+    }
+
+    // Shift the chips of the current symbol into d_shift_reg. Returns true once all
+    // 32 are in, false if the input ran out first.
+    bool collect_symbol(const float* inbuf, int ninput, int& count)
+    {
+        const int n = std::min(32 - d_chip_cnt, ninput - count);
+        const uint64_t chips = (uint64_t(d_shift_reg) << n) | slice_chips(inbuf + count, n);
+        d_shift_reg = uint32_t(chips);
+        count += n;
+        d_chip_cnt += n;
+        if (d_chip_cnt < 32) {
+            return false;
+        }
+        d_chip_cnt = 0;
+        return true;
+    }
 
     packet_sink_impl(int threshold)
         : block("packet_sink",
@@ -150,7 +339,7 @@ public:
                 fflush(stderr);
         enter_search();
 
-        message_port_register_out(pmt::mp("out"));
+        message_port_register_out(OUT_PORT);
     }
 
     ~packet_sink_impl() {}
@@ -164,7 +353,6 @@ public:
         const float* inbuf = (const float*)input_items[0];
         int ninput = ninput_items[0];
         int count = 0;
-        int i = 0;
 
         if (VERBOSE)
             fprintf(stderr, ">>> Entering state machine\n"), fflush(stderr);
@@ -180,95 +368,51 @@ public:
                             d_sync_vector),
                         fflush(stderr);
 
-                while (count < ninput) {
+                // The first step syncronizes to chip sequences.
+                if (d_preamble_cnt == 0) {
+                    search_preamble(inbuf, ninput, count);
+                    break;
+                }
 
-                    if (slice(inbuf[count++]))
-                        d_shift_reg = (d_shift_reg << 1) | 1;
-                    else
-                        d_shift_reg = d_shift_reg << 1;
+                // we found the first 0, thus we only have to do the calculation
+                // every 32 chips
+                if (!collect_symbol(inbuf, ninput, count)) {
+                    break;
+                }
 
-                    if (d_preamble_cnt > 0) {
-                        d_chip_cnt = d_chip_cnt + 1;
+                if (d_packet_byte == 0) {
+                    if (codeword_distance(d_shift_reg, 0) <= d_threshold) {
+                        if (VERBOSE2)
+                            fprintf(stderr, "Found %d 0 in chip sequence\n", d_preamble_cnt),
+                                fflush(stderr);
+                        // we found an other 0 in the chip sequence
+                        d_packet_byte = 0;
+                        d_preamble_cnt++;
+                    } else if (codeword_distance(d_shift_reg, 7) <= d_threshold) {
+                        if (VERBOSE2)
+                            fprintf(stderr, "Found first SFD\n"), fflush(stderr);
+                        d_packet_byte = 7 << 4;
+                    } else {
+                        // we are not in the synchronization header
+                        if (VERBOSE2)
+                            fprintf(stderr, "Wrong first byte of SFD. %u\n", d_shift_reg),
+                                fflush(stderr);
+                        enter_search();
                     }
-
-                    // The first if block syncronizes to chip sequences.
-                    if (d_preamble_cnt == 0) {
-                        unsigned int threshold;
-                        threshold = gr::blocks::count_bits32(
-                            (d_shift_reg & 0x7FFFFFFE) ^ (CHIP_MAPPING[0] & 0x7FFFFFFE));
-                        if (threshold < d_threshold) {
-                            //  fprintf(stderr, "Threshold %d d_preamble_cnt: %d\n",
-                            //  threshold, d_preamble_cnt);
-                            // if ((d_shift_reg&0xFFFFFE) == (CHIP_MAPPING[0]&0xFFFFFE)) {
-                            if (VERBOSE2)
-                                fprintf(stderr, "Found 0 in chip sequence\n"),
-                                    fflush(stderr);
-                            // we found a 0 in the chip sequence
-                            d_preamble_cnt += 1;
-                            // fprintf(stderr, "Threshold %d d_preamble_cnt: %d\n",
-                            // threshold, d_preamble_cnt);
-                        }
+                } else {
+                    if (codeword_distance(d_shift_reg, 10) <= d_threshold) {
+                        d_packet_byte |= 0xA;
+                        if (VERBOSE2)
+                            fprintf(stderr, "Found sync, 0x%x\n", d_packet_byte),
+                                fflush(stderr);
+                        // found SDF
+                        // setup for header decode
+                        enter_have_sync();
                     } else {
-                        // we found the first 0, thus we only have to do the calculation
-                        // every 32 chips
-                        if (d_chip_cnt == 32) {
-                            d_chip_cnt = 0;
-
-                            if (d_packet_byte == 0) {
-                                if (gr::blocks::count_bits32(
-                                        (d_shift_reg & 0x7FFFFFFE) ^
-                                        (CHIP_MAPPING[0] & 0xFFFFFFFE)) <= d_threshold) {
-                                    if (VERBOSE2)
-                                        fprintf(stderr,
-                                                "Found %d 0 in chip sequence\n",
-                                                d_preamble_cnt),
-                                            fflush(stderr);
-                                    // we found an other 0 in the chip sequence
-                                    d_packet_byte = 0;
-                                    d_preamble_cnt++;
-                                } else if (gr::blocks::count_bits32(
-                                               (d_shift_reg & 0x7FFFFFFE) ^
-                                               (CHIP_MAPPING[7] & 0xFFFFFFFE)) <=
-                                           d_threshold) {
-                                    if (VERBOSE2)
-                                        fprintf(stderr, "Found first SFD\n"),
-                                            fflush(stderr);
-                                    d_packet_byte = 7 << 4;
-                                } else {
-                                    // we are not in the synchronization header
-                                    if (VERBOSE2)
-                                        fprintf(stderr,
-                                                "Wrong first byte of SFD. %u\n",
-                                                d_shift_reg),
-                                            fflush(stderr);
-                                    enter_search();
-                                    break;
-                                }
-
-                            } else {
-                                if (gr::blocks::count_bits32(
-                                        (d_shift_reg & 0x7FFFFFFE) ^
-                                        (CHIP_MAPPING[10] & 0xFFFFFFFE)) <= d_threshold) {
-                                    d_packet_byte |= 0xA;
-                                    if (VERBOSE2)
-                                        fprintf(
-                                            stderr, "Found sync, 0x%x\n", d_packet_byte),
-                                            fflush(stderr);
-                                    // found SDF
-                                    // setup for header decode
-                                    enter_have_sync();
-                                    break;
-                                } else {
-                                    if (VERBOSE)
-                                        fprintf(stderr,
-                                                "Wrong second byte of SFD. %u\n",
-                                                d_shift_reg),
-                                            fflush(stderr);
-                                    enter_search();
-                                    break;
-                                }
-                            }
-                        }
+                        if (VERBOSE)
+                            fprintf(stderr, "Wrong second byte of SFD. %u\n", d_shift_reg),
+                                fflush(stderr);
+                        enter_search();
                     }
                 }
                 break;
@@ -281,46 +425,37 @@ public:
                             d_header),
                         fflush(stderr);
 
-                while (count < ninput) { // Decode the bytes one after another.
-                    if (slice(inbuf[count++]))
-                        d_shift_reg = (d_shift_reg << 1) | 1;
-                    else
-                        d_shift_reg = d_shift_reg << 1;
-
-                    d_chip_cnt = d_chip_cnt + 1;
-
-                    if (d_chip_cnt == 32) {
-                        d_chip_cnt = 0;
-                        unsigned char c = decode_chips(d_shift_reg);
-                        if (c == 0xFF) {
-                            // something is wrong. restart the search for a sync
-                            if (VERBOSE2)
-                                fprintf(stderr,
-                                        "Found a not valid chip sequence! %u\n",
-                                        d_shift_reg),
-                                    fflush(stderr);
-
-                            enter_search();
-                            break;
-                        }
+                // Decode the bytes one after another.
+                while (collect_symbol(inbuf, ninput, count)) {
+                    unsigned char c = decode_chips(d_shift_reg);
+                    if (c == 0xFF) {
+                        // something is wrong. restart the search for a sync
+                        if (VERBOSE2)
+                            fprintf(stderr,
+                                    "Found a not valid chip sequence! %u\n",
+                                    d_shift_reg),
+                                fflush(stderr);
+
+                        enter_search();
+                        break;
+                    }
 
-                        if (d_packet_byte_index == 0) {
-                            d_packet_byte = c;
+                    if (d_packet_byte_index == 0) {
+                        d_packet_byte = c;
+                    } else {
+                        // c is always < 15
+                        d_packet_byte |= c << 4;
+                    }
+                    d_packet_byte_index = d_packet_byte_index + 1;
+                    if (d_packet_byte_index % 2 == 0) {
+                        // we have a complete byte which represents the frame length.
+                        int frame_len = d_packet_byte;
+                        if (frame_len <= MAX_PKT_LEN) {
+                            enter_have_header(frame_len);
                         } else {
-                            // c is always < 15
-                            d_packet_byte |= c << 4;
-                        }
-                        d_packet_byte_index = d_packet_byte_index + 1;
-                        if (d_packet_byte_index % 2 == 0) {
-                            // we have a complete byte which represents the frame length.
-                            int frame_len = d_packet_byte;
-                            if (frame_len <= MAX_PKT_LEN) {
-                                enter_have_header(frame_len);
-                            } else {
-                                enter_search();
-                            }
-                            break;
+                            enter_search();
                         }
+                        break;
                     }
                 }
                 break;
@@ -334,77 +469,65 @@ public:
                             d_packetlen),
                         fflush(stderr);
 
-                while (count < ninput) { // shift bits into bytes of packet one at a time
-                    if (slice(inbuf[count++]))
-                        d_shift_reg = (d_shift_reg << 1) | 1;
-                    else
-                        d_shift_reg = d_shift_reg << 1;
-
-                    d_chip_cnt = (d_chip_cnt + 1) % 32;
+                // shift chips into bytes of packet one symbol at a time
+                while (collect_symbol(inbuf, ninput, count)) {
+                    unsigned char c = decode_chips(d_shift_reg);
+                    if (c == 0xff) {
+                        // something is wrong. restart the search for a sync
+                        if (VERBOSE2)
+                            fprintf(stderr,
+                                    "Found a not valid chip sequence! %u\n",
+                                    d_shift_reg),
+                                fflush(stderr);
+
+                        enter_search();
+                        break;
+                    }
+                    // the first symbol represents the first part of the byte.
+                    if (d_packet_byte_index == 0) {
+                        d_packet_byte = c;
+                    } else {
+                        // c is always < 15
+                        d_packet_byte |= c << 4;
+                    }
+                    // fprintf(stderr, "%d: 0x%x\n", d_packet_byte_index, c);
+                    d_packet_byte_index = d_packet_byte_index + 1;
+                    if (d_packet_byte_index % 2 == 0) {
+                        // we have a complete byte
+                        if (VERBOSE2)
+                            fprintf(stderr,
+                                    "packetcnt: %d, payloadcnt: %d, payload 0x%x, "
+                                    "d_packet_byte_index: %d\n",
+                                    d_packetlen_cnt,
+                                    d_payload_cnt,
+                                    d_packet_byte,
+                                    d_packet_byte_index),
+                                fflush(stderr);
+
+                        d_packet[d_packetlen_cnt++] = d_packet_byte;
+                        d_payload_cnt++;
+                        d_packet_byte_index = 0;
+
+                        if (d_payload_cnt >= d_packetlen) { // packet is filled, including
+                                                            // CRC. might do check later
+                            unsigned int scaled_lqi = (d_lqi / MAX_LQI_SAMPLES) << 3;
+                            unsigned char lqi = (scaled_lqi >= 256 ? 255 : scaled_lqi);
+
+                            pmt::pmt_t meta = pmt::make_dict();
+                            meta =
+                                pmt::dict_add(meta, LQI_KEY, pmt::from_long(lqi));
+
+                            message_port_pub(
+                                OUT_PORT,
+                                d_pool.make_pdu(meta, d_packet, d_packetlen_cnt));
 
-                    if (d_chip_cnt == 0) {
-                        unsigned char c = decode_chips(d_shift_reg);
-                        if (c == 0xff) {
-                            // something is wrong. restart the search for a sync
                             if (VERBOSE2)
                                 fprintf(stderr,
-                                        "Found a not valid chip sequence! %u\n",
-                                        d_shift_reg),
-                                    fflush(stderr);
-
+                                        "Adding message of size %d to queue\n",
+                                        d_packetlen_cnt);
                             enter_search();
                             break;
                         }
-                        // the first symbol represents the first part of the byte.
-                        if (d_packet_byte_index == 0) {
-                            d_packet_byte = c;
-                        } else {
-                            // c is always < 15
-                            d_packet_byte |= c << 4;
-                        }
-                        // fprintf(stderr, "%d: 0x%x\n", d_packet_byte_index, c);
-                        d_packet_byte_index = d_packet_byte_index + 1;
-                        if (d_packet_byte_index % 2 == 0) {
-                            // we have a complete byte
-                            if (VERBOSE2)
-                                fprintf(stderr,
-                                        "packetcnt: %d, payloadcnt: %d, payload 0x%x, "
-                                        "d_packet_byte_index: %d\n",
-                                        d_packetlen_cnt,
-                                        d_payload_cnt,
-                                        d_packet_byte,
-                                        d_packet_byte_index),
-                                    fflush(stderr);
-
-                            d_packet[d_packetlen_cnt++] = d_packet_byte;
-                            d_payload_cnt++;
-                            d_packet_byte_index = 0;
-
-                            if (d_payload_cnt >=
-                                d_packetlen) { // packet is filled, including CRC. might
-                                               // do check later in here
-                                unsigned int scaled_lqi = (d_lqi / MAX_LQI_SAMPLES) << 3;
-                                unsigned char lqi =
-                                    (scaled_lqi >= 256 ? 255 : scaled_lqi);
-
-                                pmt::pmt_t meta = pmt::make_dict();
-                                meta = pmt::dict_add(
-                                    meta, pmt::mp("lqi"), pmt::from_long(lqi));
-
-                                std::memcpy(buf, d_packet, d_packetlen_cnt);
-                                pmt::pmt_t payload = pmt::make_blob(buf, d_packetlen_cnt);
-
-                                message_port_pub(pmt::mp("out"),
-                                                 pmt::cons(meta, payload));
-
-                                if (VERBOSE2)
-                                    fprintf(stderr,
-                                            "Adding message of size %d to queue\n",
-                                            d_packetlen_cnt);
-                                enter_search();
-                                break;
-                            }
-                        }
                     }
                 }
                 break;
@@ -446,8 +569,7 @@ private:
     unsigned int d_lqi; // Link Quality Information
     unsigned int d_lqi_sample_count;
 
-    // FIXME:
-    char buf[256];
+    pdu_pool d_pool;
 };
 
 packet_sink::sptr packet_sink::make(unsigned int threshold)
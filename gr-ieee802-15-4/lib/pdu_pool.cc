@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pdu_pool.h"
+#include <atomic>
+#include <cstring>
+
+using namespace gr::ieee802_15_4;
+
+namespace {
+
+// A kept PMT nobody else references, or nil. Receivers drop their references on
+// other threads; the fence orders their last reads of it before our writes.
+pmt::pmt_t unreferenced(const std::vector<pmt::pmt_t>& kept)
+{
+    for (const auto& p : kept) {
+        if (p.use_count() == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return p;
+        }
+    }
+    return pmt::PMT_NIL;
+}
+
+} // namespace
+
+pdu_pool::pdu_pool() : d_blobs(MAX_LEN + 1) {}
+
+pmt::pmt_t pdu_pool::blob(size_t len)
+{
+    if (len > MAX_LEN) {
+        return pmt::make_u8vector(len, 0);
+    }
+    std::vector<pmt::pmt_t>& kept = d_blobs[len];
+    pmt::pmt_t b = unreferenced(kept);
+    if (b == pmt::PMT_NIL) {
+        b = pmt::make_u8vector(len, 0);
+        if (kept.size() < MAX_KEPT) {
+            kept.push_back(b);
+        }
+    }
+    return b;
+}
+
+pmt::pmt_t pdu_pool::pair()
+{
+    pmt::pmt_t p = unreferenced(d_pairs);
+    if (p == pmt::PMT_NIL) {
+        p = pmt::cons(pmt::PMT_NIL, pmt::PMT_NIL);
+        if (d_pairs.size() < MAX_KEPT) {
+            d_pairs.push_back(p);
+        }
+    } else {
+        // let go of the old blob, so that it can be recycled too
+        pmt::set_car(p, pmt::PMT_NIL);
+        pmt::set_cdr(p, pmt::PMT_NIL);
+    }
+    return p;
+}
+
+pmt::pmt_t pdu_pool::make_pdu(const pmt::pmt_t& meta,
+                              const void* header,
+                              size_t header_len,
+                              const void* payload,
+                              size_t payload_len)
+{
+    pmt::pmt_t pdu = pair();
+    pmt::pmt_t b = blob(header_len + payload_len);
+    size_t len;
+    uint8_t* data = pmt::u8vector_writable_elements(b, len);
+    if (header_len) {
+        std::memcpy(data, header, header_len);
+    }
+    if (payload_len) {
+        std::memcpy(data + header_len, payload, payload_len);
+    }
+
+    pmt::set_car(pdu, meta);
+    pmt::set_cdr(pdu, b);
+    return pdu;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_IEEE802_15_4_PDU_POOL_H
+#define INCLUDED_IEEE802_15_4_PDU_POOL_H
+
+#include <pmt/pmt.h>
+#include <cstddef>
+#include <vector>
+
+namespace gr {
+namespace ieee802_15_4 {
+
+/*
+ * PDUs, (meta . blob) pairs, built from recycled PMTs. The pool keeps the pairs and
+ * blobs it handed out; once the pool holds the only reference to one, every receiver
+ * is done with it and it is overwritten for the next PDU. A frame then costs two
+ * copies into existing PMTs instead of a pair, a blob and its buffer from the heap.
+ *
+ * Blobs have a fixed length, so they are kept per length up to MAX_LEN bytes; longer
+ * ones are not recycled. A pool is not thread safe; each block, or each rime
+ * connection, has its own and uses it from its message handlers only.
+ */
+class pdu_pool
+{
+public:
+    static constexpr size_t MAX_LEN = 255;
+
+    pdu_pool();
+
+    // (meta . blob) with the header bytes followed by the payload bytes
+    pmt::pmt_t make_pdu(const pmt::pmt_t& meta,
+                        const void* header,
+                        size_t header_len,
+                        const void* payload = nullptr,
+                        size_t payload_len = 0);
+
+private:
+    // PMTs kept per kind and length. More can be in flight at once, but then
+    // receivers are falling behind and the heap is the lesser problem.
+    static constexpr size_t MAX_KEPT = 8;
+
+    pmt::pmt_t blob(size_t len);
+    pmt::pmt_t pair();
+
+    std::vector<std::vector<pmt::pmt_t>> d_blobs; // by length
+    std::vector<pmt::pmt_t> d_pairs;
+};
+
+} // namespace ieee802_15_4
+} // namespace gr
+
+#endif /* INCLUDED_IEEE802_15_4_PDU_POOL_H */
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "subchirp_correlator.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <tuple>
+
+using gr::ieee802_15_4::subchirp_correlator;
+
+namespace {
+const int LEN_SUBCHIRP = 38;
+const int NUM_SUBCHIRPS = 4;
+
+// up and down chirps of different rates, one per subchirp
+std::vector<gr_complex> make_chirp_seq()
+{
+    std::vector<gr_complex> seq;
+    for (int s = 0; s < NUM_SUBCHIRPS; s++) {
+        const float rate = (s % 2 ? -1.0f : 1.0f) * (1 + s / 2) * M_PI / LEN_SUBCHIRP;
+        for (int n = 0; n < LEN_SUBCHIRP; n++) {
+            seq.push_back(std::polar(1.0f, rate * n * n / 2));
+        }
+    }
+    return seq;
+}
+
+// noise with three chirp sequences of one user and a weaker one of another
+std::vector<gr_complex> make_signal(const std::vector<gr_complex>& seq)
+{
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0, 0.3f);
+    std::vector<gr_complex> x(1500);
+    for (auto& v : x) {
+        v = gr_complex(noise(rng), noise(rng));
+    }
+    for (int start : { 100, 400, 700 }) {
+        for (size_t k = 0; k < seq.size(); k++) {
+            x[start + k] += seq[k];
+        }
+    }
+    for (size_t k = 0; k < seq.size(); k++) {
+        x[1000 + k] += 0.5f * seq[k];
+    }
+    return x;
+}
+
+// the sample by sample search the FFT screening replaces
+int direct_find(const subchirp_correlator& corr,
+                const gr_complex* in,
+                int npos,
+                int subchirp,
+                float threshold)
+{
+    for (int p = 0; p < npos; p++) {
+        if (std::norm(corr.correlate(in + p, subchirp)) > threshold) {
+            return p;
+        }
+    }
+    return npos;
+}
+
+// find() followed by a direct confirmation, as in multiuser_chirp_detector_cc
+int screened_find(subchirp_correlator& corr,
+                  const gr_complex* in,
+                  int npos,
+                  int subchirp,
+                  float threshold)
+{
+    int p = 0;
+    while (p < npos) {
+        p += corr.find(in + p, npos - p, subchirp, threshold);
+        if (p == npos || std::norm(corr.correlate(in + p, subchirp)) > threshold) {
+            break;
+        }
+        p++;
+    }
+    return p;
+}
+
+// thresholds exactly at, and just below, the largest correlation powers
+std::vector<float> boundary_thresholds(const subchirp_correlator& corr,
+                                       const std::vector<gr_complex>& x,
+                                       int npos)
+{
+    std::vector<float> powers;
+    for (int s = 0; s < NUM_SUBCHIRPS; s++) {
+        for (int p = 0; p < npos; p++) {
+            powers.push_back(std::norm(corr.correlate(&x[p], s)));
+        }
+    }
+    std::sort(powers.rbegin(), powers.rend());
+    std::vector<float> thresholds;
+    for (size_t k = 0; k < 40; k++) {
+        thresholds.push_back(powers[k]);
+        thresholds.push_back(std::nextafter(powers[k], 0.0f));
+    }
+    return thresholds;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(t1_find_matches_direct_search)
+{
+    const auto seq = make_chirp_seq();
+    const auto x = make_signal(seq);
+    const int npos = x.size() - LEN_SUBCHIRP + 1;
+    subchirp_correlator corr(seq, LEN_SUBCHIRP);
+
+    for (float threshold : boundary_thresholds(corr, x, npos)) {
+        for (int s = 0; s < NUM_SUBCHIRPS; s++) {
+            // every hit in turn, resuming after the previous one
+            int p = 0;
+            while (p < npos) {
+                const int expected = p + direct_find(corr, &x[p], npos - p, s, threshold);
+                const int found = p + screened_find(corr, &x[p], npos - p, s, threshold);
+                BOOST_REQUIRE_EQUAL(found, expected);
+                p = found + 1;
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(t2_scan_matches_direct_search)
+{
+    const auto seq = make_chirp_seq();
+    const auto x = make_signal(seq);
+    const int npos = x.size() - LEN_SUBCHIRP + 1;
+    subchirp_correlator corr(seq, LEN_SUBCHIRP);
+
+    for (float threshold : boundary_thresholds(corr, x, npos)) {
+        std::set<std::tuple<int, int>> expected;
+        for (int s = 0; s < NUM_SUBCHIRPS; s++) {
+            for (int p = 0; p < npos; p++) {
+                if (std::norm(corr.correlate(&x[p], s)) > threshold) {
+                    expected.emplace(p, s);
+                }
+            }
+        }
+
+        std::vector<subchirp_correlator::hit> hits;
+        corr.scan(x.data(), npos, threshold, hits);
+        std::set<std::tuple<int, int>> found;
+        for (const auto& h : hits) {
+            const gr_complex direct = corr.correlate(&x[h.position], h.subchirp);
+            BOOST_CHECK_EQUAL(h.power, std::norm(direct));
+            found.emplace(h.position, h.subchirp);
+        }
+        BOOST_REQUIRE_EQUAL(hits.size(), found.size());
+        BOOST_REQUIRE(found == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(t3_scan_finds_every_user)
+{
+    const auto seq = make_chirp_seq();
+    const auto x = make_signal(seq);
+    const int npos = x.size() - LEN_SUBCHIRP + 1;
+    subchirp_correlator corr(seq, LEN_SUBCHIRP);
+
+    std::vector<subchirp_correlator::hit> hits;
+    corr.scan(x.data(), npos, 0.5f, hits);
+    for (int start : { 100, 400, 700, 1000 }) {
+        for (int s = 0; s < NUM_SUBCHIRPS; s++) {
+            const int pos = start + s * LEN_SUBCHIRP;
+            BOOST_CHECK(std::any_of(hits.begin(), hits.end(), [&](const auto& h) {
+                return h.position == pos && h.subchirp == s;
+            }));
+        }
+    }
+}
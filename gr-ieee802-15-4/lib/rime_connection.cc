@@ -35,19 +35,19 @@ rime_connection::rime_connection(rime_stack* block,
 
 uint16_t rime_connection::channel() const { return d_channel; }
 
-std::string rime_connection::msg_to_string(pmt::pmt_t msg)
+msg_view rime_connection::view(const pmt::pmt_t& msg, std::string& storage)
 {
     if (pmt::is_pair(msg)) {
         pmt::pmt_t blob = pmt::cdr(msg);
-        return std::string(static_cast<const char*>(pmt::blob_data(blob)),
-                           pmt::blob_length(blob));
+        return { static_cast<const uint8_t*>(pmt::blob_data(blob)),
+                 pmt::blob_length(blob) };
     } else if (pmt::is_symbol(msg)) {
-        return std::string(pmt::symbol_to_string(msg));
+        storage = pmt::symbol_to_string(msg);
+        return { reinterpret_cast<const uint8_t*>(storage.data()), storage.size() };
     } else if (pmt::is_blob(msg)) {
-        return std::string(static_cast<const char*>(pmt::blob_data(msg)),
-                           pmt::blob_length(msg));
+        return { static_cast<const uint8_t*>(pmt::blob_data(msg)),
+                 pmt::blob_length(msg) };
     }
 
     throw std::runtime_error("rime connection: wrong message type");
-    return "";
 }
@@ -17,12 +17,20 @@
 #ifndef INCLUDED_RIME_CONNECTION_H
 #define INCLUDED_RIME_CONNECTION_H
 
+#include "pdu_pool.h"
 #include <gnuradio/block_detail.h>
 #include <ieee802_15_4/api.h>
 #include <ieee802_15_4/rime_stack.h>
 
 namespace gr {
 namespace ieee802_15_4 {
+
+// The bytes of a message, owned by the PMT they came in.
+struct msg_view {
+    const uint8_t* data;
+    size_t len;
+};
+
 class IEEE802_15_4_API rime_connection
 {
 protected:
@@ -32,9 +40,12 @@ protected:
     pmt::pmt_t d_outport;
     pmt::pmt_t d_mac_outport;
     uint8_t d_rime_add_mine[2];
+    // messages to d_outport and d_mac_outport, from the message handlers
+    pdu_pool d_pool;
 
 public:
-    static std::string msg_to_string(pmt::pmt_t msg);
+    // A symbol message has no buffer to point into, its name is copied to storage.
+    static msg_view view(const pmt::pmt_t& msg, std::string& storage);
     rime_connection(rime_stack* block,
                     uint16_t channel,
                     pmt::pmt_t inport,
@@ -42,7 +53,8 @@ public:
                     const uint8_t rime_add_mine[2]);
     virtual ~rime_connection(){};
     virtual void pack(pmt::pmt_t msg) = 0;
-    virtual void unpack(pmt::pmt_t msg) = 0;
+    // frame: a rime frame for this connection's channel, header included
+    virtual void unpack(msg_view frame) = 0;
     uint16_t channel() const;
 };
 } // namespace ieee802_15_4
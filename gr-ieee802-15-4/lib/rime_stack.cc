@@ -148,11 +148,12 @@ public:
             assert(false);
         }
 
-        unsigned char buf[2];
-        std::memcpy(buf, pmt::blob_data(blob), 2);
+        msg_view frame = { static_cast<const uint8_t*>(pmt::blob_data(blob)),
+                           pmt::blob_length(blob) };
         for (rime_connection* conn : d_connections) {
-            if (conn->channel() == buf[0] && (conn->channel() >> 8) == buf[1]) {
-                conn->unpack(blob);
+            if (conn->channel() == frame.data[0] &&
+                (conn->channel() >> 8) == frame.data[1]) {
+                conn->unpack(frame);
                 return;
             }
         }
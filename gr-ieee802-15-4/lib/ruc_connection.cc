@@ -22,6 +22,7 @@
 #define DEBUG 1
 #define dout DEBUG&& std::cout
 
+static const pmt::pmt_t SEQNO_KEY = pmt::mp("seqno");
 
 using namespace gr::ieee802_15_4;
 
@@ -73,10 +74,11 @@ void ruc_connection::pack(pmt::pmt_t msg)
         return;
     }
 
-    std::string tmp = rime_connection::msg_to_string(msg);
+    std::string storage;
+    msg_view data = rime_connection::view(msg, storage);
 
     uint8_t dest[2];
-    if (!uc_connection::rime_add_from_string(tmp, dest)) {
+    if (!uc_connection::rime_add_from_string(data, dest)) {
         std::cerr << "Warning: invalid target RIME-Address for runicast on channel ";
         std::cerr << static_cast<unsigned>(d_channel);
         std::cerr << ". Message will not be sent." << std::endl;
@@ -86,37 +88,33 @@ void ruc_connection::pack(pmt::pmt_t msg)
     std::array<uint8_t, 256> buf = ruc_connection::make_msgbuf(
         d_channel, false, d_send_seqno, d_rime_add_mine, dest);
 
-    size_t data_len = tmp.length();
-    assert(data_len);
-    assert(data_len < 256 - header_length);
+    assert(data.len);
+    assert(data.len < 256 - header_length);
 
-    std::memcpy(buf.data() + header_length, tmp.data(), data_len);
-    pmt::pmt_t rime_msg = pmt::make_blob(buf.data(), data_len + header_length);
     pmt::pmt_t dict = pmt::make_dict();
-    dict = pmt::dict_add(dict, pmt::mp("seqno"), pmt::from_long(d_send_seqno));
+    dict = pmt::dict_add(dict, SEQNO_KEY, pmt::from_long(d_send_seqno));
 
-    d_stubborn_sender.enqueue(pmt::cons(dict, rime_msg));
+    d_stubborn_sender.enqueue(
+        d_pool.make_pdu(dict, buf.data(), header_length, data.data, data.len));
     d_send_seqno = (d_send_seqno + 1) % (1 << seqno_bits);
 }
 
-void ruc_connection::unpack(pmt::pmt_t msg)
+void ruc_connection::unpack(msg_view frame)
 {
-    uint8_t buf[256];
+    const uint8_t* header = frame.data;
     uint8_t target_rime_zero, target_rime_one;
     uint8_t sender_rime_zero, sender_rime_one;
     bool is_ack = false;
     uint8_t packet_seqno;
-    size_t data_len = pmt::blob_length(msg);
-    std::memcpy(buf, pmt::blob_data(msg), data_len);
-
-    target_rime_zero = buf[2] << (1 + seqno_bits);
-    target_rime_zero |= buf[3] >> (7 - seqno_bits);
-    target_rime_one = buf[3] << (1 + seqno_bits);
-    target_rime_one |= buf[4] >> (7 - seqno_bits);
-    sender_rime_zero = buf[4] << (1 + seqno_bits);
-    sender_rime_zero |= buf[5] >> (7 - seqno_bits);
-    sender_rime_one = buf[5] << (1 + seqno_bits);
-    sender_rime_one |= buf[6] >> (7 - seqno_bits);
+
+    target_rime_zero = header[2] << (1 + seqno_bits);
+    target_rime_zero |= header[3] >> (7 - seqno_bits);
+    target_rime_one = header[3] << (1 + seqno_bits);
+    target_rime_one |= header[4] >> (7 - seqno_bits);
+    sender_rime_zero = header[4] << (1 + seqno_bits);
+    sender_rime_zero |= header[5] >> (7 - seqno_bits);
+    sender_rime_one = header[5] << (1 + seqno_bits);
+    sender_rime_one |= header[6] >> (7 - seqno_bits);
 
     dout << "[" << static_cast<int>(d_rime_add_mine[0]) << ".";
     dout << static_cast<int>(d_rime_add_mine[1]) << "]: ";
@@ -129,12 +127,13 @@ void ruc_connection::unpack(pmt::pmt_t msg)
         return;
     }
 
-    if ((buf[2] & 0x80) > 0) {
+    uint8_t flags = header[2];
+    if ((flags & 0x80) > 0) {
         is_ack = true;
-        buf[2] &= 0x7f; // reset ack-flag
+        flags &= 0x7f; // reset ack-flag
     }
 
-    packet_seqno = buf[2] >> (7 - seqno_bits);
+    packet_seqno = flags >> (7 - seqno_bits);
 
     if (is_ack) {
         if (packet_seqno != recv_seqno()) { // ignore duplicate packets
@@ -154,9 +153,10 @@ void ruc_connection::unpack(pmt::pmt_t msg)
 
     } else {
         // output message
-        pmt::pmt_t rime_payload =
-            pmt::make_blob(buf + header_length, data_len - header_length);
-        d_block->message_port_pub(d_outport, pmt::cons(pmt::PMT_NIL, rime_payload));
+        d_block->message_port_pub(
+            d_outport,
+            d_pool.make_pdu(
+                pmt::PMT_NIL, frame.data + header_length, frame.len - header_length));
 
         // send ack
         uint8_t dest[] = { sender_rime_zero, sender_rime_one };
@@ -168,8 +168,8 @@ void ruc_connection::unpack(pmt::pmt_t msg)
         dout << static_cast<int>(dest[0]) << ".";
         dout << static_cast<int>(dest[1]) << std::endl;
 
-        pmt::pmt_t ack_msg = pmt::make_blob(buf.data(), header_length);
-        d_block->message_port_pub(d_mac_outport, pmt::cons(pmt::PMT_NIL, ack_msg));
+        d_block->message_port_pub(d_mac_outport,
+                                  d_pool.make_pdu(pmt::PMT_NIL, buf.data(), header_length));
     }
 }
 
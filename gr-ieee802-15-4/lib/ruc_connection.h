@@ -46,7 +46,7 @@ public:
                    pmt::pmt_t outport,
                    const uint8_t rime_add_mine[2]);
     void pack(pmt::pmt_t msg);
-    void unpack(pmt::pmt_t msg);
+    void unpack(msg_view frame);
     void inc_recv_seqno();
     int recv_seqno();
 };
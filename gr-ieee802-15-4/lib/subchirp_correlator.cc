@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "subchirp_correlator.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gr {
+namespace ieee802_15_4 {
+
+namespace {
+// The FFT spans at least this many subchirps, so that most of each block yields
+// valid positions.
+constexpr int FFT_SUBCHIRPS = 4;
+// Screening threshold relative to the detection threshold, covering the rounding of
+// the FFT correlation and the running energy.
+constexpr float SCREEN_MARGIN = 0.99f;
+
+int fft_size_for(int len)
+{
+    int size = 64;
+    while (size < FFT_SUBCHIRPS * len) {
+        size <<= 1;
+    }
+    return size;
+}
+} // namespace
+
+subchirp_correlator::subchirp_correlator(const std::vector<gr_complex>& chirp_seq,
+                                         int len_subchirp)
+    : d_len(len_subchirp),
+      d_fft_size(fft_size_for(len_subchirp)),
+      d_block_positions(d_fft_size - len_subchirp + 1),
+      d_energy(0),
+      d_e_subchirp(0),
+      d_chirp_seq(chirp_seq),
+      d_fwd(d_fft_size),
+      d_rev(d_fft_size),
+      d_screen(d_block_positions)
+{
+    for (int k = 0; k < d_len; k++) {
+        d_energy += std::norm(chirp_seq[k]);
+    }
+    volk_32fc_x2_conjugate_dot_prod_32fc(
+        &d_e_subchirp, &d_chirp_seq[0], &d_chirp_seq[0], d_len);
+
+    const int nsubchirps = num_subchirps();
+    d_spectra.resize(nsubchirps * d_fft_size);
+    for (int s = 0; s < nsubchirps; s++) {
+        gr_complex* buf = d_fwd.get_inbuf();
+        std::copy(&chirp_seq[s * d_len], &chirp_seq[(s + 1) * d_len], buf);
+        std::fill(buf + d_len, buf + d_fft_size, gr_complex(0, 0));
+        d_fwd.execute();
+        const gr_complex* spectrum = d_fwd.get_outbuf();
+        for (int k = 0; k < d_fft_size; k++) {
+            d_spectra[s * d_fft_size + k] = std::conj(spectrum[k]) / float(d_fft_size);
+        }
+    }
+}
+
+gr_complex subchirp_correlator::correlate(const gr_complex* buf, int subchirp) const
+{
+    gr_complex corrval = 0;
+    volk_32fc_x2_conjugate_dot_prod_32fc(
+        &corrval, buf, &d_chirp_seq[subchirp * d_len], d_len);
+    gr_complex e_buf = 0;
+    volk_32fc_x2_conjugate_dot_prod_32fc(&e_buf, buf, buf, d_len);
+    // normalize using standard deviations of both signals (assuming mean==0)
+    // add 1e-6 to avoid divide-by-zero errors
+    return corrval / (std::sqrt(e_buf * d_e_subchirp) + gr_complex(1e-6, 0));
+}
+
+void subchirp_correlator::transform_block(const gr_complex* in, int nsamples)
+{
+    gr_complex* x = d_fwd.get_inbuf();
+    std::copy(in, in + nsamples, x);
+    std::fill(x + nsamples, x + d_fft_size, gr_complex(0, 0));
+    d_fwd.execute();
+}
+
+const gr_complex* subchirp_correlator::correlate_block(int subchirp)
+{
+    // IFFT(FFT(x) * conj(FFT(c)))[p] = sum_k x[p + k] conj(c[k]), valid for
+    // p < d_block_positions
+    volk_32fc_x2_multiply_32fc(d_rev.get_inbuf(),
+                               d_fwd.get_outbuf(),
+                               &d_spectra[subchirp * d_fft_size],
+                               d_fft_size);
+    d_rev.execute();
+    return d_rev.get_outbuf();
+}
+
+void subchirp_correlator::screen_block(const gr_complex* in, int nblock, float threshold)
+{
+    const float screen = threshold * SCREEN_MARGIN;
+    // running energy of the window, restarted every block
+    double energy = 0;
+    for (int k = 0; k < d_len; k++) {
+        energy += std::norm(in[k]);
+    }
+    for (int p = 0; p < nblock; p++) {
+        if (p > 0) {
+            energy += std::norm(in[p + d_len - 1]) - std::norm(in[p - 1]);
+        }
+        // as in the direct test: |corr|^2 / (sqrt(e_buf * e_sub) + 1e-6)^2
+        const float denom = std::sqrt(std::max(energy, 0.0) * d_energy) + 1e-6f;
+        d_screen[p] = screen * denom * denom;
+    }
+}
+
+int subchirp_correlator::find(const gr_complex* in,
+                              int npos,
+                              int subchirp,
+                              float threshold)
+{
+    for (int p0 = 0; p0 < npos; p0 += d_block_positions) {
+        const int nblock = std::min(d_block_positions, npos - p0);
+        transform_block(in + p0, nblock + d_len - 1);
+        const gr_complex* corr = correlate_block(subchirp);
+        screen_block(in + p0, nblock, threshold);
+        for (int p = 0; p < nblock; p++) {
+            if (std::norm(corr[p]) > d_screen[p]) {
+                return p0 + p;
+            }
+        }
+    }
+    return npos;
+}
+
+void subchirp_correlator::scan(const gr_complex* in,
+                               int npos,
+                               float threshold,
+                               std::vector<hit>& hits)
+{
+    const int nsubchirps = num_subchirps();
+    for (int p0 = 0; p0 < npos; p0 += d_block_positions) {
+        const int nblock = std::min(d_block_positions, npos - p0);
+        transform_block(in + p0, nblock + d_len - 1);
+        screen_block(in + p0, nblock, threshold);
+        for (int s = 0; s < nsubchirps; s++) {
+            const gr_complex* corr = correlate_block(s);
+            for (int p = 0; p < nblock; p++) {
+                if (std::norm(corr[p]) <= d_screen[p]) {
+                    continue;
+                }
+                const float power = std::norm(correlate(in + p0 + p, s));
+                if (power > threshold) {
+                    hits.push_back(hit{ p0 + p, s, power });
+                }
+            }
+        }
+    }
+}
+
+} // namespace ieee802_15_4
+} // namespace gr
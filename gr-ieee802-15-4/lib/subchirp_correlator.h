@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Free Software Foundation, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_IEEE802_15_4_SUBCHIRP_CORRELATOR_H
+#define INCLUDED_IEEE802_15_4_SUBCHIRP_CORRELATOR_H
+
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/gr_complex.h>
+#include <vector>
+
+namespace gr {
+namespace ieee802_15_4 {
+
+/*
+ * Normalized correlation of a stream with the subchirps of a chirp sequence at many
+ * positions at once: overlap-save FFT correlation against the precomputed spectrum
+ * of each subchirp, divided by a running sum of the stream's energy. One forward
+ * FFT of fft_size() samples, and one inverse FFT per subchirp, cover
+ * fft_size() - len_subchirp + 1 positions, instead of two dot products per position
+ * and subchirp.
+ */
+class subchirp_correlator
+{
+public:
+    struct hit {
+        int position;
+        int subchirp;
+        float power; // normalized correlation power, as std::norm(correlate())
+    };
+
+    subchirp_correlator(const std::vector<gr_complex>& chirp_seq, int len_subchirp);
+
+    int fft_size() const { return d_fft_size; }
+    int num_subchirps() const { return d_chirp_seq.size() / d_len; }
+
+    // Normalized correlation of buf[0 .. len_subchirp) with a subchirp, computed
+    // directly with two dot products.
+    gr_complex correlate(const gr_complex* buf, int subchirp) const;
+
+    // First position p < npos at which the normalized correlation power of
+    // in[p .. p + len_subchirp) with the given subchirp may exceed threshold, or npos.
+    // in holds npos + len_subchirp - 1 samples. The test has a small margin for the
+    // FFT's rounding, so a hit must be confirmed by a direct correlation.
+    int find(const gr_complex* in, int npos, int subchirp, float threshold);
+
+    // Appends to hits every position p < npos and subchirp at which the normalized
+    // correlation power exceeds threshold, in one pass over in. Candidates of the FFT
+    // screening are confirmed with correlate(), so the hits are exactly those of a
+    // direct search.
+    void scan(const gr_complex* in, int npos, float threshold, std::vector<hit>& hits);
+
+private:
+    int d_len;
+    int d_fft_size;
+    int d_block_positions;   // positions per FFT block
+    float d_energy;          // of one subchirp
+    gr_complex d_e_subchirp; // the same, as the direct correlation uses it
+    std::vector<gr_complex> d_chirp_seq;
+    gr::fft::fft_complex_fwd d_fwd;
+    gr::fft::fft_complex_rev d_rev;
+    // per subchirp: conj(FFT(zero-padded subchirp)) / fft_size
+    std::vector<gr_complex> d_spectra;
+    // per position of the current block: screening threshold for |corr|^2
+    std::vector<float> d_screen;
+
+    void transform_block(const gr_complex* in, int nsamples);
+    const gr_complex* correlate_block(int subchirp);
+    void screen_block(const gr_complex* in, int nblock, float threshold);
+};
+
+} // namespace ieee802_15_4
+} // namespace gr
+
+#endif /* INCLUDED_IEEE802_15_4_SUBCHIRP_CORRELATOR_H */
@@ -17,6 +17,8 @@
 
 #include "bc_connection.h"
 #include "uc_connection.h"
+#include <algorithm>
+#include <cctype>
 
 using namespace gr::ieee802_15_4;
 
@@ -44,18 +46,44 @@ uc_connection::make_msgbuf(uint16_t channel, const uint8_t src[2], const uint8_t
     return buf;
 }
 
-bool uc_connection::rime_add_from_string(std::string& to_parse, uint8_t addr[2])
+namespace {
+
+// strtoul in base 10 on a buffer that is not null terminated. Values above 255 are
+// no part of an address and come out as 256.
+unsigned long parse_ulong(const uint8_t* p, const uint8_t* end)
+{
+    while (p < end && std::isspace(*p)) {
+        p++;
+    }
+    if (p < end && *p == '+') {
+        p++;
+    }
+    unsigned long value = 0;
+    for (; p < end && std::isdigit(*p); p++) {
+        value = std::min(value * 10 + (*p - '0'), 256ul);
+    }
+    return value;
+}
+
+} // namespace
+
+bool uc_connection::rime_add_from_string(msg_view& msg, uint8_t addr[2])
 {
-    unsigned long rime_zero_long = std::strtoul(to_parse.data(), nullptr, 10);
-    size_t index = to_parse.find(".");
-    to_parse.erase(0, index + 1);
-    unsigned long rime_one_long = std::strtoul(to_parse.data(), nullptr, 10);
-    index = to_parse.find_first_not_of("0123456789");
-    if (to_parse.at(index) == ' ') {
-        to_parse.erase(0, index + 1);
-    } else {
-        to_parse.erase(0, index);
+    const uint8_t* end = msg.data + msg.len;
+    unsigned long rime_zero_long = parse_ulong(msg.data, end);
+    const uint8_t* p = std::find(msg.data, end, '.');
+    p = p == end ? msg.data : p + 1;
+    unsigned long rime_one_long = parse_ulong(p, end);
+    p = std::find_if(p, end, [](uint8_t c) { return !std::isdigit(c); });
+    if (p == end) {
+        // no payload after the address
+        return false;
     }
+    if (*p == ' ') {
+        p++;
+    }
+    msg.len = end - p;
+    msg.data = p;
     if (rime_zero_long > 255 || rime_one_long > 255 ||
         (rime_zero_long == 0 && rime_one_long == 0)) {
         return false;
@@ -74,10 +102,11 @@ void uc_connection::pack(pmt::pmt_t msg)
         return;
     }
 
-    std::string tmp = rime_connection::msg_to_string(msg);
+    std::string storage;
+    msg_view data = rime_connection::view(msg, storage);
 
     uint8_t dest[2];
-    if (!uc_connection::rime_add_from_string(tmp, dest)) {
+    if (!uc_connection::rime_add_from_string(data, dest)) {
         std::cerr << "Warning: invalid target RIME-Address for unicast on channel ";
         std::cerr << static_cast<unsigned>(d_channel);
         std::cerr << ". Message will not be sent." << std::endl;
@@ -87,29 +116,25 @@ void uc_connection::pack(pmt::pmt_t msg)
     std::array<uint8_t, 256> buf =
         uc_connection::make_msgbuf(d_channel, d_rime_add_mine, dest);
 
-    size_t data_len = tmp.length();
-    assert(data_len);
-    assert(data_len < 256 - header_length);
-
-    std::memcpy(buf.data() + header_length, tmp.data(), data_len);
-    pmt::pmt_t rime_msg = pmt::make_blob(buf.data(), data_len + header_length);
+    assert(data.len);
+    assert(data.len < 256 - header_length);
 
-    d_block->message_port_pub(d_mac_outport, pmt::cons(pmt::PMT_NIL, rime_msg));
+    d_block->message_port_pub(
+        d_mac_outport,
+        d_pool.make_pdu(pmt::PMT_NIL, buf.data(), header_length, data.data, data.len));
 }
 
-void uc_connection::unpack(pmt::pmt_t msg)
+void uc_connection::unpack(msg_view frame)
 {
-    unsigned char buf[256];
-    size_t data_len = pmt::blob_length(msg);
-    std::memcpy(buf, pmt::blob_data(msg), data_len);
-
     // this block is not the destination of the message
-    if (buf[2] != d_rime_add_mine[0] || buf[3] != d_rime_add_mine[1]) {
-        std::cout << "wrong rime add " << int(buf[2]) << "." << int(buf[3]) << std::endl;
+    if (frame.data[2] != d_rime_add_mine[0] || frame.data[3] != d_rime_add_mine[1]) {
+        std::cout << "wrong rime add " << int(frame.data[2]) << "." << int(frame.data[3])
+                  << std::endl;
         return;
     }
 
-    pmt::pmt_t rime_payload =
-        pmt::make_blob(buf + header_length, data_len - header_length);
-    d_block->message_port_pub(d_outport, pmt::cons(pmt::PMT_NIL, rime_payload));
+    d_block->message_port_pub(
+        d_outport,
+        d_pool.make_pdu(
+            pmt::PMT_NIL, frame.data + header_length, frame.len - header_length));
 }
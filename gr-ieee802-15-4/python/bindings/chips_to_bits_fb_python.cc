@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(chips_to_bits_fb.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(8b2d311cb935ae8ae5d15320de3a6d5d)                     */
+/* BINDTOOL_HEADER_FILE_HASH(5c72ce680d8483479a4e49666480879a)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
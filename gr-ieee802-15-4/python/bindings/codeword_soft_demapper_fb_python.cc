@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(codeword_soft_demapper_fb.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(b2c725b787d15184d4df030597b6a2be)                     */
+/* BINDTOOL_HEADER_FILE_HASH(dd6b06728351c05165de6cc9e968c1d6)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
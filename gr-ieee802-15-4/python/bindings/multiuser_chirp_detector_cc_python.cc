@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(multiuser_chirp_detector_cc.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(07f3a8e0bf8162cde013aff2c055a608)                     */
+/* BINDTOOL_HEADER_FILE_HASH(244552f673a89939a1534f57470ff104)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -44,5 +44,20 @@ class qa_chips_to_bits_fb (gr_unittest.TestCase):
         ref = (0,0,1,0,0,1,1,1)
         self.assertFloatTuplesAlmostEqual(bits_out, ref)
 
+    def test_002_llr (self):
+        # set up fg
+        chips_in = (3,2,-2,-3, 4,-3,3,-4, -2,2,-1,1.5, -1.5,-1.2,2,1)
+        self.src = blocks.vector_source_f(chips_in)
+        self.c2b = ieee802_15_4.chips_to_bits_fb([[1,1,0,0],[1,0,1,0],[0,1,0,1],[0,0,1,1]])
+        self.snk = blocks.vector_sink_b(1)
+        self.llr = blocks.vector_sink_f(1)
+        self.tb.connect(self.src, self.c2b, self.snk)
+        self.tb.connect((self.c2b, 1), self.llr)
+        self.tb.run ()
+        # check data: best correlation with a 1 bit minus best with a 0 bit
+        ref = (-8,-12, 12,-16, -6,7, 6.4,5)
+        self.assertFloatTuplesAlmostEqual(self.snk.data(), (0,0,1,0,0,1,1,1))
+        self.assertFloatTuplesAlmostEqual(self.llr.data(), ref, 5)
+
 if __name__ == '__main__':
     gr_unittest.run(qa_chips_to_bits_fb, "qa_chips_to_bits_fb.xml")
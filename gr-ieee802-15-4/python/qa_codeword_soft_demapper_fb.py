@@ -50,6 +50,20 @@ class qa_codeword_soft_demapper_fb (gr_unittest.TestCase):
         print("ref:", bits)
         self.assertFloatTuplesAlmostEqual(data_out, bits)
 
+    def test_002_llr_unused_bit (self):
+        # three codewords on three bits: no codeword sets the msb
+        cw = [[1,1,1,1], [1,-1,1,-1], [1,1,-1,-1]]
+        self.src = blocks.vector_source_f((1,1,1,1))
+        self.enc = ieee802_15_4.codeword_soft_demapper_fb(bits_per_cw=3,codewords=cw)
+        self.snk = blocks.vector_sink_b(1)
+        self.llr = blocks.vector_sink_f(1)
+        self.tb.connect(self.src, self.enc, self.snk)
+        self.tb.connect((self.enc, 1), self.llr)
+        self.tb.run()
+        # correlations (4, 0, 0): the msb is certainly 0, clamped to -2 * 4
+        self.assertFloatTuplesAlmostEqual(self.snk.data(), (0,0,0))
+        self.assertFloatTuplesAlmostEqual(self.llr.data(), (-8,-4,-4), 5)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_codeword_soft_demapper_fb)
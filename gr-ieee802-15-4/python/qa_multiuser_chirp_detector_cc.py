@@ -24,6 +24,7 @@ from gnuradio import blocks
 import ieee802_15_4 as ieee802_15_4_installed # css_phy is not found in the just compiled swig version...
 import ieee802_15_4_swig as ieee802_15_4
 import numpy as np
+import pmt
 
 class qa_multiuser_multiuser_chirp_detector_cc (gr_unittest.TestCase):
 
@@ -82,6 +83,29 @@ class qa_multiuser_multiuser_chirp_detector_cc (gr_unittest.TestCase):
         data_out = snk.data()
         self.assertComplexTuplesAlmostEqual(ref, data_out, 5)
 
+    def test_004_t (self): # every chirp is reported on the chirps port, with its time gap
+        # set up fg
+        print("test_004_t")
+        len_chirp = len(self.p.chirp_seq)
+        len_gap_1 = len(self.p.time_gap_1)
+        data_in = np.concatenate((self.p.chirp_seq, self.p.time_gap_1, self.p.chirp_seq, self.p.time_gap_2, np.zeros((100,))))
+        src = blocks.vector_source_c(data_in)
+        det = ieee802_15_4.multiuser_chirp_detector_cc(self.p.chirp_seq, len_gap_1, len(self.p.time_gap_2), 38, 0.99)
+        snk = blocks.vector_sink_c()
+        dbg = blocks.message_debug()
+        self.tb.connect(src, det, snk)
+        self.tb.msg_connect(det, "chirps", dbg, "store")
+        self.tb.run ()
+        # check data
+        self.assertEqual(dbg.num_messages(), 2)
+        chirps = [dbg.get_message(i) for i in range(2)]
+        offsets = [pmt.to_uint64(pmt.dict_ref(c, pmt.intern("offset"), pmt.PMT_NIL)) for c in chirps]
+        self.assertEqual(offsets, [0, len_chirp + len_gap_1])
+        for c in chirps:
+            self.assertEqual(pmt.to_long(pmt.dict_ref(c, pmt.intern("subchirps"), pmt.PMT_NIL)), 15)
+        self.assertFalse(pmt.dict_has_key(chirps[0], pmt.intern("time_gap")))
+        self.assertEqual(pmt.to_long(pmt.dict_ref(chirps[1], pmt.intern("time_gap"), pmt.PMT_NIL)), len_gap_1)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_multiuser_multiuser_chirp_detector_cc)